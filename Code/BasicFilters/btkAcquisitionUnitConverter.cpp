@@ -73,6 +73,8 @@ namespace btk
    * degree and watt. Even if you could convert trajectories and moments with the desired 
    * units, it is recommended to use the same length unit (i.e. mm and Nmm or m with Nm).
    *
+   * The points and the analog channels are copied and scaled in parallel if several threads are set (see ProcessObject::SetThreadNumber()).
+   *
    * @ingroup BTKBasicFilters
    */
    
@@ -217,6 +219,39 @@ namespace btk
     return Acquisition::New();
   };
   
+  static inline void _btk_acquisition_unit_converter_finish(Point* /* point */, double /* scale */, const std::string& /* unit */)
+  {};
+  
+  static inline void _btk_acquisition_unit_converter_finish(Analog* analog, double scale, const std::string& unit)
+  {
+    analog->SetUnit(unit);
+    analog->SetScale(analog->GetScale() * scale);
+  };
+  
+  // Copies and scales each measure given to the method Append() (in parallel if several threads are used).
+  template <class T>
+  struct _btk_acquisition_unit_converter_loop
+  {
+    void Append(typename T::Pointer measure, double scale, const std::string& unit)
+    {
+      this->inputs.push_back(measure);
+      this->scales.push_back(scale);
+      this->units.push_back(unit);
+      this->outputs.push_back(typename T::Pointer());
+    };
+    void operator()(int i)
+    {
+      typename T::Pointer m = this->inputs[i]->Clone();
+      m->GetValues() *= this->scales[i];
+      _btk_acquisition_unit_converter_finish(m.get(), this->scales[i], this->units[i]);
+      this->outputs[i] = m;
+    };
+    std::vector<typename T::Pointer> inputs;
+    std::vector<double> scales;
+    std::vector<std::string> units;
+    std::vector<typename T::Pointer> outputs;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -338,24 +373,28 @@ namespace btk
     else
       output->SetPointUnit(Point::Scalar, scalarUnit);
     
-    // Point conversion
+    // Point conversion (the points are copied and scaled in parallel, then appended in the same order)
+    _btk_acquisition_unit_converter_loop<Point> points;
     for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
     {
-      btk::Point::Pointer p = (*it)->Clone();
-      if (p->GetType() < 6)
-        p->GetValues() *= scales[p->GetType()];
-      else if (p->GetType() == 6) // Reaction: Force, Moment and Position
+      double s = 1.0;
+      if ((*it)->GetType() < 6)
+        s = scales[(*it)->GetType()];
+      else if ((*it)->GetType() == 6) // Reaction: Force, Moment and Position
       {
-        std::string suffix = p->GetLabel().substr(2, p->GetLabel().length()-2);
+        std::string suffix = (*it)->GetLabel().substr(2, (*it)->GetLabel().length()-2);
         if (suffix.compare(".F") == 0)
-          p->GetValues() *= scales[Force];
+          s = scales[Force];
         else if (suffix.compare(".M") == 0)
-          p->GetValues() *= scales[Moment];
+          s = scales[Moment];
         else
-          p->GetValues() *= scales[Length];
+          s = scales[Length];
       }
-      output->AppendPoint(p);
+      points.Append(*it, s, "");
     }
+    this->ParallelFor(static_cast<int>(points.inputs.size()), points);
+    for (size_t i = 0 ; i < points.outputs.size() ; ++i)
+      output->AppendPoint(points.outputs[i]);
     
     // Metadata + FP
     std::vector<int> channelsToNoScale;
@@ -451,6 +490,7 @@ namespace btk
                   break;
                 case 2:
                 case 4:
+                case 21:
                   {
                   const double sf[6] = {scales[Force], scales[Force], scales[Force], scales[Moment], scales[Moment], scales[Moment]};
                   corrupted = !this->ConvertCalMatrix(values, i*valuesStep, total, columnsStep, 6, 6, sf);
@@ -464,6 +504,8 @@ namespace btk
                   break;
                 case 3:
                 case 7:
+                case 11:
+                case 12:
                   {
                   const double sf[8] = {scales[Force], scales[Force], scales[Force], scales[Force], scales[Force], scales[Force], scales[Force], scales[Force]};
                   corrupted = !this->ConvertCalMatrix(values, i*valuesStep, total, columnsStep, 8, 8, sf);
@@ -475,15 +517,6 @@ namespace btk
                   corrupted = !this->ConvertCalMatrix(values, i*valuesStep, total, columnsStep, 12, 12, sf);
                   }
                   break;
-                case 11:
-                  btkErrorMacro("Force Platform type 11 is not yet supported. Please, report this to the developers");
-                  break;
-                case 12:
-                  btkErrorMacro("Force Platform type 12 is not yet supported. Please, report this to the developers");
-                  break;
-                case 21:
-                  btkErrorMacro("Force Platform type 21 is not yet supported. Please, report this to the developers");
-                  break;
                 }
               }
               if (corrupted)
@@ -498,23 +531,24 @@ namespace btk
       }
     }
     
-    // Analog conversion
+    // Analog conversion (same principle than for the points)
+    _btk_acquisition_unit_converter_loop<Analog> analogs;
     int idxChannel = 0;
     for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
     {
       double s = 1.0;
-      btk::Analog::Pointer ac = (*it)->Clone();
+      std::string unit = (*it)->GetUnit();
       // Check the unit to discover the type
       // int idxIn; // Already declared for the scalar.
       if (this->CheckUnit(&idxIn, numLength, AcquisitionUnitConverter::LengthUnit, (*it)->GetUnit()))
       {
         s = AcquisitionUnitConverter::LengthScale[idxIn * numLength + indexesOut[Length]];
-        ac->SetUnit(this->m_Units[Length]);
+        unit = this->m_Units[Length];
       }
       else if (this->CheckUnit(&idxIn, numAngle, AcquisitionUnitConverter::AngleUnit, (*it)->GetUnit()))
       {
         s = AcquisitionUnitConverter::AngleScale[idxIn * numAngle + indexesOut[Angle]];
-        ac->SetUnit(this->m_Units[Angle]);
+        unit = this->m_Units[Angle];
       }
       else if (this->CheckUnit(&idxIn, numForce, AcquisitionUnitConverter::ForceUnit, (*it)->GetUnit()))
       {
@@ -532,7 +566,7 @@ namespace btk
           s = 1.0;
         else
           s = AcquisitionUnitConverter::ForceScale[idxIn * numForce + indexesOut[Force]];
-        ac->SetUnit(this->m_Units[Force]);
+        unit = this->m_Units[Force];
       }
       else if (this->CheckUnit(&idxIn, numMoment, AcquisitionUnitConverter::MomentUnit, (*it)->GetUnit()))
       {
@@ -550,12 +584,12 @@ namespace btk
           s = 1.0;
         else
           s = AcquisitionUnitConverter::MomentScale[idxIn * numMoment + indexesOut[Moment]];
-        ac->SetUnit(this->m_Units[Moment]);
+        unit = this->m_Units[Moment];
       }
       else if (this->CheckUnit(&idxIn, numPower, AcquisitionUnitConverter::PowerUnit, (*it)->GetUnit()))
       {
         s = AcquisitionUnitConverter::PowerScale[idxIn * numPower + indexesOut[Power]];
-        ac->SetUnit(this->m_Units[Power]);
+        unit = this->m_Units[Power];
       }
       else if (this->CheckUnit(&idxIn, numVoltage, AcquisitionUnitConverter::VoltageUnit, (*it)->GetUnit()))
       {
@@ -563,11 +597,12 @@ namespace btk
       }
       else
         btkErrorMacro("Unknown analog channel's unit: '"+ (*it)->GetUnit() + "'. Impossible to scale its data.");
-      ac->GetValues() *= s;
-      ac->SetScale(ac->GetScale() * s);
-      output->AppendAnalog(ac);
+      analogs.Append(*it, s, unit);
       ++idxChannel;
     }
+    this->ParallelFor(static_cast<int>(analogs.inputs.size()), analogs);
+    for (size_t i = 0 ; i < analogs.outputs.size() ; ++i)
+      output->AppendAnalog(analogs.outputs[i]);
     
     output->SetFirstFrame(input->GetFirstFrame());
     output->SetAnalogResolution(input->GetAnalogResolution());
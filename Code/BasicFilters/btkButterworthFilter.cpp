@@ -0,0 +1,267 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkButterworthFilter.h"
+
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkEigen/SignalProcessing/SOSFilter.h>
+
+#include <algorithm>
+
+namespace btk
+{
+  // Second-order sections of the filter designed for one sampling frequency.
+  struct _btk_butterworth_design
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 6> sos;
+    Eigen::Matrix<double, Eigen::Dynamic, 2> zi;
+    int elen; // Number of samples used in the reflections
+  };
+  
+  // Contiguous samples to filter.
+  struct _btk_butterworth_channel
+  {
+    const double* input;
+    double* output;
+    int length;
+    int design;
+  };
+  
+  static bool _btk_butterworth_channel_less(const _btk_butterworth_channel& lhs, const _btk_butterworth_channel& rhs)
+  {
+    return (lhs.design < rhs.design) || ((lhs.design == rhs.design) && (lhs.length < rhs.length));
+  };
+  
+  // The channels with the same length and the same filter are filtered by groups of 4 (in parallel if several threads are used).
+  struct _btk_butterworth_loop
+  {
+    typedef btkEigen::FiltFiltLanesBuffer<double, 4>::Type Buffer;
+    
+    void operator()(int idx) const
+    {
+      const _btk_butterworth_channel* group = &(this->channels[this->groups[idx]]);
+      const int num = this->groups[idx+1] - this->groups[idx];
+      const _btk_butterworth_design& design = this->designs[group[0].design];
+      const int len = group[0].length;
+      // Same buffer for the 4 channels, the reflections and the two passes.
+      Buffer W(len + 2 * design.elen, 4);
+      for (int i = 0 ; i < num ; ++i)
+        W.block(design.elen, i, len, 1) = Eigen::Map< const Eigen::Matrix<double, Eigen::Dynamic, 1> >(group[i].input, len);
+      W.block(design.elen, num, len, 4 - num).setZero();
+      btkEigen::sosfiltfiltLanes<double, 4>(design.sos, design.zi, design.elen, &W);
+      for (int i = 0 ; i < num ; ++i)
+        Eigen::Map< Eigen::Matrix<double, Eigen::Dynamic, 1> >(group[i].output, len) = W.block(design.elen, i, len, 1);
+    };
+    
+    // Returns the index of the design or -1 if the filter cannot be designed.
+    int AddDesign(int order, double cutoffFrequency, double samplingFrequency)
+    {
+      if (order < 1)
+      {
+        btkErrorMacro("The order of the filter must be strictly positive.");
+        return -1;
+      }
+      if (samplingFrequency <= 0.0)
+      {
+        btkErrorMacro("The sampling frequency must be strictly positive.");
+        return -1;
+      }
+      if ((cutoffFrequency <= 0.0) || (cutoffFrequency >= samplingFrequency / 2.0))
+      {
+        btkErrorMacro("The cutoff frequency must be strictly positive and lower than the half of the sampling frequency.");
+        return -1;
+      }
+      _btk_butterworth_design design;
+      if (!btkEigen::butterSOS(&design.sos, order, 2.0 * cutoffFrequency / samplingFrequency))
+        return -1;
+      btkEigen::sosfiltState(&design.zi, design.sos);
+      design.elen = 3 * order;
+      this->designs.push_back(design);
+      return static_cast<int>(this->designs.size()) - 1;
+    };
+    
+    // The channels too short to be filtered are ignored.
+    void AddChannel(const double* input, double* output, int length, int design)
+    {
+      if (length <= this->designs[design].elen)
+        return;
+      _btk_butterworth_channel channel = {input, output, length, design};
+      this->channels.push_back(channel);
+    };
+    
+    // Sorts the channels and sets the first channel of each group. Returns the number of groups.
+    int Prepare()
+    {
+      std::sort(this->channels.begin(), this->channels.end(), _btk_butterworth_channel_less);
+      this->groups.clear();
+      for (int i = 0 ; i < static_cast<int>(this->channels.size()) ; ++i)
+      {
+        if (this->groups.empty() || (i - this->groups.back() == 4) 
+            || (this->channels[i].design != this->channels[i-1].design) || (this->channels[i].length != this->channels[i-1].length))
+          this->groups.push_back(i);
+      }
+      const int num = static_cast<int>(this->groups.size());
+      this->groups.push_back(static_cast<int>(this->channels.size()));
+      return num;
+    };
+    
+    std::vector<_btk_butterworth_design> designs;
+    std::vector<_btk_butterworth_channel> channels;
+    std::vector<int> groups;
+  };
+  
+  // Copies the points and registers each block of consecutive valid frames of their coordinates.
+  static void _btk_butterworth_points(_btk_butterworth_loop* loop, int design, PointCollection::Pointer input, PointCollection::Pointer output)
+  {
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      const int frameNumber = (*it)->GetFrameNumber();
+      Point::Pointer point = Point::New((*it)->GetLabel(), frameNumber, (*it)->GetType(), (*it)->GetDescription());
+      point->SetValues((*it)->GetValues());
+      point->SetResiduals((*it)->GetResiduals());
+      output->InsertItem(point);
+      const Point::Residuals& residuals = (*it)->GetResiduals();
+      int i = 0;
+      while (i < frameNumber)
+      {
+        if (residuals.coeff(i) < 0.0)
+        {
+          ++i;
+          continue;
+        }
+        int j = i;
+        while ((j < frameNumber) && (residuals.coeff(j) >= 0.0))
+          ++j;
+        for (int k = 0 ; k < 3 ; ++k)
+          loop->AddChannel((*it)->GetValues().data() + k * frameNumber + i, point->GetValues().data() + k * frameNumber + i, j - i, design);
+        i = j;
+      }
+    }
+  };
+  
+  // Copies the analog channels and registers their values. 
+  // The copies are filtered in place as the input values can be strided (analog channels packed in a row major btk::AnalogBlock).
+  static void _btk_butterworth_analogs(_btk_butterworth_loop* loop, int design, AnalogCollection::Pointer input, AnalogCollection::Pointer output)
+  {
+    for (AnalogCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      Analog::Pointer analog = Analog::New((*it)->GetLabel(), (*it)->GetFrameNumber());
+      analog->SetDescription((*it)->GetDescription());
+      analog->SetUnit((*it)->GetUnit());
+      analog->SetGain((*it)->GetGain());
+      analog->SetOffset((*it)->GetOffset());
+      analog->SetScale((*it)->GetScale());
+      analog->SetValues((*it)->GetValues());
+      output->InsertItem(analog);
+      loop->AddChannel(analog->GetValues().data(), analog->GetValues().data(), (*it)->GetFrameNumber(), design);
+    }
+  };
+  
+  /**
+   * Specialized version to filter a collection of points. The sampling frequency must be set.
+   */
+  template <>
+  void ButterworthFilter<PointCollection>::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_butterworth_loop loop;
+    const int design = loop.AddDesign(this->m_Order, this->m_CutoffFrequency, this->m_SamplingFrequency);
+    if (design == -1)
+      return;
+    _btk_butterworth_points(&loop, design, input, output);
+    this->ParallelFor(loop.Prepare(), loop);
+  };
+  
+  /**
+   * Specialized version to filter a collection of analog channels. The sampling frequency must be set.
+   */
+  template <>
+  void ButterworthFilter<AnalogCollection>::GenerateData()
+  {
+    AnalogCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    AnalogCollection::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_butterworth_loop loop;
+    const int design = loop.AddDesign(this->m_Order, this->m_CutoffFrequency, this->m_SamplingFrequency);
+    if (design == -1)
+      return;
+    _btk_butterworth_analogs(&loop, design, input, output);
+    this->ParallelFor(loop.Prepare(), loop);
+  };
+  
+  /**
+   * Specialized version to filter an acquisition. The points and the analog channels are filtered with the same cutoff frequency 
+   * and their own sampling frequency (the point frequency and the analog frequency). The other parts of the acquisition are copied.
+   */
+  template <>
+  void ButterworthFilter<Acquisition>::GenerateData()
+  {
+    Acquisition::Pointer output = this->GetOutput();
+    output->Reset();
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_butterworth_loop loop;
+    int pointDesign = -1, analogDesign = -1;
+    if ((input->GetPointNumber() != 0) && ((pointDesign = loop.AddDesign(this->m_Order, this->m_CutoffFrequency, input->GetPointFrequency())) == -1))
+      return;
+    if ((input->GetAnalogNumber() != 0) && ((analogDesign = loop.AddDesign(this->m_Order, this->m_CutoffFrequency, input->GetAnalogFrequency())) == -1))
+      return;
+    PointCollection::Pointer points = PointCollection::New();
+    if (pointDesign != -1)
+      _btk_butterworth_points(&loop, pointDesign, input->GetPoints(), points);
+    AnalogCollection::Pointer analogs = AnalogCollection::New();
+    if (analogDesign != -1)
+      _btk_butterworth_analogs(&loop, analogDesign, input->GetAnalogs(), analogs);
+    // The points and the analog channels are filtered in the same loop.
+    this->ParallelFor(loop.Prepare(), loop);
+    output->SetPoints(points);
+    output->SetAnalogs(analogs);
+    output->SetEvents(input->GetEvents()->Clone());
+    output->SetMetaData(input->GetMetaData()->Clone());
+    output->SetFirstFrame(input->GetFirstFrame());
+    output->SetPointFrequency(input->GetPointFrequency());
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->Resize(output->GetPointNumber(), input->GetPointFrameNumber(), output->GetAnalogNumber(), input->GetNumberAnalogSamplePerFrame());
+  };
+};
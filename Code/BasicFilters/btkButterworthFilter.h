@@ -0,0 +1,286 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkButterworthFilter_h
+#define __btkButterworthFilter_h
+
+#include "btkProcessObject.h"
+#include "btkLogger.h"
+#include "btkPointCollection.h"
+#include "btkAnalogCollection.h"
+#include "btkAcquisition.h"
+
+namespace btk
+{
+  template <class T>
+  class ButterworthFilter : public ProcessObject
+  {
+  public:
+    typedef btkSharedPtr<ButterworthFilter> Pointer;
+    typedef btkSharedPtr<const ButterworthFilter> ConstPointer;
+       
+    typedef typename T::Pointer ItemPointer;
+    typedef typename T::ConstPointer ItemConstPointer;    
+    
+    static Pointer New() {return Pointer(new ButterworthFilter());};
+    
+    virtual ~ButterworthFilter() {};
+    
+    ItemPointer GetInput() {return this->GetInput(0);};
+    void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    ItemPointer GetOutput() {return this->GetOutput(0);};
+    
+    int GetOrder() const {return this->m_Order;};
+    void SetOrder(int order);
+    double GetCutoffFrequency() const {return this->m_CutoffFrequency;};
+    void SetCutoffFrequency(double fc);
+    double GetSamplingFrequency() const {return this->m_SamplingFrequency;};
+    void SetSamplingFrequency(double fs);
+    
+  protected:
+    ButterworthFilter();
+    
+    ItemPointer GetInput(int idx) {return static_pointer_cast<T>(this->GetNthInput(idx));};
+    ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    virtual void GenerateInputRequestedRegion();
+    virtual bool HashParameters(Hash* hash) const;
+    
+  private:
+    ButterworthFilter(const ButterworthFilter& ); // Not implemented.
+    ButterworthFilter& operator=(const ButterworthFilter& ); // Not implemented.
+    
+    int m_Order;
+    double m_CutoffFrequency;
+    double m_SamplingFrequency;
+  };
+  
+  template <> BTK_BASICFILTERS_EXPORT void ButterworthFilter<PointCollection>::GenerateData();
+  template <> BTK_BASICFILTERS_EXPORT void ButterworthFilter<AnalogCollection>::GenerateData();
+  template <> BTK_BASICFILTERS_EXPORT void ButterworthFilter<Acquisition>::GenerateData();
+  
+  /**
+   * @class ButterworthFilter btkButterworthFilter.h
+   * @brief Low-pass Butterworth filter without phase delay (forward-backward filter).
+   * @tparam T Must be a class inheriting of btk::DataObject
+   *
+   * The filter is designed as second-order sections with the order and the cutoff frequency given to this process (see btkEigen::butterSOS()). 
+   * Compared to the coefficients of the transfer function, the cascade of sections stays numerically stable for the high orders and the low cutoff frequencies. 
+   * As the data are filtered forward and backward, the order of the final filter is twice the given order 
+   * and its attenuation at the cutoff frequency is -6 dB (same behaviour than the function filtfilt in Matlab or SciPy).
+   * The signals are extended by reflection at their boundaries and the initial states are computed with the method of Gustafsson (1996).
+   *
+   * The channels of the input (each coordinate of the points, each analog channel) are filtered by groups of 4 channels 
+   * having the same length: the recursion of the filter is computed for the 4 channels at once (see btkEigen::sosfiltfiltLanes()). 
+   * The groups are also distributed over the threads set for this process (see SetThreadNumber()).
+   *
+   * For the points, only the valid frames (residual greater or equal to 0) are filtered. Each block of consecutive valid frames is filtered separately. 
+   * The blocks too short to be filtered (3 times the order of the filter or less) are not modified. 
+   * The same rule is applied to the analog channels.
+   *
+   * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
+   *         - btk::PointCollection
+   *         - btk::AnalogCollection
+   *         - btk::Acquisition
+   *
+   * For a collection, the sampling frequency must be set (see SetSamplingFrequency()). For an acquisition, the point and analog frequencies are used. 
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef ButterworthFilter<T>::Pointer
+   * Smart pointer associated with a ButterworthFilter object.
+   */
+  
+  /**
+   * @typedef ButterworthFilter<T>::ConstPointer
+   * Smart pointer associated with a const ButterworthFilter object.
+   */
+  
+  /**
+   * @typedef ButterworthFilter<T>::ItemPointer
+   * Smart pointer associated with a T object.
+   */
+  
+  /**
+   * @typedef ButterworthFilter<T>::ItemConstPointer
+   * Smart const pointer associated with a T object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer ButterworthFilter<T>::New();
+   * Creates a smart pointer associated with a ButterworthFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual ButterworthFilter<T>::~ButterworthFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ButterworthFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void ButterworthFilter<T>::SetInput(ItemPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ButterworthFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> int ButterworthFilter<T>::GetOrder() const
+   * Returns the order of the designed filter (2 by default). 
+   */
+  
+  /**
+   * Sets the order of the designed filter. The order of the final filter is twice this value.
+   */
+  template <class T>
+  void ButterworthFilter<T>::SetOrder(int order)
+  {
+    if (this->m_Order == order)
+      return;
+    this->m_Order = order;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> double ButterworthFilter<T>::GetCutoffFrequency() const
+   * Returns the cutoff frequency (in Hz) of the filter (0 by default). 
+   */
+  
+  /**
+   * Sets the cutoff frequency (in Hz) of the filter. It must be lower than the half of the sampling frequency.
+   */
+  template <class T>
+  void ButterworthFilter<T>::SetCutoffFrequency(double fc)
+  {
+    if (this->m_CutoffFrequency == fc)
+      return;
+    this->m_CutoffFrequency = fc;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> double ButterworthFilter<T>::GetSamplingFrequency() const
+   * Returns the sampling frequency (in Hz) of the data (0 by default). 
+   */
+  
+  /**
+   * Sets the sampling frequency (in Hz) of the data. This value is not used for an acquisition.
+   */
+  template <class T>
+  void ButterworthFilter<T>::SetSamplingFrequency(double fs)
+  {
+    if (this->m_SamplingFrequency == fs)
+      return;
+    this->m_SamplingFrequency = fs;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  ButterworthFilter<T>::ButterworthFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Order = 2;
+    this->m_CutoffFrequency = 0.0;
+    this->m_SamplingFrequency = 0.0;
+  };
+  
+  /**
+   * @fn template <class T> ItemPointer ButterworthFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ButterworthFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a T:Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer ButterworthFilter<T>::MakeOutput(int /* idx */)
+  {
+    return T::New();
+  };
+  
+  /**
+   * Generic method to generate the outputs' data. Does nothing.
+   */
+  template <class T>
+  void ButterworthFilter<T>::GenerateData()
+  {
+    btkErrorMacro("Generic method. Please specialize it.");
+  };
+  
+  /**
+   * Requests all the frames of the input as each filtered frame depends on all the frames of the input.
+   */
+  template <class T>
+  void ButterworthFilter<T>::GenerateInputRequestedRegion()
+  {
+    DataObject::Pointer input = this->GetNthInput(0);
+    if (input)
+      input->ResetRequestedRegion();
+  };
+  
+  /**
+   * Adds the order, the cutoff frequency and the sampling frequency to the digest @a hash.
+   */
+  template <class T>
+  bool ButterworthFilter<T>::HashParameters(Hash* hash) const
+  {
+    hash->Add(this->m_Order);
+    hash->Add(this->m_CutoffFrequency);
+    hash->Add(this->m_SamplingFrequency);
+    return true;
+  };
+};
+
+#endif // __btkButterworthFilter_h
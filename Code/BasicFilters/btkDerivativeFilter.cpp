@@ -0,0 +1,328 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkDerivativeFilter.h"
+
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkEigen/SignalProcessing/SOSFilter.h>
+
+#include <Eigen/QR>
+
+#include <algorithm>
+
+namespace btk
+{
+  // Central differences of the samples @a in (separated by @a stride) written in @a out. The length must be at least 3.
+  static void _btk_derivative_central(const double* in, int stride, int length, double* out, int order, double fs)
+  {
+    const int last = (length - 1) * stride;
+    if (order == 1)
+    {
+      const double s = fs / 2.0;
+      out[0] = (-3.0 * in[0] + 4.0 * in[stride] - in[2*stride]) * s;
+      for (int i = 1 ; i < length - 1 ; ++i)
+        out[i] = (in[(i+1)*stride] - in[(i-1)*stride]) * s;
+      out[length-1] = (3.0 * in[last] - 4.0 * in[last-stride] + in[last-2*stride]) * s;
+    }
+    else
+    {
+      const double s = fs * fs;
+      for (int i = 1 ; i < length - 1 ; ++i)
+        out[i] = (in[(i+1)*stride] - 2.0 * in[i*stride] + in[(i-1)*stride]) * s;
+      out[0] = out[1];
+      out[length-1] = out[length-2];
+    }
+  };
+  
+  // Savitzky-Golay filter: the row r of @a coefficients evaluates the derivative at the position r of the window. The length must be at least the window size.
+  static void _btk_derivative_savgol(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>& coefficients, const double* in, int stride, int length, double* out)
+  {
+    const int w = static_cast<int>(coefficients.cols());
+    const int m = w / 2;
+    for (int i = 0 ; i < length ; ++i)
+    {
+      int r = m, first = i - m; // Centered window
+      if (i < m)
+      {
+        r = i;
+        first = 0;
+      }
+      else if (i >= length - m)
+      {
+        r = w - (length - i);
+        first = length - w;
+      }
+      const double* c = coefficients.data() + r * w;
+      const double* x = in + first * stride;
+      double d = 0.0;
+      for (int k = 0 ; k < w ; ++k)
+        d += c[k] * x[k*stride];
+      out[i] = d;
+    }
+  };
+  
+  // Contiguous samples to derive.
+  struct _btk_derivative_channel
+  {
+    const double* input;
+    int stride;
+    double* output;
+    int length;
+  };
+  
+  static bool _btk_derivative_channel_less(const _btk_derivative_channel& lhs, const _btk_derivative_channel& rhs)
+  {
+    return lhs.length < rhs.length;
+  };
+  
+  // The channels with the same length are processed by groups of 4 (in parallel if several threads are used).
+  struct _btk_derivative_loop
+  {
+    typedef btkEigen::FiltFiltLanesBuffer<double, 4>::Type Buffer;
+    
+    void operator()(int idx) const
+    {
+      const _btk_derivative_channel* group = &(this->channels[this->groups[idx]]);
+      const int num = this->groups[idx+1] - this->groups[idx];
+      if (this->method == DerivativeFilter<PointCollection>::Butterworth)
+      {
+        const int len = group[0].length;
+        // The differences are computed from the buffer of the filter.
+        Buffer W(len + 2 * this->elen, 4);
+        for (int i = 0 ; i < num ; ++i)
+          W.block(this->elen, i, len, 1) = Eigen::Map< const Eigen::Matrix<double, Eigen::Dynamic, 1>, 0, Eigen::InnerStride<> >(group[i].input, len, Eigen::InnerStride<>(group[i].stride));
+        W.block(this->elen, num, len, 4 - num).setZero();
+        btkEigen::sosfiltfiltLanes<double, 4>(this->sos, this->zi, this->elen, &W);
+        for (int i = 0 ; i < num ; ++i)
+          _btk_derivative_central(W.data() + this->elen * 4 + i, 4, len, group[i].output, this->order, this->samplingFrequency);
+      }
+      else if (this->method == DerivativeFilter<PointCollection>::SavitzkyGolay)
+      {
+        for (int i = 0 ; i < num ; ++i)
+          _btk_derivative_savgol(this->coefficients, group[i].input, group[i].stride, group[i].length, group[i].output);
+      }
+      else
+      {
+        for (int i = 0 ; i < num ; ++i)
+          _btk_derivative_central(group[i].input, group[i].stride, group[i].length, group[i].output, this->order, this->samplingFrequency);
+      }
+    };
+    
+    // Checks the parameters and computes the coefficients of the method. Returns false if the parameters are not valid.
+    bool Configure(int method, int order, double fs, int windowSize, int polynomialOrder, double fc, int filterOrder)
+    {
+      if ((order != 1) && (order != 2))
+      {
+        btkErrorMacro("Only the first and the second derivatives can be computed.");
+        return false;
+      }
+      if (fs <= 0.0)
+      {
+        btkErrorMacro("The sampling frequency must be strictly positive.");
+        return false;
+      }
+      this->method = method;
+      this->order = order;
+      this->samplingFrequency = fs;
+      this->minLength = 3;
+      if (method == DerivativeFilter<PointCollection>::SavitzkyGolay)
+      {
+        if ((windowSize < 3) || (windowSize % 2 == 0))
+        {
+          btkErrorMacro("The window size must be odd and greater or equal to 3.");
+          return false;
+        }
+        if ((polynomialOrder < order) || (polynomialOrder >= windowSize))
+        {
+          btkErrorMacro("The polynomial order must be greater or equal to the order of the derivative and lower than the window size.");
+          return false;
+        }
+        // Least squares fit of the polynomial on the window: p = P * x where A * P = I (A: Vandermonde matrix).
+        const int m = windowSize / 2;
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> A(windowSize, polynomialOrder + 1);
+        for (int i = 0 ; i < windowSize ; ++i)
+        {
+          A.coeffRef(i,0) = 1.0;
+          for (int q = 1 ; q <= polynomialOrder ; ++q)
+            A.coeffRef(i,q) = A.coeff(i,q-1) * static_cast<double>(i - m);
+        }
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> P = A.colPivHouseholderQr().solve(Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Identity(windowSize, windowSize));
+        // Derivative of the polynomial at each position of the window.
+        const double scale = (order == 1) ? fs : fs * fs;
+        this->coefficients.setZero(windowSize, windowSize);
+        for (int r = 0 ; r < windowSize ; ++r)
+        {
+          const double t = static_cast<double>(r - m);
+          for (int q = order ; q <= polynomialOrder ; ++q)
+          {
+            double f = (order == 1) ? static_cast<double>(q) : static_cast<double>(q * (q - 1));
+            for (int e = 0 ; e < q - order ; ++e)
+              f *= t;
+            this->coefficients.row(r) += f * scale * P.row(q);
+          }
+        }
+        this->minLength = windowSize;
+      }
+      else if (method == DerivativeFilter<PointCollection>::Butterworth)
+      {
+        if (filterOrder < 1)
+        {
+          btkErrorMacro("The order of the filter must be strictly positive.");
+          return false;
+        }
+        if ((fc <= 0.0) || (fc >= fs / 2.0))
+        {
+          btkErrorMacro("The cutoff frequency must be strictly positive and lower than the half of the sampling frequency.");
+          return false;
+        }
+        if (!btkEigen::butterSOS(&this->sos, filterOrder, 2.0 * fc / fs))
+          return false;
+        btkEigen::sosfiltState(&this->zi, this->sos);
+        this->elen = 3 * filterOrder;
+        this->minLength = std::max(3, this->elen + 1);
+      }
+      return true;
+    };
+    
+    // Returns false if the channel is too short to be derived.
+    bool AddChannel(const double* input, int stride, double* output, int length)
+    {
+      if (length < this->minLength)
+        return false;
+      _btk_derivative_channel channel = {input, stride, output, length};
+      this->channels.push_back(channel);
+      return true;
+    };
+    
+    // Sorts the channels and sets the first channel of each group. Returns the number of groups.
+    int Prepare()
+    {
+      std::sort(this->channels.begin(), this->channels.end(), _btk_derivative_channel_less);
+      this->groups.clear();
+      for (int i = 0 ; i < static_cast<int>(this->channels.size()) ; ++i)
+      {
+        if (this->groups.empty() || (i - this->groups.back() == 4) || (this->channels[i].length != this->channels[i-1].length))
+          this->groups.push_back(i);
+      }
+      const int num = static_cast<int>(this->groups.size());
+      this->groups.push_back(static_cast<int>(this->channels.size()));
+      return num;
+    };
+    
+    int method;
+    int order;
+    double samplingFrequency;
+    int minLength;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> coefficients; // Savitzky-Golay
+    Eigen::Matrix<double, Eigen::Dynamic, 6> sos; // Butterworth
+    Eigen::Matrix<double, Eigen::Dynamic, 2> zi; // Butterworth
+    int elen; // Number of samples used in the reflections (Butterworth)
+    std::vector<_btk_derivative_channel> channels;
+    std::vector<int> groups;
+  };
+  
+  /**
+   * Specialized version to derive a collection of points. The sampling frequency must be set.
+   */
+  template <>
+  void DerivativeFilter<PointCollection>::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_derivative_loop loop;
+    if (!loop.Configure(this->m_Method, this->m_DerivativeOrder, this->m_SamplingFrequency, this->m_WindowSize, this->m_PolynomialOrder, this->m_CutoffFrequency, this->m_FilterOrder))
+      return;
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      const int frameNumber = (*it)->GetFrameNumber();
+      Point::Pointer point = Point::New((*it)->GetLabel(), frameNumber, Point::Scalar, (*it)->GetDescription());
+      point->GetValues().setZero();
+      point->GetResiduals().setConstant(-1.0);
+      output->InsertItem(point);
+      const Point::Residuals& residuals = (*it)->GetResiduals();
+      int i = 0;
+      while (i < frameNumber)
+      {
+        if (residuals.coeff(i) < 0.0)
+        {
+          ++i;
+          continue;
+        }
+        int j = i;
+        while ((j < frameNumber) && (residuals.coeff(j) >= 0.0))
+          ++j;
+        bool valid = true;
+        for (int k = 0 ; k < 3 ; ++k)
+          valid &= loop.AddChannel((*it)->GetValues().data() + k * frameNumber + i, 1, point->GetValues().data() + k * frameNumber + i, j - i);
+        if (valid)
+          point->GetResiduals().segment(i, j - i).setZero();
+        i = j;
+      }
+    }
+    this->ParallelFor(loop.Prepare(), loop);
+  };
+  
+  /**
+   * Specialized version to derive a collection of analog channels. The sampling frequency must be set.
+   */
+  template <>
+  void DerivativeFilter<AnalogCollection>::GenerateData()
+  {
+    AnalogCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    AnalogCollection::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_derivative_loop loop;
+    if (!loop.Configure(this->m_Method, this->m_DerivativeOrder, this->m_SamplingFrequency, this->m_WindowSize, this->m_PolynomialOrder, this->m_CutoffFrequency, this->m_FilterOrder))
+      return;
+    const std::string suffix = (this->m_DerivativeOrder == 1) ? "/s" : "/s^2";
+    for (AnalogCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      Analog::Pointer analog = Analog::New((*it)->GetLabel(), (*it)->GetFrameNumber());
+      analog->SetDescription((*it)->GetDescription());
+      analog->SetUnit((*it)->GetUnit() + suffix);
+      analog->GetValues().setZero();
+      output->InsertItem(analog);
+      // The input values can be strided (analog channels packed in a row major btk::AnalogBlock).
+      const Analog::Values& values = (*it)->GetValues();
+      loop.AddChannel(values.data(), static_cast<int>(values.innerStride()), analog->GetValues().data(), (*it)->GetFrameNumber());
+    }
+    this->ParallelFor(loop.Prepare(), loop);
+  };
+};
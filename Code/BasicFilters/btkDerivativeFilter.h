@@ -0,0 +1,400 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkDerivativeFilter_h
+#define __btkDerivativeFilter_h
+
+#include "btkProcessObject.h"
+#include "btkLogger.h"
+#include "btkPointCollection.h"
+#include "btkAnalogCollection.h"
+
+namespace btk
+{
+  template <class T>
+  class DerivativeFilter : public ProcessObject
+  {
+  public:
+    typedef enum {CentralDifference = 0, SavitzkyGolay, Butterworth} Method;
+    
+    typedef btkSharedPtr<DerivativeFilter> Pointer;
+    typedef btkSharedPtr<const DerivativeFilter> ConstPointer;
+       
+    typedef typename T::Pointer ItemPointer;
+    typedef typename T::ConstPointer ItemConstPointer;    
+    
+    static Pointer New() {return Pointer(new DerivativeFilter());};
+    
+    virtual ~DerivativeFilter() {};
+    
+    ItemPointer GetInput() {return this->GetInput(0);};
+    void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    ItemPointer GetOutput() {return this->GetOutput(0);};
+    
+    Method GetMethod() const {return this->m_Method;};
+    void SetMethod(Method method);
+    int GetDerivativeOrder() const {return this->m_DerivativeOrder;};
+    void SetDerivativeOrder(int order);
+    double GetSamplingFrequency() const {return this->m_SamplingFrequency;};
+    void SetSamplingFrequency(double fs);
+    int GetWindowSize() const {return this->m_WindowSize;};
+    void SetWindowSize(int size);
+    int GetPolynomialOrder() const {return this->m_PolynomialOrder;};
+    void SetPolynomialOrder(int order);
+    double GetCutoffFrequency() const {return this->m_CutoffFrequency;};
+    void SetCutoffFrequency(double fc);
+    int GetFilterOrder() const {return this->m_FilterOrder;};
+    void SetFilterOrder(int order);
+    
+  protected:
+    DerivativeFilter();
+    
+    ItemPointer GetInput(int idx) {return static_pointer_cast<T>(this->GetNthInput(idx));};
+    ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    virtual void GenerateInputRequestedRegion();
+    virtual bool HashParameters(Hash* hash) const;
+    
+  private:
+    DerivativeFilter(const DerivativeFilter& ); // Not implemented.
+    DerivativeFilter& operator=(const DerivativeFilter& ); // Not implemented.
+    
+    Method m_Method;
+    int m_DerivativeOrder;
+    double m_SamplingFrequency;
+    int m_WindowSize;
+    int m_PolynomialOrder;
+    double m_CutoffFrequency;
+    int m_FilterOrder;
+  };
+  
+  template <> BTK_BASICFILTERS_EXPORT void DerivativeFilter<PointCollection>::GenerateData();
+  template <> BTK_BASICFILTERS_EXPORT void DerivativeFilter<AnalogCollection>::GenerateData();
+  
+  /**
+   * @class DerivativeFilter btkDerivativeFilter.h
+   * @brief Computes the first or the second derivative of the points (e.g. velocity and acceleration of the markers) or of the analog channels.
+   * @tparam T Must be a class inheriting of btk::DataObject
+   *
+   * The derivatives are computed with one of the following methods:
+   *  - CentralDifference (default): central differences. At the boundaries, the first derivative uses the one-sided three-point formula 
+   *    and the second derivative is the one of the nearest frame;
+   *  - SavitzkyGolay: least squares fit of a polynomial (see SetPolynomialOrder()) on a moving window (see SetWindowSize()). 
+   *    At the boundaries, the polynomial fitted on the first (last) window is used (same behaviour than the mode 'interp' of the function savgol_filter in SciPy);
+   *  - Butterworth: central differences of the data filtered with a zero-lag Butterworth filter (see btk::ButterworthFilter and SetCutoffFrequency(), SetFilterOrder()). 
+   *    The differences are computed directly in the buffer of the filter, without storing the filtered data.
+   *
+   * The derivatives are scaled with the sampling frequency (see SetSamplingFrequency()) to be expressed per second.
+   *
+   * The output contains one new point (analog channel) for each input point (analog channel) with the same label. 
+   * The points are of type Point::Scalar as their values are not positions anymore. 
+   * The unit of the analog channels is suffixed by "/s" (first derivative) or "/s^2" (second derivative).
+   *
+   * For the points, only the valid frames (residual greater or equal to 0) are used. Each block of consecutive valid frames is derived separately. 
+   * The blocks too short for the chosen method (3 frames for the central differences, the window size for the Savitzky-Golay filter, 
+   * more than 3 times the order of the filter for the Butterworth method) are set as invalid in the output (residual equal to -1 and values set to 0).
+   * The residual of the other frames is set to 0. The values of the analog channels too short are set to 0.
+   *
+   * The coordinates of the points and the analog channels are processed by groups of 4 channels having the same length. 
+   * For the Butterworth method, the filter is designed as second-order sections and its recursion is computed for the 4 channels at once (see btkEigen::sosfiltfiltLanes()). 
+   * The groups are distributed over the threads set for this process (see SetThreadNumber()).
+   *
+   * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
+   *         - btk::PointCollection
+   *         - btk::AnalogCollection
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef DerivativeFilter<T>::Method
+   * Methods available to compute the derivatives.
+   */
+  
+  /**
+   * @var DerivativeFilter<T>::Method DerivativeFilter<T>::CentralDifference
+   * Central differences.
+   */
+  
+  /**
+   * @var DerivativeFilter<T>::Method DerivativeFilter<T>::SavitzkyGolay
+   * Savitzky-Golay filter.
+   */
+  
+  /**
+   * @var DerivativeFilter<T>::Method DerivativeFilter<T>::Butterworth
+   * Central differences of the data filtered by a zero-lag Butterworth filter.
+   */
+  
+  /**
+   * @typedef DerivativeFilter<T>::Pointer
+   * Smart pointer associated with a DerivativeFilter object.
+   */
+  
+  /**
+   * @typedef DerivativeFilter<T>::ConstPointer
+   * Smart pointer associated with a const DerivativeFilter object.
+   */
+  
+  /**
+   * @typedef DerivativeFilter<T>::ItemPointer
+   * Smart pointer associated with a T object.
+   */
+  
+  /**
+   * @typedef DerivativeFilter<T>::ItemConstPointer
+   * Smart const pointer associated with a T object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer DerivativeFilter<T>::New();
+   * Creates a smart pointer associated with a DerivativeFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual DerivativeFilter<T>::~DerivativeFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer DerivativeFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void DerivativeFilter<T>::SetInput(ItemPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer DerivativeFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> Method DerivativeFilter<T>::GetMethod() const
+   * Returns the method used to compute the derivatives (CentralDifference by default). 
+   */
+  
+  /**
+   * Sets the method used to compute the derivatives.
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetMethod(Method method)
+  {
+    if (this->m_Method == method)
+      return;
+    this->m_Method = method;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int DerivativeFilter<T>::GetDerivativeOrder() const
+   * Returns the order of the derivative (1 by default). 
+   */
+  
+  /**
+   * Sets the order of the derivative: 1 for the first derivative (velocity), 2 for the second derivative (acceleration).
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetDerivativeOrder(int order)
+  {
+    if (this->m_DerivativeOrder == order)
+      return;
+    this->m_DerivativeOrder = order;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> double DerivativeFilter<T>::GetSamplingFrequency() const
+   * Returns the sampling frequency (in Hz) of the data (0 by default). 
+   */
+  
+  /**
+   * Sets the sampling frequency (in Hz) of the data. It must be set.
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetSamplingFrequency(double fs)
+  {
+    if (this->m_SamplingFrequency == fs)
+      return;
+    this->m_SamplingFrequency = fs;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int DerivativeFilter<T>::GetWindowSize() const
+   * Returns the number of frames of the window used by the Savitzky-Golay filter (5 by default). 
+   */
+  
+  /**
+   * Sets the number of frames of the window used by the Savitzky-Golay filter. It must be odd and greater than the polynomial order.
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetWindowSize(int size)
+  {
+    if (this->m_WindowSize == size)
+      return;
+    this->m_WindowSize = size;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int DerivativeFilter<T>::GetPolynomialOrder() const
+   * Returns the order of the polynomial fitted by the Savitzky-Golay filter (2 by default). 
+   */
+  
+  /**
+   * Sets the order of the polynomial fitted by the Savitzky-Golay filter. It must be greater or equal to the order of the derivative.
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetPolynomialOrder(int order)
+  {
+    if (this->m_PolynomialOrder == order)
+      return;
+    this->m_PolynomialOrder = order;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> double DerivativeFilter<T>::GetCutoffFrequency() const
+   * Returns the cutoff frequency (in Hz) of the Butterworth filter (0 by default). 
+   */
+  
+  /**
+   * Sets the cutoff frequency (in Hz) of the Butterworth filter. It must be lower than the half of the sampling frequency.
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetCutoffFrequency(double fc)
+  {
+    if (this->m_CutoffFrequency == fc)
+      return;
+    this->m_CutoffFrequency = fc;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int DerivativeFilter<T>::GetFilterOrder() const
+   * Returns the order of the Butterworth filter (2 by default). 
+   */
+  
+  /**
+   * Sets the order of the Butterworth filter. As the data are filtered forward and backward, the order of the final filter is twice this value.
+   */
+  template <class T>
+  void DerivativeFilter<T>::SetFilterOrder(int order)
+  {
+    if (this->m_FilterOrder == order)
+      return;
+    this->m_FilterOrder = order;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  DerivativeFilter<T>::DerivativeFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Method = CentralDifference;
+    this->m_DerivativeOrder = 1;
+    this->m_SamplingFrequency = 0.0;
+    this->m_WindowSize = 5;
+    this->m_PolynomialOrder = 2;
+    this->m_CutoffFrequency = 0.0;
+    this->m_FilterOrder = 2;
+  };
+  
+  /**
+   * @fn template <class T> ItemPointer DerivativeFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer DerivativeFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a T:Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer DerivativeFilter<T>::MakeOutput(int /* idx */)
+  {
+    return T::New();
+  };
+  
+  /**
+   * Generic method to generate the outputs' data. Does nothing.
+   */
+  template <class T>
+  void DerivativeFilter<T>::GenerateData()
+  {
+    btkErrorMacro("Generic method. Please specialize it.");
+  };
+  
+  /**
+   * Requests all the frames of the input as the derivative at the boundaries of the requested region depends on the frames around them.
+   */
+  template <class T>
+  void DerivativeFilter<T>::GenerateInputRequestedRegion()
+  {
+    DataObject::Pointer input = this->GetNthInput(0);
+    if (input)
+      input->ResetRequestedRegion();
+  };
+  
+  /**
+   * Adds all the parameters of the process to the digest @a hash.
+   */
+  template <class T>
+  bool DerivativeFilter<T>::HashParameters(Hash* hash) const
+  {
+    hash->Add(static_cast<int>(this->m_Method));
+    hash->Add(this->m_DerivativeOrder);
+    hash->Add(this->m_SamplingFrequency);
+    hash->Add(this->m_WindowSize);
+    hash->Add(this->m_PolynomialOrder);
+    hash->Add(this->m_CutoffFrequency);
+    hash->Add(this->m_FilterOrder);
+    return true;
+  };
+};
+
+#endif // __btkDerivativeFilter_h
@@ -0,0 +1,336 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkDownsampleFilter.h"
+
+#include <btkEigen/SignalProcessing/Decimate.h>
+
+#include <map>
+#include <cmath>
+
+namespace btk
+{
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _btk_downsample_block;
+  typedef std::map<int, std::vector<int> > _btk_downsample_groups;
+  
+  // Downsamples all the channels (columns) of the block @a X at once.
+  static _btk_downsample_block _btk_downsample_channels(int ratio, bool antiAliasing, const _btk_downsample_block& X)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> h;
+    if (antiAliasing)
+      btkEigen::decimationFilter(&h, ratio);
+    else
+      h.setOnes(1);
+    return btkEigen::decimate(h, ratio, X);
+  };
+  
+  static int _btk_downsample_frame_number(Wrench::Pointer w) {return w->GetPosition()->GetFrameNumber();};
+  static int _btk_downsample_frame_number(Point::Pointer p) {return p->GetFrameNumber();};
+  static int _btk_downsample_frame_number(Analog::Pointer a) {return a->GetFrameNumber();};
+  
+  // Groups the indices of the items having the same number of frames. Each group is downsampled in one block.
+  template <class T>
+  static _btk_downsample_groups _btk_downsample_group(typename Collection<T>::Pointer input)
+  {
+    _btk_downsample_groups groups;
+    int inc = 0;
+    for (typename Collection<T>::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      groups[_btk_downsample_frame_number(*it)].push_back(inc++);
+    return groups;
+  };
+  
+  static bool _btk_downsample_check_ratio(int ratio)
+  {
+    if (ratio < 1)
+    {
+      btkErrorMacro("The up/down ratio must be strictly positive.");
+      return false;
+    }
+    return true;
+  };
+  
+  // The 9 components of each wrench are gathered in the same block.
+  static void _btk_downsample_wrenches(int ratio, bool antiAliasing, const std::vector<Wrench::Pointer>& in, const std::vector<Wrench::Pointer>& out)
+  {
+    const int num = static_cast<int>(in.size());
+    _btk_downsample_block X(_btk_downsample_frame_number(in[0]), 9 * num);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+        X.middleCols(9 * i + 3 * j, 3) = in[i]->GetComponent(j)->GetValues();
+    }
+    _btk_downsample_block Y = _btk_downsample_channels(ratio, antiAliasing, X);
+    const int outFrameNumber = static_cast<int>(Y.rows());
+    for (int i = 0 ; i < num ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+      {
+        Point::Pointer component = out[i]->GetComponent(j);
+        component->SetLabel(in[i]->GetComponent(j)->GetLabel());
+        component->SetFrameNumber(outFrameNumber);
+        component->GetValues() = Y.middleCols(9 * i + 3 * j, 3);
+      }
+    }
+  };
+  
+  // Each point is represented by 4 channels: its coordinates multiplied by its validity and its validity.
+  // The filtered coordinates are then normalized by the filtered validity so the invalid frames are excluded from the filter.
+  static void _btk_downsample_points(int ratio, bool antiAliasing, const std::vector<Point::Pointer>& in, const std::vector<Point::Pointer>& out)
+  {
+    const int num = static_cast<int>(in.size());
+    const int inFrameNumber = _btk_downsample_frame_number(in[0]);
+    _btk_downsample_block X(inFrameNumber, 4 * num);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const Point::Values& values = in[i]->GetValues();
+      const Point::Residuals& residuals = in[i]->GetResiduals();
+      for (int j = 0 ; j < inFrameNumber ; ++j)
+      {
+        const double valid = (residuals.coeff(j) < 0.0) ? 0.0 : 1.0;
+        X.block(j, 4 * i, 1, 3) = valid * values.row(j);
+        X.coeffRef(j, 4 * i + 3) = valid;
+      }
+    }
+    _btk_downsample_block Y = _btk_downsample_channels(ratio, antiAliasing, X);
+    const int outFrameNumber = static_cast<int>(Y.rows());
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const Point::Values& inValues = in[i]->GetValues();
+      const Point::Residuals& inResiduals = in[i]->GetResiduals();
+      Point::Values& values = out[i]->GetValues();
+      Point::Residuals& residuals = out[i]->GetResiduals();
+      for (int j = 0 ; j < outFrameNumber ; ++j)
+      {
+        const double weight = Y.coeff(j, 4 * i + 3);
+        residuals.coeffRef(j) = inResiduals.coeff(j * ratio);
+        if (residuals.coeff(j) < 0.0)
+          values.row(j).setZero();
+        // Not enough valid frames around this one to filter it.
+        else if (weight < 0.5)
+          values.row(j) = inValues.row(j * ratio);
+        else
+          values.row(j) = Y.block(j, 4 * i, 1, 3) / weight;
+      }
+    }
+  };
+  
+  static void _btk_downsample_analogs(int ratio, bool antiAliasing, const std::vector<Analog::Pointer>& in, const std::vector<Analog::Pointer>& out)
+  {
+    const int num = static_cast<int>(in.size());
+    _btk_downsample_block X(_btk_downsample_frame_number(in[0]), num);
+    for (int i = 0 ; i < num ; ++i)
+      X.col(i) = in[i]->GetValues();
+    _btk_downsample_block Y = _btk_downsample_channels(ratio, antiAliasing, X);
+    for (int i = 0 ; i < num ; ++i)
+      out[i]->GetValues() = Y.col(i);
+  };
+  
+  /**
+   * Specialized version to downsample wrench.
+   */
+  template <>
+  void DownsampleData<Wrench>(int ratio, bool antiAliasing, Wrench::Pointer input, Wrench::Pointer output)
+  {
+    if (!_btk_downsample_check_ratio(ratio))
+      return;
+    _btk_downsample_wrenches(ratio, antiAliasing, std::vector<Wrench::Pointer>(1, input), std::vector<Wrench::Pointer>(1, output));
+  };
+  
+  /**
+   * Specialized version to downsample collection of wrenches. 
+   * The wrenches with the same number of frames are downsampled together.
+   */
+  template <>
+  void DownsampleData<WrenchCollection>(int ratio, bool antiAliasing, WrenchCollection::Pointer input, WrenchCollection::Pointer output)
+  {
+    if (!_btk_downsample_check_ratio(ratio))
+      return;
+    output->SetItemNumber(input->GetItemNumber());
+    WrenchCollection::Iterator itIn = input->Begin();
+    WrenchCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (*itOut == Wrench::Null)
+        *itOut = Wrench::New((*itIn)->GetPosition()->GetLabel());
+      ++itIn;
+      ++itOut;
+    }
+    _btk_downsample_groups groups = _btk_downsample_group<Wrench>(input);
+    for (_btk_downsample_groups::const_iterator it = groups.begin() ; it != groups.end() ; ++it)
+    {
+      std::vector<Wrench::Pointer> in, out;
+      for (size_t i = 0 ; i < it->second.size() ; ++i)
+      {
+        in.push_back(input->GetItem(it->second[i]));
+        out.push_back(output->GetItem(it->second[i]));
+      }
+      _btk_downsample_wrenches(ratio, antiAliasing, in, out);
+    }
+  };
+  
+  /**
+   * Specialized version to downsample collection of points. 
+   * The points with the same number of frames are downsampled together. 
+   * The invalid frames of each point are excluded from the anti-aliasing filter. 
+   */
+  template <>
+  void DownsampleData<PointCollection>(int ratio, bool antiAliasing, PointCollection::Pointer input, PointCollection::Pointer output)
+  {
+    output->Clear();
+    if (!_btk_downsample_check_ratio(ratio))
+      return;
+    output->SetItemNumber(input->GetItemNumber());
+    _btk_downsample_groups groups = _btk_downsample_group<Point>(input);
+    for (_btk_downsample_groups::const_iterator it = groups.begin() ; it != groups.end() ; ++it)
+    {
+      std::vector<Point::Pointer> in, out;
+      for (size_t i = 0 ; i < it->second.size() ; ++i)
+      {
+        Point::Pointer source = input->GetItem(it->second[i]);
+        Point::Pointer target = Point::New(source->GetLabel(), it->first / ratio, source->GetType(), source->GetDescription());
+        output->SetItem(it->second[i], target);
+        in.push_back(source);
+        out.push_back(target);
+      }
+      _btk_downsample_points(ratio, antiAliasing, in, out);
+    }
+  };
+  
+  /**
+   * Specialized version to downsample collection of analog channels. 
+   * The analog channels with the same number of frames are downsampled together.
+   */
+  template <>
+  void DownsampleData<AnalogCollection>(int ratio, bool antiAliasing, AnalogCollection::Pointer input, AnalogCollection::Pointer output)
+  {
+    output->Clear();
+    if (!_btk_downsample_check_ratio(ratio))
+      return;
+    output->SetItemNumber(input->GetItemNumber());
+    _btk_downsample_groups groups = _btk_downsample_group<Analog>(input);
+    for (_btk_downsample_groups::const_iterator it = groups.begin() ; it != groups.end() ; ++it)
+    {
+      std::vector<Analog::Pointer> in, out;
+      for (size_t i = 0 ; i < it->second.size() ; ++i)
+      {
+        Analog::Pointer source = input->GetItem(it->second[i]);
+        Analog::Pointer target = Analog::New(source->GetLabel(), it->first / ratio);
+        target->SetDescription(source->GetDescription());
+        target->SetUnit(source->GetUnit());
+        target->SetGain(source->GetGain());
+        target->SetOffset(source->GetOffset());
+        target->SetScale(source->GetScale());
+        output->SetItem(it->second[i], target);
+        in.push_back(source);
+        out.push_back(target);
+      }
+      _btk_downsample_analogs(ratio, antiAliasing, in, out);
+    }
+  };
+  
+  /**
+   * Specialized version to downsample acquisition. 
+   * The ratio is applied to the analog channels (the value 0 corresponds to the number of analog samples per frame). 
+   * The points and the events are downsampled only if the analog frequency becomes lower than the point frequency.
+   */
+  template <>
+  void DownsampleData<Acquisition>(int ratio, bool antiAliasing, Acquisition::Pointer input, Acquisition::Pointer output)
+  {
+    output->Reset();
+    const int analogSampleNumber = input->GetNumberAnalogSamplePerFrame();
+    if (ratio == 0)
+      ratio = analogSampleNumber;
+    if (!_btk_downsample_check_ratio(ratio))
+      return;
+    int pointRatio = 1;
+    int sampleNumber = 1;
+    if (ratio <= analogSampleNumber)
+    {
+      if (analogSampleNumber % ratio != 0)
+      {
+        btkErrorMacro("The up/down ratio must be a divisor or a multiple of the number of analog samples per frame.");
+        return;
+      }
+      sampleNumber = analogSampleNumber / ratio;
+    }
+    else
+    {
+      if (ratio % analogSampleNumber != 0)
+      {
+        btkErrorMacro("The up/down ratio must be a divisor or a multiple of the number of analog samples per frame.");
+        return;
+      }
+      pointRatio = ratio / analogSampleNumber;
+    }
+    
+    // The parts which are not downsampled are copied to not share them with the input.
+    if (pointRatio == 1)
+    {
+      output->SetPoints(input->GetPoints()->Clone());
+      output->SetEvents(input->GetEvents()->Clone());
+    }
+    else
+    {
+      PointCollection::Pointer points = PointCollection::New();
+      DownsampleData<PointCollection>(pointRatio, antiAliasing, input->GetPoints(), points);
+      output->SetPoints(points);
+      // The frame 1 stays the frame 1.
+      EventCollection::Pointer events = EventCollection::New();
+      for (Acquisition::EventConstIterator it = input->BeginEvent() ; it != input->EndEvent() ; ++it)
+      {
+        Event::Pointer event = (*it)->Clone();
+        if (event->GetFrame() != -1)
+          event->SetFrame(static_cast<int>(std::floor(static_cast<double>(event->GetFrame() - 1) / static_cast<double>(pointRatio) + 0.5)) + 1);
+        events->InsertItem(event);
+      }
+      output->SetEvents(events);
+    }
+    if (ratio == 1)
+      output->SetAnalogs(input->GetAnalogs()->Clone());
+    else
+    {
+      AnalogCollection::Pointer analogs = AnalogCollection::New();
+      DownsampleData<AnalogCollection>(ratio, antiAliasing, input->GetAnalogs(), analogs);
+      output->SetAnalogs(analogs);
+    }
+    output->SetFirstFrame((input->GetFirstFrame() - 1) / pointRatio + 1);
+    output->SetPointFrequency(input->GetPointFrequency() / static_cast<double>(pointRatio));
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->SetMetaData(input->GetMetaData()->Clone());
+    output->Resize(output->GetPointNumber(), input->GetPointFrameNumber() / pointRatio, output->GetAnalogNumber(), sampleNumber);
+  };
+};
@@ -40,6 +40,9 @@
 #include "btkCollection.h"
 #include "btkLogger.h"
 #include "btkWrenchCollection.h"
+#include "btkPointCollection.h"
+#include "btkAnalogCollection.h"
+#include "btkAcquisition.h"
 
 namespace btk
 {
@@ -59,10 +62,14 @@ namespace btk
     
     ItemPointer GetInput() {return this->GetInput(0);};
     void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    Acquisition::Pointer GetReferenceAcquisition() {return static_pointer_cast<Acquisition>(this->GetNthInput(1));};
+    void SetReferenceAcquisition(Acquisition::Pointer input) {this->SetNthInput(1, input);};
     ItemPointer GetOutput() {return this->GetOutput(0);};
     
     int GetUpDownRatio() const {return this->m_Ratio;};
     void SetUpDownRatio(int ratio);
+    bool GetAntiAliasing() const {return this->m_AntiAliasing;};
+    void SetAntiAliasing(bool activated);
     
   protected:
     DownsampleFilter();
@@ -71,12 +78,15 @@ namespace btk
     ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
     virtual DataObject::Pointer MakeOutput(int idx);
     virtual void GenerateData();
+    virtual void GenerateInputRequestedRegion();
+    virtual bool HashParameters(Hash* hash) const;
     
   private:
     DownsampleFilter(const DownsampleFilter& ); // Not implemented.
     DownsampleFilter& operator=(const DownsampleFilter& ); // Not implemented.
     
     int m_Ratio;
+    bool m_AntiAliasing;
   };
   
   /**
@@ -88,14 +98,24 @@ namespace btk
    * The given value is an integer corresponding to the ratio used to extract only the value of interest.
    * For example, if you have 200 frames and a ratio of 10, then 20 frames will be extracted (one frame each 10 frames).
    *
+   * The data can be low-pass filtered before to be downsampled to avoid any aliasing (see SetAntiAliasing()). 
+   * This filter is not activated by default. The anti-aliasing filter is a linear phase FIR filter (20*ratio+1 coefficients, cutoff frequency set to the new Nyquist frequency)
+   * centred on the extracted frames (no delay). Only the extracted frames are computed and all the channels of the input are filtered together.
+   * For the points, the invalid frames (residual equal to -1) are excluded from the filter and stay invalid.
+   *
+   * The ratio can be derived from the input during the update of the pipeline: if the ratio is set to 0, then the number of analog samples 
+   * per frame of the acquisition given to the method SetReferenceAcquisition() (or of the input for an acquisition) is used. 
+   * For example, the wrenches computed from the analog channels of an acquisition are then downsampled to the frequency of its points.
+   *
    * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
    *         - btk::Wrench
    *         - btk::WrenchCollection
+   *         - btk::PointCollection
+   *         - btk::AnalogCollection
+   *         - btk::Acquisition
    *
-   *
-   * @note: The design of this class is not perfect as it cannot be used in a pipeline without 
-   * to update the part before to know some information (up/down ratio).
-   * This class (or the pipeline mechanism) could be modified in a future version of BTK to make up this problem.
+   * For an acquisition, the ratio is applied to the analog channels. The points are downsampled only when the analog 
+   * frequency becomes lower than the point frequency. Thus, the ratio must be a divisor or a multiple of the number of analog samples per frame.
    *
    * @ingroup BTKBasicFilters
    */
@@ -140,6 +160,17 @@ namespace btk
    * Sets the input required with this process.
    */
   
+  /**
+   * @fn template <class T> Acquisition::Pointer DownsampleFilter<T>::GetReferenceAcquisition()
+   * Gets the acquisition used to derive the ratio when it is set to 0.
+   */
+  
+  /**
+   * @fn template <class T> void DownsampleFilter<T>::SetReferenceAcquisition(Acquisition::Pointer input)
+   * Sets the acquisition used to derive the ratio when it is set to 0 (optional input). 
+   * Its number of analog samples per frame is then used as ratio.
+   */
+  
   /**
    * @fn template <class T> ItemPointer DownsampleFilter<T>::GetOutput()
    * Gets the output created with this process.
@@ -151,7 +182,8 @@ namespace btk
    */
   
   /**
-   * Sets the ratio used to downsample the data.
+   * Sets the ratio used to downsample the data. 
+   * The value 0 means the ratio is derived from the reference acquisition (see SetReferenceAcquisition()).
    */
   template <class T>
   void DownsampleFilter<T>::SetUpDownRatio(int ratio)
@@ -163,15 +195,34 @@ namespace btk
   };
   
   /**
-   * Constructor. Sets the number of inputs and outputs to 1.
+   * @fn template <class T> bool DownsampleFilter<T>::GetAntiAliasing() const
+   * Returns the activation of the anti-aliasing filter.
+   */
+  
+  /**
+   * Activates or not the anti-aliasing filter. If it is not activated, the frames are simply extracted (one frame each ratio frames).
+   */
+  template <class T>
+  void DownsampleFilter<T>::SetAntiAliasing(bool activated)
+  {
+    if (this->m_AntiAliasing == activated)
+      return;
+    this->m_AntiAliasing = activated; 
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs to 2 (the reference acquisition is optional) and the number of outputs to 1.
+   * The anti-aliasing filter is not activated.
    */
   template <class T>
   DownsampleFilter<T>::DownsampleFilter()
   : ProcessObject()
   {
-    this->SetInputNumber(1);
+    this->SetInputNumber(2);
     this->SetOutputNumber(1);
     this->m_Ratio = 1;
+    this->m_AntiAliasing = false;
   };
   
   /**
@@ -199,75 +250,66 @@ namespace btk
   template <class T>
   void DownsampleFilter<T>::GenerateData()
   {
-    DownsampleData(this->m_Ratio, this->GetInput(), this->GetOutput());
+    int ratio = this->m_Ratio;
+    Acquisition::Pointer reference = this->GetReferenceAcquisition();
+    if ((ratio == 0) && reference)
+      ratio = reference->GetNumberAnalogSamplePerFrame();
+    DownsampleData(ratio, this->m_AntiAliasing, this->GetInput(), this->GetOutput());
     this->GetOutput()->Modified();
   };
+  
+  /**
+   * Requests all the frames of the inputs as the frames of the output do not correspond to the frames of the input.
+   */
+  template <class T>
+  void DownsampleFilter<T>::GenerateInputRequestedRegion()
+  {
+    for (int i = 0 ; i < this->GetInputNumber() ; ++i)
+    {
+      DataObject::Pointer input = this->GetNthInput(i);
+      if (input)
+        input->ResetRequestedRegion();
+    }
+  };
+  
+  /**
+   * Adds the ratio and the activation of the anti-aliasing filter to the digest @a hash.
+   */
+  template <class T>
+  bool DownsampleFilter<T>::HashParameters(Hash* hash) const
+  {
+    hash->Add(this->m_Ratio);
+    hash->Add(this->m_AntiAliasing);
+    return true;
+  };
 
   /**
    * Generic method to downsample data. Does nothing.
    */
   template <class T>
-  inline void DownsampleData(int ratio, btkSharedPtr<T> input, btkSharedPtr<T> output)
+  inline void DownsampleData(int ratio, bool antiAliasing, btkSharedPtr<T> input, btkSharedPtr<T> output)
   {
     btkNotUsed(ratio);
+    btkNotUsed(antiAliasing);
     btkNotUsed(input);
     btkNotUsed(output);
     btkErrorMacro("Generic method. Please specialize it.");
   };
-
-  /**
-   * Specialized version to downsample wrench.
-   */
-  template <>
-  inline void DownsampleData<Wrench>(int ratio, Wrench::Pointer input, Wrench::Pointer output)
-  {
-    int inFrameNumber = input->GetPosition()->GetFrameNumber();
-    int outFrameNumber = inFrameNumber / ratio;
-    output->GetPosition()->SetLabel(input->GetPosition()->GetLabel());
-    output->GetPosition()->SetFrameNumber(outFrameNumber);
-    output->GetForce()->SetLabel(input->GetForce()->GetLabel());
-    output->GetForce()->SetFrameNumber(outFrameNumber);
-    output->GetMoment()->SetLabel(input->GetMoment()->GetLabel());
-    output->GetMoment()->SetFrameNumber(outFrameNumber);
-    double* inPosition = input->GetPosition()->GetValues().data();
-    double* inForce = input->GetForce()->GetValues().data();
-    double* inMoment = input->GetMoment()->GetValues().data();
-    double* outPosition = output->GetPosition()->GetValues().data();
-    double* outForce = output->GetForce()->GetValues().data();
-    double* outMoment = output->GetMoment()->GetValues().data();
-    for (int i = 0 ; i < outFrameNumber ; ++i)
-    {
-      outPosition[i] = inPosition[i * ratio];
-      outPosition[i + outFrameNumber] = inPosition[i * ratio + inFrameNumber];
-      outPosition[i + 2 * outFrameNumber] = inPosition[i * ratio + 2 * inFrameNumber];
-      outForce[i] = inForce[i * ratio];
-      outForce[i + outFrameNumber] = inForce[i * ratio + inFrameNumber];
-      outForce[i + 2 * outFrameNumber] = inForce[i * ratio + 2 * inFrameNumber];
-      outMoment[i] = inMoment[i * ratio];
-      outMoment[i + outFrameNumber] = inMoment[i * ratio + inFrameNumber];
-      outMoment[i + 2 * outFrameNumber] = inMoment[i * ratio + 2 * inFrameNumber];
-    }
-  };
-
+  
   /**
-   * Specialized version to downsample collection of wrenches.
+   * Downsample data without anti-aliasing filter (one frame each @a ratio frames).
    */
-  template <>
-  inline void DownsampleData<WrenchCollection>(int ratio, WrenchCollection::Pointer input, WrenchCollection::Pointer output)
+  template <class T>
+  inline void DownsampleData(int ratio, btkSharedPtr<T> input, btkSharedPtr<T> output)
   {
-    output->SetItemNumber(input->GetItemNumber());
-    WrenchCollection::Iterator itIn = input->Begin();
-    WrenchCollection::Iterator itOut = output->Begin();
-    while (itIn != input->End())
-    {
-      if (*itOut == Wrench::Null)
-        *itOut = Wrench::New((*itIn)->GetPosition()->GetLabel());
-      DownsampleData<Wrench>(ratio, *itIn, *itOut);
-      ++itIn;
-      ++itOut;
-    }
+    DownsampleData<T>(ratio, false, input, output);
   };
 
+  template <> BTK_BASICFILTERS_EXPORT void DownsampleData<Wrench>(int ratio, bool antiAliasing, Wrench::Pointer input, Wrench::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void DownsampleData<WrenchCollection>(int ratio, bool antiAliasing, WrenchCollection::Pointer input, WrenchCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void DownsampleData<PointCollection>(int ratio, bool antiAliasing, PointCollection::Pointer input, PointCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void DownsampleData<AnalogCollection>(int ratio, bool antiAliasing, AnalogCollection::Pointer input, AnalogCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void DownsampleData<Acquisition>(int ratio, bool antiAliasing, Acquisition::Pointer input, Acquisition::Pointer output);
 };
 
 #endif // __btkDownsampleFilter_h
@@ -38,6 +38,28 @@
 
 namespace btk
 {
+  // Number of frames processed at once by the wrench kernel. The components of a block stay in the L1 cache.
+  static const int _btk_force_platform_wrench_block = 128;
+  typedef Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, _btk_force_platform_wrench_block, 1> _btk_force_platform_wrench_component;
+  
+  // Stores the given components (rotated and translated if requested) in the rows [i, i+n[ of the values.
+  static inline void _btk_force_platform_wrench_store(Point::Values& values, int i, const _btk_force_platform_wrench_component& x, const _btk_force_platform_wrench_component& y, const _btk_force_platform_wrench_component& z, const Eigen::Matrix<double, 3, 3>* R, const Eigen::Matrix<double, 3, 1>& t)
+  {
+    const int n = static_cast<int>(x.rows());
+    if (R != 0)
+    {
+      values.col(0).segment(i,n) = ((*R)(0,0) * x + (*R)(0,1) * y + (*R)(0,2) * z + t.x()).matrix();
+      values.col(1).segment(i,n) = ((*R)(1,0) * x + (*R)(1,1) * y + (*R)(1,2) * z + t.y()).matrix();
+      values.col(2).segment(i,n) = ((*R)(2,0) * x + (*R)(2,1) * y + (*R)(2,2) * z + t.z()).matrix();
+    }
+    else
+    {
+      values.col(0).segment(i,n) = x.matrix();
+      values.col(1).segment(i,n) = y.matrix();
+      values.col(2).segment(i,n) = z.matrix();
+    }
+  };
+  
   /**
    * @class ForcePlatformWrenchFilter btkForcePlatformWrenchFilter.h
    * @brief Calcule the wrench of the center of the force platform data, expressed in the global frame (by default).
@@ -47,6 +69,22 @@ namespace btk
    *
    * You can use the method SetTransformToGlobalFrame() to have the wrench expressed in the frame of the force platform.
    *
+   * The wrench of each force platform is computed in a single pass over its channels. The frames are processed by blocks small enough
+   * to stay in the cache: the channels are combined into the components of the wrench, the finishing step specific to the type 
+   * of the force platform (and to the subclass, see btk::GroundReactionWrenchFilter) is applied and the result is transformed
+   * in the global frame before to be stored in the output. 
+   *
+   * The force platforms are independent and their wrenches are computed in parallel when several threads are set with the method SetThreadNumber().
+   *
+   * @note The finishing methods FinishTypeI(), FinishAMTI() and FinishKistler() redefined by a subclass do not modify the computed wrench anymore.
+   * They describe the finishing step in a ForcePlatformWrenchFilter::Finishing object, applied then by the single pass.
+   * This breaks the former signatures <tt>void FinishXXX(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index)</tt>: 
+   * a subclass redefining these former methods does not compile anymore and has to be adapted.
+   *
+   * The force platforms with 6 channels (types 2, 4, 5 and 21) are considered as AMTI force platforms, while the force platforms 
+   * with piezoelectric sensors (types 3, 6, 7 and 11) are considered as Kistler force platforms. The type 12 (Gaitway treadmill) is not supported:
+   * the locations of its two groups of vertical sensors are not known and its wrench is not computed (a warning is reported).
+   *
    * @ingroup BTKBasicFilters
    */
   
@@ -130,6 +168,38 @@ namespace btk
     return WrenchCollection::New();
   };
   
+  /**
+   * Adds the prefix of the wrenches' label and the activation of the transformation in the global frame to the digest @a hash.
+   */
+  bool ForcePlatformWrenchFilter::HashParameters(Hash* hash) const
+  {
+    hash->Add(this->GetWrenchPrefix());
+    hash->Add(this->m_GlobalTransformationActivated);
+    return true;
+  };
+  
+  /**
+   * @struct ForcePlatformWrenchFilter::Finishing
+   * @brief Computations applied to the wrench of a force platform once its components are extracted from the channels.
+   *
+   * By default, the moments of a force platform type I are expressed at the measured COP and nothing is done for the other types.
+   * The moments measured at the COP can be transported to the origin (@a transportedFromCOP). The subclasses can also ask to transport the moments from the origin of the force platform
+   * to the center of its working surface (@a transported and @a origin) and to locate the wrench at the origin of the 
+   * working surface, at the COP or at the PWA (@a location set to one of the values of GroundReactionWrenchFilter::Location).
+   * The threshold is used to suppress the PWA computed with a small vertical force.
+   */
+  
+  // Computation of the wrenches prepared in the method GenerateData(). Each index corresponds to one force platform.
+  struct ForcePlatformWrenchFilter::WrenchLoop
+  {
+    WrenchLoop(const ForcePlatformWrenchFilter* f) : filter(f), wrenches(), platforms(), finishings() {};
+    void operator()(int i) const {this->filter->ComputeWrench(this->wrenches[i], this->platforms[i], this->finishings[i]);};
+    const ForcePlatformWrenchFilter* filter;
+    std::vector<Wrench::Pointer> wrenches;
+    std::vector<ForcePlatform::Pointer> platforms;
+    std::vector<Finishing> finishings;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -139,6 +209,7 @@ namespace btk
     ForcePlatformCollection::Pointer input = this->GetInput();
     if (input != ForcePlatformCollection::Null)
     {
+      WrenchLoop loop(this);
       int inc = 0;
       for (ForcePlatformCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
       {
@@ -166,105 +237,205 @@ namespace btk
         wrh->GetPosition()->GetResiduals().setZero(frameNumber);        
         wrh->GetForce()->GetResiduals().setZero(frameNumber);
         wrh->GetMoment()->GetResiduals().setZero(frameNumber);
-        // Values
+        // Values (computed in parallel after the preparation of every wrench)
+        Finishing finishing;
         switch((*it)->GetType())
         {
-          // 6 channels
           case 1:
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues();
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(1)->GetValues();
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(2)->GetValues();
-            wrh->GetPosition()->GetValues().col(0) = (*it)->GetChannel(3)->GetValues();
-            wrh->GetPosition()->GetValues().col(1) = (*it)->GetChannel(4)->GetValues();
-            wrh->GetPosition()->GetValues().col(2).setZero();
-            wrh->GetMoment()->GetValues().col(0).setZero();
-            wrh->GetMoment()->GetValues().col(1).setZero();
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetChannel(5)->GetValues();
-            this->FinishTypeI(wrh, *it, inc);
+            this->FinishTypeI(&finishing, *it, inc);
             break;
           case 2:
           case 4:
           case 5:
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues();
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(1)->GetValues();
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(2)->GetValues();
-            wrh->GetMoment()->GetValues().col(0) = (*it)->GetChannel(3)->GetValues();
-            wrh->GetMoment()->GetValues().col(1) = (*it)->GetChannel(4)->GetValues();
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetChannel(5)->GetValues();
-            this->FinishAMTI(wrh, *it, inc);
+          case 21:
+            this->FinishAMTI(&finishing, *it, inc);
             break;
           case 3:
-            // Fx
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues() + (*it)->GetChannel(1)->GetValues();
-            // Fy
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(2)->GetValues() + (*it)->GetChannel(3)->GetValues();
-            // Fz
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(4)->GetValues() + (*it)->GetChannel(5)->GetValues() + (*it)->GetChannel(6)->GetValues() + (*it)->GetChannel(7)->GetValues();
-            // Mx
-            wrh->GetMoment()->GetValues().col(0) = (*it)->GetOrigin().y() * ((*it)->GetChannel(4)->GetValues() + (*it)->GetChannel(5)->GetValues() - (*it)->GetChannel(6)->GetValues() - (*it)->GetChannel(7)->GetValues());
-            // My
-            wrh->GetMoment()->GetValues().col(1) = (*it)->GetOrigin().x() * ((*it)->GetChannel(5)->GetValues() + (*it)->GetChannel(6)->GetValues() - (*it)->GetChannel(4)->GetValues() - (*it)->GetChannel(7)->GetValues());
-            // Mz
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetOrigin().y() * ((*it)->GetChannel(1)->GetValues() - (*it)->GetChannel(0)->GetValues()) + (*it)->GetOrigin().x() * ((*it)->GetChannel(2)->GetValues() - (*it)->GetChannel(3)->GetValues());
-            this->FinishKistler(wrh, *it, inc);
-            break;
           case 6:
-            btkErrorMacro("Force Platform type 6 is not yet supported. Please, report this to the developers");
-            break;
           case 7:
-            btkErrorMacro("Force Platform type 7 is not yet supported. Please, report this to the developers");
-            break;
           case 11:
-            btkErrorMacro("Force Platform type 11 is not yet supported. Please, report this to the developers");
+            this->FinishKistler(&finishing, *it, inc);
             break;
           case 12:
-            btkErrorMacro("Force Platform type 12 is not yet supported. Please, report this to the developers");
-            break;
-          case 21:
-            btkErrorMacro("Force Platform type 21 is not yet supported. Please, report this to the developers");
-            break;
+            btkWarningMacro("Force platform type 12 (Gaitway treadmill) is not yet supported. The wrench of the force platform #" + ToString(inc) + " is not computed.");
+            continue;
+          default:
+            continue;
         }
-        if (this->m_GlobalTransformationActivated)
-          this->TransformToGlobal(wrh, (*it)->GetCorners());
+        // The compact values are expanded before the parallel loop.
+        for (int i = 0 ; i < (*it)->GetChannelNumber() ; ++i)
+        {
+          if ((*it)->GetChannel(i))
+            (*it)->GetChannel(i)->GetData()->Expand();
+        }
+        loop.wrenches.push_back(wrh);
+        loop.platforms.push_back(*it);
+        loop.finishings.push_back(finishing);
       }
+      this->ParallelFor(static_cast<int>(loop.wrenches.size()), loop);
       output->SetItemNumber(input->GetItemNumber());
     }
   };
   
+  /**
+   * Computes the wrench @a wrh of the force platform @a fp in a single pass over its channels.
+   * For each block of frames, the channels are combined into the components of the wrench, the @a finishing is applied
+   * and the components are transformed into the global frame (if activated) before to be stored.
+   */
+  void ForcePlatformWrenchFilter::ComputeWrench(Wrench::Pointer wrh, ForcePlatform::Pointer fp, const Finishing& finishing) const
+  {
+    typedef _btk_force_platform_wrench_component Component;
+    const int type = fp->GetType();
+    const int channelNumber = (type == 6) ? 12 : (((type == 3) || (type == 7) || (type == 11)) ? 8 : 6);
+    if (fp->GetChannelNumber() < channelNumber)
+    {
+      btkErrorMacro("Unexpected number of analog channels (" + ToString(fp->GetChannelNumber()) + ") for a force platform type " + ToString(type) + ".");
+      return;
+    }
+    // The access to the values expands the channels stored with a lower precision.
+    const Analog::Values* ch[12];
+    for (int i = 0 ; i < channelNumber ; ++i)
+      ch[i] = &(fp->GetChannel(i)->GetValues());
+    const double ox = fp->GetOrigin().x(), oy = fp->GetOrigin().y();
+    // Transformation to the global frame
+    Eigen::Matrix<double, 3, 3> R;
+    Eigen::Matrix<double, 3, 1> t = Eigen::Matrix<double, 3, 1>::Zero();
+    const Eigen::Matrix<double, 3, 1> zero = Eigen::Matrix<double, 3, 1>::Zero();
+    if (this->m_GlobalTransformationActivated)
+    {
+      const ForcePlatform::Corners& c = fp->GetCorners();
+      R.col(0) = c.col(0) - c.col(1);
+      R.col(0).normalize();
+      R.col(2) = R.col(0).cross(c.col(0) - c.col(3));
+      R.col(2).normalize();
+      R.col(1) = R.col(2).cross(R.col(0));
+      t = (c.col(0) + c.col(2)) / 2;
+    }
+    const Eigen::Matrix<double, 3, 3>* rotation = this->m_GlobalTransformationActivated ? &R : 0;
+    const ForcePlatform::Origin& o = finishing.origin;
+    Point::Values& force = wrh->GetForce()->GetValues();
+    Point::Values& moment = wrh->GetMoment()->GetValues();
+    Point::Values& position = wrh->GetPosition()->GetValues();
+    Point::Residuals& residuals = wrh->GetPosition()->GetResiduals();
+    const int frameNumber = static_cast<int>(force.rows());
+    Component Fx, Fy, Fz, Mx, My, Mz, Px, Py, Pz, sNF;
+    for (int i = 0 ; i < frameNumber ; i += _btk_force_platform_wrench_block)
+    {
+      const int n = std::min(_btk_force_platform_wrench_block, frameNumber - i);
+      Pz.setZero(n);
+      // Components of the wrench in the frame of the force platform
+      if (type == 1)
+      {
+        Fx = ch[0]->segment(i,n); Fy = ch[1]->segment(i,n); Fz = ch[2]->segment(i,n);
+        Px = ch[3]->segment(i,n); Py = ch[4]->segment(i,n);
+        Mz = ch[5]->segment(i,n);
+        if (finishing.transportedFromCOP)
+        {
+          Mx = Py * Fz;
+          My = -Fz * Px;
+          Mz -= Fx * Py - Px * Fy;
+        }
+        else
+        {
+          Mx.setZero(n);
+          My.setZero(n);
+        }
+      }
+      else if ((type == 3) || (type == 7) || (type == 11))
+      {
+        Fx = ch[0]->segment(i,n).array() + ch[1]->segment(i,n).array();
+        Fy = ch[2]->segment(i,n).array() + ch[3]->segment(i,n).array();
+        Fz = ch[4]->segment(i,n).array() + ch[5]->segment(i,n).array() + ch[6]->segment(i,n).array() + ch[7]->segment(i,n).array();
+        Mx = oy * (ch[4]->segment(i,n).array() + ch[5]->segment(i,n).array() - ch[6]->segment(i,n).array() - ch[7]->segment(i,n).array());
+        My = ox * (ch[5]->segment(i,n).array() + ch[6]->segment(i,n).array() - ch[4]->segment(i,n).array() - ch[7]->segment(i,n).array());
+        Mz = oy * (ch[1]->segment(i,n).array() - ch[0]->segment(i,n).array()) + ox * (ch[2]->segment(i,n).array() - ch[3]->segment(i,n).array());
+        Px.setZero(n); Py.setZero(n);
+      }
+      else if (type == 6)
+      {
+        // Sensors located at (a,b), (-a,b), (-a,-b), (a,-b) with a = ox and b = oy.
+        Fx = ch[0]->segment(i,n).array() + ch[1]->segment(i,n).array() + ch[2]->segment(i,n).array() + ch[3]->segment(i,n).array();
+        Fy = ch[4]->segment(i,n).array() + ch[5]->segment(i,n).array() + ch[6]->segment(i,n).array() + ch[7]->segment(i,n).array();
+        Fz = ch[8]->segment(i,n).array() + ch[9]->segment(i,n).array() + ch[10]->segment(i,n).array() + ch[11]->segment(i,n).array();
+        Mx = oy * (ch[8]->segment(i,n).array() + ch[9]->segment(i,n).array() - ch[10]->segment(i,n).array() - ch[11]->segment(i,n).array());
+        My = ox * (ch[9]->segment(i,n).array() + ch[10]->segment(i,n).array() - ch[8]->segment(i,n).array() - ch[11]->segment(i,n).array());
+        Mz = ox * (ch[4]->segment(i,n).array() - ch[5]->segment(i,n).array() - ch[6]->segment(i,n).array() + ch[7]->segment(i,n).array())
+           + oy * (ch[2]->segment(i,n).array() + ch[3]->segment(i,n).array() - ch[0]->segment(i,n).array() - ch[1]->segment(i,n).array());
+        Px.setZero(n); Py.setZero(n);
+      }
+      else
+      {
+        Fx = ch[0]->segment(i,n); Fy = ch[1]->segment(i,n); Fz = ch[2]->segment(i,n);
+        Mx = ch[3]->segment(i,n); My = ch[4]->segment(i,n); Mz = ch[5]->segment(i,n);
+        Px.setZero(n); Py.setZero(n);
+      }
+      // M_s = M_o + F x OS
+      if (finishing.transported)
+      {
+        Mx += Fy * o.z() - o.y() * Fz;
+        My += Fz * o.x() - o.z() * Fx;
+        Mz += Fx * o.y() - o.x() * Fy;
+      }
+      // Location of the wrench (see GroundReactionWrenchFilter::Location)
+      if (finishing.location == 0) // Origin
+      {
+        Px.setZero(); Py.setZero();
+      }
+      else if (finishing.location == 1) // COP
+      {
+        Px = -My / Fz;
+        Py = Mx / Fz;
+        Mx.setZero();
+        My.setZero();
+        Mz += -Px * Fy + Py * Fx;
+      }
+      else if (finishing.location == 2) // PWA
+      {
+        // For explanations of the PWA calculation, see Shimba T. (1984), 
+        // "An estimation of center of gravity from force platform data", 
+        // Journal of Biomechanics 17(1), 53–60.
+        sNF = Fx.square() + Fy.square() + Fz.square();
+        Px = (Fy * Mz - Fz * My) / sNF - (Fx.square() * My - Fx * (Fy * Mx)) / (sNF * Fz);
+        Py = (Fz * Mx - Fx * Mz) / sNF - (Fx * (Fy * My) - Fy.square() * Mx) / (sNF * Fz);
+        // Suppress false PWA
+        for (int j = 0 ; j < n ; ++j)
+        {
+          if ((sNF.coeff(j) == 0.0) || (finishing.thresholdActivated && (fabs(Fz.coeff(j)) <= finishing.thresholdValue)))
+          {
+            Px.coeffRef(j) = 0.0;
+            Py.coeffRef(j) = 0.0;
+            residuals.coeffRef(i+j) = -1.0;
+          }
+        }
+        // M_pwa = M_s + F_s x PWA (Pz = 0)
+        Mx -= Py * Fz;
+        My += Fz * Px;
+        Mz += Fx * Py - Px * Fy;
+      }
+      _btk_force_platform_wrench_store(force, i, Fx, Fy, Fz, rotation, zero);
+      _btk_force_platform_wrench_store(moment, i, Mx, My, Mz, rotation, zero);
+      _btk_force_platform_wrench_store(position, i, Px, Py, Pz, rotation, t);
+    }
+  };
+  
   /**
    * Finish the computation of the wrench for the force platform type I.
    * Because, it is force platform Type I, the position is not set to the origin, but measured to the COP. The moment must be corrected!
    */
-  void ForcePlatformWrenchFilter::FinishTypeI(Wrench::Pointer wrh , ForcePlatform::Pointer /* fp */, int /* index */)
+  void ForcePlatformWrenchFilter::FinishTypeI(Finishing* finishing, ForcePlatform::Pointer /* fp */, int /* index */) const
   {
-    typedef Eigen::Array<double, Eigen::Dynamic, 1> Component;
-    Component Fx = wrh->GetForce()->GetValues().col(0).array();
-    Component Fy = wrh->GetForce()->GetValues().col(1).array();
-    Component Fz = wrh->GetForce()->GetValues().col(2).array();
-    Component Mx = wrh->GetMoment()->GetValues().col(0).array();
-    Component My = wrh->GetMoment()->GetValues().col(1).array();
-    Component Mz = wrh->GetMoment()->GetValues().col(2).array();
-    Component Px = wrh->GetPosition()->GetValues().col(0).array();
-    Component Py = wrh->GetPosition()->GetValues().col(1).array();
-    Component Pz = wrh->GetPosition()->GetValues().col(2).array();
-    Mx -= Fy * Pz - Py * Fz;
-    My -= Fz * Px - Pz * Fx;
-    Mz -= Fx * Py - Px * Fy;
-    wrh->GetMoment()->GetValues().col(0) = Mx;
-    wrh->GetMoment()->GetValues().col(1) = My;
-    wrh->GetMoment()->GetValues().col(2) = Mz;
+    finishing->transportedFromCOP = true;
   };
   
   /**
-   * Finish the computation of the wrench for the AMTI force platform (nothing to do).
+   * Nothing to finish for the AMTI force platform.
    */
-  void ForcePlatformWrenchFilter::FinishAMTI(Wrench::Pointer /* wrh */, ForcePlatform::Pointer /* fp */, int /* index */)
+  void ForcePlatformWrenchFilter::FinishAMTI(Finishing* /* finishing */, ForcePlatform::Pointer /* fp */, int /* index */) const
   {};
    
   /**
-   * Finish the computation of the wrench for the Kistler force platform (nothing to do).
+   * Nothing to finish for the Kistler force platform.
    */
-  void ForcePlatformWrenchFilter::FinishKistler(Wrench::Pointer /* wrh */, ForcePlatform::Pointer /* fp */, int /* index */)
+  void ForcePlatformWrenchFilter::FinishKistler(Finishing* /* finishing */, ForcePlatform::Pointer /* fp */, int /* index */) const
   {};
 };
-
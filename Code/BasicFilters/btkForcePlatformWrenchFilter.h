@@ -75,40 +75,39 @@ namespace btk
     WrenchCollection::Pointer GetOutput(int idx) {return static_pointer_cast<WrenchCollection>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual bool HashParameters(Hash* hash) const;
+    
+    struct Finishing
+    {
+      Finishing() : transportedFromCOP(false), transported(false), origin(ForcePlatform::Origin::Zero()), location(-1), thresholdActivated(false), thresholdValue(0.0) {};
+      bool transportedFromCOP;
+      bool transported;
+      ForcePlatform::Origin origin;
+      int location;
+      bool thresholdActivated;
+      double thresholdValue;
+    };
     
   private:
     virtual std::string GetWrenchPrefix() const {return "FPW";};
-    virtual void FinishTypeI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    virtual void FinishAMTI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    virtual void FinishKistler(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    void TransformToGlobal(Wrench::Pointer wrh, const ForcePlatform::Corners& c) const;
+    virtual void FinishTypeI(Finishing* finishing, ForcePlatform::Pointer fp, int index) const;
+    virtual void FinishAMTI(Finishing* finishing, ForcePlatform::Pointer fp, int index) const;
+    virtual void FinishKistler(Finishing* finishing, ForcePlatform::Pointer fp, int index) const;
+    void ComputeWrench(Wrench::Pointer wrh, ForcePlatform::Pointer fp, const Finishing& finishing) const;
+    struct WrenchLoop;
+    
+    // Former finishing methods, which modified the computed wrench. They are not called anymore.
+    // Their return type is changed so that a subclass still redefining them does not compile (instead of being silently ignored).
+    struct FormerFinishing {};
+    virtual FormerFinishing FinishTypeI(Wrench::Pointer , ForcePlatform::Pointer , int ) {return FormerFinishing();};
+    virtual FormerFinishing FinishAMTI(Wrench::Pointer , ForcePlatform::Pointer , int ) {return FormerFinishing();};
+    virtual FormerFinishing FinishKistler(Wrench::Pointer , ForcePlatform::Pointer , int ) {return FormerFinishing();};
 
     bool m_GlobalTransformationActivated;
 
     ForcePlatformWrenchFilter(const ForcePlatformWrenchFilter& ); // Not implemented.
     ForcePlatformWrenchFilter& operator=(const ForcePlatformWrenchFilter& ); // Not implemented.
   };
-  
-  inline void ForcePlatformWrenchFilter::TransformToGlobal(Wrench::Pointer wrh, const ForcePlatform::Corners& c) const
-  {
-    Eigen::Matrix<double, 3, 3> R;
-    Eigen::Matrix<double, 3, 1> t;
-    R.col(0) = c.col(0) - c.col(1);
-    R.col(0).normalize();
-    R.col(2) = R.col(0).cross(c.col(0) - c.col(3));
-    R.col(2).normalize();
-    R.col(1) = R.col(2).cross(R.col(0));
-    t = (c.col(0) + c.col(2)) / 2;
-    // Forces & Moments rotation
-    wrh->GetForce()->GetValues() *= R.transpose();
-    wrh->GetMoment()->GetValues() *= R.transpose();
-    // Position rotation
-    wrh->GetPosition()->GetValues() *= R.transpose();
-    // Position translation
-    wrh->GetPosition()->GetValues().col(0).array() += t.x();
-    wrh->GetPosition()->GetValues().col(1).array() += t.y();
-    wrh->GetPosition()->GetValues().col(2).array() += t.z();
-  };
 };
 
 #endif // __btkForcePlatformWrenchFilter_h
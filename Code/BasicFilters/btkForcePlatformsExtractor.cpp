@@ -34,9 +34,12 @@
  */
 
 #include "btkForcePlatformsExtractor.h"
+#include "btkAnalogBlock.h"
 #include "btkMetaData.h"
 #include "btkConvert.h"
 
+#include <algorithm>
+
 namespace btk
 {
   /**
@@ -63,14 +66,14 @@ namespace btk
    *  - Type 2: 6 channels (FX, FY, FZ, MX, MY, MZ);
    *  - Type 3: 8 channels (FZ1, FZ2, FZ3, FZ4, FX12, FX34, FY14, FY23);
    *  - Type 4: Same as Type-2 + calibration matrix 6 (columns) by 6 (rows);
-   *  - Type 5: Same as Type-3 + calibration matrix 6 (columns) by 8 (rows).
-   *
-   * However, some other types are not yet supported due to the lack of information and data on them:
+   *  - Type 5: Same as Type-3 + calibration matrix 6 (columns) by 8 (rows);
    *  - Type 6: 12 channels (FX[1,2,3,4], FY[1,2,3,4], FZ[1,2,3,4]) + calibration matrix 12 by 12;
    *  - Type 7: 8 channels (FZ1, FZ2, FZ3, FZ4, FX12, FX34, FY14, FY23) + calibration matrix 8 by 8;
-   *  - Type 11: Kistler Split Belt Treadmill: 8 channels + calibration matrix 8X8 + polynomial correction matrix 2x6 + COP translation + COP rotation;
-   *  - Type 12: Gaitway treadmill: 8 channels (Fz11, Fz12, Fz13, Fz14, Fz21, Fz22, Fz23, and Fz24) + calibration matrix 8X8.
-   *  - Type 21: AMTI-Stairs: 2 force plates with 6 channels + a calibration matrix 6x6 + data to locate the corners of the 4 steps.
+   *  - Type 11: Kistler Split Belt Treadmill: 8 channels + calibration matrix 8X8. The polynomial correction of the COP is not applied;
+   *  - Type 12: Gaitway treadmill: 8 channels (Fz11, Fz12, Fz13, Fz14, Fz21, Fz22, Fz23, and Fz24) + calibration matrix 8X8;
+   *  - Type 21: AMTI-Stairs: each force plate has 6 channels + a calibration matrix 6x6. The corners of the steps are not extracted.
+   *
+   * The calibration matrix is applied to all the frames by blocks, using one matrix product per block.
    *
    * @ingroup BTKBasicFilters
    */
@@ -133,6 +136,14 @@ namespace btk
     return ForcePlatformCollection::New();
   };
   
+  /**
+   * The extraction has no parameter: the outputs depend only on the content of the input.
+   */
+  bool ForcePlatformsExtractor::HashParameters(Hash* /* hash */) const
+  {
+    return true;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -281,44 +292,30 @@ namespace btk
           noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 6:
-          {
-          btkErrorMacro("Force Platform type 6 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType6::Pointer fp6 = ForcePlatformType6::New();
-          //this->ExtractForcePlatformData(fp6, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp6;
-          }
+          (*itFP) = ForcePlatformType6::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 7:
-          {
-          btkErrorMacro("Force Platform type 7 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType7::Pointer fp7 = ForcePlatformType7::New();
-          //this->ExtractForcePlatformData(fp7, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp7;
-          }
+          (*itFP) = ForcePlatformType7::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 11:
-          {
-          btkErrorMacro("Force Platform type 11 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType11::Pointer fp11 = ForcePlatformType11::New();
-          //this->ExtractForcePlatformData(fp11, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp11;
-          }
+          (*itFP) = ForcePlatformType11::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
+          btkWarningMacro("The polynomial correction of the COP for the force platform #" + ToString(i + 1) + " (type 11) is not applied.");
           break;
         case 12:
-          {
-          btkErrorMacro("Force Platform type 12 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType12::Pointer fp12 = ForcePlatformType12::New();
-          //this->ExtractForcePlatformData(fp12, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp12;
-          }
+          (*itFP) = ForcePlatformType12::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         case 21:
-          {
-          btkErrorMacro("Force Platform type 21 is not yet supported. Please, report this to the developers");
-          //ForcePlatformType21::Pointer fp21 = ForcePlatformType21::New();
-          //this->ExtractForcePlatformData(fp21, analogs, (*itForcePlatformGr));
-          //(*itFP) = fp21;
-          }
+          (*itFP) = ForcePlatformType21::New();
+          this->ExtractForcePlatformDataCommon((*itFP), i, calMatrixCoefficentNumberAleadyExtracted, pOrigin, pCorners, pCalMatrix);
+          noError = this->ExtractForcePlatformDataWithCalibrationMatrix((*itFP), analogs, channelNumberAlreadyExtracted, channelsIndex);
           break;
         default:
           btkErrorMacro("Unsupported force platform type. Impossible to extract corresponding data");
@@ -396,6 +393,8 @@ namespace btk
     {
       for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
         fp->SetChannel(i, channels->GetItem(channelsIndex[i + alreadyExtracted] - 1)->Clone());
+      // The channels of the force platform are stored in one block to be processed at once by the filters.
+      AnalogBlock::Pack(fp->GetChannels());
     }
     return noError;
   };
@@ -409,7 +408,9 @@ namespace btk
     if (noError)
     {
       int numberOfFrame = channels->GetItem(0)->GetFrameNumber();
-      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> data = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>(numberOfFrame, numberOfChannelToExtract);
+      AnalogBlock::Pointer block = AnalogBlock::New(numberOfFrame, numberOfChannelToExtract);
+      AnalogBlock::Matrix data = block->GetMatrix();
+      std::vector<const Analog::Values*> values(numberOfChannelToExtract);
       for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
       {
         Analog::Pointer channel = Analog::New();
@@ -417,38 +418,30 @@ namespace btk
         channel->SetLabel(channelToCopy->GetLabel());
         channel->SetDescription(channelToCopy->GetDescription());
         fp->SetChannel(i, channel);
-        data.col(i) = channelToCopy->GetValues();
+        values[i] = &(channelToCopy->GetValues());
       }
-      data *= fp->GetCalMatrix().transpose();
-
+      // The calibration matrix is applied with one matrix product per block of frames. 
+      // The channels of a block are gathered in a small matrix kept in the cache, and the product is directly stored in the output.
+      const ForcePlatform::CalMatrix calT = fp->GetCalMatrix().transpose();
+      const int blockFrameNumber = 256;
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> raw(blockFrameNumber, numberOfChannelToExtract);
+      for (int i = 0 ; i < numberOfFrame ; i += blockFrameNumber)
+      {
+        const int n = std::min(blockFrameNumber, numberOfFrame - i);
+        for (int j = 0 ; j < numberOfChannelToExtract ; ++j)
+          raw.col(j).head(n) = values[j]->segment(i, n);
+        data.middleRows(i, n).noalias() = raw.topRows(n) * calT;
+      }
+      // The calibrated channels are directly the columns of the block.
       for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
-        fp->GetChannel(i)->SetValues(data.col(i));
+      {
+        Analog::Data::Pointer channelData = Analog::Data::New(0);
+        channelData->SetBlock(block, i);
+        fp->GetChannel(i)->SetData(channelData);
+      }
     }
     return noError;
   };
-/*
-  void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType5::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
-  {
-  };
-
-  void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType6::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
-  {
-
-  };
-  */
-/*
-  void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType7::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
-  {};
-
-  void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType11::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
-  {};
-
-  void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType12::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
-  {};
-
-  void ForcePlatformsExtractor::ExtractForcePlatformData(ForcePlatformType21::Pointer fp, AnalogCollection::Pointer channels, MetaData::Pointer fpGr)
-  {};
-  */
   
   bool ForcePlatformsExtractor::CheckAnalogIndicesForForcePlatform(std::vector<int> channelsIndex, int alreadyExtracted, int numberOfChannelToExtract, int numberOfChannels) const
   {
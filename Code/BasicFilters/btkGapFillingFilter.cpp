@@ -0,0 +1,197 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkGapFillingFilter.h"
+
+#include <btkEigen/Interpolation/Interp1.h>
+
+namespace btk
+{
+  // Valid frames used to interpolate a gap (up to 4 on each side). The maximum size is known at the compilation, so the samples are stored on the stack.
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 8, 1> _btk_gapfilling_window;
+  
+  struct _btk_gapfilling_point
+  {
+    const Point::Values* inputValues;
+    const Point::Residuals* inputResiduals;
+    Point::Values* outputValues;
+    Point::Residuals* outputResiduals;
+  };
+  
+  static void _btk_gapfilling_evaluate(btkEigen::Base_interp<_btk_gapfilling_window>* interp, Point::Values* values, int component, int begin, int end)
+  {
+    for (int i = begin ; i < end ; ++i)
+      values->coeffRef(i, component) = interp->interp(static_cast<double>(i));
+  };
+  
+  // Each point is processed separately (in parallel if several threads are used).
+  struct _btk_gapfilling_loop
+  {
+    void operator()(int idx) const
+    {
+      const _btk_gapfilling_point& point = this->points[idx];
+      const Point::Residuals& residuals = *(point.inputResiduals);
+      const int frameNumber = static_cast<int>(residuals.rows());
+      int i = 0;
+      while (i < frameNumber)
+      {
+        if (residuals.coeff(i) >= 0.0)
+        {
+          ++i;
+          continue;
+        }
+        int j = i;
+        while ((j < frameNumber) && (residuals.coeff(j) < 0.0))
+          ++j;
+        if ((i != 0) && (j != frameNumber) && ((this->maxGap < 0) || (j - i <= this->maxGap)))
+          this->Fill(point, i, j);
+        i = j;
+      }
+    };
+    
+    // Interpolates the frames [begin, end[ from the valid frames around them.
+    void Fill(const _btk_gapfilling_point& point, int begin, int end) const
+    {
+      const Point::Residuals& residuals = *(point.inputResiduals);
+      const int frameNumber = static_cast<int>(residuals.rows());
+      const int side = (this->method == GapFillingFilter<PointCollection>::Linear) ? 1 : ((this->method == GapFillingFilter<PointCollection>::PCHIP) ? 2 : 4);
+      int before[4], after[4];
+      int nb = 0, na = 0;
+      for (int i = begin - 1 ; (i >= 0) && (nb < side) ; --i)
+      {
+        if (residuals.coeff(i) >= 0.0)
+          before[nb++] = i;
+      }
+      for (int i = end ; (i < frameNumber) && (na < side) ; ++i)
+      {
+        if (residuals.coeff(i) >= 0.0)
+          after[na++] = i;
+      }
+      const int num = nb + na;
+      _btk_gapfilling_window x(num), y(num);
+      for (int i = 0 ; i < nb ; ++i)
+        x.coeffRef(i) = static_cast<double>(before[nb - 1 - i]);
+      for (int i = 0 ; i < na ; ++i)
+        x.coeffRef(nb + i) = static_cast<double>(after[i]);
+      for (int c = 0 ; c < 3 ; ++c)
+      {
+        for (int i = 0 ; i < num ; ++i)
+          y.coeffRef(i) = point.inputValues->coeff(static_cast<int>(x.coeff(i)), c);
+        if ((num == 2) || (this->method == GapFillingFilter<PointCollection>::Linear))
+        {
+          btkEigen::Linear_interp<_btk_gapfilling_window> interp(&x, &y);
+          _btk_gapfilling_evaluate(&interp, point.outputValues, c, begin, end);
+        }
+        else if (this->method == GapFillingFilter<PointCollection>::PCHIP)
+        {
+          btkEigen::PCHIP_interp<_btk_gapfilling_window> interp(&x, &y);
+          _btk_gapfilling_evaluate(&interp, point.outputValues, c, begin, end);
+        }
+        else
+        {
+          btkEigen::Spline_interp<_btk_gapfilling_window> interp(&x, &y);
+          _btk_gapfilling_evaluate(&interp, point.outputValues, c, begin, end);
+        }
+      }
+      point.outputResiduals->segment(begin, end - begin).setZero();
+    };
+    
+    int method;
+    int maxGap;
+    std::vector<_btk_gapfilling_point> points;
+  };
+  
+  // Copies the points and registers them in the loop.
+  static void _btk_gapfilling_points(_btk_gapfilling_loop* loop, PointCollection::Pointer input, PointCollection::Pointer output)
+  {
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      Point::Pointer point = Point::New((*it)->GetLabel(), (*it)->GetFrameNumber(), (*it)->GetType(), (*it)->GetDescription());
+      point->SetValues((*it)->GetValues());
+      point->SetResiduals((*it)->GetResiduals());
+      output->InsertItem(point);
+      _btk_gapfilling_point p = {&((*it)->GetValues()), &((*it)->GetResiduals()), &(point->GetValues()), &(point->GetResiduals())};
+      loop->points.push_back(p);
+    }
+  };
+  
+  /**
+   * Specialized version to fill the gaps of a collection of points. A negative maximum gap means that all the gaps are filled.
+   */
+  template <>
+  void GapFillingFilter<PointCollection>::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_gapfilling_loop loop;
+    loop.method = this->m_Method;
+    loop.maxGap = this->m_MaxGap;
+    _btk_gapfilling_points(&loop, input, output);
+    this->ParallelFor(static_cast<int>(loop.points.size()), loop);
+  };
+  
+  /**
+   * Specialized version to fill the gaps of the points of an acquisition. 
+   * A negative maximum gap means that the maximum interpolation gap of the acquisition is used. The other parts of the acquisition are copied.
+   */
+  template <>
+  void GapFillingFilter<Acquisition>::GenerateData()
+  {
+    Acquisition::Pointer output = this->GetOutput();
+    output->Reset();
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    _btk_gapfilling_loop loop;
+    loop.method = this->m_Method;
+    loop.maxGap = (this->m_MaxGap < 0) ? input->GetMaxInterpolationGap() : this->m_MaxGap;
+    PointCollection::Pointer points = PointCollection::New();
+    _btk_gapfilling_points(&loop, input->GetPoints(), points);
+    this->ParallelFor(static_cast<int>(loop.points.size()), loop);
+    output->SetPoints(points);
+    output->SetAnalogs(input->GetAnalogs()->Clone());
+    output->SetEvents(input->GetEvents()->Clone());
+    output->SetMetaData(input->GetMetaData()->Clone());
+    output->SetFirstFrame(input->GetFirstFrame());
+    output->SetPointFrequency(input->GetPointFrequency());
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->Resize(output->GetPointNumber(), input->GetPointFrameNumber(), output->GetAnalogNumber(), input->GetNumberAnalogSamplePerFrame());
+  };
+};
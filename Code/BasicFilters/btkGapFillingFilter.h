@@ -0,0 +1,283 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkGapFillingFilter_h
+#define __btkGapFillingFilter_h
+
+#include "btkProcessObject.h"
+#include "btkLogger.h"
+#include "btkPointCollection.h"
+#include "btkAcquisition.h"
+
+namespace btk
+{
+  template <class T>
+  class GapFillingFilter : public ProcessObject
+  {
+  public:
+    typedef enum {Linear = 0, PCHIP, Spline} Method;
+    
+    typedef btkSharedPtr<GapFillingFilter> Pointer;
+    typedef btkSharedPtr<const GapFillingFilter> ConstPointer;
+       
+    typedef typename T::Pointer ItemPointer;
+    typedef typename T::ConstPointer ItemConstPointer;    
+    
+    static Pointer New() {return Pointer(new GapFillingFilter());};
+    
+    virtual ~GapFillingFilter() {};
+    
+    ItemPointer GetInput() {return this->GetInput(0);};
+    void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    ItemPointer GetOutput() {return this->GetOutput(0);};
+    
+    Method GetMethod() const {return this->m_Method;};
+    void SetMethod(Method method);
+    int GetMaxGap() const {return this->m_MaxGap;};
+    void SetMaxGap(int gap);
+    
+  protected:
+    GapFillingFilter();
+    
+    ItemPointer GetInput(int idx) {return static_pointer_cast<T>(this->GetNthInput(idx));};
+    ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    virtual void GenerateInputRequestedRegion();
+    virtual bool HashParameters(Hash* hash) const;
+    
+  private:
+    GapFillingFilter(const GapFillingFilter& ); // Not implemented.
+    GapFillingFilter& operator=(const GapFillingFilter& ); // Not implemented.
+    
+    Method m_Method;
+    int m_MaxGap;
+  };
+  
+  template <> BTK_BASICFILTERS_EXPORT void GapFillingFilter<PointCollection>::GenerateData();
+  template <> BTK_BASICFILTERS_EXPORT void GapFillingFilter<Acquisition>::GenerateData();
+  
+  /**
+   * @class GapFillingFilter btkGapFillingFilter.h
+   * @brief Fills the gaps of the points (frames with a negative residual) by interpolation.
+   * @tparam T Must be a class inheriting of btk::DataObject
+   *
+   * A gap is a block of consecutive invalid frames (residual lower than 0) bounded by valid frames. 
+   * The gaps at the beginning or at the end of a point are not filled (no extrapolation), as well as the gaps longer than the maximum gap (see SetMaxGap()).
+   * The filled frames have their residual set to 0 (value used in the C3D format for the interpolated or filtered frames).
+   *
+   * Each gap is interpolated from a few valid frames around it (skipping the other gaps):
+   *  - Linear: the last valid frame before the gap and the first one after;
+   *  - PCHIP (default): 2 valid frames on each side. As the slopes of a piecewise cubic Hermite interpolating polynomial only depends on the neighbouring samples, 
+   *    the result is the same than the PCHIP interpolation of all the valid frames (see btkEigen::PCHIP_interp);
+   *  - Spline: natural cubic spline going through up to 4 valid frames on each side (see btkEigen::Spline_interp).
+   * When less than 2 valid frames are available on one side, the PCHIP and spline methods are reduced to the available frames (linear interpolation for 2 frames).
+   * The local samples are stored on the stack, so the interpolation of a gap does not allocate memory.
+   *
+   * The points are distributed over the threads set for this process (see SetThreadNumber()). 
+   *
+   * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
+   *         - btk::PointCollection
+   *         - btk::Acquisition
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef GapFillingFilter<T>::Method
+   * Interpolation methods available to fill the gaps.
+   */
+  
+  /**
+   * @var GapFillingFilter<T>::Method GapFillingFilter<T>::Linear
+   * Linear interpolation.
+   */
+  
+  /**
+   * @var GapFillingFilter<T>::Method GapFillingFilter<T>::PCHIP
+   * Piecewise cubic Hermite interpolating polynomial.
+   */
+  
+  /**
+   * @var GapFillingFilter<T>::Method GapFillingFilter<T>::Spline
+   * Natural cubic spline.
+   */
+  
+  /**
+   * @typedef GapFillingFilter<T>::Pointer
+   * Smart pointer associated with a GapFillingFilter object.
+   */
+  
+  /**
+   * @typedef GapFillingFilter<T>::ConstPointer
+   * Smart pointer associated with a const GapFillingFilter object.
+   */
+  
+  /**
+   * @typedef GapFillingFilter<T>::ItemPointer
+   * Smart pointer associated with a T object.
+   */
+  
+  /**
+   * @typedef GapFillingFilter<T>::ItemConstPointer
+   * Smart const pointer associated with a T object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer GapFillingFilter<T>::New();
+   * Creates a smart pointer associated with a GapFillingFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual GapFillingFilter<T>::~GapFillingFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer GapFillingFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void GapFillingFilter<T>::SetInput(ItemPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer GapFillingFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> Method GapFillingFilter<T>::GetMethod() const
+   * Returns the interpolation method (PCHIP by default). 
+   */
+  
+  /**
+   * Sets the interpolation method.
+   */
+  template <class T>
+  void GapFillingFilter<T>::SetMethod(Method method)
+  {
+    if (this->m_Method == method)
+      return;
+    this->m_Method = method;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> int GapFillingFilter<T>::GetMaxGap() const
+   * Returns the maximum number of frames of a gap to fill (-1 by default). 
+   */
+  
+  /**
+   * Sets the maximum number of frames of a gap to fill. 
+   * A negative value means that the maximum interpolation gap of the acquisition is used (see Acquisition::GetMaxInterpolationGap()). 
+   * For a collection of points, a negative value means that all the gaps are filled.
+   */
+  template <class T>
+  void GapFillingFilter<T>::SetMaxGap(int gap)
+  {
+    if (this->m_MaxGap == gap)
+      return;
+    this->m_MaxGap = gap;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  GapFillingFilter<T>::GapFillingFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Method = PCHIP;
+    this->m_MaxGap = -1;
+  };
+  
+  /**
+   * @fn template <class T> ItemPointer GapFillingFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer GapFillingFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a T:Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer GapFillingFilter<T>::MakeOutput(int /* idx */)
+  {
+    return T::New();
+  };
+  
+  /**
+   * Generic method to generate the outputs' data. Does nothing.
+   */
+  template <class T>
+  void GapFillingFilter<T>::GenerateData()
+  {
+    btkErrorMacro("Generic method. Please specialize it.");
+  };
+  
+  /**
+   * Requests all the frames of the input as the frames used to fill a gap can be anywhere in the input.
+   */
+  template <class T>
+  void GapFillingFilter<T>::GenerateInputRequestedRegion()
+  {
+    DataObject::Pointer input = this->GetNthInput(0);
+    if (input)
+      input->ResetRequestedRegion();
+  };
+  
+  /**
+   * Adds the method and the maximum gap to the digest @a hash.
+   */
+  template <class T>
+  bool GapFillingFilter<T>::HashParameters(Hash* hash) const
+  {
+    hash->Add(static_cast<int>(this->m_Method));
+    hash->Add(this->m_MaxGap);
+    return true;
+  };
+};
+
+#endif // __btkGapFillingFilter_h
@@ -123,6 +123,16 @@ namespace btk
     this->Modified();
   };
 
+  /**
+   * @fn Location GroundReactionWrenchFilter::getLocation() const
+   * Returns the location of the computed wrenches (origin of the working surface, COP or PWA).
+   */
+  
+  /**
+   * @fn void GroundReactionWrenchFilter::setLocation(Location loc)
+   * Sets the location of the computed wrenches (origin of the working surface by default).
+   */
+
   /**
    * Constructor. Sets the number of inputs and outputs to 1.
    */
@@ -133,13 +143,25 @@ namespace btk
     this->SetOutputNumber(1);
     this->m_ThresholdActivated = false;
     this->m_ThresholdValue = 0.0;
-    setLocation(Origin);
+    this->m_location = Origin;
+  };
+  
+  /**
+   * Adds the parameters of the base class, the threshold (state and value) and the location of the wrenches to the digest @a hash.
+   */
+  bool GroundReactionWrenchFilter::HashParameters(Hash* hash) const
+  {
+    this->ForcePlatformWrenchFilter::HashParameters(hash);
+    hash->Add(this->m_ThresholdActivated);
+    hash->Add(this->m_ThresholdValue);
+    hash->Add(static_cast<int>(this->m_location));
+    return true;
   };
   
   /**
    * Finish the computation of the ground reaction wrench for the force platform type I (nothing to do).
    */
-  void GroundReactionWrenchFilter::FinishTypeI(Wrench::Pointer /* wrh */, ForcePlatform::Pointer /* fp */, int /* index */)
+  void GroundReactionWrenchFilter::FinishTypeI(Finishing* /* finishing */, ForcePlatform::Pointer /* fp */, int /* index */) const
   {
     /*
     ForcePlatform::Origin origin;
@@ -150,13 +172,13 @@ namespace btk
       origin.z() *= -1;
     }
     */
-    //this->FinishGRWComputation(grw, origin);
+    //this->FinishGRWComputation(finishing, origin);
   };
   
   /**
-   * Finish the computation of the ground reaction wrench for the AMTI force platforms.
+   * Finish the computation of the ground reaction wrench for the AMTI force platforms: the moments are transported to the center of the working surface and the wrench is located as requested.
    */
-  void GroundReactionWrenchFilter::FinishAMTI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index)
+  void GroundReactionWrenchFilter::FinishAMTI(Finishing* finishing, ForcePlatform::Pointer fp, int index) const
   {
     ForcePlatform::Origin origin = fp->GetOrigin();
     if (origin.z() > 0)
@@ -164,14 +186,14 @@ namespace btk
       btkWarningMacro("Origin for the force platform #" + ToString(index) + " seems to be located from the center of the working surface instead of the inverse. Data are inverted to locate the center of the working surface from the platform's origin.");
       origin *= -1;
     }
-    this->FinishGRWComputation(wrh, origin);
+    this->FinishGRWComputation(finishing, origin);
 
   };
    
   /**
-   * Finish the computation of the ground reaction wrench for the Kislter force platform.
+   * Finish the computation of the ground reaction wrench for the Kislter force platform: the moments are transported to the center of the working surface and the wrench is located as requested.
    */
-  void GroundReactionWrenchFilter::FinishKistler(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index)
+  void GroundReactionWrenchFilter::FinishKistler(Finishing* finishing, ForcePlatform::Pointer fp, int index) const
   {
     ForcePlatform::Origin origin;
     origin << 0, 0, fp->GetOrigin().z();
@@ -180,7 +202,7 @@ namespace btk
       btkWarningMacro("Vertical offset between the origin of the force platform #" + ToString(index) + " and the center of the working surface seems to be misconfigured (positive value). The opposite of this offset is used.");
       origin.z() *= -1;
     }
-    this->FinishGRWComputation(wrh, origin);
+    this->FinishGRWComputation(finishing, origin);
   };
 };
 
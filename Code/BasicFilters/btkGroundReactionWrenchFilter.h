@@ -65,16 +65,18 @@ namespace btk
     double GetThresholdValue() const {return this->m_ThresholdValue;};
     BTK_BASICFILTERS_EXPORT void SetThresholdValue(double v);
 
-    void setLocation(Location loc) { m_location = loc; }
+    Location getLocation() const {return this->m_location;};
+    void setLocation(Location loc) {if (this->m_location == loc) return; this->m_location = loc; this->Modified();};
   protected:
     BTK_BASICFILTERS_EXPORT GroundReactionWrenchFilter();
+    BTK_BASICFILTERS_EXPORT virtual bool HashParameters(Hash* hash) const;
     
   private:
     virtual std::string GetWrenchPrefix() const {return "GRW";};
-    virtual void FinishTypeI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    virtual void FinishAMTI(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    virtual void FinishKistler(Wrench::Pointer wrh, ForcePlatform::Pointer fp, int index);
-    void FinishGRWComputation(Wrench::Pointer grw, const ForcePlatform::Origin& o) const;
+    virtual void FinishTypeI(Finishing* finishing, ForcePlatform::Pointer fp, int index) const;
+    virtual void FinishAMTI(Finishing* finishing, ForcePlatform::Pointer fp, int index) const;
+    virtual void FinishKistler(Finishing* finishing, ForcePlatform::Pointer fp, int index) const;
+    void FinishGRWComputation(Finishing* finishing, const ForcePlatform::Origin& o) const;
     
     GroundReactionWrenchFilter(const GroundReactionWrenchFilter& ); // Not implemented.
     GroundReactionWrenchFilter& operator=(const GroundReactionWrenchFilter& ); // Not implemented.
@@ -84,73 +86,13 @@ namespace btk
     Location m_location;
   };
 
-  inline void GroundReactionWrenchFilter::FinishGRWComputation(Wrench::Pointer grw, const ForcePlatform::Origin& o) const
+  inline void GroundReactionWrenchFilter::FinishGRWComputation(Finishing* finishing, const ForcePlatform::Origin& o) const
   { 
-    typedef Eigen::Array<double, Eigen::Dynamic, 1> Component;
-    Component Fx = grw->GetForce()->GetValues().col(0).array();
-    Component Fy = grw->GetForce()->GetValues().col(1).array();
-    Component Fz = grw->GetForce()->GetValues().col(2).array();
-    Component Mx = grw->GetMoment()->GetValues().col(0).array();
-    Component My = grw->GetMoment()->GetValues().col(1).array();
-    Component Mz = grw->GetMoment()->GetValues().col(2).array();
-    Component Px = grw->GetPosition()->GetValues().col(0).array();
-    Component Py = grw->GetPosition()->GetValues().col(1).array();
-    Component Pz = grw->GetPosition()->GetValues().col(2).array();
-
-    // Square norm of the forces.
-    Component sNF =  grw->GetForce()->GetValues().rowwise().squaredNorm();
-    // M_s = M_o + F x OS
-    Mx += Fy * o.z() - o.y() * Fz;
-    My += Fz * o.x() - o.z() * Fx;
-    Mz += Fx * o.y() - o.x() * Fy;
-
-    Pz.setZero();
-    // Origin of the force plate ix 0, 0,0
-    if (m_location == Origin) {
-        Px.setZero();
-        Py.setZero();
-    }
-    else if (m_location == COP) {
-        Px = -My / Fz;
-        Py = Mx / Fz;
-        Mx.setZero();
-        My.setZero();
-        Mz += -Px*Fy + Py*Fx;
-    }
-    // PWA
-    // For explanations of the PWA calculation, see Shimba T. (1984), 
-    // "An estimation of center of gravity from force platform data", 
-    // Journal of Biomechanics 17(1), 53–60.
-    else if (m_location == PWA) {
-        Px = (Fy * Mz - Fz * My) / sNF - (Fx.square() * My - Fx * (Fy * Mx)) / (sNF * Fz);
-        Py = (Fz * Mx - Fx * Mz) / sNF - (Fx * (Fy * My) - Fy.square() * Mx) / (sNF * Fz);
-
-        // Suppress false PWA
-        for (int i = 0; i < Fz.rows(); ++i)
-        {
-            if ((sNF.coeff(i) == 0.0) || (this->m_ThresholdActivated && (fabs(Fz.coeff(i)) <= this->m_ThresholdValue)))
-            {
-                Px.coeffRef(i) = 0.0;
-                Py.coeffRef(i) = 0.0;
-                // Pz.coeffRef(i) = 0.0; // Already set to 0
-                grw->GetPosition()->GetResiduals().coeffRef(i) = -1.0;
-            }
-        }
-        // M_pwa = M_s + F_s x PWA
-        Mx += Fy * Pz - Py * Fz;
-        My += Fz * Px - Pz * Fx;
-        Mz += Fx * Py - Px * Fy;
-    }
-
-    grw->GetForce()->GetValues().col(0) = Fx;
-    grw->GetForce()->GetValues().col(1) = Fy;
-    grw->GetForce()->GetValues().col(2) = Fz;
-    grw->GetMoment()->GetValues().col(0) = Mx;
-    grw->GetMoment()->GetValues().col(1) = My;
-    grw->GetMoment()->GetValues().col(2) = Mz;
-    grw->GetPosition()->GetValues().col(0) = Px;
-    grw->GetPosition()->GetValues().col(1) = Py;
-    grw->GetPosition()->GetValues().col(2) = Pz;
+    finishing->transported = true;
+    finishing->origin = o;
+    finishing->location = this->m_location;
+    finishing->thresholdActivated = this->m_ThresholdActivated;
+    finishing->thresholdValue = this->m_ThresholdValue;
   };
 };
 
@@ -60,6 +60,8 @@ namespace btk
   *
   * Note: In case your inertial sensor contain only a subset of the proposed type (for example 1D accelerometer + 2D gyroscope), you don't need to add 3 channels with 0 values. Only the metadata IMU:CHANNEL and IMU:CAL_MATRIX must be adapted in consequence. For example the value of IMU:CHANNEL could be [0 0 1 2 3 0]  (Z accelerometer on channel #1, X and Y gyroscope on #2 and #3 respectively). The metadata IMU:CAL_MATRIX will be then a matrix with 3x3 value (e.g. [1 0 0 0 1 0 0 0 1]).
   *
+  * The calibration matrices of the IMUs are applied in parallel when several threads are set (see ProcessObject::SetThreadNumber()).
+  *
   * @note This class is still experimental and could be modified in the next release.
   *
   * @ingroup BTKBasicFilters
@@ -128,6 +130,27 @@ namespace btk
     return IMUCollection::New();
   };
   
+  // Calibration of the channels of the IMUs. Each index corresponds to one IMU.
+  struct IMUsExtractor::CalibrationLoop
+  {
+    void operator()(int idx) const
+    {
+      const std::vector<Analog::Pointer>& sources = this->sources[idx];
+      const std::vector<Analog::Pointer>& targets = this->targets[idx];
+      const int numberOfFrames = this->frameNumbers[idx];
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> data(numberOfFrames, static_cast<int>(sources.size()));
+      for (size_t i = 0 ; i < sources.size() ; ++i)
+        data.col(i) = sources[i]->GetValues();
+      data *= this->units[idx]->GetCalMatrix().transpose();
+      for (size_t i = 0 ; i < targets.size() ; ++i)
+        targets[i]->SetValues(data.col(i));
+    };
+    std::vector<IMU::Pointer> units;
+    std::vector< std::vector<Analog::Pointer> > sources;
+    std::vector< std::vector<Analog::Pointer> > targets;
+    std::vector<int> frameNumbers;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -135,6 +158,7 @@ namespace btk
   {
     IMUCollection::Pointer output = this->GetOutput();
     output->Clear();
+    CalibrationLoop loop;
     size_t numTotalUnits = 0;
     for (int i = 0 ; i < this->GetInputNumber() ; ++i)
     {
@@ -169,19 +193,19 @@ namespace btk
           if (itChannels == (*itIMU)->End())
           {
             btkErrorMacro("No IMU::CHANNEL entry. Impossible to extract analog channels associated with the unit(s). IMUs' data are empty.");
-            return;
+            break;
           }
           else if (!(*itChannels)->HasInfo() || (*itChannels)->GetInfo()->GetDimensions().size() != 2)
           {
             btkErrorMacro("Wrong format for the IMU::CHANNEL entry. Impossible to extract analog channels associated with the unit(s). IMUs' data are empty.");
-            return;
+            break;
           }
           
           MetaData::Iterator itCalMatrix = (*itIMU)->FindChild("CAL_MATRIX");
           if ((itCalMatrix != (*itIMU)->End()) && (!(*itChannels)->HasInfo() || (*itChannels)->GetInfo()->GetDimensions().size() != 2))
           {
             btkErrorMacro("Wrong format for the IMU::CAL_MATRIX entry. Impossible to extract analog channels associated with the unit(s). IMUs' data are empty.");
-            return;
+            break;
           }
 
           MetaDataInfo::Pointer info;
@@ -233,7 +257,8 @@ namespace btk
               break;
             case 2:
               imu = IMUType2::New(labels[i], descs[i], false);
-              this->ExtractDataWithCalibrationMatrix(imu.get(), input->GetAnalogs(), &(calibration[channelNumberAlreadyExtracted*channelNumberAlreadyExtracted]), channelsIndex, 6+extra[i], channelStep, channelNumberAlreadyExtracted);
+              this->ExtractDataWithCalibrationMatrix(imu.get(), input->GetAnalogs(), &(calibration[channelNumberAlreadyExtracted*channelStep]), channelsIndex, 6+extra[i], channelStep, channelNumberAlreadyExtracted, &loop);
+              loop.units.push_back(imu);
               break;
             // TODO: Implement IMMU
             default:
@@ -250,6 +275,7 @@ namespace btk
         }
       }
     }
+    this->ParallelFor(static_cast<int>(loop.units.size()), loop);
   };
   
   void IMUsExtractor::ExtractData(IMU* imu, AnalogCollection::Pointer channels, std::vector<int> channelsIndex, int numberOfChannelsToExtract, int alreadyExtracted)
@@ -263,12 +289,10 @@ namespace btk
     }
   };
   
-  void IMUsExtractor::ExtractDataWithCalibrationMatrix(IMU* imu, AnalogCollection::Pointer channels, double* pCalib, std::vector<int> channelsIndex, int numberOfChannelsToExtract, int channelStep, int alreadyExtracted)
+  void IMUsExtractor::ExtractDataWithCalibrationMatrix(IMU* imu, AnalogCollection::Pointer channels, double* pCalib, std::vector<int> channelsIndex, int numberOfChannelsToExtract, int channelStep, int alreadyExtracted, CalibrationLoop* loop)
   {
     int numberOfChannels = channels->GetItemNumber();
-    int numChannelsExtracted = 0;
-    int numberOfFrames = channels->GetItem(0)->GetFrameNumber();
-    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> data = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>(numberOfFrames, numberOfChannelsToExtract);
+    std::vector<Analog::Pointer> sources, targets;
     for (int i = 0 ; i < numberOfChannelsToExtract ; ++i)
     {
       int index = channelsIndex[i + alreadyExtracted];
@@ -280,22 +304,16 @@ namespace btk
         channel->SetDescription(channelToCopy->GetDescription());
         channel->SetUnit(channelToCopy->GetUnit());
         imu->SetChannel(i, channel);
-        data.col(numChannelsExtracted) = channelToCopy->GetValues();
-        ++numChannelsExtracted;
+        channelToCopy->GetData()->Expand(); // The compact values are expanded before the parallel loop.
+        sources.push_back(channelToCopy);
+        targets.push_back(channel);
       }
     }
-    data.conservativeResize(numberOfFrames,numChannelsExtracted);
+    const int numChannelsExtracted = static_cast<int>(sources.size());
     imu->SetCalMatrix(Eigen::Map< Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> >(pCalib, channelStep, channelStep).block(0,0,numChannelsExtracted,numChannelsExtracted));
-    data *= imu->GetCalMatrix().transpose();
-    numChannelsExtracted = 0;
-    for (int i = 0 ; i < numberOfChannelsToExtract ; ++i)
-    {
-      Analog::Pointer channel = imu->GetChannel(i);
-      if (channel != Analog::Null)
-      {
-        channel->SetValues(data.col(numChannelsExtracted));
-        ++numChannelsExtracted;
-      }
-    }
+    // The calibrated values are computed later by the loop (one IMU per index).
+    loop->sources.push_back(sources);
+    loop->targets.push_back(targets);
+    loop->frameNumbers.push_back(channels->GetItem(0)->GetFrameNumber());
   };
 };
@@ -67,7 +67,8 @@ namespace btk
     
   private:
     void ExtractData(IMU* imu, AnalogCollection::Pointer channels, std::vector<int> channelsIndex, int numberOfChannelsToExtract, int alreadyExtracted);
-    void ExtractDataWithCalibrationMatrix(IMU* imu, AnalogCollection::Pointer channels, double* pCalib, std::vector<int> channelsIndex, int numberOfChannelsToExtract, int channelStep, int alreadyExtracted);
+    struct CalibrationLoop;
+    void ExtractDataWithCalibrationMatrix(IMU* imu, AnalogCollection::Pointer channels, double* pCalib, std::vector<int> channelsIndex, int numberOfChannelsToExtract, int channelStep, int alreadyExtracted, CalibrationLoop* loop);
   
     IMUsExtractor(const IMUsExtractor& ); // Not implemented.
     IMUsExtractor& operator=(const IMUsExtractor& ); // Not implemented.
@@ -75,6 +75,7 @@ namespace btk
     ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
     virtual DataObject::Pointer MakeOutput(int idx);
     virtual void GenerateData();
+    virtual void GenerateInputRequestedRegion();
     
   private:
     MeasureFrameExtractor(const MeasureFrameExtractor& ); // Not implemented.
@@ -194,6 +195,16 @@ namespace btk
     return T::New();
   };
   
+  /**
+   * Requests all the frames of the input as the index of the frame to extract is relative to the first frame of the input.
+   */
+  template <class T>
+  void MeasureFrameExtractor<T>::GenerateInputRequestedRegion()
+  {
+    if (this->GetInput())
+      this->GetInput()->ResetRequestedRegion();
+  };
+  
   /**
    * Generates the outputs' data.
    */
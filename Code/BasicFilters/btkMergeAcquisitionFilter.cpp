@@ -35,6 +35,7 @@
 
 #include "btkMergeAcquisitionFilter.h"
 #include "btkMetaDataUtils.h"
+#include "btkResampleFilter.h"
 
 #include "btkConvert.h"
 
@@ -53,7 +54,7 @@ namespace btk
    * of frames corresponds to the sum of the input's frame number. 
    *
    * Rules to merge/concatenate acquisitions are:
-   *  - Must have the same acquisition frequency (or 0).
+   *  - Must have the same acquisition frequency (or 0), except if the resampling is enabled (see SetResampling()).
    *  - Must have the same number of analog samples per point frame (if there are points and analog channels).
    *  - Must have the same analog resolution.
    *  - Must have the same units (Use btk::AcquisitionUnitConvert to convert them).
@@ -74,6 +75,9 @@ namespace btk
    *
    * Moreover, you can set a rule to keep only the data from the higher or the lower first frame. Use the method SetFirstFrameRule() with the values KeepAllFrames or KeepFromHighestFirstFrame.
    *
+   * Finally, the inputs acquired with different sample rates can be aligned on the first merged input. Use the method SetResampling() to resample them 
+   * (point frequency and number of analog samples per frame) before the merging/concatenation (see btk::ResampleAcquisition()).
+   *
    * @ingroup BTKBasicFilters
    */
   /**
@@ -123,6 +127,23 @@ namespace btk
     this->m_FirstFrameRule = rule;
     this->Modified();
   };
+  
+  /**
+   * @fn bool MergeAcquisitionFilter::GetResampling() const
+   * Returns the status of the resampling of the inputs (disabled by default).
+   */
+  
+  /**
+   * Enables/disables the resampling of the inputs. When enabled, the inputs with a point frequency or a number of analog samples per frame 
+   * different than the first merged input are resampled instead of being rejected.
+   */ 
+  void MergeAcquisitionFilter::SetResampling(bool enabled)
+  {
+    if (this->m_Resampling == enabled)
+      return;
+    this->m_Resampling = enabled;
+    this->Modified();
+  };
 
   /**
    * @fn Acquisition::Pointer MergeAcquisitionFilter::GetInput(int idx)
@@ -148,6 +169,7 @@ namespace btk
     this->SetInputNumber(2);
     this->SetOutputNumber(1);
     this->m_FirstFrameRule = KeepAllFrames;
+    this->m_Resampling = false;
   };
   
   /**
@@ -163,6 +185,18 @@ namespace btk
     return Acquisition::New();
   };
   
+  /**
+   * Requests all the frames of the inputs as their frames can be numbered with different frequencies.
+   */
+  void MergeAcquisitionFilter::GenerateInputRequestedRegion()
+  {
+    for (int i = 0 ; i < this->GetInputNumber() ; ++i)
+    {
+      if (this->GetNthInput(i))
+        this->GetNthInput(i)->ResetRequestedRegion();
+    }
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -182,6 +216,19 @@ namespace btk
         btkWarningMacro("Input #" + ToString(idx) + " is not merged: Impossible to merge a null input.");
         continue;
       }
+      // Resample the input to the sample rates of the output
+      if (this->m_Resampling && !firstInput && (in->GetPointFrequency() != 0) && (output->GetPointFrequency() != 0)
+          && ((in->GetPointFrequency() != output->GetPointFrequency()) || (!in->IsEmptyAnalog() && !output->IsEmptyAnalog() && (in->GetNumberAnalogSamplePerFrame() != output->GetNumberAnalogSamplePerFrame()))))
+      {
+        Acquisition::Pointer resampled = Acquisition::New();
+        const int sampleNumber = output->IsEmptyAnalog() ? in->GetNumberAnalogSamplePerFrame() : output->GetNumberAnalogSamplePerFrame();
+        if (!ResampleAcquisition(in, resampled, output->GetPointFrequency(), sampleNumber))
+        {
+          btkWarningMacro("Input #" + ToString(idx) + " is not merged: Impossible to resample it.");
+          continue;
+        }
+        in = resampled;
+      }
       // Check the point's frequency
       if ((in->GetPointFrequency() != 0) && (output->GetPointFrequency() != 0) && !in->IsEmptyPoint() && !output->IsEmptyPoint() && (in->GetPointFrequency() != output->GetPointFrequency()))
       {
@@ -57,6 +57,8 @@ namespace btk
     
     int GetFirstFrameRule() const {return this->m_FirstFrameRule;};
     BTK_BASICFILTERS_EXPORT void SetFirstFrameRule(int rule);
+    bool GetResampling() const {return this->m_Resampling;};
+    BTK_BASICFILTERS_EXPORT void SetResampling(bool enabled);
     
     Acquisition::Pointer GetInput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthInput(idx));};
     void SetInput(int idx, Acquisition::Pointer input) {this->SetNthInput(idx, input);};
@@ -68,6 +70,7 @@ namespace btk
     Acquisition::Pointer GetOutput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual void GenerateInputRequestedRegion();
     
   private:
     void MergeAcquisition(int idx, Acquisition::Pointer out);
@@ -88,6 +91,7 @@ namespace btk
     MergeAcquisitionFilter& operator=(const MergeAcquisitionFilter& ); // Not implemented.
     
     int m_FirstFrameRule;
+    bool m_Resampling;
   };
 };
 
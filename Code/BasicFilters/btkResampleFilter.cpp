@@ -0,0 +1,344 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkResampleFilter.h"
+
+#include "btkConvert.h"
+
+#include <btkEigen/SignalProcessing/Resample.h>
+
+#include <map>
+#include <cmath>
+
+namespace btk
+{
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _btk_resample_block;
+  typedef std::map<int, std::vector<int> > _btk_resample_groups;
+  
+  // Resamples all the channels (columns) of the block @a X at once.
+  static _btk_resample_block _btk_resample_channels(int up, int down, const _btk_resample_block& X)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> h;
+    btkEigen::resamplingFilter(&h, up, down);
+    return btkEigen::resample(h, up, down, X);
+  };
+  
+  static int _btk_resample_frame_number(int frameNumber, int up, int down)
+  {
+    return (frameNumber * up + down - 1) / down;
+  };
+  
+  static bool _btk_resample_check_ratio(int up, int down)
+  {
+    if ((up < 1) || (down < 1))
+    {
+      btkErrorMacro("The up/down ratio must be strictly positive.");
+      return false;
+    }
+    return true;
+  };
+  
+  // Same behaviour than btkEigen::rationalize but warns when the fraction is only an approximation of the ratio.
+  static bool _btk_resample_rationalize(double ratio, int* up, int* down)
+  {
+    if (ratio <= 0.0)
+    {
+      btkErrorMacro("The sample rates must be strictly positive.");
+      return false;
+    }
+    if (!btkEigen::rationalize(ratio, up, down) && (*up > 0))
+      btkWarningMacro("The ratio between the sample rates cannot be represented exactly by a fraction. The ratio " + ToString(*up) + "/" + ToString(*down) + " is used.");
+    return (*up > 0);
+  };
+  
+  // Groups the indices of the items having the same number of frames. Each group is resampled in one block.
+  template <class T>
+  static _btk_resample_groups _btk_resample_group(typename Collection<T>::Pointer input)
+  {
+    _btk_resample_groups groups;
+    int inc = 0;
+    for (typename Collection<T>::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      groups[(*it)->GetFrameNumber()].push_back(inc++);
+    return groups;
+  };
+  
+  // Each point is represented by 4 channels: its coordinates multiplied by its validity and its validity.
+  // The filtered coordinates are then normalized by the filtered validity so the invalid frames are excluded from the filter.
+  // A resampled frame is valid only if the input frames around it are valid.
+  static void _btk_resample_points(int up, int down, const std::vector<Point::Pointer>& in, const std::vector<Point::Pointer>& out)
+  {
+    const int num = static_cast<int>(in.size());
+    const int inFrameNumber = in[0]->GetFrameNumber();
+    _btk_resample_block X(inFrameNumber, 4 * num);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const Point::Values& values = in[i]->GetValues();
+      const Point::Residuals& residuals = in[i]->GetResiduals();
+      for (int j = 0 ; j < inFrameNumber ; ++j)
+      {
+        const double valid = (residuals.coeff(j) < 0.0) ? 0.0 : 1.0;
+        X.block(j, 4 * i, 1, 3) = valid * values.row(j);
+        X.coeffRef(j, 4 * i + 3) = valid;
+      }
+    }
+    _btk_resample_block Y = _btk_resample_channels(up, down, X);
+    const int outFrameNumber = static_cast<int>(Y.rows());
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const Point::Values& inValues = in[i]->GetValues();
+      const Point::Residuals& inResiduals = in[i]->GetResiduals();
+      Point::Values& values = out[i]->GetValues();
+      Point::Residuals& residuals = out[i]->GetResiduals();
+      for (int j = 0 ; j < outFrameNumber ; ++j)
+      {
+        // Input frames around the resampled one.
+        const int lower = (j * down) / up;
+        const int upper = std::min(lower + (((j * down) % up) ? 1 : 0), inFrameNumber - 1);
+        const int nearest = std::min((2 * j * down + up) / (2 * up), inFrameNumber - 1);
+        const double weight = Y.coeff(j, 4 * i + 3);
+        if ((inResiduals.coeff(lower) < 0.0) || (inResiduals.coeff(upper) < 0.0))
+        {
+          residuals.coeffRef(j) = -1.0;
+          values.row(j).setZero();
+          continue;
+        }
+        residuals.coeffRef(j) = inResiduals.coeff(nearest);
+        // Not enough valid frames around this one to filter it.
+        if (weight < 0.5)
+        {
+          const double alpha = static_cast<double>(j * down) / static_cast<double>(up) - static_cast<double>(lower);
+          values.row(j) = (1.0 - alpha) * inValues.row(lower) + alpha * inValues.row(upper);
+        }
+        else
+          values.row(j) = Y.block(j, 4 * i, 1, 3) / weight;
+      }
+    }
+  };
+  
+  static void _btk_resample_analogs(int up, int down, const std::vector<Analog::Pointer>& in, const std::vector<Analog::Pointer>& out)
+  {
+    const int num = static_cast<int>(in.size());
+    _btk_resample_block X(in[0]->GetFrameNumber(), num);
+    for (int i = 0 ; i < num ; ++i)
+      X.col(i) = in[i]->GetValues();
+    _btk_resample_block Y = _btk_resample_channels(up, down, X);
+    for (int i = 0 ; i < num ; ++i)
+      out[i]->GetValues() = Y.col(i);
+  };
+  
+  /**
+   * Specialized version to resample collection of points. 
+   * The points with the same number of frames are resampled together. 
+   * The invalid frames of each point are excluded from the filter. 
+   * The argument @a frequency is not used.
+   */
+  template <>
+  void ResampleData<PointCollection>(int up, int down, double /* frequency */, PointCollection::Pointer input, PointCollection::Pointer output)
+  {
+    output->Clear();
+    if (!_btk_resample_check_ratio(up, down))
+      return;
+    output->SetItemNumber(input->GetItemNumber());
+    _btk_resample_groups groups = _btk_resample_group<Point>(input);
+    for (_btk_resample_groups::const_iterator it = groups.begin() ; it != groups.end() ; ++it)
+    {
+      std::vector<Point::Pointer> in, out;
+      for (size_t i = 0 ; i < it->second.size() ; ++i)
+      {
+        Point::Pointer source = input->GetItem(it->second[i]);
+        Point::Pointer target = Point::New(source->GetLabel(), _btk_resample_frame_number(it->first, up, down), source->GetType(), source->GetDescription());
+        output->SetItem(it->second[i], target);
+        in.push_back(source);
+        out.push_back(target);
+      }
+      _btk_resample_points(up, down, in, out);
+    }
+  };
+  
+  /**
+   * Specialized version to resample collection of analog channels. 
+   * The analog channels with the same number of frames are resampled together.
+   * The argument @a frequency is not used.
+   */
+  template <>
+  void ResampleData<AnalogCollection>(int up, int down, double /* frequency */, AnalogCollection::Pointer input, AnalogCollection::Pointer output)
+  {
+    output->Clear();
+    if (!_btk_resample_check_ratio(up, down))
+      return;
+    output->SetItemNumber(input->GetItemNumber());
+    _btk_resample_groups groups = _btk_resample_group<Analog>(input);
+    for (_btk_resample_groups::const_iterator it = groups.begin() ; it != groups.end() ; ++it)
+    {
+      std::vector<Analog::Pointer> in, out;
+      for (size_t i = 0 ; i < it->second.size() ; ++i)
+      {
+        Analog::Pointer source = input->GetItem(it->second[i]);
+        Analog::Pointer target = Analog::New(source->GetLabel(), _btk_resample_frame_number(it->first, up, down));
+        target->SetDescription(source->GetDescription());
+        target->SetUnit(source->GetUnit());
+        target->SetGain(source->GetGain());
+        target->SetOffset(source->GetOffset());
+        target->SetScale(source->GetScale());
+        output->SetItem(it->second[i], target);
+        in.push_back(source);
+        out.push_back(target);
+      }
+      _btk_resample_analogs(up, down, in, out);
+    }
+  };
+  
+  /**
+   * Specialized version to resample collection of IMUs. 
+   * If the argument @a frequency is greater than 0, then each IMU is resampled at this frequency (the ratio is computed from the frequency of the IMU). 
+   * Otherwise, the ratio @a up / @a down is used. The frequency of the IMUs is updated accordingly.
+   */
+  template <>
+  void ResampleData<IMUCollection>(int up, int down, double frequency, IMUCollection::Pointer input, IMUCollection::Pointer output)
+  {
+    output->Clear();
+    if ((frequency <= 0.0) && !_btk_resample_check_ratio(up, down))
+      return;
+    for (IMUCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      int p = up, q = down;
+      if ((frequency > 0.0) && !_btk_resample_rationalize(frequency / (*it)->GetFrequency(), &p, &q))
+      {
+        btkErrorMacro("Impossible to resample the IMU '" + (*it)->GetLabel() + "'. Its frequency must be strictly positive.");
+        output->Clear();
+        return;
+      }
+      IMU::Pointer imu = (*it)->Clone();
+      AnalogCollection::Pointer channels = imu->GetChannels();
+      if (!channels->IsEmpty())
+      {
+        std::vector<Analog::Pointer> in(channels->Begin(), channels->End());
+        std::vector<Analog::Pointer> out(in.size());
+        for (size_t i = 0 ; i < in.size() ; ++i)
+          out[i] = Analog::New(_btk_resample_frame_number(imu->GetFrameNumber(), p, q));
+        _btk_resample_analogs(p, q, in, out);
+        imu->SetFrameNumber(_btk_resample_frame_number(imu->GetFrameNumber(), p, q));
+        for (size_t i = 0 ; i < in.size() ; ++i)
+          in[i]->GetValues() = out[i]->GetValues();
+      }
+      imu->SetFrequency(imu->GetFrequency() * static_cast<double>(p) / static_cast<double>(q));
+      output->InsertItem(imu);
+    }
+  };
+  
+  /**
+   * Specialized version to resample acquisition. 
+   * If the argument @a frequency is greater than 0, then it is used as the new point frequency. Otherwise, the point frequency is multiplied by the ratio @a up / @a down.
+   * In both cases, the number of analog samples per frame is kept.
+   *
+   * @sa ResampleAcquisition()
+   */
+  template <>
+  void ResampleData<Acquisition>(int up, int down, double frequency, Acquisition::Pointer input, Acquisition::Pointer output)
+  {
+    if (frequency <= 0.0)
+    {
+      if (!_btk_resample_check_ratio(up, down))
+      {
+        output->Reset();
+        return;
+      }
+      frequency = input->GetPointFrequency() * static_cast<double>(up) / static_cast<double>(down);
+    }
+    ResampleAcquisition(input, output, frequency, input->GetNumberAnalogSamplePerFrame());
+  };
+  
+  /**
+   * Resamples the acquisition @a input at the point frequency @a pointFrequency with @a analogSampleNumberPerFrame analog samples per frame and stores the result in @a output. 
+   * Each kind of data uses its own ratio (the ratio between its new and its current sample rate). When this ratio cannot be represented by a fraction with a denominator lower than 1000, 
+   * the closest fraction is used and a warning is displayed. Returns false if the acquisition cannot be resampled (the output is then empty).
+   *
+   * The frames of the events are adapted to the new point frequency.
+   */
+  bool ResampleAcquisition(Acquisition::Pointer input, Acquisition::Pointer output, double pointFrequency, int analogSampleNumberPerFrame)
+  {
+    output->Reset();
+    if (analogSampleNumberPerFrame < 1)
+    {
+      btkErrorMacro("The number of analog samples per frame must be strictly positive.");
+      return false;
+    }
+    const double frequency = input->GetPointFrequency();
+    int pointRatio[2], analogRatio[2];
+    if (!_btk_resample_rationalize(pointFrequency / frequency, pointRatio, pointRatio + 1)
+        || !_btk_resample_rationalize(pointFrequency * static_cast<double>(analogSampleNumberPerFrame) / (frequency * static_cast<double>(input->GetNumberAnalogSamplePerFrame())), analogRatio, analogRatio + 1))
+      return false;
+    
+    // The parts which are not resampled are copied to not share them with the input.
+    if (pointRatio[0] == pointRatio[1])
+    {
+      output->SetPoints(input->GetPoints()->Clone());
+      output->SetEvents(input->GetEvents()->Clone());
+    }
+    else
+    {
+      PointCollection::Pointer points = PointCollection::New();
+      ResampleData<PointCollection>(pointRatio[0], pointRatio[1], 0.0, input->GetPoints(), points);
+      output->SetPoints(points);
+      // The frame 1 stays the frame 1.
+      const double scale = static_cast<double>(pointRatio[0]) / static_cast<double>(pointRatio[1]);
+      EventCollection::Pointer events = EventCollection::New();
+      for (Acquisition::EventConstIterator it = input->BeginEvent() ; it != input->EndEvent() ; ++it)
+      {
+        Event::Pointer event = (*it)->Clone();
+        if (event->GetFrame() != -1)
+          event->SetFrame(static_cast<int>(std::floor(static_cast<double>(event->GetFrame() - 1) * scale + 0.5)) + 1);
+        events->InsertItem(event);
+      }
+      output->SetEvents(events);
+    }
+    if (analogRatio[0] == analogRatio[1])
+      output->SetAnalogs(input->GetAnalogs()->Clone());
+    else
+    {
+      AnalogCollection::Pointer analogs = AnalogCollection::New();
+      ResampleData<AnalogCollection>(analogRatio[0], analogRatio[1], 0.0, input->GetAnalogs(), analogs);
+      output->SetAnalogs(analogs);
+    }
+    output->SetFirstFrame(static_cast<int>(std::floor(static_cast<double>(input->GetFirstFrame() - 1) * pointRatio[0] / pointRatio[1] + 0.5)) + 1);
+    output->SetPointFrequency(pointFrequency);
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->SetMetaData(input->GetMetaData()->Clone());
+    output->Resize(output->GetPointNumber(), _btk_resample_frame_number(input->GetPointFrameNumber(), pointRatio[0], pointRatio[1]), output->GetAnalogNumber(), analogSampleNumberPerFrame);
+    return true;
+  };
+};
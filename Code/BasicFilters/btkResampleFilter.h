@@ -0,0 +1,293 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkResampleFilter_h
+#define __btkResampleFilter_h
+
+#include "btkProcessObject.h"
+#include "btkLogger.h"
+#include "btkPointCollection.h"
+#include "btkAnalogCollection.h"
+#include "btkIMUCollection.h"
+#include "btkAcquisition.h"
+
+namespace btk
+{
+  template <class T>
+  class ResampleFilter : public ProcessObject
+  {
+  public:
+    typedef btkSharedPtr<ResampleFilter> Pointer;
+    typedef btkSharedPtr<const ResampleFilter> ConstPointer;
+       
+    typedef typename T::Pointer ItemPointer;
+    typedef typename T::ConstPointer ItemConstPointer;    
+    
+    static Pointer New() {return Pointer(new ResampleFilter());};
+    
+    virtual ~ResampleFilter() {};
+    
+    ItemPointer GetInput() {return this->GetInput(0);};
+    void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    ItemPointer GetOutput() {return this->GetOutput(0);};
+    
+    int GetUpRatio() const {return this->m_UpRatio;};
+    int GetDownRatio() const {return this->m_DownRatio;};
+    void SetUpDownRatio(int up, int down);
+    double GetFrequency() const {return this->m_Frequency;};
+    void SetFrequency(double f);
+    
+  protected:
+    ResampleFilter();
+    
+    ItemPointer GetInput(int idx) {return static_pointer_cast<T>(this->GetNthInput(idx));};
+    ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    virtual void GenerateInputRequestedRegion();
+    virtual bool HashParameters(Hash* hash) const;
+    
+  private:
+    ResampleFilter(const ResampleFilter& ); // Not implemented.
+    ResampleFilter& operator=(const ResampleFilter& ); // Not implemented.
+    
+    int m_UpRatio;
+    int m_DownRatio;
+    double m_Frequency;
+  };
+  
+  /**
+   * @class ResampleFilter btkResampleFilter.h
+   * @brief Resamples the data stored in the given input by a rational factor.
+   * @tparam T Must be a class inheriting of btk::DataObject
+   *
+   * The data are upsampled by the up ratio, low-pass filtered and downsampled by the down ratio (see SetUpDownRatio()). 
+   * For example, analog channels sampled at 1200 Hz are resampled at 1000 Hz with an up ratio of 5 and a down ratio of 6.
+   * The filter is a linear phase FIR filter (20*max(up,down)+1 coefficients, cutoff frequency set to the lowest Nyquist frequency)
+   * centred on the computed samples (no delay). The polyphase form of the filter is used: only the computed samples are evaluated
+   * and all the channels of the input are resampled together. The output contains the samples in the time range of the input (ceil(frames * up / down) frames).
+   * For the points, the invalid frames (residual equal to -1) are excluded from the filter and stay invalid.
+   *
+   * For the inputs knowing their sample rate (acquisition, IMUs), the targeted sample rate can be given instead (see SetFrequency()).
+   * The ratio is then computed for each of them during the update of the pipeline.
+   *
+   * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
+   *         - btk::PointCollection
+   *         - btk::AnalogCollection
+   *         - btk::IMUCollection
+   *         - btk::Acquisition
+   *
+   * For an acquisition, the points and the analog channels are resampled with the same ratio. Thus, the number of analog samples per frame is not modified.
+   * The frames of the events are adapted to the new point frequency. The function ResampleAcquisition() can also be used to set the number of analog samples per frame.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::Pointer
+   * Smart pointer associated with a ResampleFilter object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ConstPointer
+   * Smart pointer associated with a const ResampleFilter object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ItemPointer
+   * Smart pointer associated with a T object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ItemConstPointer
+   * Smart const pointer associated with a T object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer ResampleFilter<T>::New();
+   * Creates a smart pointer associated with a ResampleFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual ResampleFilter<T>::~ResampleFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void ResampleFilter<T>::SetInput(ItemPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetUpRatio() const
+   * Gets the factor used to upsample the data.
+   */
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetDownRatio() const
+   * Gets the factor used to downsample the data.
+   */
+  
+  /**
+   * Sets the factors used to upsample (@a up) and then downsample (@a down) the data. 
+   * This ratio is not used if a frequency is set (see SetFrequency()) and known by the input.
+   */
+  template <class T>
+  void ResampleFilter<T>::SetUpDownRatio(int up, int down)
+  {
+    if ((this->m_UpRatio == up) && (this->m_DownRatio == down))
+      return;
+    this->m_UpRatio = up;
+    this->m_DownRatio = down;
+    this->Modified();
+  };
+  
+  /**
+   * @fn template <class T> double ResampleFilter<T>::GetFrequency() const
+   * Returns the targeted sample rate (0 by default).
+   */
+  
+  /**
+   * Sets the targeted sample rate. For an acquisition, this is the new point frequency. 
+   * The value 0 means the up/down ratio is used.
+   */
+  template <class T>
+  void ResampleFilter<T>::SetFrequency(double f)
+  {
+    if (this->m_Frequency == f)
+      return;
+    this->m_Frequency = f;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  ResampleFilter<T>::ResampleFilter()
+  : ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_UpRatio = 1;
+    this->m_DownRatio = 1;
+    this->m_Frequency = 0.0;
+  };
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a T:Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer ResampleFilter<T>::MakeOutput(int /* idx */)
+  {
+    return T::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  template <class T>
+  void ResampleFilter<T>::GenerateData()
+  {
+    ResampleData(this->m_UpRatio, this->m_DownRatio, this->m_Frequency, this->GetInput(), this->GetOutput());
+    this->GetOutput()->Modified();
+  };
+  
+  /**
+   * Requests all the frames of the input as the frames of the output do not correspond to the frames of the input.
+   */
+  template <class T>
+  void ResampleFilter<T>::GenerateInputRequestedRegion()
+  {
+    DataObject::Pointer input = this->GetNthInput(0);
+    if (input)
+      input->ResetRequestedRegion();
+  };
+  
+  /**
+   * Adds the up/down ratio and the targeted frequency to the digest @a hash.
+   */
+  template <class T>
+  bool ResampleFilter<T>::HashParameters(Hash* hash) const
+  {
+    hash->Add(this->m_UpRatio);
+    hash->Add(this->m_DownRatio);
+    hash->Add(this->m_Frequency);
+    return true;
+  };
+  
+  /**
+   * Generic method to resample data. Does nothing.
+   */
+  template <class T>
+  inline void ResampleData(int up, int down, double frequency, btkSharedPtr<T> input, btkSharedPtr<T> output)
+  {
+    btkNotUsed(up);
+    btkNotUsed(down);
+    btkNotUsed(frequency);
+    btkNotUsed(input);
+    btkNotUsed(output);
+    btkErrorMacro("Generic method. Please specialize it.");
+  };
+  
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<PointCollection>(int up, int down, double frequency, PointCollection::Pointer input, PointCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<AnalogCollection>(int up, int down, double frequency, AnalogCollection::Pointer input, AnalogCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<IMUCollection>(int up, int down, double frequency, IMUCollection::Pointer input, IMUCollection::Pointer output);
+  template <> BTK_BASICFILTERS_EXPORT void ResampleData<Acquisition>(int up, int down, double frequency, Acquisition::Pointer input, Acquisition::Pointer output);
+  
+  BTK_BASICFILTERS_EXPORT bool ResampleAcquisition(Acquisition::Pointer input, Acquisition::Pointer output, double pointFrequency, int analogSampleNumberPerFrame);
+};
+
+#endif // __btkResampleFilter_h
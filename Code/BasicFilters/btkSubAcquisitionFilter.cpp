@@ -199,6 +199,18 @@ namespace btk
     return Acquisition::New();
   };
   
+  /**
+   * Requests all the frames of the input if some frames are extracted (their indices are relative to the first frame of the input).
+   * Otherwise, the region requested to the output is requested to the input.
+   */
+  void SubAcquisitionFilter::GenerateInputRequestedRegion()
+  {
+    if ((this->mp_FramesIndex[0] == -1) && (this->mp_FramesIndex[1] == -1))
+      this->ProcessObject::GenerateInputRequestedRegion();
+    else if (this->GetInput())
+      this->GetInput()->ResetRequestedRegion();
+  };
+  
   /**
    * Generates the outputs' data.
    */
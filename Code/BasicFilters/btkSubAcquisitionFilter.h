@@ -72,6 +72,7 @@ namespace btk
     Acquisition::Pointer GetOutput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual void GenerateInputRequestedRegion();
     
   private:
     SubAcquisitionFilter(const SubAcquisitionFilter& ); // Not implemented.
@@ -203,6 +203,23 @@ namespace btk
     return EventCollection::New();
   };
   
+  /**
+   * Adds the threshold, the context mapping, the region of interest and the acquisition's information to the digest @a hash.
+   */
+  bool VerticalGroundReactionForceGaitEventDetector::HashParameters(Hash* hash) const
+  {
+    hash->Add(this->m_Threshold);
+    hash->Add(static_cast<int>(this->m_ContextMapping.size()));
+    for (size_t i = 0 ; i < this->m_ContextMapping.size() ; ++i)
+      hash->Add(this->m_ContextMapping[i]);
+    hash->Add(this->mp_ROI[0]);
+    hash->Add(this->mp_ROI[1]);
+    hash->Add(this->m_FirstFrame);
+    hash->Add(this->m_FrameRate);
+    hash->Add(this->m_SubjectName);
+    return true;
+  };
+  
   /**
    * Algorithm used to detect events during the gait.
    */
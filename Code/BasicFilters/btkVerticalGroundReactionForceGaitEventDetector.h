@@ -84,6 +84,7 @@ namespace btk
     EventCollection::Pointer GetOutput(int idx) {return static_pointer_cast<EventCollection>(this->GetNthOutput(idx));};
     BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
     BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    BTK_BASICFILTERS_EXPORT virtual bool HashParameters(Hash* hash) const;
     
   private:
     VerticalGroundReactionForceGaitEventDetector(const VerticalGroundReactionForceGaitEventDetector& ); // Not implemented.
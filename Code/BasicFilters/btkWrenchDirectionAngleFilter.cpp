@@ -50,6 +50,8 @@ namespace btk
    *
    * The output angles are expressed in degrees and the range is between 0 and 360 degrees.
    * Then a shift from 360 to 0 is possible if the force turns around itself.
+   *
+   * The angles of the wrenches can be computed in parallel (see ProcessObject::SetThreadNumber()).
    * 
    * @ingroup BTKBasicFilters
    */
@@ -117,6 +119,33 @@ namespace btk
     return PointCollection::New();
   };
   
+  // Direction angles computed for each wrench (in parallel if several threads are used).
+  struct _btk_wrench_direction_angle_loop
+  {
+    void operator()(int idx) const
+    {
+      const double radToDeg = 180.0 / M_PI;
+      const Point::Values& force = this->wrenches[idx]->GetForce()->GetValues();
+      const Point::Residuals& residuals = this->wrenches[idx]->GetPosition()->GetResiduals();
+      Point::Values& values = this->angles[idx]->GetValues();
+      for (int i = 0 ; i < static_cast<int>(values.rows()) ; ++i)
+      {
+        if (residuals.coeff(i) >= 0)
+        {
+          values.coeffRef(i,0) = atan2(-force.coeff(i,2), -force.coeff(i,1)) * radToDeg + 180.0;
+          values.coeffRef(i,1) = atan2(-force.coeff(i,2), -force.coeff(i,0)) * radToDeg + 180.0;
+          values.coeffRef(i,2) = atan2(-force.coeff(i,1), -force.coeff(i,0)) * radToDeg + 180.0;
+        }
+        else
+        {
+          this->angles[idx]->GetResiduals().coeffRef(i) = -1.0;
+        }
+      }
+    };
+    std::vector<Wrench::Pointer> wrenches;
+    std::vector<Point::Pointer> angles;
+  };
+  
   /**
    * Generates the outputs' data.
    */
@@ -125,28 +154,21 @@ namespace btk
     PointCollection::Pointer output = this->GetOutput();
     output->Clear();
     WrenchCollection::Pointer input = this->GetInput();
-    const double radToDeg = 180.0 / M_PI;
     if (input)
     {
+      _btk_wrench_direction_angle_loop loop;
       for (WrenchCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
       {
         int numFrames = (*it)->GetForce()->GetFrameNumber();
         Point::Pointer dirAngle = Point::New((*it)->GetPosition()->GetLabel() + ".DA", numFrames, Point::Angle);
-        for (int i = 0 ; i < numFrames ; ++i)
-        {
-          if ((*it)->GetPosition()->GetResiduals().coeff(i) >= 0)
-          {
-            dirAngle->GetValues().coeffRef(i,0) = atan2(-(*it)->GetForce()->GetValues().coeff(i,2), -(*it)->GetForce()->GetValues().coeff(i,1)) * radToDeg + 180.0;
-            dirAngle->GetValues().coeffRef(i,1) = atan2(-(*it)->GetForce()->GetValues().coeff(i,2), -(*it)->GetForce()->GetValues().coeff(i,0)) * radToDeg + 180.0;
-            dirAngle->GetValues().coeffRef(i,2) = atan2(-(*it)->GetForce()->GetValues().coeff(i,1), -(*it)->GetForce()->GetValues().coeff(i,0)) * radToDeg + 180.0;
-          }
-          else
-          {
-            dirAngle->GetResiduals().coeffRef(i) = -1.0;
-          }
-        }
+        // The compact values are expanded before the parallel loop.
+        (*it)->GetForce()->GetValues();
+        (*it)->GetPosition()->GetResiduals();
+        loop.wrenches.push_back(*it);
+        loop.angles.push_back(dirAngle);
         output->InsertItem(dirAngle);
       }
+      this->ParallelFor(static_cast<int>(loop.wrenches.size()), loop);
     }
   };
 };
@@ -34,6 +34,7 @@
  */
 
 #include "btkAcquisition.h"
+#include "btkAnalogBlock.h"
 #include "btkException.h"
 #include "btkConvert.h"
 
@@ -90,6 +91,41 @@ namespace btk
    * @var Acquisition::AnalogResolution Acquisition::Bit16
    * 16 bits ADC.
    */
+  
+  /**
+   * @enum Acquisition::AnalogStorage
+   * Enums used to specify how the samples of the analog channels are stored in the memory.
+   */
+  /**
+   * @var Acquisition::AnalogStorage Acquisition::Separated
+   * Each analog channel stores its samples in its own memory (default).
+   */
+  /**
+   * @var Acquisition::AnalogStorage Acquisition::ColumnMajor
+   * The analog channels are stored in one btk::AnalogBlock object where the samples of each channel are consecutive.
+   */
+  /**
+   * @var Acquisition::AnalogStorage Acquisition::RowMajor
+   * The analog channels are stored in one btk::AnalogBlock object where the samples of each frame are consecutive.
+   */
+  
+  /**
+   * @enum Acquisition::StoragePrecision
+   * Enums used to specify the precision used to store the values of the points and analog channels.
+   */
+  /**
+   * @var Acquisition::StoragePrecision Acquisition::DoublePrecision
+   * The values are stored in double precision (default).
+   */
+  /**
+   * @var Acquisition::StoragePrecision Acquisition::SinglePrecision
+   * The values are stored in single precision until they are accessed.
+   */
+  /**
+   * @var Acquisition::StoragePrecision Acquisition::RawPrecision
+   * The samples of the analog channels are stored as raw integer samples when the file reader provides them, the other values are stored in single precision. 
+   * In both cases, the values are stored in this form until they are accessed.
+   */
 
   /**
    * @typedef Acquisition::Pointer
@@ -919,6 +955,7 @@ namespace btk
       pt->SetParent(this);
       this->m_Points->InsertItem(pt);
     }
+    this->UpdateStoragePrecision();
     // Set the object as modified
     this->Modified();
   };
@@ -944,6 +981,8 @@ namespace btk
       pt->SetParent(this);
       this->m_Analogs->InsertItem(pt);
     }
+    this->UpdateAnalogStorage();
+    this->UpdateStoragePrecision();
     // Set the object as modified
     this->Modified();
   };
@@ -957,6 +996,8 @@ namespace btk
       return;
     this->SetPointFrameNumber(frameNumber);
     this->SetAnalogFrameNumber(this->m_AnalogSampleNumberPerPointFrame);
+    this->UpdateAnalogStorage();
+    this->UpdateStoragePrecision();
     this->Modified();
   };
   
@@ -1014,6 +1055,8 @@ namespace btk
       }
     }
     this->m_PointFrameNumber = frameNumber;
+    this->UpdateAnalogStorage();
+    this->UpdateStoragePrecision();
     this->Modified();
   };
 
@@ -1028,6 +1071,7 @@ namespace btk
    * - Analog resolution: 12 bits ;
    * - Default units.
    *
+   * The storage of the analog channels (see SetAnalogStorage()), the storage precision (see SetStoragePrecision()) and the memory arena (see SetMemoryArena()) are kept.
    * To re-populate this acquisition, you need to re-use the Init() method 
    * to set the point and analog number and their frame number.
    */
@@ -1221,6 +1265,36 @@ namespace btk
     this->Modified();
   };
   
+  /**
+   * @fn AnalogStorage Acquisition::GetAnalogStorage() const
+   * Returns the way the samples of the analog channels are stored in the memory.
+   */
+  
+  /**
+   * Sets the way the samples of the analog channels are stored in the memory.
+   *
+   * By default, each analog channel stores its own samples (Acquisition::Separated). 
+   * The options Acquisition::ColumnMajor and Acquisition::RowMajor store all the channels in one btk::AnalogBlock object.
+   * Each channel is then a view over a column of this block and the whole set of channels can be processed as one matrix (see btk::AnalogBlock::Find()).
+   * The row major storage is useful for the file readers as the samples are generally stored frame by frame in the files.
+   *
+   * The channels are (re)stored immediately and after each call of the methods Init(), Resize(), ResizeAnalogNumber(), ResizeFrameNumber() and ResizeFrameNumberFromEnd(). 
+   * Channels appended later or resized individually are stored in their own memory until the next call of one of these methods.
+   */
+  void Acquisition::SetAnalogStorage(AnalogStorage s)
+  {
+    if ((s != Separated) && (this->m_StoragePrecision != DoublePrecision))
+      btkWarningMacro("The analog channels cannot be stored in one block with the single precision or raw storage. They will be stored in one block only if the double precision storage is set.");
+    if (this->m_AnalogStorage == s)
+      return;
+    this->m_AnalogStorage = s;
+    if (s == Separated)
+      AnalogBlock::Unpack(this->m_Analogs);
+    else
+      this->UpdateAnalogStorage();
+    this->Modified();
+  };
+  
   /**
    * @fn int Acquisition::GetMaxInterpolationGap() const
    * Gets the maximum gap length that any interpolation method would fill for the 3D point data.
@@ -1241,6 +1315,116 @@ namespace btk
     this->Modified();
   };
   
+  /**
+   * Adds the content of this acquisition to the digest @a hash: the frames (first frame, frequency, number of frames 
+   * and of analog samples per frame), the analog resolution, the units, the maximum interpolation gap, 
+   * the metadata, the events, the points and the analog channels.
+   */
+  bool Acquisition::HashContent(Hash* hash) const
+  {
+    this->HashFrames(hash);
+    return this->mp_MetaData->HashContent(hash)
+           && this->m_Events->HashContent(hash)
+           && this->m_Points->HashContent(hash)
+           && this->m_Analogs->HashContent(hash);
+  };
+  
+  /**
+   * Sets in @a digest the combination of the frames' information (see HashContent()) and the digests 
+   * of the metadata, the events, the points and the analog channels (see DataObject::GetContentHash()).
+   * The digest of each point and each analog channel is cached: only the modified channels are hashed again.
+   * The digest depends only on the content: the same values stored in another form (see SetStoragePrecision()) give the same digest.
+   *
+   * @warning The digest of a channel is cached with its timestamp. The values modified directly by reference 
+   * (e.g. <tt>GetPoint(0)->GetValues().coeffRef(0,0) = 1.0</tt>) do not change this timestamp and the returned digest is then stale.
+   * The method Modified() of the modified point or analog channel has to be called after such modifications.
+   * The method HashContent() has not this limitation (the content is always hashed again) but is slower.
+   */
+  bool Acquisition::GetContentHash(Hash::Value* digest) const
+  {
+    Hash hash;
+    this->HashFrames(&hash);
+    Hash::Value part;
+    if (!this->mp_MetaData->GetContentHash(&part))
+      return false;
+    hash.Add(part);
+    if (!this->m_Events->GetContentHash(&part))
+      return false;
+    hash.Add(part);
+    if (!this->m_Points->GetContentHash(&part))
+      return false;
+    hash.Add(part);
+    if (!this->m_Analogs->GetContentHash(&part))
+      return false;
+    hash.Add(part);
+    *digest = hash.GetValue();
+    return true;
+  };
+  
+  /**
+   * Adds the memory used by this acquisition, its units, its metadata, its events, its points and its analog channels to @a usage.
+   * Use the method DataObject::GetMemoryUsage() to know the memory used by each component.
+   */
+  void Acquisition::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Acquisition) + this->m_Units.capacity() * sizeof(std::string));
+    for (std::vector<std::string>::const_iterator it = this->m_Units.begin() ; it != this->m_Units.end() ; ++it)
+      usage->Add(MemoryUsage::Strings, *it);
+    this->mp_MetaData->AddMemoryUsage(usage);
+    this->m_Events->AddMemoryUsage(usage);
+    this->m_Points->AddMemoryUsage(usage);
+    this->m_Analogs->AddMemoryUsage(usage);
+  };
+  
+  /**
+   * Returns a digest of the structure of this acquisition, without its values: the frames' information (see HashContent()), 
+   * the label, the description and the type of the points, the label, the description, the unit, the gain, the offset 
+   * and the scale of the analog channels, and the tree of the metadata (label, format and dimensions of each entry).
+   * Two acquisitions with the same fingerprint can be compared or concatenated channel by channel.
+   */
+  Hash::Value Acquisition::GetStructuralFingerprint() const
+  {
+    Hash hash;
+    this->HashFrames(&hash);
+    hash.Add(this->GetPointNumber());
+    for (PointConstIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+    {
+      hash.Add((*it)->GetLabel());
+      hash.Add((*it)->GetDescription());
+      hash.Add(static_cast<int>((*it)->GetType()));
+    }
+    hash.Add(this->GetAnalogNumber());
+    for (AnalogConstIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
+    {
+      hash.Add((*it)->GetLabel());
+      hash.Add((*it)->GetDescription());
+      hash.Add((*it)->GetUnit());
+      hash.Add(static_cast<int>((*it)->GetGain()));
+      hash.Add((*it)->GetOffset());
+      hash.Add((*it)->GetScale());
+    }
+    std::list<MetaData::ConstPointer> entries(1, this->mp_MetaData);
+    while (!entries.empty())
+    {
+      MetaData::ConstPointer entry = entries.front();
+      entries.pop_front();
+      hash.Add(entry->GetLabel());
+      hash.Add(entry->HasInfo());
+      if (entry->HasInfo())
+      {
+        hash.Add(static_cast<int>(entry->GetInfo()->GetFormat()));
+        const std::vector<uint8_t>& dims = entry->GetInfo()->GetDimensions();
+        hash.Add(static_cast<int>(dims.size()));
+        if (!dims.empty())
+          hash.Add(&(dims[0]), dims.size());
+      }
+      hash.Add(entry->GetChildNumber());
+      for (MetaData::ConstIterator it = entry->Begin() ; it != entry->End() ; ++it)
+        entries.push_back(*it);
+    }
+    return hash.GetValue();
+  };
+  
   /**
    * @fn Pointer Acquisition::Clone() const
    * Returns a deep copy of this object.
@@ -1262,6 +1446,8 @@ namespace btk
     this->m_PointFrameNumber = 0;
     this->m_AnalogSampleNumberPerPointFrame = 1;
     this->m_AnalogResolution = Bit12; 
+    this->m_AnalogStorage = Separated;
+    this->m_StoragePrecision = DoublePrecision;
     this->m_Units[Point::Marker] = "mm";
     this->m_Units[Point::Angle] = "deg";
     this->m_Units[Point::Force] = "N";
@@ -1311,8 +1497,10 @@ namespace btk
    * Constructor of copy. Timestamp, source and parent are reset.
    */
   Acquisition::Acquisition(const Acquisition& toCopy)
-  : DataObject(), m_Units(toCopy.m_Units)
+  : DataObject(), mp_MemoryArena(toCopy.mp_MemoryArena), m_Units(toCopy.m_Units)
   {
+    // The cloned objects are stored in the same arena than the copied acquisition (if any).
+    MemoryArena::Scope scope(this->mp_MemoryArena);
     this->m_Events = toCopy.m_Events->Clone();
     this->m_Points = toCopy.m_Points->Clone();
     this->m_Analogs = toCopy.m_Analogs->Clone();
@@ -1323,6 +1511,128 @@ namespace btk
     this->m_PointFrameNumber = toCopy.m_PointFrameNumber;
     this->m_AnalogSampleNumberPerPointFrame = toCopy.m_AnalogSampleNumberPerPointFrame;
     this->m_AnalogResolution = toCopy.m_AnalogResolution;
+    this->m_AnalogStorage = toCopy.m_AnalogStorage;
+    this->m_StoragePrecision = toCopy.m_StoragePrecision;
     this->m_MaxInterpolationGap = toCopy.m_MaxInterpolationGap;
+    this->UpdateAnalogStorage();
+  };
+  
+  /**
+   * @fn StoragePrecision Acquisition::GetStoragePrecision() const
+   * Returns the precision used to store the values of the points and analog channels.
+   */
+  
+  /**
+   * Sets the precision used to store the values (and residuals) of the points and analog channels.
+   *
+   * With the single precision storage, the memory used by the values is divided by two. 
+   * The values are converted in double precision (and stored in double precision) as soon as they are accessed with a non const method (for example Point::GetValues()).
+   * Calling again this method with the single precision storage converts in single precision the values accessed since the last call.
+   * The file readers (e.g. C3D) fill directly the single precision storage when it is set in their output.
+   *
+   * With the raw storage, the analog channels read from a file storing integer samples (e.g. C3D integer file) keep these raw samples (see btk::Analog::Data::SetRawStorage()).
+   * The memory used by their samples is then divided by four and the file writers (e.g. C3D) can save them back without any quantization error, as long as the values are not accessed.
+   * The other values are stored in single precision.
+   *
+   * The single precision and raw storages cannot be combined with the storage of the analog channels in one block (see SetAnalogStorage()).
+   * The storage precision is applied to the points and analog channels created by the methods Init(), Resize(), ResizePointNumber() and ResizeAnalogNumber().
+   */
+  void Acquisition::SetStoragePrecision(StoragePrecision p)
+  {
+    if (this->m_StoragePrecision != p)
+    {
+      this->m_StoragePrecision = p;
+      this->Modified();
+    }
+    if (p == DoublePrecision)
+    {
+      for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+      {
+        if ((*it)->GetData())
+          (*it)->GetData()->SetSinglePrecision(false);
+      }
+      for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
+      {
+        if ((*it)->GetData())
+        {
+          (*it)->GetData()->ReleaseRawStorage();
+          (*it)->GetData()->SetSinglePrecision(false);
+        }
+      }
+      this->UpdateAnalogStorage();
+    }
+    else
+      this->UpdateStoragePrecision();
+  };
+  
+  /**
+   * @fn MemoryArena::Pointer Acquisition::GetMemoryArena() const
+   * Returns the memory arena used to allocate the objects of this acquisition (or a null pointer if the heap is used).
+   */
+  
+  /**
+   * Sets the memory arena used by the file readers (see btk::AcquisitionFileReader) and the method Clone() to allocate the objects (points, analog channels, events, metadata, etc.) of this acquisition.
+   * The objects of the cloned acquisitions are stored in the same arena. 
+   * The memory of the arena is released in one time when the acquisition, its clones and their objects are destroyed.
+   *
+   * By default, no arena is used and each object is allocated with the heap.
+   * @sa btk::MemoryArena
+   */
+  void Acquisition::SetMemoryArena(MemoryArena::Pointer arena)
+  {
+    if (this->mp_MemoryArena == arena)
+      return;
+    this->mp_MemoryArena = arena;
+    this->Modified();
+  };
+  
+  // Adds the frames' information (first frame, frequency, number of frames and of analog samples per frame), 
+  // the analog resolution, the units and the maximum interpolation gap.
+  void Acquisition::HashFrames(Hash* hash) const
+  {
+    hash->Add(this->m_FirstFrame);
+    hash->Add(this->m_PointFrequency);
+    hash->Add(this->m_PointFrameNumber);
+    hash->Add(this->m_AnalogSampleNumberPerPointFrame);
+    hash->Add(static_cast<int>(this->m_AnalogResolution));
+    hash->Add(static_cast<int>(this->m_Units.size()));
+    for (size_t i = 0 ; i < this->m_Units.size() ; ++i)
+      hash->Add(this->m_Units[i]);
+    hash->Add(this->m_MaxInterpolationGap);
+  };
+  
+  /**
+   * Store the analog channels in one block if the storage is not set to Acquisition::Separated and if they are not already stored in a suitable block.
+   */
+  void Acquisition::UpdateAnalogStorage()
+  {
+    if ((this->m_AnalogStorage == Separated) || (this->m_StoragePrecision != DoublePrecision))
+      return;
+    AnalogBlock::Layout layout = (this->m_AnalogStorage == RowMajor) ? AnalogBlock::RowMajor : AnalogBlock::ColumnMajor;
+    int first = 0;
+    AnalogBlock::Pointer block = AnalogBlock::Find(this->m_Analogs, &first);
+    if (block && (first == 0) && (block->GetChannelNumber() == this->GetAnalogNumber()) && (block->GetLayout() == layout))
+      return;
+    AnalogBlock::Pack(this->m_Analogs, layout);
+  };
+  
+  /**
+   * Converts the values of the points and analog channels in single precision if this storage (or the raw storage) is set.
+   * The analog channels already stored as raw samples are kept as is with the raw storage.
+   */
+  void Acquisition::UpdateStoragePrecision()
+  {
+    if (this->m_StoragePrecision == DoublePrecision)
+      return;
+    for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+    {
+      if ((*it)->GetData())
+        (*it)->GetData()->SetSinglePrecision(true);
+    }
+    for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
+    {
+      if ((*it)->GetData() && !((*it)->GetData()->IsRaw() && (this->m_StoragePrecision == RawPrecision)))
+        (*it)->GetData()->SetSinglePrecision(true);
+    }
   };
 }
@@ -50,6 +50,8 @@ namespace btk
   {
   public:
     typedef enum {Bit8 = 8, Bit10 = 10, Bit12 = 12, Bit14 = 14, Bit16 = 16}  AnalogResolution;
+    typedef enum {Separated = 0, ColumnMajor, RowMajor} AnalogStorage;
+    typedef enum {DoublePrecision = 0, SinglePrecision, RawPrecision} StoragePrecision;
 
     typedef btkSharedPtr<Acquisition> Pointer;
     typedef btkSharedPtr<const Acquisition> ConstPointer;
@@ -174,9 +176,20 @@ namespace btk
     double GetAnalogFrequency() const {return this->m_PointFrequency * static_cast<double>(this->m_AnalogSampleNumberPerPointFrame);};
     AnalogResolution GetAnalogResolution() const {return this->m_AnalogResolution;};
     BTK_COMMON_EXPORT void SetAnalogResolution(AnalogResolution r);
+    AnalogStorage GetAnalogStorage() const {return this->m_AnalogStorage;};
+    BTK_COMMON_EXPORT void SetAnalogStorage(AnalogStorage s);
+    StoragePrecision GetStoragePrecision() const {return this->m_StoragePrecision;};
+    BTK_COMMON_EXPORT void SetStoragePrecision(StoragePrecision p);
+    MemoryArena::Pointer GetMemoryArena() const {return this->mp_MemoryArena;};
+    BTK_COMMON_EXPORT void SetMemoryArena(MemoryArena::Pointer arena);
     int GetMaxInterpolationGap() const {return this->m_MaxInterpolationGap;};
     BTK_COMMON_EXPORT void SetMaxInterpolationGap(int gap);
     
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual bool GetContentHash(Hash::Value* digest) const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    BTK_COMMON_EXPORT Hash::Value GetStructuralFingerprint() const;
+    
     Pointer Clone() const {return Pointer(new Acquisition(*this));};
     
   protected:
@@ -186,6 +199,10 @@ namespace btk
     BTK_COMMON_EXPORT void SetAnalogFrameNumber(int frameNumber);
     
   private:
+    void UpdateAnalogStorage();
+    void UpdateStoragePrecision();
+    void HashFrames(Hash* hash) const;
+
     BTK_COMMON_EXPORT Acquisition(const Acquisition& toCopy);
     Acquisition& operator=(const Acquisition& ); // Not implemented.
     
@@ -198,6 +215,9 @@ namespace btk
     int m_PointFrameNumber;
     int m_AnalogSampleNumberPerPointFrame;
     AnalogResolution m_AnalogResolution;
+    AnalogStorage m_AnalogStorage;
+    StoragePrecision m_StoragePrecision;
+    MemoryArena::Pointer mp_MemoryArena;
     std::vector<std::string> m_Units;
     int m_MaxInterpolationGap;
   };
@@ -0,0 +1,740 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkAcquisitionComparator.h"
+#include "btkHash.h"
+#include "btkLogger.h"
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace btk
+{
+  static const int _btk_comparator_chunk = 1024;
+  
+  // Column of samples in one of the storages of a measure (double, single precision or raw samples).
+  struct _btk_comparator_column
+  {
+    _btk_comparator_column() : doubles(0), singles(0), raws(0), stride(1), offset(0.0), scale(1.0) {};
+    const double* doubles;
+    const float* singles;
+    const int16_t* raws;
+    int stride;
+    double offset;
+    double scale;
+  };
+  
+  // Result of the comparison of the columns of a channel.
+  struct _btk_comparator_result
+  {
+    _btk_comparator_result() : frame(-1), component(-1), flags(), maxError(0.0) {};
+    int frame;
+    int component;
+    std::vector<bool> flags; // Frames out of tolerance (allocated with the first one).
+    double maxError;
+  };
+  
+  // Converts in double precision the samples [start, start+num[ of the column.
+  static void _btk_comparator_load(const _btk_comparator_column& column, int start, int num, double* out)
+  {
+    if (column.raws != 0)
+    {
+      const int16_t* in = column.raws + start * column.stride;
+      for (int i = 0 ; i < num ; ++i)
+        out[i] = (static_cast<double>(in[i * column.stride]) - column.offset) * column.scale;
+    }
+    else if (column.singles != 0)
+    {
+      const float* in = column.singles + start * column.stride;
+      for (int i = 0 ; i < num ; ++i)
+        out[i] = static_cast<double>(in[i * column.stride]);
+    }
+    else
+    {
+      const double* in = column.doubles + start * column.stride;
+      for (int i = 0 ; i < num ; ++i)
+        out[i] = in[i * column.stride];
+    }
+  };
+  
+  // Compares a chunk of samples. The vectorized test covers the common case (every sample within the tolerance).
+  // Only the chunks with a difference are inspected sample by sample. A NaN is always out of tolerance.
+  static void _btk_comparator_kernel(const double* reference, const double* tested, double* error, int start, int num, int length, int component, const AcquisitionComparator::Tolerance& tol, _btk_comparator_result* result)
+  {
+    if (num <= 0)
+      return;
+    Eigen::Map<const Eigen::ArrayXd> r(reference, num), t(tested, num);
+    Eigen::Map<Eigen::ArrayXd> e(error, num);
+    e = (t - r).abs();
+    if ((e <= tol.absolute + tol.relative * r.abs()).all())
+    {
+      result->maxError = std::max(result->maxError, e.maxCoeff());
+      return;
+    }
+    if (result->flags.empty())
+      result->flags.resize(length, false);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      if (!(e.coeff(i) <= tol.absolute + tol.relative * std::fabs(r.coeff(i))))
+      {
+        result->flags[start + i] = true;
+        if ((result->frame == -1) || (start + i < result->frame))
+        {
+          result->frame = start + i;
+          result->component = component;
+        }
+      }
+      if (e.coeff(i) <= std::numeric_limits<double>::max())
+        result->maxError = std::max(result->maxError, e.coeff(i));
+    }
+  };
+  
+  // Sorted digests of the labels to match the channels by label.
+  typedef std::vector< std::pair<uint64_t, int> > _btk_comparator_index;
+  
+  static uint64_t _btk_comparator_digest(const std::string& label)
+  {
+    Hash hash;
+    hash.Add(label);
+    return hash.GetValue().low;
+  };
+  
+  static void _btk_comparator_build_index(const std::vector<std::string>& labels, _btk_comparator_index* index)
+  {
+    index->resize(labels.size());
+    for (size_t i = 0 ; i < labels.size() ; ++i)
+      (*index)[i] = std::make_pair(_btk_comparator_digest(labels[i]), static_cast<int>(i));
+    std::sort(index->begin(), index->end());
+  };
+  
+  // Returns the index of the first label not yet matched, or -1.
+  static int _btk_comparator_match(const _btk_comparator_index& index, const std::vector<std::string>& labels, const std::string& label, std::vector<bool>* matched)
+  {
+    const uint64_t digest = _btk_comparator_digest(label);
+    _btk_comparator_index::const_iterator it = std::lower_bound(index.begin(), index.end(), std::make_pair(digest, -1));
+    for ( ; (it != index.end()) && (it->first == digest) ; ++it)
+    {
+      if (!(*matched)[it->second] && (labels[it->second] == label))
+      {
+        (*matched)[it->second] = true;
+        return it->second;
+      }
+    }
+    return -1;
+  };
+  
+  static _btk_comparator_column _btk_comparator_point_column(Point::Data::ConstPointer data, int component)
+  {
+    _btk_comparator_column column;
+    if (data->IsSinglePrecision())
+      column.singles = data->GetSingleValues().data() + component * data->GetSingleValues().rows();
+    else
+    {
+      const Point::Values& values = data->GetValues();
+      column.doubles = values.data() + component * values.outerStride();
+      column.stride = static_cast<int>(values.innerStride());
+    }
+    return column;
+  };
+  
+  static _btk_comparator_column _btk_comparator_residual_column(Point::Data::ConstPointer data)
+  {
+    _btk_comparator_column column;
+    if (data->IsSinglePrecision())
+      column.singles = data->GetSingleResiduals().data();
+    else
+    {
+      const Point::Residuals& residuals = data->GetResiduals();
+      column.doubles = residuals.data();
+      column.stride = static_cast<int>(residuals.innerStride());
+    }
+    return column;
+  };
+  
+  static _btk_comparator_column _btk_comparator_analog_column(Analog::Data::ConstPointer data)
+  {
+    _btk_comparator_column column;
+    if (data->IsRaw())
+    {
+      column.raws = data->GetRawValues().data();
+      column.offset = data->GetRawOffset();
+      column.scale = data->GetRawScale();
+    }
+    else if (data->IsSinglePrecision())
+      column.singles = data->GetSingleValues().data();
+    else
+    {
+      const Analog::Values& values = data->GetValues();
+      column.doubles = values.data();
+      column.stride = static_cast<int>(values.innerStride());
+    }
+    return column;
+  };
+  
+  struct _btk_comparator_event
+  {
+    std::string context;
+    std::string label;
+    std::string subject;
+    double time;
+    int Compare(const _btk_comparator_event& other) const
+    {
+      int c = this->context.compare(other.context);
+      if (c == 0)
+        c = this->label.compare(other.label);
+      if (c == 0)
+        c = this->subject.compare(other.subject);
+      return c;
+    };
+    friend bool operator<(const _btk_comparator_event& lhs, const _btk_comparator_event& rhs)
+    {
+      const int c = lhs.Compare(rhs);
+      return (c != 0) ? (c < 0) : (lhs.time < rhs.time);
+    };
+  };
+  
+  static void _btk_comparator_events(Acquisition::ConstPointer acq, std::vector<_btk_comparator_event>* events)
+  {
+    events->reserve(acq->GetEventNumber());
+    for (Acquisition::EventConstIterator it = acq->BeginEvent() ; it != acq->EndEvent() ; ++it)
+    {
+      _btk_comparator_event e;
+      e.context = (*it)->GetContext();
+      e.label = (*it)->GetLabel();
+      e.subject = (*it)->GetSubject();
+      e.time = (*it)->GetTime();
+      events->push_back(e);
+    }
+    std::sort(events->begin(), events->end());
+  };
+  
+  /**
+   * @class AcquisitionComparator btkAcquisitionComparator.h
+   * @brief Compares an acquisition to a reference with tolerances and lists the differences.
+   *
+   * The points and the analog channels are matched by their label. Their values are compared 
+   * frame by frame: a sample is within the tolerance if <tt>|tested - reference| <= absolute + relative * |reference|</tt>. 
+   * For each channel, the differences report the first frame (or sample for an analog channel) out of tolerance, 
+   * the number of frames out of tolerance and the maximum absolute error. The values are read in the form 
+   * used to store them (double, single precision or raw samples) without converting the whole channel. 
+   * The frames where a point is occluded in both acquisitions are not compared. 
+   *
+   * The events are matched by their context, label and subject, and then compared by their time.
+   * The metadata are compared recursively (format, dimensions and values) unless SetMetaDataComparison() is 
+   * used to disable it. The numerical values of the metadata use the tolerance set by SetMetaDataTolerance().
+   * 
+   * @code
+   * btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+   * comparator->SetPointTolerance(btk::AcquisitionComparator::Tolerance(1e-3)); // mm
+   * comparator->SetAnalogTolerance(btk::AcquisitionComparator::Tolerance(0.0, 1e-4));
+   * if (!comparator->Compare(reference, reader->GetOutput()))
+   *   comparator->PrintDifferences(std::cerr);
+   * @endcode
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @struct AcquisitionComparator::Tolerance btkAcquisitionComparator.h
+   * @brief Absolute and relative tolerances (by default, the values have to be equal).
+   */
+  
+  /**
+   * @fn AcquisitionComparator::Tolerance::Tolerance(double a = 0.0, double r = 0.0)
+   * Constructor.
+   */
+  
+  /**
+   * @var AcquisitionComparator::Tolerance::absolute
+   * Absolute tolerance.
+   */
+  
+  /**
+   * @var AcquisitionComparator::Tolerance::relative
+   * Tolerance relative to the magnitude of the reference value.
+   */
+  
+  /**
+   * @struct AcquisitionComparator::Difference btkAcquisitionComparator.h
+   * @brief Difference found between the reference and the tested acquisition.
+   */
+  
+  /**
+   * @enum AcquisitionComparator::Difference::Category
+   * Part of the acquisition which differs.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Category AcquisitionComparator::Difference::Frames
+   * Frames' information (first frame, frequency, number of frames, number of analog samples per frame).
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Category AcquisitionComparator::Difference::Point
+   * Point.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Category AcquisitionComparator::Difference::Analog
+   * Analog channel.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Category AcquisitionComparator::Difference::Event
+   * Event.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Category AcquisitionComparator::Difference::MetaData
+   * Metadata entry.
+   */
+  
+  /**
+   * @enum AcquisitionComparator::Difference::Type
+   * Kind of difference.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Type AcquisitionComparator::Difference::Values
+   * Values out of tolerance.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Type AcquisitionComparator::Difference::Property
+   * Property which differs (see the member @a detail).
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Type AcquisitionComparator::Difference::Missing
+   * Element of the reference not found in the tested acquisition.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::Type AcquisitionComparator::Difference::Unexpected
+   * Element of the tested acquisition not found in the reference.
+   */
+  
+  /**
+   * @var AcquisitionComparator::Difference::label
+   * Label of the channel, <tt>context:label</tt> for an event or path of the metadata entry (e.g. <tt>POINT:RATE</tt>).
+   */
+  /**
+   * @var AcquisitionComparator::Difference::detail
+   * Name of the property which differs or subject of an event.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::frame
+   * Index (starting from 0) of the first frame out of tolerance. For an analog channel, it is the index of the sample. Set to -1 if not applicable.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::component
+   * Component of the first frame out of tolerance or index of the first metadata value out of tolerance. Set to -1 if not applicable.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::frameNumber
+   * Number of frames (or metadata values) out of tolerance.
+   */
+  /**
+   * @var AcquisitionComparator::Difference::maxError
+   * Maximum absolute error (NaN and infinite errors excluded).
+   */
+  
+  /**
+   * @typedef AcquisitionComparator::Pointer
+   * Smart pointer associated with an AcquisitionComparator object.
+   */
+  
+  /**
+   * @typedef AcquisitionComparator::ConstPointer
+   * Smart pointer associated with a const AcquisitionComparator object.
+   */
+  
+  /**
+   * @typedef AcquisitionComparator::NullPointer
+   * Null pointer associated with an AcquisitionComparator object.
+   */
+  
+  /**
+   * @fn static Pointer AcquisitionComparator::New()
+   * Creates a smart pointer associated with an AcquisitionComparator object.
+   */
+  
+  /**
+   * @fn static NullPointer AcquisitionComparator::Null()
+   * Returns a null pointer associated with an AcquisitionComparator object.
+   */
+  
+  /**
+   * @fn const Tolerance& AcquisitionComparator::GetPointTolerance() const
+   * Returns the tolerance used to compare the values of the points.
+   */
+  
+  /**
+   * @fn void AcquisitionComparator::SetPointTolerance(const Tolerance& tol)
+   * Sets the tolerance used to compare the values of the points.
+   */
+  
+  /**
+   * @fn const Tolerance& AcquisitionComparator::GetAnalogTolerance() const
+   * Returns the tolerance used to compare the values of the analog channels.
+   */
+  
+  /**
+   * @fn void AcquisitionComparator::SetAnalogTolerance(const Tolerance& tol)
+   * Sets the tolerance used to compare the values of the analog channels.
+   */
+  
+  /**
+   * @fn const Tolerance& AcquisitionComparator::GetEventTolerance() const
+   * Returns the tolerance used to compare the time of the events.
+   */
+  
+  /**
+   * @fn void AcquisitionComparator::SetEventTolerance(const Tolerance& tol)
+   * Sets the tolerance used to compare the time of the events.
+   */
+  
+  /**
+   * @fn const Tolerance& AcquisitionComparator::GetMetaDataTolerance() const
+   * Returns the tolerance used to compare the numerical values of the metadata.
+   */
+  
+  /**
+   * @fn void AcquisitionComparator::SetMetaDataTolerance(const Tolerance& tol)
+   * Sets the tolerance used to compare the numerical values of the metadata.
+   */
+  
+  /**
+   * @fn bool AcquisitionComparator::GetMetaDataComparison() const
+   * Returns true if the metadata are compared (default).
+   */
+  
+  /**
+   * @fn void AcquisitionComparator::SetMetaDataComparison(bool enabled)
+   * Enables or disables the comparison of the metadata.
+   */
+  
+  /**
+   * Compares the acquisition @a tested to the acquisition @a reference. 
+   * Returns true if no difference is found. The differences are given by the method GetDifferences().
+   */
+  bool AcquisitionComparator::Compare(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested)
+  {
+    this->m_Differences.clear();
+    if (!reference || !tested)
+    {
+      btkErrorMacro("Null acquisition.");
+      return false;
+    }
+    this->CompareFrames(reference, tested);
+    this->ComparePoints(reference, tested, std::min(reference->GetPointFrameNumber(), tested->GetPointFrameNumber()));
+    if (reference->GetNumberAnalogSamplePerFrame() == tested->GetNumberAnalogSamplePerFrame())
+      this->CompareAnalogs(reference, tested, std::min(reference->GetAnalogFrameNumber(), tested->GetAnalogFrameNumber()));
+    this->CompareEvents(reference, tested);
+    if (this->m_MetaDataComparison)
+      this->CompareMetaData(reference->GetMetaData(), tested->GetMetaData(), "");
+    return this->m_Differences.empty();
+  };
+  
+  /**
+   * @fn const std::vector<Difference>& AcquisitionComparator::GetDifferences() const
+   * Returns the differences found by the last comparison.
+   */
+  
+  /**
+   * Prints the differences found by the last comparison (one per line).
+   */
+  void AcquisitionComparator::PrintDifferences(std::ostream& os) const
+  {
+    static const char* categories[] = {"Frames", "Point", "Analog", "Event", "MetaData"};
+    for (std::vector<Difference>::const_iterator it = this->m_Differences.begin() ; it != this->m_Differences.end() ; ++it)
+    {
+      os << categories[it->category];
+      if (!it->label.empty())
+        os << " '" << it->label << "'";
+      os << ": ";
+      switch (it->type)
+      {
+      case Difference::Values:
+        if (it->frame != -1)
+          os << it->frameNumber << " frame(s) out of tolerance, first at frame " << it->frame << " (component " << it->component << ")";
+        else if (it->component != -1)
+          os << it->frameNumber << " value(s) out of tolerance, first at index " << it->component;
+        else
+          os << "out of tolerance";
+        os << ", maximum error " << it->maxError;
+        break;
+      case Difference::Property:
+        os << "different " << it->detail;
+        break;
+      case Difference::Missing:
+        os << "missing";
+        break;
+      case Difference::Unexpected:
+        os << "unexpected";
+        break;
+      }
+      if ((it->category == Difference::Event) && !it->detail.empty())
+        os << " (subject '" << it->detail << "')";
+      os << "\n";
+    }
+  };
+  
+  /**
+   * Constructor. The values have to be equal and the metadata are compared.
+   */
+  AcquisitionComparator::AcquisitionComparator()
+  : m_PointTolerance(), m_AnalogTolerance(), m_EventTolerance(), m_MetaDataTolerance(), m_Differences()
+  {
+    this->m_MetaDataComparison = true;
+  };
+  
+  void AcquisitionComparator::CompareFrames(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested)
+  {
+    if (reference->GetFirstFrame() != tested->GetFirstFrame())
+      this->AppendDifference(Difference::Frames, Difference::Property, "", "first frame");
+    if (reference->GetPointFrequency() != tested->GetPointFrequency())
+      this->AppendDifference(Difference::Frames, Difference::Property, "", "frequency");
+    if (reference->GetPointFrameNumber() != tested->GetPointFrameNumber())
+      this->AppendDifference(Difference::Frames, Difference::Property, "", "number of frames");
+    if (reference->GetNumberAnalogSamplePerFrame() != tested->GetNumberAnalogSamplePerFrame())
+      this->AppendDifference(Difference::Frames, Difference::Property, "", "number of analog samples per frame");
+  };
+  
+  void AcquisitionComparator::ComparePoints(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested, int frameNumber)
+  {
+    std::vector<Point::ConstPointer> points(tested->BeginPoint(), tested->EndPoint());
+    std::vector<std::string> labels(points.size());
+    for (size_t i = 0 ; i < points.size() ; ++i)
+      labels[i] = points[i]->GetLabel();
+    _btk_comparator_index index;
+    _btk_comparator_build_index(labels, &index);
+    std::vector<bool> matched(points.size(), false);
+    std::vector<double> buffers(5 * _btk_comparator_chunk);
+    double* r = &(buffers[0]);
+    double* t = r + _btk_comparator_chunk;
+    double* e = t + _btk_comparator_chunk;
+    double* rr = e + _btk_comparator_chunk;
+    double* rt = rr + _btk_comparator_chunk;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (Acquisition::PointConstIterator it = reference->BeginPoint() ; it != reference->EndPoint() ; ++it)
+    {
+      const int idx = _btk_comparator_match(index, labels, (*it)->GetLabel(), &matched);
+      if (idx == -1)
+      {
+        this->AppendDifference(Difference::Point, Difference::Missing, (*it)->GetLabel());
+        continue;
+      }
+      if ((*it)->GetType() != points[idx]->GetType())
+        this->AppendDifference(Difference::Point, Difference::Property, (*it)->GetLabel(), "type");
+      Point::Data::ConstPointer dataR = (*it)->GetData(), dataT = points[idx]->GetData();
+      const int length = std::min(frameNumber, std::min(dataR->GetFrameNumber(), dataT->GetFrameNumber()));
+      _btk_comparator_result result;
+      for (int start = 0 ; start < length ; start += _btk_comparator_chunk)
+      {
+        const int num = std::min(_btk_comparator_chunk, length - start);
+        _btk_comparator_load(_btk_comparator_residual_column(dataR), start, num, rr);
+        _btk_comparator_load(_btk_comparator_residual_column(dataT), start, num, rt);
+        for (int c = 0 ; c < 3 ; ++c)
+        {
+          _btk_comparator_load(_btk_comparator_point_column(dataR, c), start, num, r);
+          _btk_comparator_load(_btk_comparator_point_column(dataT, c), start, num, t);
+          // Occluded in both: not compared. Occluded in only one: always out of tolerance.
+          for (int i = 0 ; i < num ; ++i)
+          {
+            const bool occludedR = (rr[i] < 0.0), occludedT = (rt[i] < 0.0);
+            if (occludedR && occludedT)
+              r[i] = t[i] = 0.0;
+            else if (occludedR != occludedT)
+              t[i] = nan;
+          }
+          _btk_comparator_kernel(r, t, e, start, num, length, c, this->m_PointTolerance, &result);
+        }
+      }
+      if (result.frame != -1)
+        this->AppendDifference(Difference::Point, Difference::Values, (*it)->GetLabel(), "", result.frame, result.component, static_cast<int>(std::count(result.flags.begin(), result.flags.end(), true)), result.maxError);
+    }
+    for (size_t i = 0 ; i < matched.size() ; ++i)
+    {
+      if (!matched[i])
+        this->AppendDifference(Difference::Point, Difference::Unexpected, labels[i]);
+    }
+  };
+  
+  void AcquisitionComparator::CompareAnalogs(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested, int frameNumber)
+  {
+    std::vector<Analog::ConstPointer> analogs(tested->BeginAnalog(), tested->EndAnalog());
+    std::vector<std::string> labels(analogs.size());
+    for (size_t i = 0 ; i < analogs.size() ; ++i)
+      labels[i] = analogs[i]->GetLabel();
+    _btk_comparator_index index;
+    _btk_comparator_build_index(labels, &index);
+    std::vector<bool> matched(analogs.size(), false);
+    std::vector<double> buffers(3 * _btk_comparator_chunk);
+    double* r = &(buffers[0]);
+    double* t = r + _btk_comparator_chunk;
+    double* e = t + _btk_comparator_chunk;
+    for (Acquisition::AnalogConstIterator it = reference->BeginAnalog() ; it != reference->EndAnalog() ; ++it)
+    {
+      const int idx = _btk_comparator_match(index, labels, (*it)->GetLabel(), &matched);
+      if (idx == -1)
+      {
+        this->AppendDifference(Difference::Analog, Difference::Missing, (*it)->GetLabel());
+        continue;
+      }
+      if ((*it)->GetUnit() != analogs[idx]->GetUnit())
+        this->AppendDifference(Difference::Analog, Difference::Property, (*it)->GetLabel(), "unit");
+      Analog::Data::ConstPointer dataR = (*it)->GetData(), dataT = analogs[idx]->GetData();
+      const _btk_comparator_column columnR = _btk_comparator_analog_column(dataR), columnT = _btk_comparator_analog_column(dataT);
+      const int length = std::min(frameNumber, std::min(dataR->GetFrameNumber(), dataT->GetFrameNumber()));
+      _btk_comparator_result result;
+      for (int start = 0 ; start < length ; start += _btk_comparator_chunk)
+      {
+        const int num = std::min(_btk_comparator_chunk, length - start);
+        _btk_comparator_load(columnR, start, num, r);
+        _btk_comparator_load(columnT, start, num, t);
+        _btk_comparator_kernel(r, t, e, start, num, length, 0, this->m_AnalogTolerance, &result);
+      }
+      if (result.frame != -1)
+        this->AppendDifference(Difference::Analog, Difference::Values, (*it)->GetLabel(), "", result.frame, result.component, static_cast<int>(std::count(result.flags.begin(), result.flags.end(), true)), result.maxError);
+    }
+    for (size_t i = 0 ; i < matched.size() ; ++i)
+    {
+      if (!matched[i])
+        this->AppendDifference(Difference::Analog, Difference::Unexpected, labels[i]);
+    }
+  };
+  
+  void AcquisitionComparator::CompareEvents(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested)
+  {
+    std::vector<_btk_comparator_event> eventsR, eventsT;
+    _btk_comparator_events(reference, &eventsR);
+    _btk_comparator_events(tested, &eventsT);
+    // Both lists are sorted by context, label, subject and time: the events of a same kind are paired in time order.
+    size_t i = 0, j = 0;
+    while ((i < eventsR.size()) || (j < eventsT.size()))
+    {
+      const int c = (i == eventsR.size()) ? 1 : ((j == eventsT.size()) ? -1 : eventsR[i].Compare(eventsT[j]));
+      if (c < 0)
+      {
+        this->AppendDifference(Difference::Event, Difference::Missing, eventsR[i].context + ":" + eventsR[i].label, eventsR[i].subject);
+        ++i;
+      }
+      else if (c > 0)
+      {
+        this->AppendDifference(Difference::Event, Difference::Unexpected, eventsT[j].context + ":" + eventsT[j].label, eventsT[j].subject);
+        ++j;
+      }
+      else
+      {
+        const double error = std::fabs(eventsT[j].time - eventsR[i].time);
+        if (!(error <= this->m_EventTolerance.absolute + this->m_EventTolerance.relative * std::fabs(eventsR[i].time)))
+          this->AppendDifference(Difference::Event, Difference::Values, eventsR[i].context + ":" + eventsR[i].label, eventsR[i].subject, -1, -1, 1, error);
+        ++i; ++j;
+      }
+    }
+  };
+  
+  void AcquisitionComparator::CompareMetaData(MetaData::ConstPointer reference, MetaData::ConstPointer tested, const std::string& path)
+  {
+    if (reference->HasInfo() != tested->HasInfo())
+      this->AppendDifference(Difference::MetaData, Difference::Property, path, "values");
+    else if (reference->HasInfo())
+    {
+      MetaDataInfo::ConstPointer infoR = reference->GetInfo(), infoT = tested->GetInfo();
+      if (infoR->GetFormat() != infoT->GetFormat())
+        this->AppendDifference(Difference::MetaData, Difference::Property, path, "format");
+      else if (infoR->GetDimensions() != infoT->GetDimensions())
+        this->AppendDifference(Difference::MetaData, Difference::Property, path, "dimensions");
+      else
+      {
+        const int num = static_cast<int>(infoR->GetValues().size());
+        int first = -1, count = 0;
+        double maxError = 0.0;
+        for (int i = 0 ; i < num ; ++i)
+        {
+          bool equal = true;
+          if (infoR->GetFormat() == MetaDataInfo::Char)
+            equal = (infoR->ToString(i) == infoT->ToString(i));
+          else
+          {
+            const double r = infoR->ToDouble(i), error = std::fabs(infoT->ToDouble(i) - r);
+            equal = (error <= this->m_MetaDataTolerance.absolute + this->m_MetaDataTolerance.relative * std::fabs(r));
+            if (error <= std::numeric_limits<double>::max())
+              maxError = std::max(maxError, error);
+          }
+          if (!equal)
+          {
+            if (first == -1)
+              first = i;
+            ++count;
+          }
+        }
+        if (count != 0)
+          this->AppendDifference(Difference::MetaData, Difference::Values, path, "", -1, first, count, maxError);
+      }
+    }
+    std::vector<MetaData::ConstPointer> children(tested->Begin(), tested->End());
+    std::vector<std::string> labels(children.size());
+    for (size_t i = 0 ; i < children.size() ; ++i)
+      labels[i] = children[i]->GetLabel();
+    _btk_comparator_index index;
+    _btk_comparator_build_index(labels, &index);
+    std::vector<bool> matched(children.size(), false);
+    const std::string prefix = path.empty() ? path : path + ":";
+    for (MetaData::ConstIterator it = reference->Begin() ; it != reference->End() ; ++it)
+    {
+      const int idx = _btk_comparator_match(index, labels, (*it)->GetLabel(), &matched);
+      if (idx == -1)
+        this->AppendDifference(Difference::MetaData, Difference::Missing, prefix + (*it)->GetLabel());
+      else
+        this->CompareMetaData(*it, children[idx], prefix + (*it)->GetLabel());
+    }
+    for (size_t i = 0 ; i < matched.size() ; ++i)
+    {
+      if (!matched[i])
+        this->AppendDifference(Difference::MetaData, Difference::Unexpected, prefix + labels[i]);
+    }
+  };
+  
+  void AcquisitionComparator::AppendDifference(Difference::Category category, Difference::Type type, const std::string& label, const std::string& detail, int frame, int component, int frameNumber, double maxError)
+  {
+    Difference diff;
+    diff.category = category;
+    diff.type = type;
+    diff.label = label;
+    diff.detail = detail;
+    diff.frame = frame;
+    diff.component = component;
+    diff.frameNumber = frameNumber;
+    diff.maxError = maxError;
+    this->m_Differences.push_back(diff);
+  };
+};
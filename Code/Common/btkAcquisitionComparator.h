@@ -0,0 +1,121 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkAcquisitionComparator_h
+#define __btkAcquisitionComparator_h
+
+#include "btkAcquisition.h"
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace btk
+{
+  class AcquisitionComparator
+  {
+  public:
+    typedef btkSharedPtr<AcquisitionComparator> Pointer;
+    typedef btkSharedPtr<const AcquisitionComparator> ConstPointer;
+    typedef btkNullPtr<AcquisitionComparator> NullPointer;
+    
+    struct Tolerance
+    {
+      Tolerance(double a = 0.0, double r = 0.0) : absolute(a), relative(r) {};
+      double absolute;
+      double relative;
+    };
+    
+    struct Difference
+    {
+      typedef enum {Frames = 0, Point, Analog, Event, MetaData} Category;
+      typedef enum {Values = 0, Property, Missing, Unexpected} Type;
+      Category category;
+      Type type;
+      std::string label;
+      std::string detail;
+      int frame;
+      int component;
+      int frameNumber;
+      double maxError;
+    };
+    
+    static Pointer New() {return Pointer(new AcquisitionComparator());};
+    static NullPointer Null() {return NullPointer();};
+    
+    // ~AcquisitionComparator(); // Implicit.
+    
+    const Tolerance& GetPointTolerance() const {return this->m_PointTolerance;};
+    void SetPointTolerance(const Tolerance& tol) {this->m_PointTolerance = tol;};
+    const Tolerance& GetAnalogTolerance() const {return this->m_AnalogTolerance;};
+    void SetAnalogTolerance(const Tolerance& tol) {this->m_AnalogTolerance = tol;};
+    const Tolerance& GetEventTolerance() const {return this->m_EventTolerance;};
+    void SetEventTolerance(const Tolerance& tol) {this->m_EventTolerance = tol;};
+    const Tolerance& GetMetaDataTolerance() const {return this->m_MetaDataTolerance;};
+    void SetMetaDataTolerance(const Tolerance& tol) {this->m_MetaDataTolerance = tol;};
+    bool GetMetaDataComparison() const {return this->m_MetaDataComparison;};
+    void SetMetaDataComparison(bool enabled) {this->m_MetaDataComparison = enabled;};
+    
+    BTK_COMMON_EXPORT bool Compare(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested);
+    const std::vector<Difference>& GetDifferences() const {return this->m_Differences;};
+    BTK_COMMON_EXPORT void PrintDifferences(std::ostream& os) const;
+    
+  protected:
+    BTK_COMMON_EXPORT AcquisitionComparator();
+    
+  private:
+    AcquisitionComparator(const AcquisitionComparator& ); // Not implemented.
+    AcquisitionComparator& operator=(const AcquisitionComparator& ); // Not implemented.
+    
+    void CompareFrames(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested);
+    void ComparePoints(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested, int frameNumber);
+    void CompareAnalogs(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested, int frameNumber);
+    void CompareEvents(Acquisition::ConstPointer reference, Acquisition::ConstPointer tested);
+    void CompareMetaData(MetaData::ConstPointer reference, MetaData::ConstPointer tested, const std::string& path);
+    void AppendDifference(Difference::Category category, Difference::Type type, const std::string& label, const std::string& detail = "", int frame = -1, int component = -1, int frameNumber = 0, double maxError = 0.0);
+    
+    Tolerance m_PointTolerance;
+    Tolerance m_AnalogTolerance;
+    Tolerance m_EventTolerance;
+    Tolerance m_MetaDataTolerance;
+    bool m_MetaDataComparison;
+    std::vector<Difference> m_Differences;
+  };
+};
+
+#endif // __btkAcquisitionComparator_h
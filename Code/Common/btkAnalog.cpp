@@ -34,6 +34,7 @@
  */
 
 #include "btkAnalog.h"
+#include "btkAnalogBlock.h"
 
 namespace btk
 {
@@ -270,6 +271,28 @@ namespace btk
     this->m_Scale = s;
     this->Modified();
   };
+  
+  /**
+   * Adds the label, the description, the unit, the gain, the offset, the scale and the samples of this channel to the digest @a hash.
+   */
+  bool Analog::HashContent(Hash* hash) const
+  {
+    hash->Add(this->m_Unit);
+    hash->Add(static_cast<int>(this->m_Gain));
+    hash->Add(this->m_Offset);
+    hash->Add(this->m_Scale);
+    return this->Measure<Analog>::HashContent(hash);
+  };
+  
+  /**
+   * Adds the memory used by this channel, its unit and its samples to @a usage.
+   */
+  void Analog::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Analog));
+    usage->Add(MemoryUsage::Strings, this->m_Unit);
+    this->Measure<Analog>::AddMemoryUsage(usage);
+  };
 
   /**
    * @fn Pointer Analog::Clone() const
@@ -361,7 +384,138 @@ namespace btk
   
   /**
    * @fn MeasureTraits<Analog>::Data::Pointer MeasureTraits<Analog>::Data::Clone() const
-   * Deep copy of the current object.
+   * Deep copy of the current object. The values of the copy are never shared with a btk::AnalogBlock object.
    */
+  
+  /**
+   * @typedef MeasureTraits<Analog>::Data::RawValues
+   * Raw samples (i.e. the counts of the analog to digital converter) of an analog channel.
+   */
+  
+  /**
+   * @fn virtual int MeasureTraits<Analog>::Data::GetFrameNumber() const
+   * Returns the number of frames, without converting the values stored in a compact form (raw samples or single precision).
+   */
+  
+  /**
+   * @fn bool MeasureTraits<Analog>::Data::IsRaw() const
+   * Returns true if the values are stored as raw samples (see SetRawStorage()).
+   */
+  
+  /**
+   * @fn RawValues& MeasureTraits<Analog>::Data::GetRawValues()
+   * Returns the raw samples. This storage is empty if the method IsRaw() returns false.
+   * This method is mostly used by the file readers to fill directly the raw samples.
+   */
+  
+  /**
+   * @fn const RawValues& MeasureTraits<Analog>::Data::GetRawValues() const
+   * Returns the raw samples. This storage is empty if the method IsRaw() returns false.
+   * This method is mostly used by the file writers to save the samples without any quantization error.
+   */
+  
+  /**
+   * @fn double MeasureTraits<Analog>::Data::GetRawOffset() const
+   * Returns the offset used to scale the raw samples.
+   */
+  
+  /**
+   * @fn bool MeasureTraits<Analog>::Data::HashContent(Hash* hash) const
+   * Adds the samples to the digest @a hash, always converted in double precision. The digest does not depend on the form used to store them (raw, single or double precision).
+   */
+  
+  /**
+   * Adds the memory used by the samples, in the form used to store them (raw, single or double precision), to @a usage.
+   * A block of channels (see AnalogBlock) is counted once, with the first channel viewing it.
+   */
+  void MeasureTraits<Analog>::Data::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Data));
+    usage->Add(MemoryUsage::Values, sizeof(int16_t) * this->m_RawValues.size());
+    AnalogBlock::Pointer block = this->GetBlock();
+    if (block)
+    {
+      usage->Add(MemoryUsage::Values, sizeof(float) * this->m_SingleValues.size());
+      usage->AddShared(MemoryUsage::Values, block.get(), sizeof(AnalogBlock) + sizeof(double) * block->GetFrameNumber() * block->GetChannelNumber());
+    }
+    else
+      this->MeasureData<Analog>::AddMemoryUsage(usage);
+  };
+  
+  /**
+   * @fn double MeasureTraits<Analog>::Data::GetRawScale() const
+   * Returns the scale used to scale the raw samples.
+   */
+  
+  /**
+   * Returns the block storing the values of this channel or a null pointer if the values are not stored in a btk::AnalogBlock object.
+   */
+  btkSharedPtr<AnalogBlock> MeasureTraits<Analog>::Data::GetBlock() const
+  {
+    if (!this->m_Values.IsShared() || (this->m_Values.GetOwner().get() != static_cast<const void*>(this->mp_Block)))
+      return AnalogBlock::Pointer();
+    return static_pointer_cast<AnalogBlock>(this->m_Values.GetOwner());
+  };
+  
+  /**
+   * Sets the values of this channel as a view over the column @a channel of the given @a block.
+   * The content of the values is not copied into the block. 
+   * Use the method btk::AnalogBlock::Pack() to store the channels of a collection into a block.
+   */
+  void MeasureTraits<Analog>::Data::SetBlock(btkSharedPtr<AnalogBlock> block, int channel)
+  {
+    if (!block || (channel < 0) || (channel >= block->GetChannelNumber()))
+    {
+      btkErrorMacro("Invalid block or channel index.");
+      return;
+    }
+    // The samples stored in a compact form are discarded
+    this->m_RawValues.resize(0);
+    this->m_SingleValues.resize(0, 1);
+    this->m_Raw = false;
+    this->m_SinglePrecision = false;
+    this->m_Compacted = false;
+    this->m_Values.Share(block->GetData() + channel * block->GetChannelStride(), block->GetFrameNumber(), 1, Eigen::InnerStride<>(block->GetFrameStride()), block);
+    this->mp_Block = block.get();
+    this->Modified();
+  };
+  
+  /**
+   * Stores the values as raw samples (16-bit integers) to divide by four the memory used.
+   * The values are given by the formula <tt>(raw - offset) * scale</tt>. The current values are quantized with the given @a offset and @a scale.
+   *
+   * The raw samples are converted in double precision (and stored in double precision) as soon as the values are accessed with a non const method (for example GetValues()).
+   * The const accessors never convert them. Until then, a file writer can save them without any quantization error (see GetRawValues()).
+   */
+  void MeasureTraits<Analog>::Data::SetRawStorage(double offset, double scale)
+  {
+    if (scale == 0.0)
+    {
+      btkErrorMacro("The scale of the raw samples cannot be null.");
+      return;
+    }
+    const Values& values = this->GetValues();
+    RawValues raw(values.rows());
+    for (int i = 0 ; i < raw.rows() ; ++i)
+      raw.coeffRef(i) = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, floor(values.coeff(i) / scale + offset + 0.5))));
+    this->m_RawValues.swap(raw);
+    this->m_Values.resize(0, 1);
+    this->m_RawOffset = offset;
+    this->m_RawScale = scale;
+    this->m_Raw = true;
+    this->m_Compacted = true;
+    this->Modified();
+  };
+  
+  /**
+   * Converts the raw samples in double precision. Nothing is done if the values are not stored as raw samples.
+   */
+  void MeasureTraits<Analog>::Data::ReleaseRawStorage()
+  {
+    if (!this->m_Raw)
+      return;
+    this->ExpandValues();
+    this->Modified();
+  };
 }
 
@@ -37,15 +37,27 @@
 #define __btkAnalog_h
 
 #include "btkMeasure.h"
+#include "btkMeasureValues.h"
+
+#if defined(_MSC_VER)
+  // MSVC doesn't have the header stdint.h
+  #include "Utilities/msvc_stdint.h"
+#else
+  #include <stdint.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
 
 namespace btk
 {
   class Analog;
+  class AnalogBlock;
   
   template <>
   struct MeasureTraits<Analog>
   {
-    typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Values; ///< Analog's  values along the time with 1 components (1 column).
+    typedef MeasureValues<Eigen::Matrix<double, Eigen::Dynamic, 1>, Eigen::InnerStride<> > Values; ///< Analog's  values along the time with 1 components (1 column).
     
    /**
     * @class Data
@@ -54,6 +66,8 @@ namespace btk
    class Data : public MeasureData<Analog>
     {
     public:
+      typedef Eigen::Matrix<int16_t, Eigen::Dynamic, 1> RawValues; ///< Raw samples of the analog channel (ADC counts).
+      
       typedef btkSharedPtr<Data> Pointer;
       typedef btkSharedPtr<const Data> ConstPointer;
       typedef btkNullPtr<Data> NullPointer;
@@ -63,13 +77,38 @@ namespace btk
       static NullPointer Null() {return NullPointer();}; 
       
       void Resize(int frameNumber);
+      virtual int GetFrameNumber() const {return static_cast<int>(this->m_Raw ? this->m_RawValues.rows() : this->MeasureData<Analog>::GetFrameNumber());};
       
       Pointer Clone() const {return Pointer(new Data(*this));}
       
+      BTK_COMMON_EXPORT btkSharedPtr<AnalogBlock> GetBlock() const;
+      BTK_COMMON_EXPORT void SetBlock(btkSharedPtr<AnalogBlock> block, int channel);
+      
+      bool IsRaw() const {return this->m_Raw;};
+      BTK_COMMON_EXPORT void SetRawStorage(double offset, double scale);
+      BTK_COMMON_EXPORT void ReleaseRawStorage();
+      RawValues& GetRawValues() {return this->m_RawValues;};
+      const RawValues& GetRawValues() const {return this->m_RawValues;};
+      double GetRawOffset() const {return this->m_RawOffset;};
+      double GetRawScale() const {return this->m_RawScale;};
+      
+      virtual bool HashContent(Hash* hash) const;
+      BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+      
+    protected:
+      virtual void CompactValues();
+      virtual void ExpandValues();
+      
     private:
-      Data(int frameNumber) : MeasureData<Analog>(frameNumber) {};
-      Data(const Data& toCopy) : MeasureData<Analog>(toCopy) {};
+      Data(int frameNumber) : MeasureData<Analog>(frameNumber), mp_Block(0), m_RawValues(), m_RawOffset(0.0), m_RawScale(1.0), m_Raw(false) {};
+      Data(const Data& toCopy) : MeasureData<Analog>(toCopy), mp_Block(0), m_RawValues(toCopy.m_RawValues), m_RawOffset(toCopy.m_RawOffset), m_RawScale(toCopy.m_RawScale), m_Raw(toCopy.m_Raw) {};
       Data& operator=(const Data& ); // Not implemented.
+      
+      const AnalogBlock* mp_Block;
+      RawValues m_RawValues;
+      double m_RawOffset;
+      double m_RawScale;
+      bool m_Raw;
     };
   };
   
@@ -107,6 +146,9 @@ namespace btk
 
     void SetDataSlice(int frame, double val);
     
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
     Pointer Clone() const {return Pointer(new Analog(*this));}
     
   protected:
@@ -132,15 +174,53 @@ namespace btk
   
   inline void MeasureTraits<Analog>::Data::Resize(int frameNumber)
   {
-    if (frameNumber > this->m_Values.rows())
+    const int num = this->GetFrameNumber();
+    if (this->m_Raw)
+    {
+      this->m_RawValues.conservativeResize(frameNumber);
+      if (frameNumber > num) // Raw sample corresponding to a null value (as much as possible)
+        this->m_RawValues.segment(num, frameNumber - num).setConstant(static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, floor(this->m_RawOffset + 0.5)))));
+      return;
+    }
+    if (this->m_SinglePrecision)
+    {
+      this->m_SingleValues.conservativeResize(frameNumber);
+      if (frameNumber > num)
+        this->m_SingleValues.segment(num, frameNumber - num).setZero();
+      return;
+    }
+    this->m_Values.conservativeResize(frameNumber);
+    if (frameNumber > num)
+      this->m_Values.segment(num, frameNumber - num).setZero();
+  };
+  
+  inline bool MeasureTraits<Analog>::Data::HashContent(Hash* hash) const
+  {
+    if (!this->m_Raw)
+      return this->MeasureData<Analog>::HashContent(hash);
+    // Same conversion than ExpandValues().
+    hash->AddMatrixAs<double>(((this->m_RawValues.cast<double>().array() - this->m_RawOffset) * this->m_RawScale).matrix());
+    return true;
+  };
+  
+  inline void MeasureTraits<Analog>::Data::CompactValues()
+  {
+    if (this->m_Raw)
+      this->ExpandValues();
+    this->MeasureData<Analog>::CompactValues();
+  };
+  
+  inline void MeasureTraits<Analog>::Data::ExpandValues()
+  {
+    if (!this->m_Raw)
     {
-      Values v = Values::Zero(frameNumber,Values::ColsAtCompileTime);
-      if (this->m_Values.data() != 0)
-        v.block(0,0,this->m_Values.rows(),Values::ColsAtCompileTime) = this->m_Values;
-      this->m_Values = v;
+      this->MeasureData<Analog>::ExpandValues();
+      return;
     }
-    else
-      this->m_Values.conservativeResize(frameNumber);
+    this->m_Values = ((this->m_RawValues.cast<double>().array() - this->m_RawOffset) * this->m_RawScale).matrix();
+    this->m_RawValues.resize(0);
+    this->m_Raw = false;
+    this->m_Compacted = false;
   };
 };
 
@@ -0,0 +1,269 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkAnalogBlock.h"
+
+#include <algorithm>
+
+namespace btk
+{
+  /**
+   * @class AnalogBlock btkAnalogBlock.h
+   * @brief Contiguous storage of the values of several analog channels.
+   *
+   * The samples of several analog channels are stored in a single memory buffer, as a matrix where each row is a frame and each column a channel.
+   * The buffer can be organized by channels (AnalogBlock::ColumnMajor) or by frames (AnalogBlock::RowMajor). 
+   * The latter corresponds to the order of the samples in most of the file formats (e.g. C3D) and gives sequential writes when a file is read.
+   *
+   * The channels of a collection are stored in a block using the method Pack(). 
+   * Each btk::Analog object keeps its own values (Analog::GetValues()), but these values are then only a view (with a stride) over a column of the block.
+   * The method GetMatrix() gives access to all the channels as one matrix, which can be used by filters to process several channels at once (e.g. with one matrix product).
+   * The method Find() returns the block (if any) storing consecutively the channels of a collection.
+   *
+   * A block is kept alive by the channels referencing it. Resizing a channel or assigning it values with another number of frames detaches it from the block.
+   *
+   * @sa Acquisition::SetAnalogStorage
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @enum AnalogBlock::Layout
+   * Organization of the samples in the memory.
+   */
+  /**
+   * @var AnalogBlock::Layout AnalogBlock::ColumnMajor
+   * The samples of one channel are consecutive in the memory.
+   */
+  /**
+   * @var AnalogBlock::Layout AnalogBlock::RowMajor
+   * The samples of one frame (for all the channels) are consecutive in the memory.
+   */
+  
+  /**
+   * @typedef AnalogBlock::Matrix
+   * Matrix (frames x channels) mapping the memory of the block.
+   */
+  
+  /**
+   * @typedef AnalogBlock::ConstMatrix
+   * Constant matrix (frames x channels) mapping the memory of the block.
+   */
+  
+  /**
+   * @typedef AnalogBlock::Pointer
+   * Smart pointer associated with an AnalogBlock object.
+   */
+  
+  /**
+   * @typedef AnalogBlock::ConstPointer
+   * Smart pointer associated with a const AnalogBlock object.
+   */
+  
+  /**
+   * @typedef AnalogBlock::NullPointer
+   * Special null pointer associated with an AnalogBlock object.
+   * This type should be used only internally to test the nullity of a smart pointer.
+   * See the static method Null() instead.
+   */
+  
+  /**
+   * @fn static Pointer AnalogBlock::New(int frameNumber, int channelNumber, Layout layout = ColumnMajor)
+   * Creates a smart pointer associated with an AnalogBlock object. The samples are set to 0.
+   */
+  
+  /**
+   * @fn static NullPointer AnalogBlock::Null()
+   * Static function to return a null pointer.
+   */
+  
+  /**
+   * Copy the values of the channels contained in @a analogs into a new block and then set these channels as views over the columns of the block.
+   *
+   * All the channels must have the same number of frames. Otherwise, an error is triggered, the channels are not modified and a null pointer is returned.
+   * A null pointer is also returned if the collection is empty or if the channels have no frame.
+   */
+  AnalogBlock::Pointer AnalogBlock::Pack(AnalogCollection::Pointer analogs, Layout layout)
+  {
+    if (!analogs || analogs->IsEmpty())
+      return AnalogBlock::Pointer();
+    int frameNumber = analogs->GetFrontItem()->GetFrameNumber();
+    for (AnalogCollection::ConstIterator it = analogs->Begin() ; it != analogs->End() ; ++it)
+    {
+      if ((*it)->GetFrameNumber() != frameNumber)
+      {
+        btkErrorMacro("Impossible to store in one block analog channels with different number of frames.");
+        return AnalogBlock::Pointer();
+      }
+    }
+    if (frameNumber == 0)
+      return AnalogBlock::Pointer();
+    AnalogBlock::Pointer block = AnalogBlock::New(frameNumber, analogs->GetItemNumber(), layout);
+    AnalogBlock::Matrix m = block->GetMatrix();
+    int channel = 0;
+    for (AnalogCollection::ConstIterator it = analogs->Begin() ; it != analogs->End() ; ++it)
+    {
+      m.col(channel) = (*it)->GetValues();
+      (*it)->GetData()->SetBlock(block, channel);
+      ++channel;
+    }
+    return block;
+  };
+  
+  /**
+   * Copy the values of the channels contained in @a analogs which are stored in a block in their own memory.
+   */
+  void AnalogBlock::Unpack(AnalogCollection::Pointer analogs)
+  {
+    if (!analogs)
+      return;
+    for (AnalogCollection::ConstIterator it = analogs->Begin() ; it != analogs->End() ; ++it)
+    {
+      if ((*it)->GetData() && (*it)->GetData()->GetBlock())
+        (*it)->GetValues().Detach();
+    }
+  };
+  
+  /**
+   * Returns the block storing consecutively (and in the same order) all the channels contained in @a analogs.
+   * The optional argument @a first is set with the index of the column in the block corresponding to the first channel.
+   * If the channels are not stored in the same block, then a null pointer is returned.
+   */
+  AnalogBlock::Pointer AnalogBlock::Find(AnalogCollection::ConstPointer analogs, int* first)
+  {
+    if (!analogs || analogs->IsEmpty() || !analogs->GetFrontItem()->GetData())
+      return AnalogBlock::Pointer();
+    AnalogBlock::Pointer block = analogs->GetFrontItem()->GetData()->GetBlock();
+    if (!block)
+      return AnalogBlock::Pointer();
+    int channel = static_cast<int>(analogs->GetFrontItem()->GetValues().data() - block->GetData()) / block->GetChannelStride();
+    if (channel + analogs->GetItemNumber() > block->GetChannelNumber())
+      return AnalogBlock::Pointer();
+    if (first != 0)
+      *first = channel;
+    for (AnalogCollection::ConstIterator it = analogs->Begin() ; it != analogs->End() ; ++it)
+    {
+      if (!(*it)->GetData() 
+          || ((*it)->GetData()->GetBlock() != block)
+          || ((*it)->GetValues().data() != block->GetData() + channel * block->GetChannelStride()))
+        return AnalogBlock::Pointer();
+      ++channel;
+    }
+    return block;
+  };
+  
+  /**
+   * Destructor. Free the memory used by the samples.
+   */
+  AnalogBlock::~AnalogBlock()
+  {
+    delete[] this->mp_Data;
+  };
+  
+  /**
+   * @fn int AnalogBlock::GetFrameNumber() const
+   * Returns the number of frames (rows) stored in the block.
+   */
+  
+  /**
+   * @fn int AnalogBlock::GetChannelNumber() const
+   * Returns the number of channels (columns) stored in the block.
+   */
+  
+  /**
+   * @fn Layout AnalogBlock::GetLayout() const
+   * Returns the organization of the samples in the memory.
+   */
+  
+  /**
+   * @fn int AnalogBlock::GetFrameStride() const
+   * Returns the distance in the memory between two consecutive frames of a channel.
+   */
+  
+  /**
+   * @fn int AnalogBlock::GetChannelStride() const
+   * Returns the distance in the memory between the first sample of two consecutive channels.
+   */
+  
+  /**
+   * @fn double* AnalogBlock::GetData()
+   * Returns the pointer to the first sample of the block.
+   */
+  
+  /**
+   * @fn const double* AnalogBlock::GetData() const
+   * Returns the pointer to the first sample of the block.
+   */
+  
+  /**
+   * @fn Matrix AnalogBlock::GetMatrix()
+   * Returns a matrix (frames x channels) mapping all the samples of the block.
+   */
+  
+  /**
+   * @fn ConstMatrix AnalogBlock::GetMatrix() const
+   * Returns a matrix (frames x channels) mapping all the samples of the block.
+   */
+  
+  /**
+   * Returns a matrix mapping the @a num consecutive channels starting at the channel @a first.
+   * @warning There is no checking on the given indices.
+   */
+  AnalogBlock::Matrix AnalogBlock::GetChannels(int first, int num)
+  {
+    return Matrix(this->mp_Data + first * this->GetChannelStride(), this->m_FrameNumber, num, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(this->GetChannelStride(), this->GetFrameStride()));
+  };
+  
+  /**
+   * Returns a constant matrix mapping the @a num consecutive channels starting at the channel @a first.
+   * @warning There is no checking on the given indices.
+   */
+  AnalogBlock::ConstMatrix AnalogBlock::GetChannels(int first, int num) const
+  {
+    return ConstMatrix(this->mp_Data + first * this->GetChannelStride(), this->m_FrameNumber, num, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(this->GetChannelStride(), this->GetFrameStride()));
+  };
+  
+  /**
+   * Constructor. The samples are set to 0.
+   */
+  AnalogBlock::AnalogBlock(int frameNumber, int channelNumber, Layout layout)
+  {
+    this->m_FrameNumber = frameNumber;
+    this->m_ChannelNumber = channelNumber;
+    this->m_Layout = layout;
+    this->mp_Data = new double[frameNumber * channelNumber];
+    std::fill(this->mp_Data, this->mp_Data + frameNumber * channelNumber, 0.0);
+  };
+};
@@ -0,0 +1,93 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkAnalogBlock_h
+#define __btkAnalogBlock_h
+
+#include "btkAnalogCollection.h"
+
+namespace btk
+{
+  class AnalogBlock
+  {
+  public:
+    typedef enum {ColumnMajor = 0, RowMajor} Layout;
+    
+    typedef Eigen::Map<Eigen::MatrixXd, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > Matrix;
+    typedef Eigen::Map<const Eigen::MatrixXd, Eigen::Unaligned, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> > ConstMatrix;
+    
+    typedef btkSharedPtr<AnalogBlock> Pointer;
+    typedef btkSharedPtr<const AnalogBlock> ConstPointer;
+    typedef btkNullPtr<AnalogBlock> NullPointer;
+    
+    static Pointer New(int frameNumber, int channelNumber, Layout layout = ColumnMajor) {return Pointer(new AnalogBlock(frameNumber, channelNumber, layout));};
+    static NullPointer Null() {return NullPointer();};
+    
+    BTK_COMMON_EXPORT static Pointer Pack(AnalogCollection::Pointer analogs, Layout layout = ColumnMajor);
+    BTK_COMMON_EXPORT static void Unpack(AnalogCollection::Pointer analogs);
+    BTK_COMMON_EXPORT static Pointer Find(AnalogCollection::ConstPointer analogs, int* first = 0);
+    
+    BTK_COMMON_EXPORT ~AnalogBlock();
+    
+    int GetFrameNumber() const {return this->m_FrameNumber;};
+    int GetChannelNumber() const {return this->m_ChannelNumber;};
+    Layout GetLayout() const {return this->m_Layout;};
+    int GetFrameStride() const {return (this->m_Layout == ColumnMajor) ? 1 : this->m_ChannelNumber;};
+    int GetChannelStride() const {return (this->m_Layout == ColumnMajor) ? this->m_FrameNumber : 1;};
+    
+    double* GetData() {return this->mp_Data;};
+    const double* GetData() const {return this->mp_Data;};
+    
+    Matrix GetMatrix() {return this->GetChannels(0, this->m_ChannelNumber);};
+    ConstMatrix GetMatrix() const {return this->GetChannels(0, this->m_ChannelNumber);};
+    BTK_COMMON_EXPORT Matrix GetChannels(int first, int num);
+    BTK_COMMON_EXPORT ConstMatrix GetChannels(int first, int num) const;
+    
+  protected:
+    BTK_COMMON_EXPORT AnalogBlock(int frameNumber, int channelNumber, Layout layout);
+    
+  private:
+    AnalogBlock(const AnalogBlock& ); // Not implemented.
+    AnalogBlock& operator=(const AnalogBlock& ); // Not implemented.
+    
+    int m_FrameNumber;
+    int m_ChannelNumber;
+    Layout m_Layout;
+    double* mp_Data;
+  };
+};
+
+#endif // __btkAnalogBlock_h
@@ -0,0 +1,386 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkAsyncUpdate.h"
+#include "btkThreadPool_p.h"
+#include "btkMemoryArena.h"
+#include "btkLogger.h"
+
+namespace btk
+{
+  struct AsyncUpdate::Task
+  {
+    ProcessObject::Pointer process;
+    thread_pool_p* pool;
+    thread_pool_p::group group;
+    MemoryArena* arena;
+    critical_section_p lock;
+    State state;
+    double progress;
+    bool cancelled; // Cancellation requested.
+    bool interrupted; // Cancellation detected during the update.
+    std::string error;
+  };
+  
+  // Pool shared by the asynchronous updates and number of updates using it.
+  static thread_pool_p* _btk_async_pool = 0;
+  static int _btk_async_thread_number = 0;
+  static int _btk_async_tasks = 0;
+  static critical_section_p _btk_async_lock;
+  // Asynchronous update executed by the current thread (if any).
+  static btkThreadLocal void* _btk_async_current = 0;
+  
+  // The threads are stopped at the exit of the program if no update is still referenced.
+  struct _btk_async_exit
+  {
+    ~_btk_async_exit()
+    {
+      _btk_async_lock.Lock();
+      if (_btk_async_tasks == 0)
+      {
+        delete _btk_async_pool;
+        _btk_async_pool = 0;
+      }
+      _btk_async_lock.Unlock();
+    };
+  };
+  static _btk_async_exit _btk_async_exit_guard;
+  
+  // Must be called with the lock acquired.
+  static thread_pool_p* _btk_async_get_pool()
+  {
+    if (_btk_async_pool == 0)
+      _btk_async_pool = new thread_pool_p(_btk_async_thread_number);
+    return _btk_async_pool;
+  };
+  
+  /**
+   * @class AsyncUpdateCancelled btkAsyncUpdate.h
+   * @brief Exception thrown by AsyncUpdate::ReportProgress() when the cancellation of the update is requested.
+   */
+  
+  /**
+   * @fn AsyncUpdateCancelled::AsyncUpdateCancelled(const std::string& msg)
+   * Constructor.
+   */
+  
+  /**
+   * @fn virtual AsyncUpdateCancelled::~AsyncUpdateCancelled()
+   * Empty destructor.
+   */
+  
+  /**
+   * @class AsyncUpdate btkAsyncUpdate.h
+   * @brief Updates a process in a background thread.
+   *
+   * The method ProcessObject::Update() blocks the calling thread until the data are generated. 
+   * For example, the reading of a file with an AcquisitionFileReader object blocks the thread during 
+   * the whole disk access. This class updates a process with one of the threads of a pool shared 
+   * by all the asynchronous updates. The returned object is a handle to follow the progress of the update, 
+   * to cancel it or to wait for its end. A GUI or a service can then read the next trial while the current one is processed.
+   *
+   * @code
+   * btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+   * reader->SetFilename("trial02.c3d");
+   * btk::AsyncUpdate::Pointer update = btk::AsyncUpdate::New(reader);
+   * ... // Process the previous trial
+   * update->Wait(); // Throws an exception if the reading failed.
+   * btk::Acquisition::Pointer acq = reader->GetOutput();
+   * @endcode
+   *
+   * The progress is reported by the long loops of the processes and the file IOs (e.g. the loops 
+   * over the frames of the C3DFileIO class) with the method ReportProgress(). These calls are also 
+   * the points where the update is interrupted when its cancellation is requested.
+   *
+   * The thread updating the process uses the memory arena set for the thread creating the handle (see MemoryArena::Scope).
+   * This arena is kept alive by the handle: the scope setting it can end before the end of the update.
+   *
+   * @warning The process and its inputs must not be modified or updated by another thread before the end of the asynchronous update.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @var AsyncUpdate::State AsyncUpdate::Pending
+   * The update is waiting for a thread.
+   */
+  /**
+   * @var AsyncUpdate::State AsyncUpdate::Running
+   * The process is being updated.
+   */
+  /**
+   * @var AsyncUpdate::State AsyncUpdate::Finished
+   * The process was updated.
+   */
+  /**
+   * @var AsyncUpdate::State AsyncUpdate::Failed
+   * An exception was thrown during the update (see GetErrorMessage()).
+   */
+  /**
+   * @var AsyncUpdate::State AsyncUpdate::Cancelled
+   * The update was cancelled before its start or interrupted.
+   */
+  
+  /**
+   * @typedef AsyncUpdate::Pointer
+   * Smart pointer associated with an AsyncUpdate object.
+   */
+  
+  /**
+   * @typedef AsyncUpdate::ConstPointer
+   * Smart pointer associated with a const AsyncUpdate object.
+   */
+  
+  /**
+   * @typedef AsyncUpdate::NullPointer
+   * Type used to return a null pointer.
+   */
+  
+  /**
+   * @fn static Pointer AsyncUpdate::New(ProcessObject::Pointer process)
+   * Starts the update of the process @a process in a background thread and returns a handle to follow it.
+   */
+  
+  /**
+   * @fn static NullPointer AsyncUpdate::Null()
+   * Static function to return a null pointer.
+   */
+  
+  /**
+   * Destructor. Waits for the end of the update (the exceptions are not thrown).
+   */
+  AsyncUpdate::~AsyncUpdate()
+  {
+    this->mp_Task->pool->Wait(&(this->mp_Task->group));
+    if (this->mp_Task->arena != 0)
+      this->mp_Task->arena->Release(false);
+    delete this->mp_Task;
+    _btk_async_lock.Lock();
+    --_btk_async_tasks;
+    _btk_async_lock.Unlock();
+  };
+  
+  /**
+   * Returns the state of the update.
+   */
+  AsyncUpdate::State AsyncUpdate::GetState() const
+  {
+    this->mp_Task->lock.Lock();
+    State state = this->mp_Task->state;
+    this->mp_Task->lock.Unlock();
+    return state;
+  };
+  
+  /**
+   * @fn bool AsyncUpdate::IsFinished() const
+   * Returns true if the update is finished, failed or cancelled. This method does not block.
+   */
+  
+  /**
+   * Returns the last progress reported by the update, between 0 and 1.
+   */
+  double AsyncUpdate::GetProgress() const
+  {
+    this->mp_Task->lock.Lock();
+    double progress = this->mp_Task->progress;
+    this->mp_Task->lock.Unlock();
+    return progress;
+  };
+  
+  /**
+   * Returns the message of the exception thrown during the update (empty if the update did not fail).
+   */
+  std::string AsyncUpdate::GetErrorMessage() const
+  {
+    this->mp_Task->lock.Lock();
+    std::string error = this->mp_Task->error;
+    this->mp_Task->lock.Unlock();
+    return error;
+  };
+  
+  /**
+   * Requests the cancellation of the update. A pending update is not started. A running update is 
+   * interrupted at its next progress report (see ReportProgress()). The generated data are then incomplete 
+   * (for example, the file written by an AcquisitionFileWriter object) and the process is updated again 
+   * the next time it is requested.
+   * This method does not wait for the end of the update.
+   */
+  void AsyncUpdate::Cancel()
+  {
+    this->mp_Task->lock.Lock();
+    this->mp_Task->cancelled = true;
+    this->mp_Task->lock.Unlock();
+  };
+  
+  /**
+   * Waits for the end of the update. The waiting thread can be used to execute other pending asynchronous updates.
+   * If the update failed, a RuntimeError exception with the message of the thrown exception is thrown.
+   */
+  void AsyncUpdate::Wait()
+  {
+    this->mp_Task->pool->Wait(&(this->mp_Task->group));
+    if (this->GetState() == Failed)
+      throw(RuntimeError(this->GetErrorMessage()));
+  };
+  
+  /**
+   * Returns the number of threads used by the asynchronous updates. 
+   * If the threads are not supported, this number is 0 and the processes are updated by the method Wait().
+   */
+  int AsyncUpdate::GetThreadNumber()
+  {
+    _btk_async_lock.Lock();
+    int num = _btk_async_get_pool()->GetThreadNumber();
+    _btk_async_lock.Unlock();
+    return num;
+  };
+  
+  /**
+   * Sets the number of threads used by the asynchronous updates. If @a threadNumber is null or negative, 
+   * the number of threads corresponds to the number of processors (default).
+   * The threads can be changed only if no asynchronous update is referenced. Otherwise, an error is reported and nothing is done.
+   */
+  void AsyncUpdate::SetThreadNumber(int threadNumber)
+  {
+    _btk_async_lock.Lock();
+    if (_btk_async_tasks != 0)
+    {
+      _btk_async_lock.Unlock();
+      btkErrorMacro("The number of threads cannot be changed while some asynchronous updates are referenced.");
+      return;
+    }
+    if (threadNumber != _btk_async_thread_number)
+    {
+      delete _btk_async_pool;
+      _btk_async_pool = 0;
+      _btk_async_thread_number = threadNumber;
+    }
+    _btk_async_lock.Unlock();
+  };
+  
+  /**
+   * Reports the progress (between 0 and 1) of the asynchronous update executed by the current thread. 
+   * Nothing is done if the current thread does not execute an asynchronous update.
+   * This method is meant to be called regularly by the long loops of the processes and file IOs.
+   *
+   * If the cancellation of the update was requested, an AsyncUpdateCancelled exception is thrown.
+   */
+  void AsyncUpdate::ReportProgress(double progress)
+  {
+    Task* task = static_cast<Task*>(_btk_async_current);
+    if (task == 0)
+      return;
+    task->lock.Lock();
+    task->progress = (progress < 0.0) ? 0.0 : ((progress > 1.0) ? 1.0 : progress);
+    const bool cancelled = task->cancelled;
+    task->interrupted = cancelled;
+    task->lock.Unlock();
+    if (cancelled)
+      throw(AsyncUpdateCancelled("The update was cancelled."));
+  };
+  
+  /**
+   * Constructor. Submits the update of the process to the shared pool of threads.
+   */
+  AsyncUpdate::AsyncUpdate(ProcessObject::Pointer process)
+  {
+    this->mp_Task = new Task;
+    this->mp_Task->process = process;
+    // The arena is kept alive until the end of the task, even if the scope which set it ends before.
+    this->mp_Task->arena = MemoryArena::GetCurrent();
+    if (this->mp_Task->arena != 0)
+      this->mp_Task->arena->Retain();
+    this->mp_Task->state = Pending;
+    this->mp_Task->progress = 0.0;
+    this->mp_Task->cancelled = false;
+    this->mp_Task->interrupted = false;
+    _btk_async_lock.Lock();
+    this->mp_Task->pool = _btk_async_get_pool();
+    ++_btk_async_tasks;
+    _btk_async_lock.Unlock();
+    this->mp_Task->pool->Submit(&(this->mp_Task->group), &AsyncUpdate::Run, this->mp_Task);
+  };
+  
+  /**
+   * Updates the process of the task @a data. The exceptions are stored in the task.
+   */
+  void AsyncUpdate::Run(void* data)
+  {
+    Task* task = static_cast<Task*>(data);
+    task->lock.Lock();
+    if (task->cancelled || !task->process)
+    {
+      task->state = task->cancelled ? Cancelled : Finished;
+      task->lock.Unlock();
+      return;
+    }
+    task->state = Running;
+    task->lock.Unlock();
+    // The waiting thread can execute an update while it is itself updating a process.
+    void* previous = _btk_async_current;
+    _btk_async_current = task;
+    State state = Finished;
+    std::string error;
+    try
+    {
+      MemoryArena::Scope scope(task->arena);
+      task->process->Update();
+    }
+    catch (std::exception& e)
+    {
+      state = Failed;
+      error = e.what();
+    }
+    catch (...)
+    {
+      state = Failed;
+      error = "Unknown exception";
+    }
+    _btk_async_current = previous;
+    task->lock.Lock();
+    // The exception thrown by ReportProgress() can be wrapped by the IO (e.g. C3DFileIOException).
+    if ((state == Failed) && task->interrupted)
+    {
+      state = Cancelled;
+      error.clear();
+    }
+    if (state == Finished)
+      task->progress = 1.0;
+    task->state = state;
+    task->error = error;
+    task->lock.Unlock();
+  };
+};
@@ -0,0 +1,99 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkAsyncUpdate_h
+#define __btkAsyncUpdate_h
+
+#include "btkProcessObject.h"
+#include "btkException.h"
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <string>
+
+namespace btk
+{
+  class AsyncUpdateCancelled : public Exception
+  {
+  public:
+    explicit AsyncUpdateCancelled(const std::string& msg)
+    : Exception(msg)
+    {};
+      
+    virtual ~AsyncUpdateCancelled() throw() {};
+  };
+  
+  class AsyncUpdate
+  {
+  public:
+    typedef enum {Pending = 0, Running, Finished, Failed, Cancelled} State;
+    
+    typedef btkSharedPtr<AsyncUpdate> Pointer;
+    typedef btkSharedPtr<const AsyncUpdate> ConstPointer;
+    typedef btkNullPtr<AsyncUpdate> NullPointer;
+    
+    static Pointer New(ProcessObject::Pointer process) {return Pointer(new AsyncUpdate(process));};
+    static NullPointer Null() {return NullPointer();};
+    
+    BTK_COMMON_EXPORT ~AsyncUpdate();
+    
+    BTK_COMMON_EXPORT State GetState() const;
+    bool IsFinished() const {return (this->GetState() >= Finished);};
+    BTK_COMMON_EXPORT double GetProgress() const;
+    BTK_COMMON_EXPORT std::string GetErrorMessage() const;
+    BTK_COMMON_EXPORT void Cancel();
+    BTK_COMMON_EXPORT void Wait();
+    
+    BTK_COMMON_EXPORT static int GetThreadNumber();
+    BTK_COMMON_EXPORT static void SetThreadNumber(int threadNumber);
+    BTK_COMMON_EXPORT static void ReportProgress(double progress);
+    
+  protected:
+    BTK_COMMON_EXPORT AsyncUpdate(ProcessObject::Pointer process);
+    
+  private:
+    AsyncUpdate(const AsyncUpdate& ); // Not implemented.
+    AsyncUpdate& operator=(const AsyncUpdate& ); // Not implemented.
+    
+    struct Task;
+    
+    static void Run(void* task);
+    
+    Task* mp_Task;
+  };
+};
+
+#endif // __btkAsyncUpdate_h
@@ -37,6 +37,7 @@
 #define __btkCollection_h
 
 #include "btkDataObject.h"
+#include "btkHash.h"
 #include "btkException.h"
 #include "btkLogger.h"
 
@@ -92,6 +93,11 @@ namespace btk
     void Clear();
     Pointer Clone() const;
     
+    virtual bool HashContent(Hash* hash) const;
+    virtual bool GetContentHash(Hash::Value* digest) const;
+    virtual bool DeepCopy(const DataObject* source);
+    virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
   protected:
     Collection()
     : DataObject(), m_Items()
@@ -430,6 +436,78 @@ namespace btk
       p->m_Items.push_back((*it)->Clone());
     return p;
   };
+  
+  /**
+   * Adds the number of items and the content of each item to the digest @a hash. Null items are only marked as such.
+   * Returns false if the content of one item cannot be hashed.
+   */
+  template <class T>
+  bool Collection<T>::HashContent(Hash* hash) const
+  {
+    hash->Add(this->GetItemNumber());
+    for (ConstIterator it = this->Begin() ; it != this->End() ; ++it)
+    {
+      hash->Add(it->get() != 0);
+      if (*it && !(*it)->HashContent(hash))
+        return false;
+    }
+    return true;
+  };
+  
+  /**
+   * Sets in @a digest the combination of the number of items and the digest of each item (see DataObject::GetContentHash()).
+   * Returns false if the content of one item cannot be hashed.
+   * @warning The digests of the items are cached with their timestamp. An item modified by reference (e.g. with Point::GetValues()) has to call Modified() to be hashed again.
+   */
+  template <class T>
+  bool Collection<T>::GetContentHash(Hash::Value* digest) const
+  {
+    Hash hash;
+    hash.Add(this->GetItemNumber());
+    for (ConstIterator it = this->Begin() ; it != this->End() ; ++it)
+    {
+      Hash::Value item;
+      if (*it && !(*it)->GetContentHash(&item))
+        return false;
+      hash.Add(item);
+    }
+    *digest = hash.GetValue();
+    return true;
+  };
+  
+  /**
+   * Adds the memory used by this collection and its items to @a usage. 
+   * An item inserted in several collections is counted once. Null items are only counted as pointers.
+   */
+  template <class T>
+  void Collection<T>::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Collection<T>) + this->m_Items.size() * (2 * sizeof(void*) + sizeof(ItemPointer)));
+    for (ConstIterator it = this->Begin() ; it != this->End() ; ++it)
+    {
+      if (*it && usage->AddShared(MemoryUsage::Objects, it->get(), 0))
+        (*it)->AddMemoryUsage(usage);
+    }
+  };
+  
+  /**
+   * Replaces the items of this collection by clones of the items of the collection @a source.
+   * Returns false if @a source is not a collection of the same type.
+   */
+  template <class T>
+  bool Collection<T>::DeepCopy(const DataObject* source)
+  {
+    const Collection* src = dynamic_cast<const Collection*>(source);
+    if (src == 0)
+      return false;
+    if (src == this)
+      return true;
+    this->m_Items.clear();
+    for (ConstIterator it = src->Begin() ; it != src->End() ; ++it)
+      this->m_Items.push_back((*it)->Clone());
+    this->Modified();
+    return true;
+  };
 };
 
 #endif // __btkCollection_h
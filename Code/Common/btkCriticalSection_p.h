@@ -56,6 +56,13 @@
   typedef int btk_critical_section_t;
 #endif
 
+// Storage class specifier for the variables local to each thread.
+#if defined(_MSC_VER)
+  #define btkThreadLocal __declspec(thread)
+#else
+  #define btkThreadLocal __thread
+#endif
+
 namespace btk
 {
   class critical_section_p
@@ -36,13 +36,24 @@
 #include "btkDataObject.h"
 #include "btkProcessObject.h"
 #include "btkLogger.h"
+#include "btkCriticalSection_p.h"
 
 namespace btk
 {
+  // Protects the regions of the data objects. A data object used by several processes can receive a request from several threads.
+  static critical_section_p _btk_data_object_regions;
+  // Protects the digests cached by the data objects (see DataObject::GetCachedContentHash()).
+  static critical_section_p _btk_data_object_digests;
+  
   /**
    * @class DataObject btkDataObject.h
    * @brief Input and output entry for processes in pipelines.
    *
+   * A data object can request only a part of the frames to the process generating it (see SetRequestedRegion()). 
+   * The region is propagated upstream by the processes of the pipeline (see ProcessObject::GenerateInputRequestedRegion()) 
+   * and the sources (e.g. btk::AcquisitionFileReader) generate only the requested frames. 
+   * The work done by the pipeline is then proportional to the region of interest.
+   *
    * @ingroup BTKCommon
    */
   /**
@@ -76,6 +87,17 @@ namespace btk
    * for an example.
    */
   
+  /**
+   * @fn static void* DataObject::operator new(size_t size)
+   * Allocates the object in the memory arena used by the current thread (if any) or with the heap.
+   * @sa MemoryArena::Scope
+   */
+  
+  /**
+   * @fn static void DataObject::operator delete(void* ptr)
+   * Releases the memory allocated by the operator new.
+   */
+  
   /**
    * @fn bool DataObject::HasParent() const
    * Checks if this DataObject has a parent.
@@ -112,6 +134,176 @@ namespace btk
       this->mp_Source->Update();
   };
   
+  /**
+   * Returns true if only a part of the frames is requested to the process generating this object.
+   */
+  bool DataObject::HasRequestedRegion() const
+  {
+    _btk_data_object_regions.Lock();
+    bool has = (this->mp_RequestedRegion[0] <= this->mp_RequestedRegion[1]);
+    _btk_data_object_regions.Unlock();
+    return has;
+  };
+  
+  /**
+   * Returns the first frame of the requested region. The returned value is meaningful only if HasRequestedRegion() returns true.
+   */
+  int DataObject::GetRequestedFirstFrame() const
+  {
+    _btk_data_object_regions.Lock();
+    int frame = this->mp_RequestedRegion[0];
+    _btk_data_object_regions.Unlock();
+    return frame;
+  };
+  
+  /**
+   * Returns the last frame of the requested region. The returned value is meaningful only if HasRequestedRegion() returns true.
+   */
+  int DataObject::GetRequestedLastFrame() const
+  {
+    _btk_data_object_regions.Lock();
+    int frame = this->mp_RequestedRegion[1];
+    _btk_data_object_regions.Unlock();
+    return frame;
+  };
+  
+  /**
+   * Requests only the frames from @a firstFrame to @a lastFrame (included) to the process generating this object.
+   * The frames use the numbering of the acquisition from which the data come (see Acquisition::GetFirstFrame()).
+   * If @a firstFrame is greater than @a lastFrame, all the frames are requested.
+   *
+   * The request is taken into account at the next update. The data are generated again only if the 
+   * requested region is not included in the one already generated. The generated data can contain more 
+   * frames than requested (e.g. the context needed by a filter).
+   * @note The region requested to the output of a process is replaced during the update of the pipeline 
+   * by the region requested by the downstream processes. Then, the region must be set on the output of the last process.
+   * If several threads update at the same time some pipelines sharing processes, they must request the same region 
+   * (the class PipelineExecutor requests the union of the regions to the shared processes).
+   */
+  void DataObject::SetRequestedRegion(int firstFrame, int lastFrame)
+  {
+    _btk_data_object_regions.Lock();
+    this->mp_RequestedRegion[0] = firstFrame;
+    this->mp_RequestedRegion[1] = lastFrame;
+    _btk_data_object_regions.Unlock();
+  };
+  
+  /**
+   * Requests all the frames to the process generating this object.
+   */
+  void DataObject::ResetRequestedRegion()
+  {
+    this->SetRequestedRegion(1, 0);
+  };
+  
+  /**
+   * Adds the content of this object to the digest @a hash (see ProcessCache). 
+   * Returns false if the content of this type of object cannot be hashed (default behaviour).
+   *
+   * The inherited classes have to add every information used by a process (values, labels, parameters, etc.), 
+   * but not the information related to the pipeline (parent, source, timestamp, requested region).
+   */
+  bool DataObject::HashContent(Hash* /* hash */) const
+  {
+    return false;
+  };
+  
+  /**
+   * Sets in @a digest a digest of the content of this object and returns true. 
+   * Returns false if the content of this type of object cannot be hashed.
+   *
+   * By default, the digest is the one computed by the method HashContent(). The collections, the acquisitions, 
+   * the force platforms and the wrenches combine the digests of their elements (points, analog channels, etc.). 
+   * The digest of a point or an analog channel is cached and computed again only when its timestamp changes 
+   * (see Object::GetTimestamp()). Then, modifying one channel of a large acquisition only hashes again this channel.
+   * The digests returned by this method can be compared only between them (not with the digests of the method HashContent()).
+   *
+   * @warning The values modified directly by reference (e.g. Point::GetValues()) do not change the timestamp of the object. 
+   * The method Modified() has to be called after such modifications to compute a new digest.
+   */
+  bool DataObject::GetContentHash(Hash::Value* digest) const
+  {
+    Hash hash;
+    if (!this->HashContent(&hash))
+      return false;
+    *digest = hash.GetValue();
+    return true;
+  };
+  
+  /**
+   * Returns in @a digest the digest computed by the method HashContent(). The digest is computed again 
+   * only if the @a version given (e.g. the timestamp of this object) changed since the last call.
+   * This method can be called concurrently by several threads.
+   */
+  bool DataObject::GetCachedContentHash(Hash::Value* digest, unsigned long int version) const
+  {
+    _btk_data_object_digests.Lock();
+    bool cached = this->m_ContentHashValid && (this->m_ContentHashVersion == version);
+    if (cached)
+      *digest = this->m_ContentHash;
+    _btk_data_object_digests.Unlock();
+    if (cached)
+      return true;
+    Hash hash;
+    if (!this->HashContent(&hash))
+      return false;
+    *digest = hash.GetValue();
+    _btk_data_object_digests.Lock();
+    this->m_ContentHash = *digest;
+    this->m_ContentHashVersion = version;
+    this->m_ContentHashValid = true;
+    _btk_data_object_digests.Unlock();
+    return true;
+  };
+  
+  /**
+   * Replaces the content of this object by a copy of the content of @a source and returns true. 
+   * Returns false if @a source is not of the same type or if this type of object cannot be copied (default behaviour).
+   * The information related to the pipeline (parent, source, requested region) is not copied.
+   */
+  bool DataObject::DeepCopy(const DataObject* /* source */)
+  {
+    return false;
+  };
+  
+  /**
+   * Returns the memory used by this object and its content, sorted by component (see AddMemoryUsage()).
+   */
+  MemoryUsage DataObject::GetMemoryUsage() const
+  {
+    MemoryUsage usage;
+    this->AddMemoryUsage(&usage);
+    return usage;
+  };
+  
+  /**
+   * Adds to @a usage the memory used by this object and its content. 
+   * By default, nothing is added. The final classes add the size of their structure and the memory allocated for their content.
+   */
+  void DataObject::AddMemoryUsage(MemoryUsage* /* usage */) const
+  {};
+  
+  // Returns true if the requested frames are included in the frames generated by the last update.
+  bool DataObject::IsRequestedRegionBuffered() const
+  {
+    _btk_data_object_regions.Lock();
+    const int* req = this->mp_RequestedRegion;
+    const int* buf = this->mp_BufferedRegion;
+    bool buffered = (buf[0] > buf[1]) // All the frames were generated
+                    || ((req[0] <= req[1]) && (req[0] >= buf[0]) && (req[1] <= buf[1]));
+    _btk_data_object_regions.Unlock();
+    return buffered;
+  };
+  
+  // Stores the requested frames as the generated frames.
+  void DataObject::BufferRequestedRegion()
+  {
+    _btk_data_object_regions.Lock();
+    this->mp_BufferedRegion[0] = this->mp_RequestedRegion[0];
+    this->mp_BufferedRegion[1] = this->mp_RequestedRegion[1];
+    _btk_data_object_regions.Unlock();
+  };
+  
   /**
    * @fn DataObject::DataObject()
    * Default constructor.
@@ -238,4 +430,13 @@ namespace btk
     this->m_Description = description;
     this->Modified();
   };
+  
+  /**
+   * Adds the strings of the label and of the description to @a usage.
+   */
+  void DataObjectLabeled::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Strings, this->m_Label);
+    usage->Add(MemoryUsage::Strings, this->m_Description);
+  };
 };
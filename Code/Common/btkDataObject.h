@@ -38,6 +38,9 @@
 
 #include "btkObject.h"
 #include "btkNullPtr.h"
+#include "btkMemoryArena.h"
+#include "btkHash.h"
+#include "btkMemoryUsage.h"
 
 #include <list>
 #include <string>
@@ -55,6 +58,9 @@ namespace btk
     
     static NullPointer Null() {return NullPointer();}; 
     
+    static void* operator new(size_t size) {return MemoryArena::Allocate(size);};
+    static void operator delete(void* ptr) {MemoryArena::Deallocate(ptr);};
+    
     bool HasParent() const {return this->mp_Parent != 0;};
     DataObject* GetParent() const {return this->mp_Parent;};
     BTK_COMMON_EXPORT void SetParent(DataObject* parent);
@@ -62,32 +68,63 @@ namespace btk
     BTK_COMMON_EXPORT void Modified();
     BTK_COMMON_EXPORT void Update();
     
+    BTK_COMMON_EXPORT bool HasRequestedRegion() const;
+    BTK_COMMON_EXPORT int GetRequestedFirstFrame() const;
+    BTK_COMMON_EXPORT int GetRequestedLastFrame() const;
+    BTK_COMMON_EXPORT void SetRequestedRegion(int firstFrame, int lastFrame);
+    BTK_COMMON_EXPORT void ResetRequestedRegion();
+    
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual bool GetContentHash(Hash::Value* digest) const;
+    BTK_COMMON_EXPORT virtual bool DeepCopy(const DataObject* source);
+    
+    BTK_COMMON_EXPORT MemoryUsage GetMemoryUsage() const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
   protected:
     DataObject()
-    : Object(), m_Children()
+    : Object(), m_Children(), m_ContentHash()
     {
+      this->m_ContentHashVersion = 0;
+      this->m_ContentHashValid = false;
       this->mp_Parent = 0;
       this->mp_Source = 0;
+      this->mp_RequestedRegion[0] = 1; this->mp_RequestedRegion[1] = 0;
+      this->mp_BufferedRegion[0] = 1; this->mp_BufferedRegion[1] = 0;
     };
     DataObject(const DataObject& toCopy)
-    : Object(toCopy), m_Children()
+    : Object(toCopy), m_Children(), m_ContentHash()
     {
+      this->m_ContentHashVersion = 0;
+      this->m_ContentHashValid = false;
       this->mp_Parent = 0;
       this->mp_Source = 0;
+      this->mp_RequestedRegion[0] = 1; this->mp_RequestedRegion[1] = 0;
+      this->mp_BufferedRegion[0] = 1; this->mp_BufferedRegion[1] = 0;
     };
     BTK_COMMON_EXPORT virtual ~DataObject();
+    
+    BTK_COMMON_EXPORT bool GetCachedContentHash(Hash::Value* digest, unsigned long int version) const;
         
   private:
     void AddChild(DataObject* child);
     void RemoveChild(DataObject* child);
+    bool IsRequestedRegionBuffered() const;
+    void BufferRequestedRegion();
     
     DataObject& operator=(const DataObject& ); // Not implemented.
     
     DataObject* mp_Parent;
     std::list<DataObject*> m_Children;
     ProcessObject* mp_Source;
+    int mp_RequestedRegion[2];
+    int mp_BufferedRegion[2];
+    mutable Hash::Value m_ContentHash;
+    mutable unsigned long int m_ContentHashVersion;
+    mutable bool m_ContentHashValid;
     
     friend class ProcessObject;
+    friend class PipelineExecutor;
   };
   
   class DataObjectLabeled : public DataObject
@@ -101,6 +138,8 @@ namespace btk
     const std::string& GetDescription() const {return this->m_Description;};
     BTK_COMMON_EXPORT virtual void SetDescription(const std::string& description);
     
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
   protected:
     DataObjectLabeled(const std::string& label = "", const std::string& description = "")
     : DataObject(), m_Label(label), m_Description(description)
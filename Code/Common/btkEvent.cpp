@@ -34,6 +34,7 @@
  */
 
 #include "btkEvent.h"
+#include "btkHash.h"
 
 #include <limits>
 #include <cmath>
@@ -244,6 +245,33 @@ namespace btk
     this->Modified();
   };
 
+  /**
+   * Adds the label, the description, the context, the subject, the detection flags, the time, the frame and the ID of this event to the digest @a hash.
+   */
+  bool Event::HashContent(Hash* hash) const
+  {
+    hash->Add(this->m_Label);
+    hash->Add(this->m_Description);
+    hash->Add(this->m_Context);
+    hash->Add(this->m_Subject);
+    hash->Add(this->m_DetectionFlags);
+    hash->Add(this->m_Time);
+    hash->Add(this->m_Frame);
+    hash->Add(this->m_Id);
+    return true;
+  };
+  
+  /**
+   * Adds the memory used by this event and its strings to @a usage.
+   */
+  void Event::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Event));
+    this->DataObjectLabeled::AddMemoryUsage(usage);
+    usage->Add(MemoryUsage::Strings, this->m_Context);
+    usage->Add(MemoryUsage::Strings, this->m_Subject);
+  };
+  
   /**
    * @fn Pointer Event::Clone() const
    * Clones the object and return it as new smart pointer.
@@ -76,6 +76,9 @@ namespace btk
     int GetId() const {return this->m_Id;};
     BTK_COMMON_EXPORT void SetId(int id);
     
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
     Pointer Clone() const {return Pointer(new Event(*this));};
     BTK_COMMON_EXPORT friend bool operator==(const Event& rLHS, const Event& rRHS);
     friend bool operator!=(const Event& rLHS, const Event& rRHS)
@@ -48,7 +48,11 @@ namespace btk
    *  - btk::ForcePlatformType3: 8 channels (FZ1, FZ2, FZ3, FZ4, FX12, FX34, FY14, FY23);
    *  - btk::ForcePlatformType4: Same as Type-2 + calibration matrix 6 (columns) by 6 (rows);
    *  - btk::ForcePlatformType5: Same as Type-3 + calibration matrix 6 (columns) by 8 (rows);
-   *  - btk::ForcePlatformType6: 12 channels (FX[1,2,3,4], FY[1,2,3,4], FZ[1,2,3,4] + calibration matrix 12 by 12).
+   *  - btk::ForcePlatformType6: 12 channels (FX[1,2,3,4], FY[1,2,3,4], FZ[1,2,3,4]) + calibration matrix 12 by 12;
+   *  - btk::ForcePlatformType7: Same as Type-3 + calibration matrix 8 by 8;
+   *  - btk::ForcePlatformType11: Kistler Split Belt Treadmill, same as Type-7;
+   *  - btk::ForcePlatformType12: Gaitway treadmill, 8 channels (FZ11, FZ12, FZ13, FZ14, FZ21, FZ22, FZ23, FZ24) + calibration matrix 8 by 8;
+   *  - btk::ForcePlatformType21: AMTI-Stairs, same as Type-4 for each force platform.
    *
    * @ingroup BTKCommon 
    */
@@ -309,6 +313,47 @@ namespace btk
    * Returns the type of the force platform.
    */
 
+  /**
+   * Adds the type, the geometry, the calibration matrix and the channels of this force platform to the digest @a hash.
+   */
+  bool ForcePlatform::HashContent(Hash* hash) const
+  {
+    hash->Add(this->m_Type);
+    hash->AddMatrix(this->m_Origin);
+    hash->AddMatrix(this->m_Corners);
+    hash->AddMatrix(this->m_CalMatrix);
+    return this->m_Channels->HashContent(hash);
+  };
+  
+  /**
+   * Sets in @a digest the combination of the type, the geometry, the calibration matrix and the digest of the channels (see DataObject::GetContentHash()).
+   */
+  bool ForcePlatform::GetContentHash(Hash::Value* digest) const
+  {
+    Hash hash;
+    hash.Add(this->m_Type);
+    hash.AddMatrix(this->m_Origin);
+    hash.AddMatrix(this->m_Corners);
+    hash.AddMatrix(this->m_CalMatrix);
+    Hash::Value channels;
+    if (!this->m_Channels->GetContentHash(&channels))
+      return false;
+    hash.Add(channels);
+    *digest = hash.GetValue();
+    return true;
+  };
+  
+  /**
+   * Adds the memory used by this force platform, its geometry, its calibration matrix and its channels to @a usage.
+   * The channels shared with an acquisition are counted once if the acquisition is added to the same @a usage.
+   */
+  void ForcePlatform::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(ForcePlatform) - sizeof(Origin) - sizeof(Corners));
+    usage->Add(MemoryUsage::Calibrations, sizeof(Origin) + sizeof(Corners) + sizeof(double) * this->m_CalMatrix.size());
+    this->m_Channels->AddMemoryUsage(usage);
+  };
+  
   /**
    * @fn Pointer ForcePlatform::Clone() const
    * Clones the object and return it as new smart pointer.
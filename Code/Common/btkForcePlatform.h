@@ -90,6 +90,10 @@ namespace btk
 
     int GetType() const {return this->m_Type;};
     
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual bool GetContentHash(Hash::Value* digest) const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
     Pointer Clone() const {return Pointer(new ForcePlatform(*this));};
 
   protected:
@@ -86,11 +86,26 @@ namespace btk
    * @ingroup BTKCommon
    */
   typedef ForcePlatformType<6,12,12> ForcePlatformType6;
-  
-  // btkForcePlatformType7
-  // btkForcePlatformType11
-  // btkForcePlatformType12
-  // btkForcePlatformType21
+  /**
+   * Represents Force platform Type-7 (Same as Type-3 + calibration matrix 8 by 8)
+   * @ingroup BTKCommon
+   */
+  typedef ForcePlatformType<7,8,8> ForcePlatformType7;
+  /**
+   * Represents Force platform Type-11 (Kistler Split Belt Treadmill: same as Type-7)
+   * @ingroup BTKCommon
+   */
+  typedef ForcePlatformType<11,8,8> ForcePlatformType11;
+  /**
+   * Represents Force platform Type-12 (Gaitway treadmill: 8 channels FZ11, FZ12, FZ13, FZ14, FZ21, FZ22, FZ23, FZ24 + calibration matrix 8 by 8)
+   * @ingroup BTKCommon
+   */
+  typedef ForcePlatformType<12,8,8> ForcePlatformType12;
+  /**
+   * Represents Force platform Type-21 (AMTI-Stairs: same as Type-4 for each force platform)
+   * @ingroup BTKCommon
+   */
+  typedef ForcePlatformType<21,6,6> ForcePlatformType21;
   
   // ----------------------------------------------------------------------- //
 
@@ -111,6 +126,10 @@ namespace btk
    * - btk::ForcePlatformType4: Force platform Type-4 (Same as Type-2 + calibration matrix 6 by 6)
    * - btk::ForcePlatformType5: Force platform Type-5 (8 channels: FZ1, FZ2, FZ3, FZ4, FX12, FX34, FY14, FY23 + calibration matrix 6 (columns) by 8 (rows))
    * - btk::ForcePlatformType6: Force platform Type-6 (12 channels: FX[1,2,3,4], FY[1,2,3,4], FZ[1,2,3,4] + calibration matrix 12 by 12)
+   * - btk::ForcePlatformType7: Force platform Type-7 (Same as Type-3 + calibration matrix 8 by 8)
+   * - btk::ForcePlatformType11: Force platform Type-11 (Kistler Split Belt Treadmill: same as Type-7)
+   * - btk::ForcePlatformType12: Force platform Type-12 (Gaitway treadmill: 8 channels FZ11, FZ12, FZ13, FZ14, FZ21, FZ22, FZ23, FZ24 + calibration matrix 8 by 8)
+   * - btk::ForcePlatformType21: Force platform Type-21 (AMTI-Stairs: same as Type-4 for each force platform)
    *
    * @warning The use of the New() static method will return a ForcePlatofrm::Pointer object.
    *
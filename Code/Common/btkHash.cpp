@@ -0,0 +1,261 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkHash.h"
+
+#include <algorithm> // std::min
+#include <cstring> // memcpy
+
+namespace btk
+{
+  static const uint64_t _btk_hash_c1 = 0x87c37b91114253d5ULL;
+  static const uint64_t _btk_hash_c2 = 0x4cf5ad432745937fULL;
+  
+  inline uint64_t _btk_hash_rotl(uint64_t x, int r)
+  {
+    return (x << r) | (x >> (64 - r));
+  };
+  
+  // Little endian load: same digest on every platform (a single load with the common compilers).
+  inline uint64_t _btk_hash_load(const unsigned char* p)
+  {
+    return  static_cast<uint64_t>(p[0])        | (static_cast<uint64_t>(p[1]) << 8)
+         | (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24)
+         | (static_cast<uint64_t>(p[4]) << 32) | (static_cast<uint64_t>(p[5]) << 40)
+         | (static_cast<uint64_t>(p[6]) << 48) | (static_cast<uint64_t>(p[7]) << 56);
+  };
+  
+  inline uint64_t _btk_hash_fmix(uint64_t k)
+  {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+  };
+  
+  /**
+   * @class Hash btkHash.h
+   * @brief Computes a 128-bit digest of the content added step by step.
+   *
+   * The digest is the one of the algorithm MurmurHash3 (x64, 128 bits) computed on the concatenation 
+   * of the added bytes. The data are processed by blocks of 16 bytes (two independent 64-bit lanes), 
+   * which gives a throughput of several GB/s. The content can be added in as many steps as wanted: 
+   * the digest depends only on the added bytes, not on the way they were split. 
+   * The length of the strings and the dimensions of the matrices are included to distinguish 
+   * contents which have the same bytes but not the same structure.
+   *
+   * The member Value::low can be used alone as a 64-bit digest.
+   *
+   * This class is used to detect identical data without comparing them (see DataObject::GetContentHash() 
+   * and ProcessCache). The digest is the same on every platform for the same bytes.
+   *
+   * @warning The digest is not cryptographic.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @struct Hash::Value btkHash.h
+   * @brief 128-bit digest.
+   */
+  
+  /**
+   * @fn Hash::Value::Value()
+   * Constructor. The digest is set to 0.
+   */
+  
+  /**
+   * @fn Hash::Value::Value(uint64_t l, uint64_t h)
+   * Constructor. The low and high parts of the digest are set to @a l and @a h.
+   */
+  
+  /**
+   * @var Hash::Value::low
+   * Low 64 bits of the digest.
+   */
+  
+  /**
+   * @var Hash::Value::high
+   * High 64 bits of the digest.
+   */
+  
+  /**
+   * @fn Hash::Hash()
+   * Constructor.
+   */
+  
+  /**
+   * Returns the digest of the contents added since the construction or the last call to Reset(). 
+   * The content can still be added after.
+   */
+  Hash::Value Hash::GetValue() const
+  {
+    uint64_t h1 = this->m_H1, h2 = this->m_H2;
+    if (this->m_TailSize != 0)
+    {
+      unsigned char tail[16];
+      memcpy(tail, this->mp_Tail, this->m_TailSize);
+      memset(tail + this->m_TailSize, 0, 16 - this->m_TailSize);
+      uint64_t k1 = _btk_hash_load(tail), k2 = _btk_hash_load(tail + 8);
+      k2 *= _btk_hash_c2; k2 = _btk_hash_rotl(k2, 33); k2 *= _btk_hash_c1; h2 ^= k2;
+      k1 *= _btk_hash_c1; k1 = _btk_hash_rotl(k1, 31); k1 *= _btk_hash_c2; h1 ^= k1;
+    }
+    h1 ^= this->m_Length;
+    h2 ^= this->m_Length;
+    h1 += h2;
+    h2 += h1;
+    h1 = _btk_hash_fmix(h1);
+    h2 = _btk_hash_fmix(h2);
+    h1 += h2;
+    h2 += h1;
+    return Value(h1, h2);
+  };
+  
+  /**
+   * Resets the digest.
+   */
+  void Hash::Reset()
+  {
+    this->m_H1 = 0;
+    this->m_H2 = 0;
+    this->m_Length = 0;
+    this->m_TailSize = 0;
+  };
+  
+  /**
+   * Adds @a size bytes stored at the address @a data.
+   */
+  void Hash::Add(const void* data, size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    this->m_Length += size;
+    if (this->m_TailSize != 0)
+    {
+      const size_t num = (std::min)(size, 16 - this->m_TailSize);
+      memcpy(this->mp_Tail + this->m_TailSize, bytes, num);
+      this->m_TailSize += num;
+      bytes += num;
+      size -= num;
+      if (this->m_TailSize < 16)
+        return;
+      this->AddBlocks(this->mp_Tail, 1);
+      this->m_TailSize = 0;
+    }
+    const size_t num = size / 16;
+    this->AddBlocks(bytes, num);
+    this->m_TailSize = size - num * 16;
+    memcpy(this->mp_Tail, bytes + num * 16, this->m_TailSize);
+  };
+  
+  /**
+   * Adds the length and the characters of the string @a str.
+   */
+  void Hash::Add(const std::string& str)
+  {
+    this->Add(static_cast<int>(str.length()));
+    this->Add(str.data(), str.length());
+  };
+  
+  /**
+   * @fn void Hash::Add(const Value& v)
+   * Adds the digest @a v (e.g. the digest of a part of the content).
+   */
+  
+  /**
+   * @fn void Hash::Add(bool b)
+   * Adds the boolean @a b.
+   */
+  
+  /**
+   * @fn void Hash::Add(int i)
+   * Adds the integer @a i.
+   */
+  
+  /**
+   * @fn void Hash::Add(uint64_t i)
+   * Adds the 64-bit integer @a i.
+   */
+  
+  /**
+   * @fn void Hash::Add(double d)
+   * Adds the bytes of the real @a d.
+   */
+  
+  /**
+   * @fn template <typename M> void Hash::AddMatrix(const M& m)
+   * Adds the dimensions and the coefficients of the matrix @a m (column by column). 
+   * The coefficients stored contiguously are added in one step, the others by chunks.
+   */
+  
+  /**
+   * @fn template <typename S, typename M> void Hash::AddMatrixAs(const M& m)
+   * Adds the dimensions and the coefficients of the matrix (or expression) @a m converted in the type @a S (column by column).
+   * The digest is the same than the one given by AddMatrix() for a matrix of type @a S with the same coefficients.
+   * It is used to hash a content independently of the form used to store it (for example single precision values).
+   */
+  
+  /**
+   * Returns the digest @a v as an hexadecimal string of 32 characters (high part first).
+   */
+  std::string Hash::ToString(const Value& v)
+  {
+    static const char digits[] = "0123456789abcdef";
+    std::string str(32, '0');
+    for (int i = 0 ; i < 16 ; ++i)
+    {
+      str[15 - i] = digits[(v.high >> (4 * i)) & 0xf];
+      str[31 - i] = digits[(v.low >> (4 * i)) & 0xf];
+    }
+    return str;
+  };
+  
+  void Hash::AddBlocks(const unsigned char* data, size_t num)
+  {
+    uint64_t h1 = this->m_H1, h2 = this->m_H2;
+    for (size_t i = 0 ; i < num ; ++i, data += 16)
+    {
+      uint64_t k1 = _btk_hash_load(data), k2 = _btk_hash_load(data + 8);
+      k1 *= _btk_hash_c1; k1 = _btk_hash_rotl(k1, 31); k1 *= _btk_hash_c2; h1 ^= k1;
+      h1 = _btk_hash_rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+      k2 *= _btk_hash_c2; k2 = _btk_hash_rotl(k2, 33); k2 *= _btk_hash_c1; h2 ^= k2;
+      h2 = _btk_hash_rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+    this->m_H1 = h1;
+    this->m_H2 = h2;
+  };
+};
@@ -0,0 +1,139 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkHash_h
+#define __btkHash_h
+
+#include "btkConfigure.h"
+
+#include <string>
+#include <cstddef> // size_t
+
+#if defined(_MSC_VER)
+  // MSVC doesn't have the header stdint.h
+  #include "Utilities/msvc_stdint.h"
+#else
+  #include <stdint.h>
+#endif
+
+namespace btk
+{
+  class Hash
+  {
+  public:
+    struct Value
+    {
+      Value() : low(0), high(0) {};
+      Value(uint64_t l, uint64_t h) : low(l), high(h) {};
+      friend bool operator==(const Value& rLHS, const Value& rRHS) {return (rLHS.low == rRHS.low) && (rLHS.high == rRHS.high);};
+      friend bool operator!=(const Value& rLHS, const Value& rRHS) {return !(rLHS == rRHS);};
+      friend bool operator<(const Value& rLHS, const Value& rRHS) {return (rLHS.high < rRHS.high) || ((rLHS.high == rRHS.high) && (rLHS.low < rRHS.low));};
+      uint64_t low;
+      uint64_t high;
+    };
+    
+    Hash() {this->Reset();};
+    // ~Hash(); // Implicit.
+    
+    BTK_COMMON_EXPORT Value GetValue() const;
+    BTK_COMMON_EXPORT void Reset();
+    
+    BTK_COMMON_EXPORT void Add(const void* data, size_t size);
+    BTK_COMMON_EXPORT void Add(const std::string& str);
+    void Add(const Value& v) {this->Add(v.low); this->Add(v.high);};
+    void Add(bool b) {this->Add(static_cast<int>(b ? 1 : 0));};
+    void Add(int i) {this->Add(&i, sizeof(int));};
+    void Add(uint64_t i) {this->Add(&i, sizeof(uint64_t));};
+    void Add(double d) {this->Add(&d, sizeof(double));};
+    template <typename M> void AddMatrix(const M& m);
+    template <typename S, typename M> void AddMatrixAs(const M& m);
+    
+    BTK_COMMON_EXPORT static std::string ToString(const Value& v);
+    
+  private:
+    void AddBlocks(const unsigned char* data, size_t num);
+    
+    uint64_t m_H1;
+    uint64_t m_H2;
+    uint64_t m_Length;
+    unsigned char mp_Tail[16];
+    size_t m_TailSize;
+  };
+  
+  template <typename M>
+  void Hash::AddMatrix(const M& m)
+  {
+    typedef typename M::Scalar Scalar;
+    const int rows = static_cast<int>(m.rows()), cols = static_cast<int>(m.cols());
+    if ((rows != 0) && (cols != 0) && (m.innerStride() == 1) && ((cols == 1) || (m.outerStride() == rows)))
+    {
+      this->Add(rows);
+      this->Add(cols);
+      this->Add(m.data(), sizeof(Scalar) * rows * cols);
+    }
+    else
+      this->AddMatrixAs<Scalar>(m);
+  };
+  
+  template <typename S, typename M>
+  void Hash::AddMatrixAs(const M& m)
+  {
+    const int rows = static_cast<int>(m.rows()), cols = static_cast<int>(m.cols());
+    this->Add(rows);
+    this->Add(cols);
+    if ((rows == 0) || (cols == 0))
+      return;
+    // The coefficients are gathered by chunks to be hashed with the contiguous ones.
+    const int chunk = 256;
+    S buffer[chunk];
+    int num = 0;
+    for (int j = 0 ; j < cols ; ++j)
+    {
+      for (int i = 0 ; i < rows ; ++i)
+      {
+        buffer[num++] = static_cast<S>(m.coeff(i,j));
+        if (num == chunk)
+        {
+          this->Add(buffer, sizeof(S) * num);
+          num = 0;
+        }
+      }
+    }
+    this->Add(buffer, sizeof(S) * num);
+  };
+};
+
+#endif // __btkHash_h
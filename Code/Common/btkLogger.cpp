@@ -34,8 +34,18 @@
  */
 
 #include "btkLogger.h"
+#include "btkConvert.h"
+#include "btkThreadPool_p.h"
 
 #include <iostream>
+#include <map>
+
+#if defined(_WIN32) || defined(HAVE_ATOMIC_BUILTINS)
+  #define BTK_LOGGER_LOCK_FREE
+#endif
+#if !defined(_WIN32) && defined(BTK_THREAD_POOL_PTHREADS)
+  #include <sched.h> // sched_yield
+#endif
 
 #ifdef NDEBUG
   static btk::Logger::VerboseMode _btk_logger_verbose_mode = btk::Logger::Normal;
@@ -49,6 +59,119 @@ static std::string _btk_logger_error_affix = "ERROR";
 static btk::Logger::Stream::Pointer _btk_logger_debug_stream = btk::Logger::Stream::New(&(std::cout));
 static btk::Logger::Stream::Pointer _btk_logger_warning_stream = btk::Logger::Stream::New(&(std::cerr));
 static btk::Logger::Stream::Pointer _btk_logger_error_stream = btk::Logger::Stream::New(&(std::cerr));
+static btk::Logger::Sink::Pointer _btk_logger_sink = btk::Logger::Sink::Pointer();
+static int _btk_logger_repeat_limit = 0;
+static btk::critical_section_p _btk_logger_lock;
+static btkThreadLocal const std::string* _btk_logger_context = 0;
+
+// Number of messages emitted by each location of the code (see Logger::SetRepeatLimit()).
+struct _btk_logger_site
+{
+  int count;
+  int suppressed;
+  btk::Logger::Record last;
+};
+static std::map<std::string, _btk_logger_site> _btk_logger_sites;
+
+// Queue of the messages posted in the asynchronous mode.
+// Intrusive multiple producers / single consumer queue (D. Vyukov): the producers only exchange the head of the queue.
+struct _btk_logger_message
+{
+  btk::Logger::Record record;
+  _btk_logger_message* volatile next;
+};
+static _btk_logger_message _btk_logger_stub;
+static _btk_logger_message* volatile _btk_logger_head = &_btk_logger_stub;
+static _btk_logger_message* _btk_logger_tail = &_btk_logger_stub;
+static volatile long _btk_logger_pending = 0;
+static btk::thread_pool_p* _btk_logger_pool = 0;
+static btk::thread_pool_p::group _btk_logger_group;
+
+#if defined(BTK_LOGGER_LOCK_FREE)
+// Atomic load and exchange of the links of the queue (with a full memory barrier).
+static inline _btk_logger_message* _btk_logger_load(_btk_logger_message* volatile* ptr)
+{
+#if defined(_WIN32)
+  return static_cast<_btk_logger_message*>(InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(ptr), 0, 0));
+#else
+  return __sync_val_compare_and_swap(ptr, static_cast<_btk_logger_message*>(0), static_cast<_btk_logger_message*>(0));
+#endif
+};
+
+static inline _btk_logger_message* _btk_logger_exchange(_btk_logger_message* volatile* ptr, _btk_logger_message* value)
+{
+#if defined(_WIN32)
+  return static_cast<_btk_logger_message*>(InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(ptr), value));
+#else
+  _btk_logger_message* old = _btk_logger_load(ptr);
+  while (!__sync_bool_compare_and_swap(ptr, old, value))
+    old = _btk_logger_load(ptr);
+  return old;
+#endif
+};
+
+static inline long _btk_logger_add(volatile long* value, long inc)
+{
+#if defined(_WIN32)
+  return InterlockedExchangeAdd(value, inc) + inc;
+#else
+  return __sync_add_and_fetch(value, inc);
+#endif
+};
+
+static inline void _btk_logger_yield()
+{
+#if defined(_WIN32)
+  SwitchToThread();
+#elif defined(BTK_THREAD_POOL_PTHREADS)
+  sched_yield();
+#endif
+};
+
+static void _btk_logger_push(_btk_logger_message* msg)
+{
+  msg->next = 0;
+  _btk_logger_message* prev = _btk_logger_exchange(&_btk_logger_head, msg);
+  _btk_logger_exchange(&(prev->next), msg);
+};
+
+// Must be called only by one thread at a time. Returns 0 if the queue is empty or if a message is being pushed.
+static _btk_logger_message* _btk_logger_pop()
+{
+  _btk_logger_message* tail = _btk_logger_tail;
+  _btk_logger_message* next = _btk_logger_load(&(tail->next));
+  if (tail == &_btk_logger_stub)
+  {
+    if (next == 0)
+      return 0;
+    _btk_logger_tail = next;
+    tail = next;
+    next = _btk_logger_load(&(next->next));
+  }
+  if (next != 0)
+  {
+    _btk_logger_tail = next;
+    return tail;
+  }
+  if (tail != _btk_logger_load(&_btk_logger_head))
+    return 0;
+  _btk_logger_push(&_btk_logger_stub);
+  next = _btk_logger_load(&(tail->next));
+  if (next != 0)
+  {
+    _btk_logger_tail = next;
+    return tail;
+  }
+  return 0;
+};
+#endif
+
+// Messages still queued and repeated messages are written at the exit of the program.
+struct _btk_logger_exit
+{
+  ~_btk_logger_exit() {btk::Logger::SetAsynchronous(false); btk::Logger::Flush();};
+};
+static _btk_logger_exit _btk_logger_exit_guard;
 
 namespace btk
 {
@@ -85,6 +208,18 @@ namespace btk
    *
    * It is possible to select other output streams than std::cout and std::cerr using the method SetDebugStream(), SetWarningStream(), and SetErrorStream().
    *
+   * The logger is thread-safe. By default, a message is written by the thread which sends it. 
+   * In the asynchronous mode (see SetAsynchronous()), the messages are pushed in a lock-free queue and written by a background thread. 
+   * Thus the threads sending messages (e.g. the processes of a batch) do not wait for the output streams. The method Flush() waits for the messages already sent.
+   *
+   * Each message is also stored in a structured record (Logger::Record: level, filename, line, message, context) which can be collected by a Logger::Sink (see SetSink()).
+   * The context of the records (e.g. the file being read) is set for the current thread with the class Logger::Context. 
+   * The sink receives the records whatever the verbose mode.
+   *
+   * To avoid to flood the output when a warning is sent in a loop (e.g. for each corrupted frame of a file), the number of messages written for the same location 
+   * of the code (filename and line) can be limited with SetRepeatLimit(). The following messages of this location are counted and the last one is written by 
+   * Flush() with the number of repetitions (e.g. <tt>message (repeated 500 times)</tt>).
+   *
    * An example to use this logger is:
    * @code{.cpp}
    * #include <btkLogger.h>
@@ -122,6 +257,32 @@ namespace btk
    * Same as Normal but add also file information from where the log where written (if these informations are given).
    */
   
+  /**
+   * @enum Logger::Level
+   * Level of a log message.
+   */
+  /**
+   * @var Logger::Level Logger::DebugLevel
+   * Debug message.
+   */
+  /**
+   * @var Logger::Level Logger::WarningLevel
+   * Warning.
+   */
+  /**
+   * @var Logger::Level Logger::ErrorLevel
+   * Error.
+   */
+  
+  /**
+   * @struct Logger::Record btkLogger.h
+   * @brief Structured information of a log message.
+   *
+   * The filename is empty and the line is null if they were not given with the message. 
+   * The context is the name set by the class Logger::Context in the thread which sent the message (e.g. the file being read).
+   * The number of repetitions is not null only for the records written by Logger::Flush() for a location which exceeded the repeat limit (see Logger::SetRepeatLimit()). 
+   */
+  
   /**
    * Write the message @c msg to the debug stream
    * @note Setting the verbose mode to Normal or Detailed will have the same effect using this method as the file informations (filename, line number) are not given
@@ -131,7 +292,7 @@ namespace btk
 #ifdef NDEBUG
     btkNotUsed(msg);
 #else
-    Logger::PrintMessage(_btk_logger_debug_stream.get(), _btk_logger_debug_affix, msg);
+    Logger::Post(DebugLevel, "", 0, msg);
 #endif
   };
      
@@ -141,7 +302,7 @@ namespace btk
    */
   void Logger::Warning(const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_warning_stream.get(), _btk_logger_warning_affix, msg);
+    Logger::Post(WarningLevel, "", 0, msg);
   };
     
   /**
@@ -150,7 +311,7 @@ namespace btk
    */
   void Logger::Error(const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_error_stream.get(), _btk_logger_error_affix, msg);
+    Logger::Post(ErrorLevel, "", 0, msg);
   }
   
   /**
@@ -161,7 +322,7 @@ namespace btk
 #ifdef NDEBUG
     btkNotUsed(filename); btkNotUsed(line); btkNotUsed(msg);
 #else
-    Logger::PrintMessage(_btk_logger_debug_stream.get(), _btk_logger_debug_affix, filename, line, msg);
+    Logger::Post(DebugLevel, filename, line, msg);
 #endif
   };
   
@@ -170,7 +331,7 @@ namespace btk
    */
   void Logger::Warning(const std::string& filename, int line, const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_warning_stream.get(), _btk_logger_warning_affix, filename, line, msg);
+    Logger::Post(WarningLevel, filename, line, msg);
   };
   
   /**
@@ -178,7 +339,7 @@ namespace btk
    */
   void Logger::Error(const std::string& filename, int line, const std::string& msg)
   {
-    Logger::PrintMessage(_btk_logger_error_stream.get(), _btk_logger_error_affix, filename, line, msg);
+    Logger::Post(ErrorLevel, filename, line, msg);
   };
   
   /**
@@ -194,7 +355,9 @@ namespace btk
    */  
   void Logger::SetVerboseMode(Logger::VerboseMode mode)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_verbose_mode = mode;
+    _btk_logger_lock.Unlock();
   };
       
   /**
@@ -210,7 +373,9 @@ namespace btk
    */
   void Logger::SetPrefix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_prefix = str;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -266,7 +431,9 @@ namespace btk
    */
   void Logger::SetDebugStream(Logger::Stream::Pointer stream)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_debug_stream = stream;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -274,7 +441,9 @@ namespace btk
    */
   void Logger::SetWarningStream(Logger::Stream::Pointer stream)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_warning_stream = stream;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -282,7 +451,9 @@ namespace btk
    */
   void Logger::SetErrorStream(Logger::Stream::Pointer stream)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_error_stream = stream;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -314,7 +485,9 @@ namespace btk
    */
   void Logger::SetDebugAffix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_debug_affix = str;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -322,7 +495,9 @@ namespace btk
    */
   void Logger::SetWarningAffix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_warning_affix = str;
+    _btk_logger_lock.Unlock();
   };
     
   /**
@@ -330,15 +505,243 @@ namespace btk
    */
   void Logger::SetErrorAffix(const std::string& str)
   {
+    _btk_logger_lock.Lock();
     _btk_logger_error_affix = str;
+    _btk_logger_lock.Unlock();
   };
   
   /**
-   * Overload method to print message without information on the file and the line number where the log was written.
+   * Returns the sink collecting the records of the messages (null by default).
    */
-  void Logger::PrintMessage(Stream* level, const std::string& affix, const std::string& msg)
+  Logger::Sink::Pointer Logger::GetSink()
   {
-    Logger::PrintMessage(level, affix, "", 0, msg);
+    _btk_logger_lock.Lock();
+    Sink::Pointer sink = _btk_logger_sink;
+    _btk_logger_lock.Unlock();
+    return sink;
+  };
+  
+  /**
+   * Sets the sink collecting the records of the messages. A null pointer removes the current sink.
+   * In the asynchronous mode, the records are given to the sink by the background thread.
+   */
+  void Logger::SetSink(Logger::Sink::Pointer sink)
+  {
+    _btk_logger_lock.Lock();
+    _btk_logger_sink = sink;
+    _btk_logger_lock.Unlock();
+  };
+  
+  /**
+   * Returns the maximum number of messages written for the same location of the code (0 by default: no limit).
+   */
+  int Logger::GetRepeatLimit()
+  {
+    return _btk_logger_repeat_limit;
+  };
+  
+  /**
+   * Sets the maximum number of messages written for the same location of the code (filename and line, or message without location).
+   * The messages exceeding the limit are counted and the last one is written with the number of repetitions by the method Flush(). 
+   * The counters are reset by Flush(). Setting a null or negative limit removes the limit.
+   */
+  void Logger::SetRepeatLimit(int limit)
+  {
+    _btk_logger_lock.Lock();
+    _btk_logger_repeat_limit = (limit > 0) ? limit : 0;
+    _btk_logger_lock.Unlock();
+  };
+  
+  /**
+   * Returns true if the messages are written by a background thread.
+   */
+  bool Logger::IsAsynchronous()
+  {
+    return (_btk_logger_pool != 0);
+  };
+  
+  /**
+   * Enables or disables the writing of the messages by a background thread. 
+   * Disabling the asynchronous mode waits for the messages already sent. 
+   * The asynchronous mode is not available if the threads or the atomic operations are not supported. In this case, this method does nothing.
+   * @warning This method must not be called while other threads send messages.
+   */
+  void Logger::SetAsynchronous(bool enabled)
+  {
+#if defined(BTK_LOGGER_LOCK_FREE)
+    if (enabled && (_btk_logger_pool == 0))
+    {
+      btk::thread_pool_p* pool = new btk::thread_pool_p(1);
+      if (pool->GetThreadNumber() == 0)
+        delete pool;
+      else
+        _btk_logger_pool = pool;
+    }
+    else if (!enabled && (_btk_logger_pool != 0))
+    {
+      Logger::Flush();
+      delete _btk_logger_pool;
+      _btk_logger_pool = 0;
+    }
+#else
+    btkNotUsed(enabled);
+#endif
+  };
+  
+  /**
+   * Waits for the writing of the messages already sent (asynchronous mode) and writes the last message of each location 
+   * which exceeded the repeat limit with its number of repetitions (see SetRepeatLimit()). The counters of repetitions are then reset.
+   */
+  void Logger::Flush()
+  {
+#if defined(BTK_LOGGER_LOCK_FREE)
+    if (_btk_logger_pool != 0)
+    {
+      while (_btk_logger_add(&_btk_logger_pending, 0) != 0)
+      {
+        _btk_logger_pool->Wait(&_btk_logger_group);
+        _btk_logger_yield();
+      }
+    }
+#endif
+    _btk_logger_lock.Lock();
+    try
+    {
+      for (std::map<std::string, _btk_logger_site>::iterator it = _btk_logger_sites.begin() ; it != _btk_logger_sites.end() ; ++it)
+      {
+        if (it->second.suppressed == 0)
+          continue;
+        it->second.last.repeated = it->second.suppressed;
+        Logger::Write(it->second.last);
+      }
+      _btk_logger_sites.clear();
+    }
+    catch (...)
+    {
+      _btk_logger_lock.Unlock();
+      throw;
+    }
+    _btk_logger_lock.Unlock();
+  };
+  
+  /**
+   * Creates the record of the message and writes it (or queues it in the asynchronous mode).
+   */
+  void Logger::Post(Level level, const std::string& filename, int line, const std::string& msg)
+  {
+#if defined(BTK_LOGGER_LOCK_FREE)
+    if (_btk_logger_pool != 0)
+    {
+      _btk_logger_message* message = new _btk_logger_message;
+      Record& record = message->record;
+      record.level = level;
+      record.filename = filename;
+      record.line = line;
+      record.message = msg;
+      if (_btk_logger_context != 0)
+        record.context = *_btk_logger_context;
+      record.repeated = 0;
+      _btk_logger_push(message);
+      // The first message of a burst starts the writing of the queue.
+      if (_btk_logger_add(&_btk_logger_pending, 1) == 1)
+        _btk_logger_pool->Submit(&_btk_logger_group, &Logger::Drain, 0);
+      return;
+    }
+#endif
+    Record record;
+    record.level = level;
+    record.filename = filename;
+    record.line = line;
+    record.message = msg;
+    if (_btk_logger_context != 0)
+      record.context = *_btk_logger_context;
+    record.repeated = 0;
+    _btk_logger_lock.Lock();
+    try
+    {
+      Logger::Dispatch(record);
+    }
+    catch (...) {} // A log message must not interrupt the code which sent it.
+    _btk_logger_lock.Unlock();
+  };
+  
+  /**
+   * Task of the background thread writing the queued messages until the queue is empty.
+   */
+  void Logger::Drain(void* /* data */)
+  {
+#if defined(BTK_LOGGER_LOCK_FREE)
+    for (;;)
+    {
+      _btk_logger_message* message = _btk_logger_pop();
+      if (message == 0)
+      {
+        _btk_logger_yield(); // A message is being pushed.
+        continue;
+      }
+      _btk_logger_lock.Lock();
+      try
+      {
+        Logger::Dispatch(message->record);
+      }
+      catch (...) {}
+      _btk_logger_lock.Unlock();
+      delete message;
+      if (_btk_logger_add(&_btk_logger_pending, -1) == 0)
+        break;
+    }
+#endif
+  };
+  
+  /**
+   * Applies the repeat limit and writes the record. The logger must be locked.
+   */
+  void Logger::Dispatch(const Record& record)
+  {
+    if (_btk_logger_repeat_limit > 0)
+    {
+      std::string key = record.filename.empty() ? record.message : record.filename + ":" + ToString(record.line);
+      std::map<std::string, _btk_logger_site>::iterator it = _btk_logger_sites.find(key);
+      if (it == _btk_logger_sites.end())
+      {
+        _btk_logger_site site;
+        site.count = 0;
+        site.suppressed = 0;
+        it = _btk_logger_sites.insert(std::make_pair(key, site)).first;
+      }
+      if (++(it->second.count) > _btk_logger_repeat_limit)
+      {
+        ++(it->second.suppressed);
+        it->second.last = record;
+        return;
+      }
+    }
+    Logger::Write(record);
+  };
+  
+  /**
+   * Gives the record to the sink and prints it on the stream of its level. The logger must be locked.
+   */
+  void Logger::Write(const Record& record)
+  {
+    if (_btk_logger_sink.get() != 0)
+      _btk_logger_sink->Write(record);
+    Stream* stream = _btk_logger_debug_stream.get();
+    const std::string* affix = &_btk_logger_debug_affix;
+    if (record.level == WarningLevel)
+    {
+      stream = _btk_logger_warning_stream.get();
+      affix = &_btk_logger_warning_affix;
+    }
+    else if (record.level == ErrorLevel)
+    {
+      stream = _btk_logger_error_stream.get();
+      affix = &_btk_logger_error_affix;
+    }
+    if (record.repeated == 0)
+      Logger::PrintMessage(stream, *affix, record.filename, record.line, record.message);
+    else
+      Logger::PrintMessage(stream, *affix, record.filename, record.line, record.message + " (repeated " + ToString(record.repeated) + " times)");
   };
   
  /**
@@ -346,7 +749,7 @@ namespace btk
   */
   void Logger::PrintMessage(Stream* level, const std::string& affix, const std::string& filename, int line, const std::string& msg)
   {
-    if (_btk_logger_verbose_mode == Logger::Quiet)
+    if ((_btk_logger_verbose_mode == Logger::Quiet) || (level == 0))
       return;
     if (_btk_logger_verbose_mode > Logger::MessageOnly)
     {
@@ -404,4 +807,62 @@ namespace btk
       delete this->mp_Output;
   };
   
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @class Logger::Sink btkLogger.h
+   * @brief Interface to collect the structured records of the log messages (e.g. to store them in the report of a batch).
+   *
+   * The records are given to the method Write() by the thread writing the messages (the background thread in the asynchronous mode).
+   * An exception thrown by this method is ignored. The method must not send log messages.
+   *
+   * @sa Logger::SetSink
+   */
+  
+  /**
+   * @typedef Logger::Sink::Pointer
+   * Smart pointer associated with a Logger::Sink object.
+   */
+  
+  /**
+   * @fn virtual Logger::Sink::~Sink()
+   * Destructor.
+   */
+  
+  /**
+   * @fn virtual void Logger::Sink::Write(const Record& record) = 0
+   * Collects the given record.
+   */
+  
+  /**
+   * @fn Logger::Sink::Sink()
+   * Constructor.
+   */
+  
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @class Logger::Context btkLogger.h
+   * @brief Sets the context of the records sent by the current thread during the lifetime of this object.
+   *
+   * The previous context is restored when the object is destroyed. 
+   * The AcquisitionFileReader and AcquisitionFileWriter classes set the filename as the context of the messages sent by their IO.
+   */
+  
+  /**
+   * Sets @a name as the context of the records sent by the current thread.
+   */
+  Logger::Context::Context(const std::string& name)
+  : m_Name(name), mp_Previous(_btk_logger_context)
+  {
+    _btk_logger_context = &(this->m_Name);
+  };
+  
+  /**
+   * Restores the previous context.
+   */
+  Logger::Context::~Context()
+  {
+    _btk_logger_context = this->mp_Previous;
+  };
 };
\ No newline at end of file
@@ -101,6 +101,17 @@ namespace btk
   {
   public:
     typedef enum {Quiet = 0, MessageOnly = 1, Normal = 2, Detailed = 3} VerboseMode;
+    typedef enum {DebugLevel = 0, WarningLevel = 1, ErrorLevel = 2} Level;
+    
+    struct Record
+    {
+      Level level;
+      std::string filename;
+      int line;
+      std::string message;
+      std::string context;
+      int repeated;
+    };
     
     class Stream
     {
@@ -120,6 +131,32 @@ namespace btk
       bool m_Owned;
     };
     
+    class Sink
+    {
+    public:
+      typedef btkSharedPtr<Sink> Pointer;
+      virtual ~Sink() {};
+      virtual void Write(const Record& record) = 0;
+    protected:
+      Sink() {};
+    private:
+      Sink(const Sink&); // Not implemented.
+      Sink& operator= (const Sink&); // Not implemented.
+    };
+    
+    class Context
+    {
+    public:
+      BTK_COMMON_EXPORT Context(const std::string& name);
+      BTK_COMMON_EXPORT ~Context();
+    private:
+      Context(const Context&); // Not implemented.
+      Context& operator= (const Context&); // Not implemented.
+      
+      std::string m_Name;
+      const std::string* mp_Previous;
+    };
+    
     BTK_COMMON_EXPORT static void Debug(const std::string& msg);
     BTK_COMMON_EXPORT static void Debug(const std::string& filename, int line, const std::string& msg);
 
@@ -152,9 +189,22 @@ namespace btk
     BTK_COMMON_EXPORT static void SetWarningAffix(const std::string& str);
     BTK_COMMON_EXPORT static void SetErrorAffix(const std::string& str);
     
+    BTK_COMMON_EXPORT static Logger::Sink::Pointer GetSink();
+    BTK_COMMON_EXPORT static void SetSink(Logger::Sink::Pointer sink);
+    
+    BTK_COMMON_EXPORT static int GetRepeatLimit();
+    BTK_COMMON_EXPORT static void SetRepeatLimit(int limit);
+    
+    BTK_COMMON_EXPORT static bool IsAsynchronous();
+    BTK_COMMON_EXPORT static void SetAsynchronous(bool enabled);
+    BTK_COMMON_EXPORT static void Flush();
+    
   private:
-    static void PrintMessage(Stream* level, const std::string& affix, const std::string& msg);
+    static void Post(Level level, const std::string& filename, int line, const std::string& msg);
+    static void Dispatch(const Record& record);
+    static void Write(const Record& record);
     static void PrintMessage(Stream* level, const std::string& affix, const std::string& filename, int line, const std::string& msg);
+    static void Drain(void* data);
   };
 };
 
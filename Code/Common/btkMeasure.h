@@ -37,7 +37,9 @@
 #define __btkMeasure_h
 
 #include "btkDataObject.h"
+#include "btkHash.h"
 #include "btkLogger.h"
+#include "btkMeasureValues.h"
 
 #include <Eigen/Core>
 #include <string>
@@ -52,19 +54,66 @@ namespace btk
   {
   public:
     typedef typename MeasureTraits<Derived>::Values Values; ///< Measures' values along the time.
+    typedef Eigen::Matrix<float, Eigen::Dynamic, Values::ColsAtCompileTime> SingleValues; ///< Measures' values stored in single precision.
     
     /**
      * Returns values of the measure. The exact output type depend of the Derived class
+     * If the values are stored in a compact form (e.g. single precision), they are first converted in double precision (the data is then modified).
      */
-    Values& GetValues() {return this->m_Values;};
+    Values& GetValues() {this->Expand(); return this->m_Values;};
     /**
-     * Returns values of the measure. The exact output type depend of the Derived class
+     * Returns values of the measure stored in double precision. The exact output type depend of the Derived class
+     * This method never converts the values stored in a compact form (e.g. single precision) and an error is reported if they are (the returned values are then empty).
+     * Use the method Expand() to convert them explicitly before (for example, before to read them concurrently).
      */
-    const Values& GetValues() const {return this->m_Values;};
+    const Values& GetValues() const {if (this->m_Compacted) btkErrorMacro("The values are stored in a compact form. Use the method Expand() before to access them."); return this->m_Values;};
     /**
      * Sets values for the measure. The exact input type depend of the Derived class
+     * If the values are stored in single precision, they are directly converted.
      */
     void SetValues(const Values& v);
+    void SwapValues(Values& v);
+    void AdoptValues(typename Values::Scalar* data, int frameNumber, btkSharedPtr<void> owner);
+    /**
+     * Returns the number of frames, without converting the values stored in a compact form.
+     */
+    virtual int GetFrameNumber() const {return static_cast<int>(this->m_SinglePrecision ? this->m_SingleValues.rows() : this->m_Values.rows());};
+    
+    /**
+     * Returns true if the values are stored in a compact form (e.g. single precision) and have to be expanded before to be accessed with the const method GetValues().
+     */
+    bool IsCompacted() const {return this->m_Compacted;};
+    /**
+     * Converts the values stored in a compact form (e.g. single precision) in double precision. Nothing is done if they are not compacted.
+     */
+    void Expand() {if (this->m_Compacted) {this->ExpandValues(); this->Modified();}};
+    
+    /**
+     * Returns true if the values are stored in single precision.
+     */
+    bool IsSinglePrecision() const {return this->m_SinglePrecision;};
+    void SetSinglePrecision(bool enabled);
+    /**
+     * Returns the values stored in single precision. 
+     * This storage is empty if the method IsSinglePrecision() returns false.
+     * This method is mostly used by the file readers to fill directly the single precision storage.
+     */
+    SingleValues& GetSingleValues() {return this->m_SingleValues;};
+    /**
+     * Returns the values stored in single precision. 
+     * This storage is empty if the method IsSinglePrecision() returns false.
+     */
+    const SingleValues& GetSingleValues() const {return this->m_SingleValues;};
+    
+    /**
+     * Adds the values to the digest @a hash, always in double precision. The digest does not depend on the form used to store the values.
+     */
+    virtual bool HashContent(Hash* hash) const;
+    /**
+     * Adds the memory used by the values, in the precision used to store them, to @a usage.
+     * Values shared with other objects are counted once for their owner.
+     */
+    virtual void AddMemoryUsage(MemoryUsage* usage) const;
     
   protected:
     /**
@@ -81,7 +130,13 @@ namespace btk
      */
     MeasureData& operator=(const MeasureData& ); // Not implemented.
     
+    virtual void CompactValues();
+    virtual void ExpandValues();
+    
     typename MeasureData<Derived>::Values m_Values; ///< Values of the measure.
+    typename MeasureData<Derived>::SingleValues m_SingleValues; ///< Values of the measure stored in single precision.
+    bool m_SinglePrecision; ///< Flag to know if the values are stored in single precision.
+    bool m_Compacted; ///< Flag to know if the values have to be expanded before to be accessed.
   };
   
   template <class Derived>
@@ -99,7 +154,7 @@ namespace btk
      */
     typename Measure<Derived>::Values& GetValues();
     /**
-     * Convenient method to return the values associated with measure's data.
+     * Convenient method to return the values associated with measure's data, without converting the values stored in a compact form (see MeasureData::GetValues() const).
      * @warning This method tries to access directly to data's values even if no data has been set. Use this method carefully or use GetData() to access to measure's data. 
      */
     const typename Measure<Derived>::Values& GetValues() const;
@@ -108,6 +163,17 @@ namespace btk
      * If no data exists for this object, then it is created and the values are assigned to it.
      */
     void SetValues(const Values& v);
+    /**
+     * Convenient method to exchange the values of the measure's data with @a v, without any copy.
+     * If no data exists for this object, then it is created before the exchange.
+     */
+    void SwapValues(Values& v);
+    /**
+     * Convenient method to set the values of the measure's data as a view over the memory pointed by @a data, without any copy.
+     * If no data exists for this object, then it is created.
+     * See MeasureData::AdoptValues() for more details.
+     */
+    void AdoptValues(typename Values::Scalar* data, int frameNumber, btkSharedPtr<void> owner);
     
     /**
      * Returns the number of frames.
@@ -128,6 +194,20 @@ namespace btk
      */
     void SetData(typename Measure<Derived>::Data::Pointer data, bool parenting = true);
     
+    /**
+     * Adds the label, the description and the data of this measure to the digest @a hash.
+     */
+    virtual bool HashContent(Hash* hash) const;
+    /**
+     * Returns the digest of the method HashContent(). It is cached and computed again only when the timestamp of this measure or of its data changes.
+     * @warning The values modified by reference (e.g. with GetValues()) do not change the timestamp. Call Modified() after such modifications, otherwise the returned digest is stale.
+     */
+    virtual bool GetContentHash(Hash::Value* digest) const;
+    /**
+     * Adds the strings and the memory used by the data to @a usage. The data shared by several measures is counted once.
+     */
+    virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
   protected:
     /**
      * Constructor.
@@ -174,7 +254,7 @@ namespace btk
    const typename Measure<Derived>::Values& Measure<Derived>::GetValues() const
    {
      assert(this->mp_Data != Measure<Derived>::Data::Null);
-     return this->mp_Data->GetValues();
+     return static_cast<const typename Measure<Derived>::Data*>(this->mp_Data.get())->GetValues();
    };
   
   template <class Derived>
@@ -186,12 +266,30 @@ namespace btk
     this->Modified();
   };
   
+  template <class Derived>
+  void Measure<Derived>::SwapValues(typename Measure<Derived>::Values& v)
+  {
+    if (!this->mp_Data)
+      this->SetData(Measure<Derived>::Data::New(0));
+    this->mp_Data->SwapValues(v);
+    this->Modified();
+  };
+  
+  template <class Derived>
+  void Measure<Derived>::AdoptValues(typename Measure<Derived>::Values::Scalar* data, int frameNumber, btkSharedPtr<void> owner)
+  {
+    if (!this->mp_Data)
+      this->SetData(Measure<Derived>::Data::New(0));
+    this->mp_Data->AdoptValues(data, frameNumber, owner);
+    this->Modified();
+  };
+  
   template <class Derived>
   int Measure<Derived>::GetFrameNumber() const 
   {
     if (!this->mp_Data)
       return 0;
-    return static_cast<int>(this->mp_Data->GetValues().rows());
+    return this->mp_Data->GetFrameNumber();
   };
  
   template <class Derived>
@@ -225,6 +323,32 @@ namespace btk
       this->mp_Data->SetParent(this);
     this->Modified();
   };
+  
+  template <class Derived>
+  bool Measure<Derived>::HashContent(Hash* hash) const
+  {
+    hash->Add(this->m_Label);
+    hash->Add(this->m_Description);
+    hash->Add(this->mp_Data != Measure<Derived>::Data::Null);
+    return !this->mp_Data || this->mp_Data->HashContent(hash);
+  };
+  
+  template <class Derived>
+  bool Measure<Derived>::GetContentHash(Hash::Value* digest) const
+  {
+    unsigned long int version = this->GetTimestamp();
+    if (this->mp_Data && (this->mp_Data->GetTimestamp() > version))
+      version = this->mp_Data->GetTimestamp();
+    return this->GetCachedContentHash(digest, version);
+  };
+  
+  template <class Derived>
+  void Measure<Derived>::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    this->DataObjectLabeled::AddMemoryUsage(usage);
+    if (this->mp_Data && usage->AddShared(MemoryUsage::Objects, this->mp_Data.get(), 0))
+      this->mp_Data->AddMemoryUsage(usage);
+  };
 
   template <class Derived>
   Measure<Derived>::Measure(const std::string& label, const std::string& desc)
@@ -266,24 +390,131 @@ namespace btk
    * Currently this class store a matrix defined by the given number of frames. The template @a Derived used by this class gives the number of columns (components) of the measure.
    *
    * To add a new type of data (for example for 2D pressure mat or insole), you have to inherit from this class and add the method Resize(int frameNumber). You can also add other informations in inherited classes, like btk::Point::Data which contains reconstruction residuals.
+   *
+   * The values are stored in a btk::MeasureValues object which can own its memory or be a view over memory owned by another object. 
+   * The methods SwapValues() and AdoptValues() use this mechanism to move values in and out of the data without any copy.
+   *
+   * The values can be stored in single precision (see SetSinglePrecision()) to divide by two the memory used. 
+   * In this case, the values are converted back in double precision (and then stored in double precision) as soon as they are accessed with the non const method GetValues().
+   * The computations are then always done in double precision. The const accessors never convert the values (a const object can then be read concurrently): they give only the storage in double precision. Inherited classes storing other values (like the residuals) or proposing another compact form (like the raw samples of btk::Analog::Data) have to override the methods CompactValues() and ExpandValues().
    */
   
   template <class Derived>
   MeasureData<Derived>::MeasureData(int frameNumber)
-  : DataObject(), m_Values(MeasureData::Values::Zero(frameNumber,Derived::Values::ColsAtCompileTime))
+  : DataObject(), m_Values(MeasureData::Values::Zero(frameNumber,Derived::Values::ColsAtCompileTime)), m_SingleValues(), m_SinglePrecision(false), m_Compacted(false)
   {};
   
  template <class Derived>
   MeasureData<Derived>::MeasureData(const MeasureData& toCopy)
-  : DataObject(toCopy), m_Values(toCopy.m_Values)
+  : DataObject(toCopy), m_Values(toCopy.m_Values), m_SingleValues(toCopy.m_SingleValues), m_SinglePrecision(toCopy.m_SinglePrecision), m_Compacted(toCopy.m_Compacted)
   {};
   
   template <class Derived>
   void MeasureData<Derived>::SetValues(const typename MeasureData::Values& v)
   {
-    this->m_Values = v;
+    if (this->m_SinglePrecision)
+      this->m_SingleValues = v.template cast<float>();
+    else
+    {
+      if (this->m_Compacted) // Other compact form (e.g. raw analog samples) released.
+        this->ExpandValues();
+      this->m_Values = v;
+    }
+    this->Modified();
+  };
+  
+  /**
+   * Exchanges the values of the measure with @a v, without any copy. 
+   * This method can be used to move values in (or out of) the measure. 
+   * If the values were stored in a compact form (e.g. single precision), they are first converted in double precision.
+   * @warning The number of frames of the other components of the data (e.g. the residuals of a point) is not modified.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::SwapValues(typename MeasureData::Values& v)
+  {
+    if (this->m_Compacted)
+      this->ExpandValues();
+    this->m_Values.Swap(v);
+    this->Modified();
+  };
+  
+  /**
+   * Sets the values as a view over the memory pointed by @a data, without any copy. 
+   * The memory must contain @a frameNumber frames stored contiguously for each component (column major order).
+   * It is released by the deleter of @a owner (which acts as a release callback) when the values do not reference it anymore (e.g. destruction of the data or resizing).
+   * Until then, the modification of the values writes directly in this memory.
+   * The values previously stored in a compact form (e.g. single precision) are discarded.
+   * @warning The number of frames of the other components of the data (e.g. the residuals of a point) is not modified.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::AdoptValues(typename MeasureData::Values::Scalar* data, int frameNumber, btkSharedPtr<void> owner)
+  {
+    if (this->m_Compacted)
+      this->ExpandValues();
+    this->m_Values.Adopt(data, frameNumber, Derived::Values::ColsAtCompileTime, owner);
+    this->Modified();
+  };
+  
+  template <class Derived>
+  bool MeasureData<Derived>::HashContent(Hash* hash) const
+  {
+    if (this->m_SinglePrecision)
+      hash->AddMatrixAs<double>(this->m_SingleValues);
+    else
+      hash->AddMatrix(this->m_Values);
+    return true;
+  };
+  
+  template <class Derived>
+  void MeasureData<Derived>::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Values, sizeof(float) * this->m_SingleValues.size());
+    const size_t bytes = sizeof(double) * this->m_Values.size();
+    if (this->m_Values.IsShared())
+      usage->AddShared(MemoryUsage::Values, this->m_Values.GetOwner().get(), bytes);
+    else
+      usage->Add(MemoryUsage::Values, bytes);
+  };
+  
+  /**
+   * Enables or disables the storage of the values in single precision. 
+   * The values are converted immediately.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::SetSinglePrecision(bool enabled)
+  {
+    if (this->m_SinglePrecision == enabled)
+      return;
+    if (enabled)
+      this->CompactValues(); // Values rounded
+    else
+      this->ExpandValues();
     this->Modified();
   };
+  
+  /**
+   * Converts the values in single precision and releases the memory used by the values in double precision.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::CompactValues()
+  {
+    this->m_SingleValues = this->m_Values.template cast<float>();
+    this->m_Values.resize(0, Derived::Values::ColsAtCompileTime);
+    this->m_SinglePrecision = true;
+    this->m_Compacted = true;
+  };
+  
+  /**
+   * Converts the values in double precision and releases the memory used by the values in single precision.
+   */
+  template <class Derived>
+  void MeasureData<Derived>::ExpandValues()
+  {
+    this->m_Values = this->m_SingleValues.template cast<double>();
+    this->m_SingleValues.resize(0, Derived::Values::ColsAtCompileTime);
+    this->m_SinglePrecision = false;
+    this->m_Compacted = false;
+  };
 };
 
 #endif // __btkMeasure_h
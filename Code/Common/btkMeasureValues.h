@@ -0,0 +1,330 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkMeasureValues_h
+#define __btkMeasureValues_h
+
+#include "btkSharedPtr.h"
+
+#include <Eigen/Core>
+#include <new> // placement new
+#include <algorithm> // std::swap
+
+namespace btk
+{
+  template <typename StrideType>
+  struct MeasureValuesStride;
+  
+  template <>
+  struct MeasureValuesStride< Eigen::InnerStride<> >
+  {
+    static Eigen::InnerStride<> Natural(Eigen::DenseIndex /* rows */) {return Eigen::InnerStride<>(1);};
+    template <typename MapType> static Eigen::InnerStride<> Current(const MapType& m) {return Eigen::InnerStride<>(m.innerStride());};
+  };
+  
+  template <>
+  struct MeasureValuesStride< Eigen::OuterStride<> >
+  {
+    static Eigen::OuterStride<> Natural(Eigen::DenseIndex rows) {return Eigen::OuterStride<>(rows);};
+    template <typename MapType> static Eigen::OuterStride<> Current(const MapType& m) {return Eigen::OuterStride<>(m.outerStride());};
+  };
+  
+  template <>
+  struct MeasureValuesStride< Eigen::Stride<0,0> >
+  {
+    static Eigen::Stride<0,0> Natural(Eigen::DenseIndex /* rows */) {return Eigen::Stride<0,0>();};
+    template <typename MapType> static Eigen::Stride<0,0> Current(const MapType& /* m */) {return Eigen::Stride<0,0>();};
+  };
+  
+  template <typename PlainType, typename StrideType>
+  class MeasureValues : public Eigen::Map<PlainType, Eigen::Unaligned, StrideType>
+  {
+  public:
+    typedef Eigen::Map<PlainType, Eigen::Unaligned, StrideType> MapType;
+    typedef typename PlainType::Base Base; // Required to use Eigen::Map<MeasureValues>.
+    typedef typename PlainType::Scalar Scalar;
+    typedef typename PlainType::Index Index;
+    typedef typename PlainType::ConstantReturnType ConstantReturnType;
+    
+    MeasureValues();
+    explicit MeasureValues(Index size);
+    MeasureValues(Index rows, Index cols);
+    MeasureValues(const MeasureValues& toCopy);
+    template <typename OtherDerived> MeasureValues(const Eigen::DenseBase<OtherDerived>& other);
+    // ~MeasureValues(); // Implicit.
+    
+    MeasureValues& operator=(const MeasureValues& other) {return this->Assign(other);};
+    template <typename OtherDerived> MeasureValues& operator=(const Eigen::DenseBase<OtherDerived>& other) {return this->Assign(other);};
+    
+    void resize(Index rows, Index cols);
+    void resize(Index size) {this->resize(PlainType::IsRowMajor ? 1 : size, PlainType::IsRowMajor ? size : 1);};
+    void conservativeResize(Index rows, Index cols);
+    void conservativeResize(Index size) {this->conservativeResize(PlainType::IsRowMajor ? 1 : size, PlainType::IsRowMajor ? size : 1);};
+    MeasureValues& setZero() {this->MapType::setZero(); return *this;};
+    MeasureValues& setZero(Index rows, Index cols) {this->resize(rows, cols); return this->setZero();};
+    MeasureValues& setZero(Index size) {this->resize(size); return this->setZero();};
+    MeasureValues& setConstant(const Scalar& value) {this->MapType::setConstant(value); return *this;};
+    MeasureValues& setConstant(Index rows, Index cols, const Scalar& value) {this->resize(rows, cols); return this->setConstant(value);};
+    
+    static const ConstantReturnType Zero(Index rows, Index cols) {return PlainType::Zero(rows, cols);};
+    static const ConstantReturnType Zero(Index size) {return PlainType::Zero(size);};
+    static const ConstantReturnType Constant(Index rows, Index cols, const Scalar& value) {return PlainType::Constant(rows, cols, value);};
+    static const ConstantReturnType Constant(Index size, const Scalar& value) {return PlainType::Constant(size, value);};
+    static Eigen::Map<PlainType> Map(Scalar* data, Index rows, Index cols) {return PlainType::Map(data, rows, cols);};
+    static Eigen::Map<PlainType> Map(Scalar* data, Index size) {return PlainType::Map(data, size);};
+    
+    void Share(Scalar* data, Index rows, Index cols, const StrideType& stride, btkSharedPtr<void> owner);
+    void Adopt(Scalar* data, Index rows, Index cols, btkSharedPtr<void> owner) {this->Share(data, rows, cols, MeasureValuesStride<StrideType>::Natural(rows), owner);};
+    bool IsShared() const {return this->m_Shared;};
+    void Detach();
+    void Swap(MeasureValues& other);
+    const btkSharedPtr<void>& GetOwner() const {return this->mp_Owner;};
+    
+  private:
+    template <typename OtherDerived> MeasureValues& Assign(const Eigen::DenseBase<OtherDerived>& other);
+    void Allocate(Index rows, Index cols);
+    void Rebind(Scalar* data, Index rows, Index cols, const StrideType& stride);
+    
+    struct ArrayDeleter
+    {
+      void operator()(Scalar* p) const {delete[] p;};
+    };
+    
+    btkSharedPtr<void> mp_Owner;
+    bool m_Shared;
+  };
+  
+  /**
+   * @class MeasureValues btkMeasureValues.h
+   * @brief Storage of the values of a measure which can own its memory or be a view over memory shared with other measures.
+   *
+   * @tparam PlainType Eigen plain matrix type used to store the values (for example Eigen::Matrix<double,Eigen::Dynamic,1>).
+   * @tparam StrideType Eigen stride type used when the values are a view over shared memory (Eigen::Stride<0,0> when the shared memory is always contiguous, which keeps the linear access to the coefficients).
+   *
+   * This class is an Eigen::Map which can be used exactly like the plain matrix type it replaces.
+   * By default, the values own their memory (the stride is then the natural one). 
+   * Using the method Share(), the values become a view over a memory buffer owned by another object (for example a btk::AnalogBlock).
+   * In this case, the assignment of values with the same dimensions writes directly into the shared memory. 
+   * Any operation modifying the dimensions (resize(), conservativeResize(), assignment of values with other dimensions) detaches the values from the shared memory.
+   *
+   * The method Adopt() uses the same mechanism to map a buffer allocated outside of BTK (for example by a reader or a wrapper) without any copy.
+   * The method Swap() exchanges the memory of two sets of values, which moves values in (or out) without any copy.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * Constructor of an empty set of values.
+   */
+  template <typename PlainType, typename StrideType>
+  MeasureValues<PlainType,StrideType>::MeasureValues()
+  : MapType(0, PlainType::RowsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::RowsAtCompileTime, PlainType::ColsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::ColsAtCompileTime, MeasureValuesStride<StrideType>::Natural(0)), mp_Owner(), m_Shared(false)
+  {};
+  
+  /**
+   * Constructor for vectors which allocates the memory for @a size values (not initialized).
+   */
+  template <typename PlainType, typename StrideType>
+  MeasureValues<PlainType,StrideType>::MeasureValues(Index size)
+  : MapType(0, PlainType::RowsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::RowsAtCompileTime, PlainType::ColsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::ColsAtCompileTime, MeasureValuesStride<StrideType>::Natural(0)), mp_Owner(), m_Shared(false)
+  {
+    this->resize(size);
+  };
+  
+  /**
+   * Constructor of uninitialized values with the given dimensions.
+   */
+  template <typename PlainType, typename StrideType>
+  MeasureValues<PlainType,StrideType>::MeasureValues(Index rows, Index cols)
+  : MapType(0, PlainType::RowsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::RowsAtCompileTime, PlainType::ColsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::ColsAtCompileTime, MeasureValuesStride<StrideType>::Natural(0)), mp_Owner(), m_Shared(false)
+  {
+    this->Allocate(rows, cols);
+  };
+  
+  /**
+   * Copy constructor. The values are always deep copied, even if @a toCopy shares its memory.
+   */
+  template <typename PlainType, typename StrideType>
+  MeasureValues<PlainType,StrideType>::MeasureValues(const MeasureValues& toCopy)
+  : MapType(0, PlainType::RowsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::RowsAtCompileTime, PlainType::ColsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::ColsAtCompileTime, MeasureValuesStride<StrideType>::Natural(0)), mp_Owner(), m_Shared(false)
+  {
+    this->Allocate(toCopy.rows(), toCopy.cols());
+    this->MapType::operator=(toCopy);
+  };
+  
+  /**
+   * Constructor from any Eigen expression. The values are copied in a new memory buffer.
+   */
+  template <typename PlainType, typename StrideType>
+  template <typename OtherDerived>
+  MeasureValues<PlainType,StrideType>::MeasureValues(const Eigen::DenseBase<OtherDerived>& other)
+  : MapType(0, PlainType::RowsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::RowsAtCompileTime, PlainType::ColsAtCompileTime == Eigen::Dynamic ? 0 : PlainType::ColsAtCompileTime, MeasureValuesStride<StrideType>::Natural(0)), mp_Owner(), m_Shared(false)
+  {
+    this->Allocate(other.rows(), other.cols());
+    this->MapType::operator=(other);
+  };
+  
+  /**
+   * Resizes the values. As for an Eigen matrix, the content is not preserved when the dimensions change. 
+   * If the values were shared, they are detached and then own their memory.
+   */
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::resize(Index rows, Index cols)
+  {
+    if ((rows != this->rows()) || (cols != this->cols()))
+      this->Allocate(rows, cols);
+  };
+  
+  /**
+   * Resizes the values and keeps the content of the common block.
+   * If the values were shared, they are detached and then own their memory.
+   */
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::conservativeResize(Index rows, Index cols)
+  {
+    if ((rows == this->rows()) && (cols == this->cols()))
+      return;
+    btkSharedPtr<void> old = this->mp_Owner; // Keep the memory alive during the copy.
+    const MapType previous(this->data(), this->rows(), this->cols(), MeasureValuesStride<StrideType>::Current(*this));
+    this->Allocate(rows, cols);
+    const Index r = (std::min)(rows, previous.rows());
+    const Index c = (std::min)(cols, previous.cols());
+    if ((r != 0) && (c != 0))
+      this->MapType::block(0,0,r,c) = previous.block(0,0,r,c);
+  };
+  
+  /**
+   * Sets the values as a view over the memory pointed by @a data. 
+   * The memory is kept alive by the object @a owner as long as these values reference it.
+   */
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::Share(Scalar* data, Index rows, Index cols, const StrideType& stride, btkSharedPtr<void> owner)
+  {
+    this->Rebind(data, rows, cols, stride);
+    this->mp_Owner = owner;
+    this->m_Shared = true;
+  };
+  
+  /**
+   * @fn void MeasureValues::Adopt(Scalar* data, Index rows, Index cols, btkSharedPtr<void> owner)
+   * Sets the values as a view over the contiguous memory pointed by @a data (with the natural stride of a plain matrix). 
+   * The memory is released by the deleter of @a owner (which can be a callback given by the caller) when these values do not reference it anymore.
+   */
+  
+  /**
+   * Exchanges the memory (and the dimensions) of these values with the one of @a other. No value is copied.
+   * @note Contrary to the method swap() inherited from Eigen, this method does not require the same dimensions and does not modify the content of the memory, even if it is shared.
+   */
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::Swap(MeasureValues& other)
+  {
+    Scalar* data = this->data();
+    const Index rows = this->rows(), cols = this->cols();
+    const StrideType stride = MeasureValuesStride<StrideType>::Current(*this);
+    this->Rebind(other.data(), other.rows(), other.cols(), MeasureValuesStride<StrideType>::Current(other));
+    other.Rebind(data, rows, cols, stride);
+    this->mp_Owner.swap(other.mp_Owner);
+    std::swap(this->m_Shared, other.m_Shared);
+  };
+  
+  /**
+   * Copy the values into a new memory buffer owned by this object, if they are shared.
+   */
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::Detach()
+  {
+    if (!this->m_Shared)
+      return;
+    btkSharedPtr<void> old = this->mp_Owner; // Keep the memory alive during the copy.
+    const MapType previous(this->data(), this->rows(), this->cols(), MeasureValuesStride<StrideType>::Current(*this));
+    this->Allocate(previous.rows(), previous.cols());
+    this->MapType::operator=(previous);
+  };
+  
+  /**
+   * If the dimensions are the same, the values are directly written in the current memory (shared or not).
+   * Otherwise a new memory buffer is allocated.
+   */
+  template <typename PlainType, typename StrideType>
+  template <typename OtherDerived>
+  MeasureValues<PlainType,StrideType>& MeasureValues<PlainType,StrideType>::Assign(const Eigen::DenseBase<OtherDerived>& other)
+  {
+    if ((other.rows() == this->rows()) && (other.cols() == this->cols()))
+      this->MapType::operator=(other);
+    else
+    {
+      btkSharedPtr<void> old = this->mp_Owner; // @a other could be an expression using the current memory.
+      this->Allocate(other.rows(), other.cols());
+      this->MapType::operator=(other);
+    }
+    return *this;
+  };
+  
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::Allocate(Index rows, Index cols)
+  {
+    Scalar* data = 0;
+    if (rows * cols != 0)
+    {
+      data = new Scalar[rows * cols];
+      this->mp_Owner = btkSharedPtr<void>(data, ArrayDeleter());
+    }
+    else
+      this->mp_Owner.reset();
+    this->m_Shared = false;
+    this->Rebind(data, rows, cols, MeasureValuesStride<StrideType>::Natural(rows));
+  };
+  
+  template <typename PlainType, typename StrideType>
+  void MeasureValues<PlainType,StrideType>::Rebind(Scalar* data, Index rows, Index cols, const StrideType& stride)
+  {
+    // Official way to change the array mapped by an Eigen::Map object.
+    new (static_cast<MapType*>(this)) MapType(data, rows, cols, stride);
+  };
+};
+
+namespace Eigen
+{
+  namespace internal
+  {
+    // Eigen::Map<btk::MeasureValues<...> > is then equivalent to Eigen::Map<PlainType>.
+    template <typename PlainType, typename StrideType>
+    struct traits< btk::MeasureValues<PlainType,StrideType> > : public traits<PlainType>
+    {};
+  };
+};
+
+#endif // __btkMeasureValues_h
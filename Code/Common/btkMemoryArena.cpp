@@ -0,0 +1,302 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkMemoryArena.h"
+#include "btkCriticalSection_p.h"
+
+#include <new>
+#include <cstdlib>
+
+namespace btk
+{
+  // Arena used by the current thread (if any).
+  static btkThreadLocal MemoryArena* _btk_current_arena = 0;
+  
+  // Size of the header stored before each allocated object. It keeps the alignment of the objects.
+  static const size_t _btk_arena_header = 16;
+  
+  /**
+   * @class MemoryArena btkMemoryArena.h
+   * @brief Memory pool used to allocate the objects of an acquisition.
+   *
+   * Reading a file creates a lot of small objects (points, analog channels, events, metadata, etc.). 
+   * Allocating each of them separately with the heap leads to an overhead and a fragmentation of the memory, which is noticeable when thousands of files are processed.
+   * A memory arena allocates these objects consecutively in large chunks of memory, which are released in one time.
+   *
+   * The objects are allocated in the arena set for the current thread with the class MemoryArena::Scope.
+   * Only the objects inheriting from btk::DataObject and the btk::MetaDataInfo objects use the arena. 
+   * Their internal buffers (strings, values, etc.) are still allocated with the heap.
+   * Without arena, the objects are allocated with the heap.
+   *
+   * The memory of an arena is never reused: the destruction of an object only decreases the number of objects stored in the arena. 
+   * The chunks are released when the arena is not referenced anymore (see Pointer) and all its objects are destroyed. 
+   * An object kept after the destruction of its acquisition keeps then all the chunks of the arena.
+   *
+   * @code
+   * btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+   * reader->GetOutput()->SetMemoryArena(btk::MemoryArena::New());
+   * reader->SetFilename("myfile.c3d");
+   * reader->Update(); // All the objects created by the reader are stored in the arena.
+   * @endcode
+   *
+   * @sa Acquisition::SetMemoryArena
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @typedef MemoryArena::Pointer
+   * Smart pointer associated with a MemoryArena object.
+   */
+  
+  /**
+   * @typedef MemoryArena::ConstPointer
+   * Smart pointer associated with a const MemoryArena object.
+   */
+  
+  /**
+   * @typedef MemoryArena::NullPointer
+   * Special null pointer associated with a MemoryArena object.
+   * This type should be used only internally to test the nullity of a smart pointer.
+   * See the static method Null() instead.
+   */
+  
+  /**
+   * @class MemoryArena::Scope btkMemoryArena.h
+   * @brief Sets the arena used by the current thread during the lifetime of this object.
+   *
+   * A null arena can be given to allocate the objects with the heap during the scope.
+   * The previous arena is restored when the scope is destroyed.
+   */
+  
+  /**
+   * Sets @a arena as the arena used by the current thread.
+   * @warning The arena must be referenced (by example by its acquisition) during the lifetime of the scope.
+   */
+  MemoryArena::Scope::Scope(MemoryArena::Pointer arena)
+  : mp_Previous(_btk_current_arena)
+  {
+    _btk_current_arena = arena.get();
+  };
+  
+  /**
+   * Sets @a arena as the arena used by the current thread. 
+   * This constructor can be used to share the arena of a thread (see GetCurrent()) with another thread.
+   * @warning The arena must be referenced (by example by its acquisition) during the lifetime of the scope.
+   */
+  MemoryArena::Scope::Scope(MemoryArena* arena)
+  : mp_Previous(_btk_current_arena)
+  {
+    _btk_current_arena = arena;
+  };
+  
+  /**
+   * Restores the previous arena used by the current thread.
+   */
+  MemoryArena::Scope::~Scope()
+  {
+    _btk_current_arena = this->mp_Previous;
+  };
+  
+  /**
+   * Creates a smart pointer associated with a MemoryArena object.
+   * The memory is allocated by chunks of @a chunkSize bytes.
+   */
+  MemoryArena::Pointer MemoryArena::New(size_t chunkSize)
+  {
+    return Pointer(new MemoryArena(chunkSize), Deleter());
+  };
+  
+  /**
+   * @fn static NullPointer MemoryArena::Null()
+   * Static function to return a null pointer.
+   */
+  
+  /**
+   * @fn size_t MemoryArena::GetChunkSize() const
+   * Returns the size (in bytes) of the chunks allocated by the arena.
+   */
+  
+  /**
+   * Returns the number of chunks allocated by the arena.
+   */
+  size_t MemoryArena::GetChunkNumber() const
+  {
+    this->mp_Lock->Lock();
+    size_t num = this->m_Chunks.size();
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the memory (in bytes) allocated by the arena.
+   */
+  size_t MemoryArena::GetAllocatedSize() const
+  {
+    this->mp_Lock->Lock();
+    size_t size = this->m_AllocatedSize;
+    this->mp_Lock->Unlock();
+    return size;
+  };
+  
+  /**
+   * Returns the number of objects stored in the arena and not yet destroyed.
+   * The asynchronous updates using the arena (see AsyncUpdate) are counted as an object until the destruction of their handle.
+   */
+  int MemoryArena::GetObjectNumber() const
+  {
+    this->mp_Lock->Lock();
+    int num = this->m_ObjectNumber;
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the arena used by the current thread or a null pointer if the objects are allocated with the heap.
+   */
+  MemoryArena* MemoryArena::GetCurrent()
+  {
+    return _btk_current_arena;
+  };
+  
+  /**
+   * Allocates @a size bytes in the arena used by the current thread, or with the heap if there is no arena.
+   * This method is used by the operator new of the objects which can be stored in an arena.
+   * The memory must be released with the method Deallocate().
+   */
+  void* MemoryArena::Allocate(size_t size)
+  {
+    char* ptr = 0;
+    MemoryArena* arena = _btk_current_arena;
+    if (arena != 0)
+      ptr = static_cast<char*>(arena->AllocateBlock(size + _btk_arena_header));
+    else
+    {
+      ptr = static_cast<char*>(malloc(size + _btk_arena_header));
+      if (ptr == 0)
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<MemoryArena**>(ptr) = arena;
+    return ptr + _btk_arena_header;
+  };
+  
+  /**
+   * Releases the memory allocated by the method Allocate().
+   */
+  void MemoryArena::Deallocate(void* ptr)
+  {
+    if (ptr == 0)
+      return;
+    char* block = static_cast<char*>(ptr) - _btk_arena_header;
+    MemoryArena* arena = *reinterpret_cast<MemoryArena**>(block);
+    if (arena != 0)
+      arena->Release(false);
+    else
+      free(block);
+  };
+  
+  MemoryArena::MemoryArena(size_t chunkSize)
+  : m_Chunks()
+  {
+    this->m_ChunkSize = chunkSize;
+    this->m_AllocatedSize = 0;
+    this->mp_Head = 0;
+    this->m_Remaining = 0;
+    this->m_ObjectNumber = 0;
+    this->m_Owned = true;
+    this->mp_Lock = new critical_section_p;
+  };
+  
+  MemoryArena::~MemoryArena()
+  {
+    for (size_t i = 0 ; i < this->m_Chunks.size() ; ++i)
+      free(this->m_Chunks[i]);
+    delete this->mp_Lock;
+  };
+  
+  void* MemoryArena::AllocateBlock(size_t size)
+  {
+    size = (size + _btk_arena_header - 1) / _btk_arena_header * _btk_arena_header;
+    this->mp_Lock->Lock();
+    if (size > this->m_Remaining)
+    {
+      // Objects larger than the chunks have their own chunk. The current chunk is kept.
+      size_t chunkSize = (size > this->m_ChunkSize) ? size : this->m_ChunkSize;
+      char* chunk = static_cast<char*>(malloc(chunkSize));
+      if (chunk == 0)
+      {
+        this->mp_Lock->Unlock();
+        throw std::bad_alloc();
+      }
+      this->m_Chunks.push_back(chunk);
+      this->m_AllocatedSize += chunkSize;
+      if (chunkSize != this->m_ChunkSize)
+      {
+        ++this->m_ObjectNumber;
+        this->mp_Lock->Unlock();
+        return chunk;
+      }
+      this->mp_Head = chunk;
+      this->m_Remaining = chunkSize;
+    }
+    void* ptr = this->mp_Head;
+    this->mp_Head += size;
+    this->m_Remaining -= size;
+    ++this->m_ObjectNumber;
+    this->mp_Lock->Unlock();
+    return ptr;
+  };
+  
+  // Keeps the arena alive like an object stored in it (released with Release(false)).
+  // Used by the tasks which set the arena for another thread after the end of the scope of their creator (see AsyncUpdate).
+  void MemoryArena::Retain()
+  {
+    this->mp_Lock->Lock();
+    ++this->m_ObjectNumber;
+    this->mp_Lock->Unlock();
+  };
+  
+  void MemoryArena::Release(bool owner)
+  {
+    this->mp_Lock->Lock();
+    if (owner)
+      this->m_Owned = false;
+    else
+      --this->m_ObjectNumber;
+    bool destroy = !this->m_Owned && (this->m_ObjectNumber == 0);
+    this->mp_Lock->Unlock();
+    if (destroy)
+      delete this;
+  };
+};
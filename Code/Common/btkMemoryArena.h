@@ -0,0 +1,110 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkMemoryArena_h
+#define __btkMemoryArena_h
+
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace btk
+{
+  class critical_section_p;
+  class AsyncUpdate;
+  
+  class MemoryArena
+  {
+  public:
+    typedef btkSharedPtr<MemoryArena> Pointer;
+    typedef btkSharedPtr<const MemoryArena> ConstPointer;
+    typedef btkNullPtr<MemoryArena> NullPointer;
+    
+    class Scope
+    {
+    public:
+      BTK_COMMON_EXPORT Scope(MemoryArena::Pointer arena);
+      BTK_COMMON_EXPORT Scope(MemoryArena* arena);
+      BTK_COMMON_EXPORT ~Scope();
+    private:
+      Scope(const Scope& ); // Not implemented.
+      Scope& operator=(const Scope& ); // Not implemented.
+      
+      MemoryArena* mp_Previous;
+    };
+    
+    BTK_COMMON_EXPORT static Pointer New(size_t chunkSize = 65536);
+    static NullPointer Null() {return NullPointer();};
+    
+    size_t GetChunkSize() const {return this->m_ChunkSize;};
+    BTK_COMMON_EXPORT size_t GetChunkNumber() const;
+    BTK_COMMON_EXPORT size_t GetAllocatedSize() const;
+    BTK_COMMON_EXPORT int GetObjectNumber() const;
+    
+    BTK_COMMON_EXPORT static MemoryArena* GetCurrent();
+    BTK_COMMON_EXPORT static void* Allocate(size_t size);
+    BTK_COMMON_EXPORT static void Deallocate(void* ptr);
+    
+  private:
+    MemoryArena(size_t chunkSize);
+    ~MemoryArena();
+    MemoryArena(const MemoryArena& ); // Not implemented.
+    MemoryArena& operator=(const MemoryArena& ); // Not implemented.
+    
+    void* AllocateBlock(size_t size);
+    void Retain();
+    void Release(bool owner);
+    
+    struct Deleter
+    {
+      void operator()(MemoryArena* arena) const {arena->Release(true);};
+    };
+    
+    friend class AsyncUpdate;
+    
+    size_t m_ChunkSize;
+    std::vector<char*> m_Chunks;
+    size_t m_AllocatedSize;
+    char* mp_Head;
+    size_t m_Remaining;
+    int m_ObjectNumber;
+    bool m_Owned;
+    critical_section_p* mp_Lock;
+  };
+};
+
+#endif // __btkMemoryArena_h
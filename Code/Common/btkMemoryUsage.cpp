@@ -0,0 +1,165 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkMemoryUsage.h"
+
+#include <iomanip>
+
+namespace btk
+{
+  /**
+   * @class MemoryUsage btkMemoryUsage.h
+   * @brief Memory used by data objects, sorted by component.
+   *
+   * The memory is accumulated by the method DataObject::AddMemoryUsage() and is mostly used 
+   * with DataObject::GetMemoryUsage(). The sizes are estimations: the bookkeeping of the 
+   * allocators and of the smart pointers is not counted, and a string counts for its capacity.
+   *
+   * A buffer shared by several objects (e.g. an AnalogBlock, or values adopted from an external 
+   * buffer) is counted only once (see AddShared()).
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @enum MemoryUsage::Component
+   * Components of the memory used.
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::Objects
+   * Structure of the objects (size of the classes and of the containers' nodes).
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::Values
+   * Values of the points and of the analog channels (in double, single precision or raw samples).
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::Residuals
+   * Residuals of the points.
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::Strings
+   * Labels, descriptions, units and other strings (except the metadata).
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::MetaData
+   * Metadata (entries, strings and values).
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::Calibrations
+   * Geometry and calibration matrices of the force platforms.
+   */
+  /**
+   * @var MemoryUsage::Component MemoryUsage::Meshes
+   * Vertices, edges and faces of the triangle meshes.
+   */
+  
+  /**
+   * Constructor. Every component is set to 0.
+   */
+  MemoryUsage::MemoryUsage()
+  : m_SharedBuffers()
+  {
+    this->Clear();
+  };
+  
+  /**
+   * @fn size_t MemoryUsage::Get(Component c) const
+   * Returns the number of bytes used by the component @a c.
+   */
+  
+  /**
+   * Returns the number of bytes used by all the components.
+   */
+  size_t MemoryUsage::GetTotal() const
+  {
+    size_t total = 0;
+    for (int i = 0 ; i < ComponentNumber ; ++i)
+      total += this->mp_Bytes[i];
+    return total;
+  };
+  
+  /**
+   * @fn void MemoryUsage::Add(Component c, size_t bytes)
+   * Adds @a bytes to the component @a c.
+   */
+  
+  /**
+   * @fn void MemoryUsage::Add(Component c, const std::string& str)
+   * Adds the capacity of the string @a str to the component @a c.
+   */
+  
+  /**
+   * Adds @a bytes to the component @a c only if the @a buffer was not already added.
+   * Returns true if the bytes are added.
+   */
+  bool MemoryUsage::AddShared(Component c, const void* buffer, size_t bytes)
+  {
+    if (!this->m_SharedBuffers.insert(buffer).second)
+      return false;
+    this->mp_Bytes[c] += bytes;
+    return true;
+  };
+  
+  /**
+   * Sets every component to 0 and forgets the shared buffers.
+   */
+  void MemoryUsage::Clear()
+  {
+    for (int i = 0 ; i < ComponentNumber ; ++i)
+      this->mp_Bytes[i] = 0;
+    this->m_SharedBuffers.clear();
+  };
+  
+  /**
+   * Returns the name of the component @a c.
+   */
+  const char* MemoryUsage::GetComponentName(Component c)
+  {
+    static const char* names[ComponentNumber] = {"Objects", "Values", "Residuals", "Strings", "MetaData", "Calibrations", "Meshes"};
+    return names[c];
+  };
+  
+  /**
+   * Prints the number of bytes of each component and the total (one per line).
+   */
+  void MemoryUsage::Print(std::ostream& os) const
+  {
+    for (int i = 0 ; i < ComponentNumber ; ++i)
+      os << std::left << std::setw(14) << GetComponentName(static_cast<Component>(i)) << std::right << std::setw(14) << this->mp_Bytes[i] << "\n";
+    os << std::left << std::setw(14) << "Total" << std::right << std::setw(14) << this->GetTotal() << "\n";
+  };
+};
@@ -0,0 +1,75 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkMemoryUsage_h
+#define __btkMemoryUsage_h
+
+#include "btkConfigure.h"
+
+#include <string>
+#include <set>
+#include <ostream>
+#include <cstddef>
+
+namespace btk
+{
+  class MemoryUsage
+  {
+  public:
+    typedef enum {Objects = 0, Values, Residuals, Strings, MetaData, Calibrations, Meshes} Component;
+    
+    BTK_COMMON_EXPORT MemoryUsage();
+    // ~MemoryUsage(); // Implicit.
+    
+    size_t Get(Component c) const {return this->mp_Bytes[c];};
+    BTK_COMMON_EXPORT size_t GetTotal() const;
+    
+    void Add(Component c, size_t bytes) {this->mp_Bytes[c] += bytes;};
+    void Add(Component c, const std::string& str) {this->mp_Bytes[c] += str.capacity();};
+    BTK_COMMON_EXPORT bool AddShared(Component c, const void* buffer, size_t bytes);
+    BTK_COMMON_EXPORT void Clear();
+    
+    BTK_COMMON_EXPORT static const char* GetComponentName(Component c);
+    BTK_COMMON_EXPORT void Print(std::ostream& os) const;
+    
+  private:
+    enum {ComponentNumber = 7};
+    size_t mp_Bytes[ComponentNumber];
+    std::set<const void*> m_SharedBuffers;
+  };
+};
+
+#endif // __btkMemoryUsage_h
@@ -34,6 +34,7 @@
  */
 
 #include "btkMetaData.h"
+#include "btkHash.h"
 #include "btkException.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
@@ -553,6 +554,57 @@ namespace btk
     return pt;
   };
   
+  /**
+   * Adds the label, the description, the lock state, the information (format, dimensions and values) 
+   * and the children of this entry to the digest @a hash.
+   */
+  bool MetaData::HashContent(Hash* hash) const
+  {
+    hash->Add(this->m_Label);
+    hash->Add(this->m_Description);
+    hash->Add(this->m_Unlocked);
+    hash->Add(this->HasInfo());
+    if (this->HasInfo())
+    {
+      hash->Add(static_cast<int>(this->mp_Info->GetFormat()));
+      const std::vector<uint8_t>& dims = this->mp_Info->GetDimensions();
+      hash->Add(static_cast<int>(dims.size()));
+      if (!dims.empty())
+        hash->Add(&(dims[0]), dims.size());
+      const int num = static_cast<int>(this->mp_Info->GetValues().size());
+      hash->Add(num);
+      for (int i = 0 ; i < num ; ++i)
+      {
+        // The integers and the single precision reals are exactly represented by a double.
+        if (this->mp_Info->GetFormat() == MetaDataInfo::Char)
+          hash->Add(this->mp_Info->ToString(i));
+        else
+          hash->Add(this->mp_Info->ToDouble(i));
+      }
+    }
+    hash->Add(this->GetChildNumber());
+    for (ConstIterator it = this->Begin() ; it != this->End() ; ++it)
+    {
+      if (!(*it)->HashContent(hash))
+        return false;
+    }
+    return true;
+  };
+  
+  /**
+   * Adds the memory used by this entry and its children (strings and values included) to the component MemoryUsage::MetaData of @a usage.
+   */
+  void MetaData::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::MetaData, sizeof(MetaData) + this->m_Tree.size() * (2 * sizeof(void*) + sizeof(MetaData::Pointer)));
+    usage->Add(MemoryUsage::MetaData, this->m_Label);
+    usage->Add(MemoryUsage::MetaData, this->m_Description);
+    if (this->HasInfo())
+      this->mp_Info->AddMemoryUsage(usage);
+    for (ConstIterator it = this->Begin() ; it != this->End() ; ++it)
+      (*it)->AddMemoryUsage(usage);
+  };
+  
   /**
    * Equality operator. Doesn't check the parent's value.
    */
@@ -102,6 +102,17 @@ namespace btk
    * for an example.
    */
   
+  /**
+   * @fn static void* MetaDataInfo::operator new(size_t size)
+   * Allocates the object in the memory arena used by the current thread (if any) or with the heap.
+   * @sa MemoryArena::Scope
+   */
+  
+  /**
+   * @fn static void MetaDataInfo::operator delete(void* ptr)
+   * Releases the memory allocated by the operator new.
+   */
+  
   /**
    * @fn MetaDataInfo::Pointer MetaDataInfo::New(int8_t val)
 
@@ -623,6 +634,23 @@ namespace btk
    * @fn MetaDataInfo::Pointer MetaDataInfo::Clone() const
    * Returns a deep copy of the object as a smart pointer.
    */
+  
+  /**
+   * Adds the memory used by this object, its dimensions and its values to the component MemoryUsage::MetaData of @a usage.
+   */
+  void MetaDataInfo::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    size_t bytes = sizeof(MetaDataInfo) + this->m_Dims.capacity() * sizeof(uint8_t) + this->m_Values.capacity() * sizeof(void*);
+    // Each value is allocated separately.
+    if (this->m_Format == Char)
+    {
+      for (std::vector<void*>::const_iterator it = this->m_Values.begin() ; it != this->m_Values.end() ; ++it)
+        bytes += sizeof(std::string) + static_cast<const std::string*>(*it)->capacity();
+    }
+    else
+      bytes += this->m_Values.size() * static_cast<size_t>(this->m_Format);
+    usage->Add(MemoryUsage::MetaData, bytes);
+  };
 
   /**
    * Convert stored value at index @a idx into string.
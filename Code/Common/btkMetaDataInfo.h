@@ -38,6 +38,8 @@
 
 #include "btkSharedPtr.h"
 #include "btkNullPtr.h"
+#include "btkMemoryArena.h"
+#include "btkMemoryUsage.h"
 
 #include <string>
 #include <vector>
@@ -73,6 +75,9 @@ namespace btk
     static Pointer New(const std::vector<uint8_t>& dim, const std::vector<std::string>& val) {return Pointer(new MetaDataInfo(dim, val));};
     
     static NullPointer Null() {return NullPointer();}; 
+    
+    static void* operator new(size_t size) {return MemoryArena::Allocate(size);};
+    static void operator delete(void* ptr) {MemoryArena::Deallocate(ptr);};
 
     BTK_COMMON_EXPORT ~MetaDataInfo();
     
@@ -108,6 +113,7 @@ namespace btk
     BTK_COMMON_EXPORT void SetValues(const std::vector<uint8_t>& dims, const std::vector<std::string>& val);
     Pointer Clone() const {return Pointer(new MetaDataInfo(*this));};
     //ConstPointer Clone() const {return ConstPointer(new MetaDataInfo(*this));};
+    BTK_COMMON_EXPORT void AddMemoryUsage(MemoryUsage* usage) const;
 
     BTK_COMMON_EXPORT const std::string ToString(int idx) const;
     BTK_COMMON_EXPORT int8_t ToInt8(int idx) const;
@@ -0,0 +1,285 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkPipelineExecutor.h"
+#include "btkThreadPool_p.h"
+#include "btkMemoryArena.h"
+#include "btkException.h"
+
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+namespace btk
+{
+  struct PipelineExecutor::Node
+  {
+    ProcessObject* process;
+    std::vector<size_t> downstream;
+    int remaining; // Number of upstream processes not yet updated.
+    Execution* execution;
+  };
+  
+  struct PipelineExecutor::Execution
+  {
+    std::vector<Node> nodes;
+    std::map<const ProcessObject*, size_t> indices;
+    std::vector<char> visited; // 1: in progress, 2: done.
+    std::vector<size_t> order; // Upstream processes first.
+    thread_pool_p* pool;
+    thread_pool_p::group group;
+    MemoryArena* arena;
+    critical_section_p lock;
+    std::string error;
+  };
+  
+  /**
+   * @class PipelineExecutor btkPipelineExecutor.h
+   * @brief Updates a pipeline by executing its independent branches in parallel.
+   *
+   * The method ProcessObject::Update() updates the inputs of a process one after the other in the calling thread.
+   * This executor discovers the processes upstream of the requested process (or output) and schedules their 
+   * update on a pool of threads in a topological order: a process is updated as soon as all the processes 
+   * generating its inputs are updated. The independent branches of a pipeline (for example, the extraction
+   * of the force platforms and the extraction of the points of an acquisition) are then updated at the same time.
+   *
+   * The modification logic is the same than with the method ProcessObject::Update(): the data of a process are 
+   * generated only if the process or one of its inputs was modified since its last update (or if a region not yet 
+   * generated is requested, see DataObject::SetRequestedRegion()). The requested regions are propagated before the 
+   * update of the processes. A data object used by several processes receives the union of their requested regions.
+   *
+   * @code
+   * btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New();
+   * executor->Update(grwFilter->GetOutput());
+   * @endcode
+   *
+   * Several executors (or threads using the method ProcessObject::Update()) can update pipelines sharing some processes. 
+   * The data of a shared process are generated only once.
+   *
+   * The threads of the executor use the memory arena set for the thread calling the method Update() (see MemoryArena::Scope).
+   *
+   * @warning The processes updated in parallel must not modify the same data objects. Moreover, the values stored 
+   * in a compact form (see Acquisition::SetStoragePrecision()) are converted when they are accessed. Their access by 
+   * several processes at the same time is not safe.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @typedef PipelineExecutor::Pointer
+   * Smart pointer associated with a PipelineExecutor object.
+   */
+  
+  /**
+   * @typedef PipelineExecutor::ConstPointer
+   * Smart pointer associated with a const PipelineExecutor object.
+   */
+  
+  /**
+   * @typedef PipelineExecutor::NullPointer
+   * Type used to return a null pointer.
+   */
+  
+  /**
+   * @fn static Pointer PipelineExecutor::New(int threadNumber = 0)
+   * Creates a smart pointer associated with a PipelineExecutor object using @a threadNumber threads.
+   * If @a threadNumber is null or negative, the number of threads corresponds to the number of processors.
+   */
+  
+  /**
+   * @fn static NullPointer PipelineExecutor::Null()
+   * Static function to return a null pointer.
+   */
+  
+  /**
+   * Destructor. The threads are stopped.
+   */
+  PipelineExecutor::~PipelineExecutor()
+  {
+    delete this->mp_Pool;
+  };
+  
+  /**
+   * Returns the number of threads used to update the pipelines. 
+   * If the threads are not supported, this number is 0 and the processes are updated in the calling thread.
+   */
+  int PipelineExecutor::GetThreadNumber() const
+  {
+    return this->mp_Pool->GetThreadNumber();
+  };
+  
+  /**
+   * @fn template <typename T> void PipelineExecutor::Update(btkSharedPtr<T> object)
+   * Updates the pipeline ending with the process @a object or generating the data object @a object. 
+   * Nothing is done if the data object is not the output of a process.
+   *
+   * If an exception is thrown during the generation of the data, the processes depending on it are not updated 
+   * and a RuntimeError exception with the same message is thrown by this method.
+   */
+  
+  /**
+   * Constructor.
+   */
+  PipelineExecutor::PipelineExecutor(int threadNumber)
+  {
+    this->mp_Pool = new thread_pool_p(threadNumber);
+  };
+  
+  /**
+   * Updates the pipeline ending with the process @a process.
+   */
+  void PipelineExecutor::Execute(ProcessObject* process)
+  {
+    Execution e;
+    e.pool = this->mp_Pool;
+    e.arena = MemoryArena::GetCurrent();
+    PipelineExecutor::Discover(&e, process);
+    // The requested regions are propagated from the downstream processes. 
+    // A data object used by several processes receives the union of their regions.
+    std::map<DataObject*, std::pair<int,int> > regions;
+    for (size_t i = e.order.size() ; i > 0 ; --i)
+    {
+      ProcessObject* p = e.nodes[e.order[i-1]].process;
+      p->PropagateRequestedRegion();
+      for (size_t j = 0 ; j < p->m_Inputs.size() ; ++j)
+      {
+        DataObject* input = p->m_Inputs[j].get();
+        if (input == 0)
+          continue;
+        std::map<DataObject*, std::pair<int,int> >::iterator it = regions.find(input);
+        if (it != regions.end())
+        {
+          if ((it->second.first > it->second.second) || !input->HasRequestedRegion())
+            input->ResetRequestedRegion();
+          else
+            input->SetRequestedRegion(std::min(it->second.first, input->GetRequestedFirstFrame()), std::max(it->second.second, input->GetRequestedLastFrame()));
+        }
+        regions[input] = std::make_pair(input->GetRequestedFirstFrame(), input->GetRequestedLastFrame());
+      }
+    }
+    std::vector<Node*> ready;
+    for (size_t i = 0 ; i < e.nodes.size() ; ++i)
+    {
+      if (e.nodes[i].remaining == 0)
+        ready.push_back(&(e.nodes[i]));
+    }
+    // Submitted after the discovery as a task can release other nodes.
+    for (size_t i = 0 ; i < ready.size() ; ++i)
+      this->mp_Pool->Submit(&(e.group), &PipelineExecutor::Run, ready[i]);
+    this->mp_Pool->Wait(&(e.group));
+    if (!e.error.empty())
+      throw RuntimeError(e.error);
+  };
+  
+  // Adds the process and its upstream processes in the graph and returns its index.
+  size_t PipelineExecutor::Discover(Execution* e, ProcessObject* process)
+  {
+    size_t idx = e->nodes.size();
+    e->indices[process] = idx;
+    Node node = {process, std::vector<size_t>(), 0, e};
+    e->nodes.push_back(node);
+    e->visited.push_back(1);
+    std::vector<size_t> upstream;
+    for (size_t i = 0 ; i < process->m_Inputs.size() ; ++i)
+    {
+      DataObject::Pointer input = process->m_Inputs[i];
+      if ((input == DataObject::Null) || (input->mp_Source == 0))
+        continue;
+      size_t srcIdx;
+      std::map<const ProcessObject*, size_t>::const_iterator it = e->indices.find(input->mp_Source);
+      if (it == e->indices.end())
+        srcIdx = PipelineExecutor::Discover(e, input->mp_Source);
+      else if (e->visited[it->second] == 1)
+        continue; // Cycle: this input is not updated (same behaviour than ProcessObject::Update()).
+      else
+        srcIdx = it->second;
+      if (std::find(upstream.begin(), upstream.end(), srcIdx) == upstream.end())
+        upstream.push_back(srcIdx);
+    }
+    for (size_t j = 0 ; j < upstream.size() ; ++j)
+      e->nodes[upstream[j]].downstream.push_back(idx);
+    e->nodes[idx].remaining = static_cast<int>(upstream.size());
+    e->visited[idx] = 2;
+    e->order.push_back(idx);
+    return idx;
+  };
+  
+  // Task updating the process of a node and releasing the downstream processes.
+  void PipelineExecutor::Run(void* data)
+  {
+    Node* node = static_cast<Node*>(data);
+    Execution* e = node->execution;
+    e->lock.Lock();
+    bool failed = !e->error.empty();
+    e->lock.Unlock();
+    if (!failed)
+    {
+      MemoryArena::Scope scope(e->arena);
+      std::string error;
+      try
+      {
+        node->process->UpdateData();
+      }
+      catch (std::exception& err)
+      {
+        error = err.what();
+        if (error.empty())
+          error = "Unknown error.";
+      }
+      catch (...)
+      {
+        error = "Unknown exception.";
+      }
+      if (!error.empty())
+      {
+        e->lock.Lock();
+        if (e->error.empty())
+          e->error = error;
+        e->lock.Unlock();
+      }
+    }
+    // The downstream processes are released even in case of error to finish the execution.
+    for (size_t i = 0 ; i < node->downstream.size() ; ++i)
+    {
+      Node* next = &(e->nodes[node->downstream[i]]);
+      e->lock.Lock();
+      int remaining = --(next->remaining);
+      e->lock.Unlock();
+      if (remaining == 0)
+        e->pool->Submit(&(e->group), &PipelineExecutor::Run, next);
+    }
+  };
+};
@@ -0,0 +1,94 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkPipelineExecutor_h
+#define __btkPipelineExecutor_h
+
+#include "btkProcessObject.h"
+#include "btkDataObject.h"
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+namespace btk
+{
+  class thread_pool_p;
+  
+  class PipelineExecutor
+  {
+  public:
+    typedef btkSharedPtr<PipelineExecutor> Pointer;
+    typedef btkSharedPtr<const PipelineExecutor> ConstPointer;
+    typedef btkNullPtr<PipelineExecutor> NullPointer;
+    
+    static Pointer New(int threadNumber = 0) {return Pointer(new PipelineExecutor(threadNumber));};
+    static NullPointer Null() {return NullPointer();};
+    
+    BTK_COMMON_EXPORT ~PipelineExecutor();
+    
+    BTK_COMMON_EXPORT int GetThreadNumber() const;
+    
+    template <typename T> void Update(btkSharedPtr<T> object);
+    
+  protected:
+    BTK_COMMON_EXPORT PipelineExecutor(int threadNumber);
+    
+  private:
+    PipelineExecutor(const PipelineExecutor& ); // Not implemented.
+    PipelineExecutor& operator=(const PipelineExecutor& ); // Not implemented.
+    
+    struct Node;
+    struct Execution;
+    
+    static ProcessObject* GetProcess(ProcessObject* process) {return process;};
+    static ProcessObject* GetProcess(DataObject* output) {return output->mp_Source;};
+    BTK_COMMON_EXPORT void Execute(ProcessObject* process);
+    static size_t Discover(Execution* e, ProcessObject* process);
+    static void Run(void* node);
+    
+    thread_pool_p* mp_Pool;
+  };
+  
+  template <typename T>
+  void PipelineExecutor::Update(btkSharedPtr<T> object)
+  {
+    if (!object)
+      return;
+    ProcessObject* process = PipelineExecutor::GetProcess(object.get());
+    if (process != 0)
+      this->Execute(process);
+  };
+};
+
+#endif // __btkPipelineExecutor_h
@@ -178,13 +178,13 @@ namespace btk
   }
  
   /**
-   * Convenient method to return the residuals associated with measure's data.
+   * Convenient method to return the residuals associated with measure's data, without converting the residuals stored in single precision.
    * @warning This method tries to access directly to data's residuals even if no data has been set. Use this method carefully or use GetData() to access to point's data. 
    */
   const Point::Residuals& Point::GetResiduals() const
   {
     assert(this->mp_Data != Point::Data::Null);
-    return this->mp_Data->GetResiduals();
+    return static_cast<const Point::Data*>(this->mp_Data.get())->GetResiduals();
   };
 
   /**
@@ -197,6 +197,31 @@ namespace btk
     this->mp_Data->SetResiduals(r);
     this->Modified();
   };
+  
+  /**
+   * Exchanges the residuals with @a r, without any copy.
+   * If no data exists for this object, then it is created before the exchange.
+   */  
+  void Point::SwapResiduals(Residuals& r)
+  {
+    if (!this->mp_Data)
+      this->SetData(Point::Data::New(0));
+    this->mp_Data->SwapResiduals(r);
+    this->Modified();
+  };
+  
+  /**
+   * Sets the residuals as a view over the memory pointed by @a data, without any copy.
+   * If no data exists for this object, then it is created.
+   * See MeasureTraits<Point>::Data::AdoptResiduals() for more details.
+   */  
+  void Point::AdoptResiduals(double* data, int frameNumber, btkSharedPtr<void> owner)
+  {
+    if (!this->mp_Data)
+      this->SetData(Point::Data::New(0));
+    this->mp_Data->AdoptResiduals(data, frameNumber, owner);
+    this->Modified();
+  };
 
   /**
    * @fn Type Point::GetType() const
@@ -214,6 +239,24 @@ namespace btk
     this->Modified();
   };
   
+  /**
+   * Adds the label, the description, the type and the data (values and residuals) of this point to the digest @a hash.
+   */
+  bool Point::HashContent(Hash* hash) const
+  {
+    hash->Add(static_cast<int>(this->m_Type));
+    return this->Measure<Point>::HashContent(hash);
+  };
+  
+  /**
+   * Adds the memory used by this point and its data (values and residuals) to @a usage.
+   */
+  void Point::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Point));
+    this->Measure<Point>::AddMemoryUsage(usage);
+  };
+  
   /**
    * @fn Pointer Point::Clone() const
    * Returns a deep copy of this object.
@@ -308,13 +351,55 @@ namespace btk
   
   /**
    * @fn const MeasureTraits<Point>::Data::Residuals& MeasureTraits<Point>::Data::GetResiduals() const
-   * Returns the residuals for to this data.
+   * Returns the residuals for to this data, without converting the residuals stored in single precision. An error is reported if they are (the returned residuals are then empty). Use the method Expand() before.
    */
   
   /**
    * @fn void MeasureTraits<Point>::Data::SetResiduals(const MeasureTraits<Point>::Data::Residuals& r)
    * Sets the residuals for to this data.
    */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::SwapResiduals(MeasureTraits<Point>::Data::Residuals& r)
+   * Exchanges the residuals with @a r, without any copy. 
+   * If the residuals were stored in single precision, they are first converted in double precision.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::AdoptResiduals(double* data, int frameNumber, btkSharedPtr<void> owner)
+   * Sets the residuals as a view over the @a frameNumber values pointed by @a data, without any copy.
+   * The memory is released by the deleter of @a owner when the residuals do not reference it anymore.
+   */
+  
+  /**
+   * @fn MeasureTraits<Point>::Data::SingleResiduals& MeasureTraits<Point>::Data::GetSingleResiduals()
+   * Returns the residuals stored in single precision. This storage is empty if the method IsSinglePrecision() returns false.
+   */
+  
+  /**
+   * @fn const MeasureTraits<Point>::Data::SingleResiduals& MeasureTraits<Point>::Data::GetSingleResiduals() const
+   * Returns the residuals stored in single precision. This storage is empty if the method IsSinglePrecision() returns false.
+   */
+  
+  /**
+   * @fn bool MeasureTraits<Point>::Data::HashContent(Hash* hash) const
+   * Adds the values and the residuals to the digest @a hash, always in double precision.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::AddMemoryUsage(MemoryUsage* usage) const
+   * Adds the memory used by the values and the residuals, in the precision used to store them, to @a usage.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::CompactValues()
+   * Converts the values and the residuals in single precision.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::ExpandValues()
+   * Converts the values and the residuals in double precision.
+   */
  
   /**
    * @fn MeasureTraits<Point>::Data::Pointer MeasureTraits<Point>::Data::Clone() const
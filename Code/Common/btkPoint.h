@@ -45,8 +45,8 @@ namespace btk
   template <>
   struct MeasureTraits<Point>
   {
-    typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Values; ///< Point' values along the time with 3 components (3 columns).
-    typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Residuals; ///< Vector of double representing the residuals associated with each frames (if applicable).
+    typedef MeasureValues<Eigen::Matrix<double, Eigen::Dynamic, 3>, Eigen::Stride<0,0> > Values; ///< Point' values along the time with 3 components (3 columns).
+    typedef MeasureValues<Eigen::Matrix<double, Eigen::Dynamic, 1>, Eigen::InnerStride<> > Residuals; ///< Vector of double representing the residuals associated with each frames (if applicable).
     
     /**
      * @class Data
@@ -56,6 +56,7 @@ namespace btk
     {
     public:
       typedef MeasureTraits<Point>::Residuals Residuals; ///< Vector of double representing the residuals associated with each frames (if applicable).
+      typedef Eigen::Matrix<float, Eigen::Dynamic, 1> SingleResiduals; ///< Residuals stored in single precision.
       
       typedef btkSharedPtr<Data> Pointer;
       typedef btkSharedPtr<const Data> ConstPointer;
@@ -67,18 +68,30 @@ namespace btk
       
       void Resize(int frameNumber);
       
-      Residuals& GetResiduals() {return this->m_Residuals;};
-      const Residuals& GetResiduals() const {return this->m_Residuals;};
-      void SetResiduals(const Residuals& r) {this->m_Residuals = r; this->Modified();};
+      Residuals& GetResiduals() {this->Expand(); return this->m_Residuals;};
+      const Residuals& GetResiduals() const {if (this->m_Compacted) btkErrorMacro("The residuals are stored in a compact form. Use the method Expand() before to access them."); return this->m_Residuals;};
+      void SetResiduals(const Residuals& r);
+      void SwapResiduals(Residuals& r);
+      void AdoptResiduals(double* data, int frameNumber, btkSharedPtr<void> owner);
+      SingleResiduals& GetSingleResiduals() {return this->m_SingleResiduals;};
+      const SingleResiduals& GetSingleResiduals() const {return this->m_SingleResiduals;};
+      
+      virtual bool HashContent(Hash* hash) const;
+      virtual void AddMemoryUsage(MemoryUsage* usage) const;
       
       Pointer Clone() const {return Pointer(new Data(*this));}
       
+    protected:
+      virtual void CompactValues();
+      virtual void ExpandValues();
+      
     private:
-      Data(int frameNumber) : MeasureData<Point>(frameNumber), m_Residuals(Residuals::Zero(frameNumber,MeasureTraits<Point>::Residuals::ColsAtCompileTime)) {};
-      Data(const Data& toCopy) : MeasureData<Point>(toCopy), m_Residuals(toCopy.m_Residuals) {};
+      Data(int frameNumber) : MeasureData<Point>(frameNumber), m_Residuals(Residuals::Zero(frameNumber,MeasureTraits<Point>::Residuals::ColsAtCompileTime)), m_SingleResiduals() {};
+      Data(const Data& toCopy) : MeasureData<Point>(toCopy), m_Residuals(toCopy.m_Residuals), m_SingleResiduals(toCopy.m_SingleResiduals) {};
       Data& operator=(const Data& ); // Not implemented.
       
       Residuals m_Residuals;
+      SingleResiduals m_SingleResiduals;
     };
   };
 
@@ -106,10 +119,15 @@ namespace btk
     BTK_COMMON_EXPORT Residuals& GetResiduals();
     BTK_COMMON_EXPORT const Residuals& GetResiduals() const;
     BTK_COMMON_EXPORT void SetResiduals(const Residuals& r);
+    BTK_COMMON_EXPORT void SwapResiduals(Residuals& r);
+    BTK_COMMON_EXPORT void AdoptResiduals(double* data, int frameNumber, btkSharedPtr<void> owner);
     
     Type GetType() const {return this->m_Type;};
     BTK_COMMON_EXPORT void SetType(Point::Type t);
     
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
     Pointer Clone() const {return Pointer(new Point(*this));};
     
   protected:
@@ -135,26 +153,89 @@ namespace btk
   
   inline void MeasureTraits<Point>::Data::Resize(int frameNumber)
   {
-    // Values
-    if (frameNumber > this->m_Values.rows())
+    if (this->m_SinglePrecision)
     {
-      Values v = Values::Zero(frameNumber,Values::ColsAtCompileTime);
-      if (this->m_Values.data() != 0)
-        v.block(0,0,this->m_Values.rows(),Values::ColsAtCompileTime) = this->m_Values;
-      this->m_Values = v;
+      const int num = this->GetFrameNumber();
+      this->m_SingleValues.conservativeResize(frameNumber, Values::ColsAtCompileTime);
+      this->m_SingleResiduals.conservativeResize(frameNumber);
+      if (frameNumber > num)
+      {
+        this->m_SingleValues.bottomRows(frameNumber - num).setZero();
+        this->m_SingleResiduals.tail(frameNumber - num).setZero();
+      }
+      return;
     }
-    else
-      this->m_Values.conservativeResize(frameNumber,Values::ColsAtCompileTime);
+    // Values
+    const int num = static_cast<int>(this->m_Values.rows());
+    this->m_Values.conservativeResize(frameNumber,Values::ColsAtCompileTime);
+    if (frameNumber > num)
+      this->m_Values.bottomRows(frameNumber - num).setZero();
     // Residuals
-    if (frameNumber > this->m_Residuals.rows())
-    {
-      Residuals r = Residuals::Zero(frameNumber, Residuals::ColsAtCompileTime);
-      if (this->m_Residuals.data() != 0)
-        r.block(0,0,this->m_Residuals.rows(),Residuals::ColsAtCompileTime) = this->m_Residuals;
+    const int numRes = static_cast<int>(this->m_Residuals.rows());
+    this->m_Residuals.conservativeResize(frameNumber);
+    if (frameNumber > numRes)
+      this->m_Residuals.tail(frameNumber - numRes).setZero();
+  };
+  
+  inline void MeasureTraits<Point>::Data::SetResiduals(const Residuals& r)
+  {
+    if (this->m_SinglePrecision)
+      this->m_SingleResiduals = r.cast<float>();
+    else
       this->m_Residuals = r;
-    }
+    this->Modified();
+  };
+  
+  inline void MeasureTraits<Point>::Data::SwapResiduals(Residuals& r)
+  {
+    if (this->m_Compacted)
+      this->ExpandValues();
+    this->m_Residuals.Swap(r);
+    this->Modified();
+  };
+  
+  inline void MeasureTraits<Point>::Data::AdoptResiduals(double* data, int frameNumber, btkSharedPtr<void> owner)
+  {
+    if (this->m_Compacted)
+      this->ExpandValues();
+    this->m_Residuals.Adopt(data, frameNumber, 1, owner);
+    this->Modified();
+  };
+  
+  inline bool MeasureTraits<Point>::Data::HashContent(Hash* hash) const
+  {
+    this->MeasureData<Point>::HashContent(hash);
+    if (this->m_SinglePrecision)
+      hash->AddMatrixAs<double>(this->m_SingleResiduals);
     else
-      this->m_Residuals.conservativeResize(frameNumber);
+      hash->AddMatrix(this->m_Residuals);
+    return true;
+  };
+  
+  inline void MeasureTraits<Point>::Data::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Data));
+    this->MeasureData<Point>::AddMemoryUsage(usage);
+    usage->Add(MemoryUsage::Residuals, sizeof(float) * this->m_SingleResiduals.size());
+    const size_t bytes = sizeof(double) * this->m_Residuals.size();
+    if (this->m_Residuals.IsShared())
+      usage->AddShared(MemoryUsage::Residuals, this->m_Residuals.GetOwner().get(), bytes);
+    else
+      usage->Add(MemoryUsage::Residuals, bytes);
+  };
+  
+  inline void MeasureTraits<Point>::Data::CompactValues()
+  {
+    this->MeasureData<Point>::CompactValues();
+    this->m_SingleResiduals = this->m_Residuals.cast<float>();
+    this->m_Residuals.resize(0);
+  };
+  
+  inline void MeasureTraits<Point>::Data::ExpandValues()
+  {
+    this->MeasureData<Point>::ExpandValues();
+    this->m_Residuals = this->m_SingleResiduals.cast<double>();
+    this->m_SingleResiduals.resize(0);
   };
 };
 
@@ -0,0 +1,336 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkProcessCache.h"
+#include "btkCriticalSection_p.h"
+#include "btkLogger.h"
+
+namespace btk
+{
+  /**
+   * @class ProcessCache btkProcessCache.h
+   * @brief Memoizes the outputs of the processes for the inputs and the parameters already processed.
+   *
+   * When a cache is set to a process (see ProcessObject::SetCache()), the update of the process 
+   * computes a key with the content of its inputs (see DataObject::HashContent()), its parameters 
+   * (see ProcessObject::HashParameters()) and the regions requested for its outputs. If the key 
+   * is known, the outputs are restored by copy and the method GenerateData() is not called. Otherwise, 
+   * the outputs are generated and a copy is stored in the cache.
+   *
+   * The same cache can be shared by several processes (e.g. the filters of a pipeline) and several threads. 
+   * It keeps the outputs of the @a capacity most recently used keys. An optional storage (see SetStorage()) 
+   * extends it with another tier (e.g. the files of a directory) which is searched when a key is not in memory.
+   *
+   * @code
+   * btk::ProcessCache::Pointer cache = btk::ProcessCache::New(32);
+   * btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+   * btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+   * pfe->SetCache(cache);
+   * grwf->SetCache(cache);
+   * grwf->SetInput(pfe->GetOutput());
+   * for (...) // Each trial
+   * {
+   *   pfe->SetInput(reader->GetOutput());
+   *   grwf->Update(); // Nothing computed if the trial was already processed.
+   * }
+   * @endcode
+   *
+   * @warning The key is a 128-bit digest. Two different contents could give the same key, even if it is extremely unlikely.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @class ProcessCache::Storage btkProcessCache.h
+   * @brief Interface of an additional tier of ProcessCache (e.g. on disk).
+   *
+   * The outputs given to the methods are the outputs of the process updated: Load() has to fill them 
+   * (they are already created by the method ProcessObject::MakeOutput()) while Save() has only to read them.
+   * The methods can be called concurrently by several threads.
+   */
+  
+  /**
+   * @typedef ProcessCache::Storage::Pointer
+   * Smart pointer associated with a ProcessCache::Storage object.
+   */
+  
+  /**
+   * @typedef ProcessCache::Storage::ConstPointer
+   * Smart pointer associated with a const ProcessCache::Storage object.
+   */
+  
+  /**
+   * @fn virtual ProcessCache::Storage::~Storage()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn virtual bool ProcessCache::Storage::Load(Key key, const std::vector<DataObject::Pointer>& outputs) = 0
+   * Fills the @a outputs with the content saved for the key @a key. Returns false if the key is unknown.
+   */
+  
+  /**
+   * @fn virtual void ProcessCache::Storage::Save(Key key, const std::vector<DataObject::Pointer>& outputs) = 0
+   * Saves the content of the @a outputs for the key @a key.
+   */
+  
+  /**
+   * @fn ProcessCache::Storage::Storage()
+   * Constructor.
+   */
+  
+  /**
+   * @typedef ProcessCache::Pointer
+   * Smart pointer associated with a ProcessCache object.
+   */
+  
+  /**
+   * @typedef ProcessCache::ConstPointer
+   * Smart pointer associated with a const ProcessCache object.
+   */
+  
+  /**
+   * @typedef ProcessCache::NullPointer
+   * Type used to return a null pointer.
+   */
+  
+  /**
+   * @typedef ProcessCache::Key
+   * Key associated with the outputs of a process.
+   */
+  
+  /**
+   * @fn static Pointer ProcessCache::New(int capacity = 16)
+   * Creates a cache keeping in memory the outputs of @a capacity keys.
+   */
+  
+  /**
+   * @fn static NullPointer ProcessCache::Null()
+   * Static function to return a null pointer.
+   */
+  
+  /**
+   * Destructor.
+   */
+  ProcessCache::~ProcessCache()
+  {
+    delete this->mp_Lock;
+  };
+  
+  /**
+   * Returns the number of keys kept in memory.
+   */
+  int ProcessCache::GetCapacity() const
+  {
+    this->mp_Lock->Lock();
+    int capacity = this->m_Capacity;
+    this->mp_Lock->Unlock();
+    return capacity;
+  };
+  
+  /**
+   * Sets the number of keys kept in memory. The least recently used entries are removed if necessary.
+   * A capacity of 0 disables the memory tier (only the storage is used, if any).
+   */
+  void ProcessCache::SetCapacity(int capacity)
+  {
+    if (capacity < 0)
+    {
+      btkErrorMacro("The capacity of the cache cannot be negative.");
+      return;
+    }
+    this->mp_Lock->Lock();
+    this->m_Capacity = capacity;
+    this->Evict();
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Returns the additional tier used when a key is not kept in memory (null by default).
+   */
+  ProcessCache::Storage::Pointer ProcessCache::GetStorage() const
+  {
+    this->mp_Lock->Lock();
+    Storage::Pointer storage = this->mp_Storage;
+    this->mp_Lock->Unlock();
+    return storage;
+  };
+  
+  /**
+   * Sets the additional tier used when a key is not kept in memory.
+   */
+  void ProcessCache::SetStorage(Storage::Pointer storage)
+  {
+    this->mp_Lock->Lock();
+    this->mp_Storage = storage;
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Returns the number of keys kept in memory.
+   */
+  int ProcessCache::GetEntryNumber() const
+  {
+    this->mp_Lock->Lock();
+    int num = static_cast<int>(this->m_Index.size());
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of updates which restored their outputs.
+   */
+  int ProcessCache::GetHitNumber() const
+  {
+    this->mp_Lock->Lock();
+    int num = this->m_HitNumber;
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of updates which had to generate their outputs.
+   */
+  int ProcessCache::GetMissNumber() const
+  {
+    this->mp_Lock->Lock();
+    int num = this->m_MissNumber;
+    this->mp_Lock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Removes the entries kept in memory and resets the counters. The storage is not modified.
+   */
+  void ProcessCache::Clear()
+  {
+    this->mp_Lock->Lock();
+    this->m_Entries.clear();
+    this->m_Index.clear();
+    this->m_HitNumber = 0;
+    this->m_MissNumber = 0;
+    this->mp_Lock->Unlock();
+  };
+  
+  /**
+   * Copies in the @a outputs the content stored for the key @a key. 
+   * Returns false if the key is unknown or if one of the outputs cannot be copied (see DataObject::DeepCopy()).
+   */
+  bool ProcessCache::Restore(Key key, const std::vector<DataObject::Pointer>& outputs)
+  {
+    bool restored = false;
+    this->mp_Lock->Lock();
+    std::map<Key, EntryList::iterator>::iterator it = this->m_Index.find(key);
+    if ((it != this->m_Index.end()) && (it->second->outputs.size() == outputs.size()))
+    {
+      // Most recently used
+      this->m_Entries.splice(this->m_Entries.begin(), this->m_Entries, it->second);
+      const std::vector<DataObject::Pointer>& stored = it->second->outputs;
+      restored = true;
+      for (size_t i = 0 ; i < outputs.size() ; ++i)
+      {
+        if ((outputs[i] == DataObject::Null) || (stored[i] == DataObject::Null))
+          restored &= (outputs[i] == stored[i]);
+        else
+          restored &= outputs[i]->DeepCopy(stored[i].get());
+      }
+    }
+    Storage::Pointer storage = this->mp_Storage;
+    this->mp_Lock->Unlock();
+    if (!restored && storage)
+      restored = storage->Load(key, outputs);
+    this->mp_Lock->Lock();
+    if (restored)
+      ++this->m_HitNumber;
+    else
+      ++this->m_MissNumber;
+    this->mp_Lock->Unlock();
+    return restored;
+  };
+  
+  /**
+   * Stores the @a outputs for the key @a key. The objects are kept as is: they must be copies 
+   * of the outputs of the process (see ProcessObject::MakeOutput() and DataObject::DeepCopy()).
+   */
+  void ProcessCache::Store(Key key, const std::vector<DataObject::Pointer>& outputs)
+  {
+    this->mp_Lock->Lock();
+    if (this->m_Capacity != 0)
+    {
+      std::map<Key, EntryList::iterator>::iterator it = this->m_Index.find(key);
+      if (it != this->m_Index.end())
+      {
+        it->second->outputs = outputs;
+        this->m_Entries.splice(this->m_Entries.begin(), this->m_Entries, it->second);
+      }
+      else
+      {
+        Entry entry;
+        entry.key = key;
+        entry.outputs = outputs;
+        this->m_Entries.push_front(entry);
+        this->m_Index[key] = this->m_Entries.begin();
+        this->Evict();
+      }
+    }
+    Storage::Pointer storage = this->mp_Storage;
+    this->mp_Lock->Unlock();
+    if (storage)
+      storage->Save(key, outputs);
+  };
+  
+  /**
+   * Constructor.
+   */
+  ProcessCache::ProcessCache(int capacity)
+  : mp_Storage(), m_Entries(), m_Index()
+  {
+    this->mp_Lock = new critical_section_p;
+    this->m_Capacity = capacity < 0 ? 0 : capacity;
+    this->m_HitNumber = 0;
+    this->m_MissNumber = 0;
+  };
+  
+  // Must be called with the lock acquired.
+  void ProcessCache::Evict()
+  {
+    while (static_cast<int>(this->m_Entries.size()) > this->m_Capacity)
+    {
+      this->m_Index.erase(this->m_Entries.back().key);
+      this->m_Entries.pop_back();
+    }
+  };
+};
@@ -0,0 +1,125 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkProcessCache_h
+#define __btkProcessCache_h
+
+#include "btkDataObject.h"
+#include "btkHash.h"
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace btk
+{
+  class critical_section_p;
+  
+  class ProcessCache
+  {
+  public:
+    typedef btkSharedPtr<ProcessCache> Pointer;
+    typedef btkSharedPtr<const ProcessCache> ConstPointer;
+    typedef btkNullPtr<ProcessCache> NullPointer;
+    
+    typedef Hash::Value Key;
+    
+    class Storage
+    {
+    public:
+      typedef btkSharedPtr<Storage> Pointer;
+      typedef btkSharedPtr<const Storage> ConstPointer;
+      
+      virtual ~Storage() {};
+      
+      virtual bool Load(Key key, const std::vector<DataObject::Pointer>& outputs) = 0;
+      virtual void Save(Key key, const std::vector<DataObject::Pointer>& outputs) = 0;
+      
+    protected:
+      Storage() {};
+      
+    private:
+      Storage(const Storage& ); // Not implemented.
+      Storage& operator=(const Storage& ); // Not implemented.
+    };
+    
+    static Pointer New(int capacity = 16) {return Pointer(new ProcessCache(capacity));};
+    static NullPointer Null() {return NullPointer();};
+    
+    BTK_COMMON_EXPORT ~ProcessCache();
+    
+    BTK_COMMON_EXPORT int GetCapacity() const;
+    BTK_COMMON_EXPORT void SetCapacity(int capacity);
+    BTK_COMMON_EXPORT Storage::Pointer GetStorage() const;
+    BTK_COMMON_EXPORT void SetStorage(Storage::Pointer storage);
+    
+    BTK_COMMON_EXPORT int GetEntryNumber() const;
+    BTK_COMMON_EXPORT int GetHitNumber() const;
+    BTK_COMMON_EXPORT int GetMissNumber() const;
+    BTK_COMMON_EXPORT void Clear();
+    
+    BTK_COMMON_EXPORT bool Restore(Key key, const std::vector<DataObject::Pointer>& outputs);
+    BTK_COMMON_EXPORT void Store(Key key, const std::vector<DataObject::Pointer>& outputs);
+    
+  protected:
+    BTK_COMMON_EXPORT ProcessCache(int capacity);
+    
+  private:
+    ProcessCache(const ProcessCache& ); // Not implemented.
+    ProcessCache& operator=(const ProcessCache& ); // Not implemented.
+    
+    struct Entry
+    {
+      Key key;
+      std::vector<DataObject::Pointer> outputs;
+    };
+    typedef std::list<Entry> EntryList;
+    
+    void Evict();
+    
+    critical_section_p* mp_Lock;
+    int m_Capacity;
+    Storage::Pointer mp_Storage;
+    EntryList m_Entries; // Most recently used first.
+    std::map<Key, EntryList::iterator> m_Index;
+    int m_HitNumber;
+    int m_MissNumber;
+  };
+};
+
+#endif // __btkProcessCache_h
@@ -36,9 +36,46 @@
 #include "btkProcessObject.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkProfiler.h"
+#include "btkCriticalSection_p.h"
+#include "btkThreadPool_p.h"
+#include "btkMemoryArena.h"
+#include "btkException.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
 
 namespace btk
 {
+  // Processes updated by the current thread. Used to stop the recursion in a pipeline with a cycle.
+  struct _btk_updating_process
+  {
+    const ProcessObject* process;
+    _btk_updating_process* previous;
+  };
+  static btkThreadLocal _btk_updating_process* _btk_updating_processes = 0;
+  
+  // Pool shared by the processes to execute their loops in parallel (see ProcessObject::ParallelFor()).
+  static thread_pool_p& _btk_process_pool()
+  {
+    static thread_pool_p pool;
+    return pool;
+  };
+  
+  // Number of ranges of iterations submitted for each thread. More ranges than threads balance the work between them.
+  static const int _btk_process_ranges_per_thread = 4;
+  
+  struct ProcessObject::ParallelRange
+  {
+    ProcessObject::ParallelTask task;
+    void* body;
+    int begin;
+    int end;
+    MemoryArena* arena;
+    std::string error;
+  };
+  
   /**
    * @class ProcessObject btkProcessObject.h
    * @brief Interface to create a filter/process in a pipeline.
@@ -154,45 +191,78 @@ namespace btk
    */
   
   /**
-   * Recursive method which 1) determines the processes to update and 2) 
+   * Recursive method which 1) propagates the requested regions to the inputs, 2) determines the processes to update and 3) 
    * generate the data by using the GenerateData() method.
+   *
+   * Several threads can update at the same time some pipelines sharing processes. 
+   * The data of a shared process are generated only once, the other threads waiting for them.
+   * To update in parallel the independent branches of a pipeline, use the class PipelineExecutor.
    */
   void ProcessObject::Update()
   {
-    if (this->m_Updating)
-      return;
-    this->m_Updating = true;
-    
-    for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+    for (_btk_updating_process* p = _btk_updating_processes ; p != 0 ; p = p->previous)
     {
-      if (this->m_Inputs[inc] != DataObject::Null)
-      {
-        this->m_Inputs[inc]->Update();
-        if (this->m_Inputs[inc]->m_Timestamp >= this->m_Timestamp)
-          this->m_Modified = true;
-      }
+      if (p->process == this)
+        return;
     }
-    if (this->m_Modified)
+    _btk_updating_process current = {this, _btk_updating_processes};
+    _btk_updating_processes = &current;
+    try
     {
-      unsigned long int ts = this->GetTimestamp();
-      this->GenerateData();
-      this->Object::Modified();
-      for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+      this->PropagateRequestedRegion();
+      for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
       {
-        if ((this->m_Outputs[inc] != DataObject::Null) && (this->m_Outputs[inc]->GetTimestamp() > ts))
-          this->m_Outputs[inc]->m_Timestamp = this->m_Timestamp;
+        if (this->m_Inputs[inc] != DataObject::Null)
+          this->m_Inputs[inc]->Update();
       }
-      this->m_Modified = false;
+      this->UpdateData();
+    }
+    catch (...)
+    {
+      _btk_updating_processes = current.previous;
+      throw;
     }
-    this->m_Updating = false;
+    _btk_updating_processes = current.previous;
   };
 
   /**
    * Reset the state of the process. Usefull when an exception was thrown during the generation of the data.
+   * @deprecated An exception thrown during the update does not block the process anymore. This method does nothing.
    */
   void ProcessObject::ResetState()
+  {};
+  
+  /**
+   * @fn ProcessCache::Pointer ProcessObject::GetCache() const
+   * Returns the cache used to memoize the outputs of this process (null by default).
+   */
+  
+  /**
+   * @fn void ProcessObject::SetCache(ProcessCache::Pointer cache)
+   * Sets the cache used to memoize the outputs of this process. The outputs are restored from the cache 
+   * instead of being generated when the content of the inputs, the parameters of the process and 
+   * the requested regions were already processed (see ProcessCache).
+   *
+   * The cache is used only if the process implements the method HashParameters(), if the content of 
+   * its inputs can be hashed (see DataObject::HashContent()) and if its outputs can be copied (see DataObject::DeepCopy()).
+   */
+  
+  /**
+   * @fn int ProcessObject::GetThreadNumber() const
+   * Returns the number of threads used by the process to execute its loops (see SetThreadNumber()).
+   */
+  
+  /**
+   * Sets the number of threads used by the process to execute its loops over independent items (force platforms, points, etc.). 
+   * If @a num is null or negative, the number of processors is used. By default, a process uses only one thread.
+   *
+   * The threads come from a pool shared by all the processes. The outputs do not depend on the number of threads: 
+   * each item is computed by a single thread and the items are stored in the same order.
+   * The output is not modified by this method as the result stays the same.
+   */
+  void ProcessObject::SetThreadNumber(int num)
   {
-    this->m_Updating = false;
+    this->m_ThreadNumber = (num <= 0) ? thread_pool_p::GetHardwareConcurrency() : num;
   };
   
   /**
@@ -202,10 +272,12 @@ namespace btk
   ProcessObject::ProcessObject()
   : Object(),
     m_Inputs(std::vector<DataObject::Pointer>(0)),
-    m_Outputs(std::vector<DataObject::Pointer>(0))
+    m_Outputs(std::vector<DataObject::Pointer>(0)),
+    mp_Cache()
   {
     this->m_Modified = false;
-    this->m_Updating = false;
+    this->mp_UpdateLock = new critical_section_p;
+    this->m_ThreadNumber = 1;
   };
   
   /**
@@ -219,6 +291,7 @@ namespace btk
       if (this->m_Outputs[idx])
         this->m_Outputs[idx]->mp_Source = 0;
     }
+    delete this->mp_UpdateLock;
   };
   
   /**
@@ -381,6 +454,249 @@ namespace btk
     // this->Object::Modified();
   };
   
+  /**
+   * Sets the region requested to the inputs (see GenerateInputRequestedRegion()).
+   */
+  void ProcessObject::PropagateRequestedRegion()
+  {
+    this->mp_UpdateLock->Lock();
+    try
+    {
+      this->GenerateInputRequestedRegion();
+    }
+    catch (...)
+    {
+      this->mp_UpdateLock->Unlock();
+      throw;
+    }
+    this->mp_UpdateLock->Unlock();
+  };
+  
+  /**
+   * Generates the data if the process or one of its inputs was modified since the last update 
+   * or if a region not yet generated is requested to one of its outputs. The inputs must be already updated.
+   */
+  void ProcessObject::UpdateData()
+  {
+    this->mp_UpdateLock->Lock();
+    try
+    {
+      for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+      {
+        if ((this->m_Inputs[inc] != DataObject::Null) && (this->m_Inputs[inc]->m_Timestamp >= this->m_Timestamp))
+          this->m_Modified = true;
+      }
+      // Region requested outside of the generated one?
+      for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+      {
+        if ((this->m_Outputs[inc] != DataObject::Null) && !this->m_Outputs[inc]->IsRequestedRegionBuffered())
+          this->m_Modified = true;
+      }
+      if (this->m_Modified)
+      {
+        unsigned long int ts = this->GetTimestamp();
+        Profiler::Scope profile("Process", typeid(*this));
+        ProcessCache::Key key;
+        bool cacheable = (this->mp_Cache != ProcessCache::Null) && this->ComputeCacheKey(&key);
+        if (!cacheable || !this->mp_Cache->Restore(key, this->m_Outputs))
+        {
+          this->GenerateData();
+          if (cacheable)
+            this->StoreOutputs(key);
+        }
+        for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+          profile.AddData(this->m_Outputs[inc].get());
+        this->Object::Modified();
+        for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+        {
+          if (this->m_Outputs[inc] == DataObject::Null)
+            continue;
+          if (this->m_Outputs[inc]->GetTimestamp() > ts)
+            this->m_Outputs[inc]->m_Timestamp = this->m_Timestamp;
+          this->m_Outputs[inc]->BufferRequestedRegion();
+        }
+        this->m_Modified = false;
+      }
+    }
+    catch (...)
+    {
+      this->mp_UpdateLock->Unlock();
+      throw;
+    }
+    this->mp_UpdateLock->Unlock();
+  };
+  
+  // Computes the key associated with the type of the process, its parameters, the content of its inputs and the regions requested for its outputs.
+  bool ProcessObject::ComputeCacheKey(ProcessCache::Key* key) const
+  {
+    Hash hash;
+    hash.Add(std::string(typeid(*this).name()));
+    if (!this->HashParameters(&hash))
+      return false;
+    hash.Add(static_cast<int>(this->m_Inputs.size()));
+    for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+    {
+      hash.Add(this->m_Inputs[inc] != DataObject::Null);
+      if ((this->m_Inputs[inc] != DataObject::Null) && !this->m_Inputs[inc]->HashContent(&hash))
+        return false;
+    }
+    hash.Add(static_cast<int>(this->m_Outputs.size()));
+    for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+    {
+      if (this->m_Outputs[inc] == DataObject::Null)
+        continue;
+      hash.Add(this->m_Outputs[inc]->GetRequestedFirstFrame());
+      hash.Add(this->m_Outputs[inc]->GetRequestedLastFrame());
+    }
+    *key = hash.GetValue();
+    return true;
+  };
+  
+  // Stores a copy of the generated outputs in the cache.
+  void ProcessObject::StoreOutputs(ProcessCache::Key key)
+  {
+    std::vector<DataObject::Pointer> copies(this->m_Outputs.size());
+    for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+    {
+      if (this->m_Outputs[inc] == DataObject::Null)
+        continue;
+      copies[inc] = this->MakeOutput(static_cast<int>(inc));
+      if (!copies[inc]->DeepCopy(this->m_Outputs[inc].get()))
+        return;
+    }
+    this->mp_Cache->Store(key, copies);
+  };
+  
+  /**
+   * Sets the region requested to the inputs from the region requested to the outputs. 
+   * This method is called by the update of the pipeline before the update of the inputs.
+   *
+   * By default, the frames requested to the outputs (enlarged by the number of frames returned by 
+   * GetRequestedRegionPadding()) are requested to all the inputs. If one output requests all 
+   * its frames or if the process has no output (e.g. a writer), all the frames are requested to the inputs.
+   *
+   * An inherited class has to override this method if the frames of its outputs do not correspond 
+   * to the frames of its inputs (e.g. the frames of the outputs are renumbered or resampled). 
+   */
+  void ProcessObject::GenerateInputRequestedRegion()
+  {
+    bool all = false, found = false;
+    int first = 0, last = 0;
+    for (size_t inc = 0 ; inc < this->m_Outputs.size() ; ++inc)
+    {
+      const DataObject* output = this->m_Outputs[inc].get();
+      if (output == 0)
+        continue;
+      if (!output->HasRequestedRegion())
+      {
+        all = true;
+        break;
+      }
+      if (!found || (output->GetRequestedFirstFrame() < first))
+        first = output->GetRequestedFirstFrame();
+      if (!found || (output->GetRequestedLastFrame() > last))
+        last = output->GetRequestedLastFrame();
+      found = true;
+    }
+    all |= !found;
+    const int padding = this->GetRequestedRegionPadding();
+    for (size_t inc = 0 ; inc < this->m_Inputs.size() ; ++inc)
+    {
+      if (this->m_Inputs[inc] == DataObject::Null)
+        continue;
+      if (all)
+        this->m_Inputs[inc]->ResetRequestedRegion();
+      else
+        this->m_Inputs[inc]->SetRequestedRegion(first - padding, last + padding);
+    }
+  };
+  
+  /**
+   * @fn virtual int ProcessObject::GetRequestedRegionPadding() const
+   * Returns the number of frames added before and after the region requested to the inputs. 
+   * An inherited class which needs some context to compute the requested frames (e.g. a filter or a derivative) 
+   * has to override this method. By default, no frame is added.
+   */
+  
+  /**
+   * Adds the parameters of the process to the digest @a hash and returns true. 
+   * By default, this method returns false and the outputs of the process are never restored from a cache (see SetCache()).
+   * An inherited class has to override this method to add every parameter used by the method GenerateData().
+   */
+  bool ProcessObject::HashParameters(Hash* /* hash */) const
+  {
+    return false;
+  };
+  
+  /**
+   * @fn template <typename F> void ProcessObject::ParallelFor(int num, F& body) const
+   * Calls @a body(i) for each index @a i between 0 and @a num - 1 using the threads set for this process (see SetThreadNumber()).
+   * The indices are split in contiguous ranges executed by the threads of a shared pool. The calling thread executes 
+   * some ranges too and this method returns when all the indices are processed. 
+   *
+   * The functor @a body must only modify the data associated with the index @a i (for example, the i-th output created 
+   * before the loop). The creation of the outputs and their insertion in a collection have to be done outside of the loop
+   * to keep their order. The memory arena of the calling thread is used by the threads (see MemoryArena::Scope).
+   *
+   * If an exception is thrown by @a body, the other ranges are finished and a RuntimeError exception with the same 
+   * message is thrown by this method (the message of the first range in case of several exceptions).
+   */
+  
+  /**
+   * Executes the function @a task over the @a num iterations of the loop @a body.
+   */
+  void ProcessObject::ExecuteParallelFor(int num, ParallelTask task, void* body) const
+  {
+    if (num <= 0)
+      return;
+    const int rangeNumber = std::min(num, (this->m_ThreadNumber > 1) ? this->m_ThreadNumber * _btk_process_ranges_per_thread : 1);
+    if (rangeNumber == 1)
+    {
+      task(body, 0, num);
+      return;
+    }
+    std::vector<ParallelRange> ranges(rangeNumber);
+    thread_pool_p& pool = _btk_process_pool();
+    thread_pool_p::group group;
+    for (int i = 0 ; i < rangeNumber ; ++i)
+    {
+      ParallelRange& range = ranges[i];
+      range.task = task;
+      range.body = body;
+      range.begin = static_cast<int>(static_cast<long long>(num) * i / rangeNumber);
+      range.end = static_cast<int>(static_cast<long long>(num) * (i + 1) / rangeNumber);
+      range.arena = MemoryArena::GetCurrent();
+      pool.Submit(&group, &ProcessObject::RunParallelRange, &range);
+    }
+    pool.Wait(&group);
+    for (int i = 0 ; i < rangeNumber ; ++i)
+    {
+      if (!ranges[i].error.empty())
+        throw RuntimeError(ranges[i].error);
+    }
+  };
+  
+  // Task executing a range of iterations. The exceptions cannot go through the thread pool.
+  void ProcessObject::RunParallelRange(void* data)
+  {
+    ParallelRange* range = static_cast<ParallelRange*>(data);
+    MemoryArena::Scope scope(range->arena);
+    try
+    {
+      range->task(range->body, range->begin, range->end);
+    }
+    catch (std::exception& err)
+    {
+      range->error = err.what();
+      if (range->error.empty())
+        range->error = "Unknown error.";
+    }
+    catch (...)
+    {
+      range->error = "Unknown exception.";
+    }
+  };
+  
   /**
    * @fn bool ProcessObject::IsModified() const
    * Indicates if the process is modified or not.
@@ -38,11 +38,14 @@
 
 #include "btkObject.h"
 #include "btkDataObject.h"
+#include "btkProcessCache.h"
 
 #include <vector>
 
 namespace btk
 {
+  class critical_section_p;
+  
   class ProcessObject : public Object
   {
   public:
@@ -57,6 +60,12 @@ namespace btk
     BTK_COMMON_EXPORT void Update();
     BTK_COMMON_EXPORT void ResetState();
     
+    ProcessCache::Pointer GetCache() const {return this->mp_Cache;};
+    void SetCache(ProcessCache::Pointer cache) {this->mp_Cache = cache;};
+    
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    BTK_COMMON_EXPORT void SetThreadNumber(int num);
+    
   protected:
     BTK_COMMON_EXPORT ProcessObject();
     BTK_COMMON_EXPORT virtual ~ProcessObject();
@@ -77,15 +86,48 @@ namespace btk
     bool IsModified() const {return this->m_Modified;};
     BTK_COMMON_EXPORT virtual void GenerateData() = 0;
     BTK_COMMON_EXPORT virtual DataObject::Pointer MakeOutput(int idx) = 0;
+    BTK_COMMON_EXPORT virtual void GenerateInputRequestedRegion();
+    virtual int GetRequestedRegionPadding() const {return 0;};
+    BTK_COMMON_EXPORT virtual bool HashParameters(Hash* hash) const;
+    template <typename F> void ParallelFor(int num, F& body) const;
     
   private:
     ProcessObject(const ProcessObject& ); // Not implemented.
     ProcessObject& operator=(const ProcessObject& ); // Not implemented.
     
+    void PropagateRequestedRegion();
+    void UpdateData();
+    bool ComputeCacheKey(ProcessCache::Key* key) const;
+    void StoreOutputs(ProcessCache::Key key);
+    
+    struct ParallelRange;
+    typedef void (*ParallelTask)(void* body, int begin, int end);
+    template <typename F> static void RunParallelTask(void* body, int begin, int end);
+    BTK_COMMON_EXPORT void ExecuteParallelFor(int num, ParallelTask task, void* body) const;
+    static void RunParallelRange(void* range);
+    
     std::vector<DataObject::Pointer> m_Inputs;
     std::vector<DataObject::Pointer> m_Outputs;
     bool m_Modified;
-    bool m_Updating;
+    critical_section_p* mp_UpdateLock;
+    ProcessCache::Pointer mp_Cache;
+    int m_ThreadNumber;
+    
+    friend class PipelineExecutor;
+  };
+  
+  template <typename F>
+  void ProcessObject::ParallelFor(int num, F& body) const
+  {
+    this->ExecuteParallelFor(num, &ProcessObject::RunParallelTask<F>, &body);
+  };
+  
+  template <typename F>
+  void ProcessObject::RunParallelTask(void* body, int begin, int end)
+  {
+    F& f = *static_cast<F*>(body);
+    for (int i = begin ; i < end ; ++i)
+      f(i);
   };
 };
 
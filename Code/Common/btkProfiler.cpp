@@ -0,0 +1,449 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkProfiler.h"
+#include "btkCriticalSection_p.h"
+#include "btkAcquisition.h"
+
+#include <map>
+#include <algorithm>
+#include <iomanip>
+#include <ctime>
+
+#if defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#else
+  #include <time.h>
+  #include <sys/time.h>
+  #include <sys/resource.h>
+#endif
+
+#if defined(__GNUC__)
+  #include <cxxabi.h>
+  #include <cstdlib>
+#endif
+
+namespace btk
+{
+  static bool _btk_profiler_enabled = false;
+  static double _btk_profiler_origin = 0.0;
+  static int _btk_profiler_thread_number = 0;
+  static btkThreadLocal int _btk_profiler_thread = -1;
+  
+  static critical_section_p& _btk_profiler_lock()
+  {
+    static critical_section_p lock;
+    return lock;
+  };
+  
+  static std::vector<Profiler::Record>& _btk_profiler_records()
+  {
+    static std::vector<Profiler::Record> records;
+    return records;
+  };
+  
+  // Monotonic time in microseconds.
+  static double _btk_profiler_wall_time()
+  {
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) * 1.0e6 / static_cast<double>(frequency.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) * 1.0e6 + static_cast<double>(ts.tv_nsec) * 1.0e-3;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return static_cast<double>(tv.tv_sec) * 1.0e6 + static_cast<double>(tv.tv_usec);
+#endif
+  };
+  
+  // CPU time of the current thread in microseconds (CPU time of the process if not available).
+  static double _btk_profiler_cpu_time()
+  {
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user) == 0)
+      return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime; u.HighPart = user.dwHighDateTime;
+    return static_cast<double>(k.QuadPart + u.QuadPart) * 0.1; // 100 ns unit
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1.0e6 + static_cast<double>(ts.tv_nsec) * 1.0e-3;
+#else
+    return static_cast<double>(std::clock()) * 1.0e6 / static_cast<double>(CLOCKS_PER_SEC);
+#endif
+  };
+  
+  // Peak resident memory of the process in bytes (not available under Windows).
+  static size_t _btk_profiler_peak_memory()
+  {
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+  #if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // bytes
+  #else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes
+  #endif
+#endif
+  };
+  
+  static std::string _btk_profiler_type_name(const std::type_info& type)
+  {
+#if defined(__GNUC__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), 0, 0, &status);
+    if (demangled != 0)
+    {
+      std::string name = demangled;
+      std::free(demangled);
+      return name;
+    }
+#endif
+    std::string name = type.name();
+    if (name.compare(0, 6, "class ") == 0) // MSVC
+      name.erase(0, 6);
+    return name;
+  };
+  
+  // Measures accumulated for one category and name.
+  struct _btk_profiler_summary
+  {
+    int calls;
+    double wallTime;
+    double cpuTime;
+    size_t bytes;
+    int frames;
+    int channels;
+    size_t peakMemory;
+  };
+  
+  static void _btk_profiler_json_string(std::ostream& os, const std::string& str)
+  {
+    os << "\"";
+    for (size_t i = 0 ; i < str.length() ; ++i)
+    {
+      const char c = str[i];
+      if ((c == '"') || (c == '\\'))
+        os << '\\' << c;
+      else if (static_cast<unsigned char>(c) < 0x20)
+        os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+      else
+        os << c;
+    }
+    os << "\"";
+  };
+  
+  /**
+   * @class Profiler btkProfiler.h
+   * @brief Records the time spent in the processes and the IOs of the pipelines.
+   *
+   * When the profiler is enabled (see SetEnabled()), each generation of the data of a process (see ProcessObject::Update())
+   * and each reading or writing of a file by an IO (see AcquisitionFileReader and AcquisitionFileWriter) is recorded.
+   * A record contains the wall time, the CPU time of the thread, the number of bytes read or written, 
+   * the number of frames and channels generated and the increase of the peak memory of the process during the invocation.
+   *
+   * The recording is thread-safe: the processes updated in parallel (see PipelineExecutor) are recorded with the index of their thread.
+   * The records can be retrieved with GetRecords(), printed as a table with PrintSummary() or exported 
+   * in the Chrome trace event format with WriteChromeTrace() (the file can be opened in the page chrome://tracing or with Perfetto).
+   *
+   * The profiler is disabled by default. In this case, the cost of the instrumentation is only one test by invocation.
+   *
+   * @code
+   * btk::Profiler::SetEnabled(true);
+   * reader->Update();
+   * btk::Profiler::PrintSummary(std::cout);
+   * std::ofstream ofs("trace.json");
+   * btk::Profiler::WriteChromeTrace(ofs);
+   * @endcode
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @struct Profiler::Record btkProfiler.h
+   * @brief Measures recorded for one invocation.
+   *
+   * The times (@c start, @c wallTime, @c cpuTime) are given in microseconds. The start is relative to the first activation of the profiler (or to the last call of Clear()).
+   * The peak memory corresponds to the increase (in bytes) of the peak resident memory of the process during the invocation. This measure is not available under Windows.
+   */
+  
+  /**
+   * @class Profiler::Scope btkProfiler.h
+   * @brief Records the invocation corresponding to the lifetime of this object.
+   *
+   * Nothing is measured if the profiler is disabled when the scope is created.
+   */
+  
+  /**
+   * Starts the measure of an invocation with the given @a category (e.g. "Process", "Read"). 
+   * The name of the record is the name of the given @a type. The @a detail (e.g. a filename) is optional.
+   * @warning The strings @a category and @a detail must be valid during the lifetime of the scope.
+   */
+  Profiler::Scope::Scope(const char* category, const std::type_info& type, const char* detail)
+  : m_Active(_btk_profiler_enabled)
+  {
+    this->mp_Category = category;
+    this->mp_Type = &type;
+    this->mp_Detail = detail;
+    this->m_Bytes = 0;
+    this->m_Frames = 0;
+    this->m_Channels = 0;
+    if (this->m_Active)
+    {
+      this->m_PeakMemoryStart = _btk_profiler_peak_memory();
+      this->m_CpuStart = _btk_profiler_cpu_time();
+      this->m_Start = _btk_profiler_wall_time();
+    }
+    else
+    {
+      this->m_PeakMemoryStart = 0;
+      this->m_CpuStart = 0.0;
+      this->m_Start = 0.0;
+    }
+  };
+  
+  /**
+   * @fn Profiler::Scope::~Scope()
+   * Stores the record of the invocation.
+   */
+  
+  /**
+   * @fn bool Profiler::Scope::IsActive() const
+   * Returns true if the invocation is recorded (i.e. the profiler was enabled when the scope was created).
+   */
+  
+  /**
+   * @fn void Profiler::Scope::SetBytes(size_t bytes)
+   * Sets the number of bytes read or written during the invocation.
+   */
+  
+  /**
+   * @fn void Profiler::Scope::AddData(const DataObject* data)
+   * Adds the frames and the channels of @a data (acquisition, point, analog channel) to the record.
+   * The number of frames is the largest number of frames of the added data. The channels are accumulated.
+   */
+  
+  void Profiler::Scope::Count(const DataObject* data)
+  {
+    int frames = 0, channels = 0;
+    if (const Acquisition* acq = dynamic_cast<const Acquisition*>(data))
+    {
+      frames = acq->GetPointFrameNumber();
+      channels = acq->GetPointNumber() + acq->GetAnalogNumber();
+    }
+    else if (const Point* point = dynamic_cast<const Point*>(data))
+    {
+      frames = point->GetFrameNumber();
+      channels = 1;
+    }
+    else if (const Analog* analog = dynamic_cast<const Analog*>(data))
+    {
+      frames = analog->GetFrameNumber();
+      channels = 1;
+    }
+    if (frames > this->m_Frames)
+      this->m_Frames = frames;
+    this->m_Channels += channels;
+  };
+  
+  void Profiler::Scope::Stop()
+  {
+    const double end = _btk_profiler_wall_time();
+    Record record;
+    record.cpuTime = _btk_profiler_cpu_time() - this->m_CpuStart;
+    const size_t peak = _btk_profiler_peak_memory();
+    record.peakMemory = (peak > this->m_PeakMemoryStart) ? peak - this->m_PeakMemoryStart : 0;
+    record.category = this->mp_Category;
+    record.name = _btk_profiler_type_name(*(this->mp_Type));
+    if (this->mp_Detail != 0)
+      record.detail = this->mp_Detail;
+    record.wallTime = end - this->m_Start;
+    record.bytes = this->m_Bytes;
+    record.frames = this->m_Frames;
+    record.channels = this->m_Channels;
+    _btk_profiler_lock().Lock();
+    if (_btk_profiler_thread == -1)
+      _btk_profiler_thread = _btk_profiler_thread_number++;
+    record.thread = _btk_profiler_thread;
+    record.start = this->m_Start - _btk_profiler_origin;
+    try
+    {
+      _btk_profiler_records().push_back(record);
+    }
+    catch (...) {} // The record is lost but the destructor of the scope must not throw.
+    _btk_profiler_lock().Unlock();
+  };
+  
+  /**
+   * Returns true if the invocations are recorded.
+   */
+  bool Profiler::IsEnabled()
+  {
+    return _btk_profiler_enabled;
+  };
+  
+  /**
+   * Enables or disables the recording of the invocations. 
+   * The recorded invocations are kept when the profiler is disabled (see Clear()).
+   */
+  void Profiler::SetEnabled(bool enabled)
+  {
+    _btk_profiler_lock().Lock();
+    if (enabled && !_btk_profiler_enabled && _btk_profiler_records().empty())
+      _btk_profiler_origin = _btk_profiler_wall_time();
+    _btk_profiler_enabled = enabled;
+    _btk_profiler_lock().Unlock();
+  };
+  
+  /**
+   * Removes the recorded invocations. The start time of the next records is relative to this call.
+   */
+  void Profiler::Clear()
+  {
+    _btk_profiler_lock().Lock();
+    _btk_profiler_records().clear();
+    _btk_profiler_origin = _btk_profiler_wall_time();
+    _btk_profiler_lock().Unlock();
+  };
+  
+  /**
+   * Returns a copy of the recorded invocations.
+   */
+  std::vector<Profiler::Record> Profiler::GetRecords()
+  {
+    _btk_profiler_lock().Lock();
+    std::vector<Record> records = _btk_profiler_records();
+    _btk_profiler_lock().Unlock();
+    return records;
+  };
+  
+  /**
+   * Prints in @a os a table summarizing the recorded invocations grouped by category and name.
+   * The times are given in milliseconds.
+   */
+  void Profiler::PrintSummary(std::ostream& os)
+  {
+    std::vector<Record> records = Profiler::GetRecords();
+    std::vector< std::pair<std::string, std::string> > keys;
+    std::map< std::pair<std::string, std::string>, _btk_profiler_summary > summaries;
+    for (size_t i = 0 ; i < records.size() ; ++i)
+    {
+      const Record& r = records[i];
+      std::pair<std::string, std::string> key(r.category, r.name);
+      std::map< std::pair<std::string, std::string>, _btk_profiler_summary >::iterator it = summaries.find(key);
+      if (it == summaries.end())
+      {
+        _btk_profiler_summary s = {0, 0.0, 0.0, 0, 0, 0, 0};
+        it = summaries.insert(std::make_pair(key, s)).first;
+        keys.push_back(key);
+      }
+      _btk_profiler_summary& s = it->second;
+      s.calls += 1;
+      s.wallTime += r.wallTime;
+      s.cpuTime += r.cpuTime;
+      s.bytes += r.bytes;
+      s.frames += r.frames;
+      s.channels += r.channels;
+      if (r.peakMemory > s.peakMemory)
+        s.peakMemory = r.peakMemory;
+    }
+    size_t width = 4;
+    for (size_t i = 0 ; i < keys.size() ; ++i)
+      width = std::max(width, keys[i].second.length());
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::left << std::setw(10) << "Category" << std::setw(static_cast<int>(width) + 2) << "Name" << std::right
+       << std::setw(8) << "Calls" << std::setw(14) << "Wall (ms)" << std::setw(14) << "Mean (ms)" << std::setw(14) << "CPU (ms)" 
+       << std::setw(14) << "Bytes" << std::setw(12) << "Frames" << std::setw(10) << "Channels" << std::setw(14) << "Peak (kB)" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    for (size_t i = 0 ; i < keys.size() ; ++i)
+    {
+      const _btk_profiler_summary& s = summaries[keys[i]];
+      os << std::left << std::setw(10) << keys[i].first << std::setw(static_cast<int>(width) + 2) << keys[i].second << std::right
+         << std::setw(8) << s.calls << std::setw(14) << s.wallTime * 1.0e-3 << std::setw(14) << s.wallTime * 1.0e-3 / s.calls << std::setw(14) << s.cpuTime * 1.0e-3
+         << std::setw(14) << s.bytes << std::setw(12) << s.frames << std::setw(10) << s.channels << std::setw(14) << s.peakMemory / 1024 << std::endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+  };
+  
+  /**
+   * Writes the recorded invocations in @a os using the JSON format of the Chrome trace events.
+   * Each invocation is exported as a complete event ("X") and its measures are stored in its arguments.
+   */
+  void Profiler::WriteChromeTrace(std::ostream& os)
+  {
+    std::vector<Record> records = Profiler::GetRecords();
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+    os << "{\"traceEvents\":[";
+    for (size_t i = 0 ; i < records.size() ; ++i)
+    {
+      const Record& r = records[i];
+      os << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+      _btk_profiler_json_string(os, r.name);
+      os << ",\"cat\":";
+      _btk_profiler_json_string(os, r.category);
+      os << ",\"ph\":\"X\",\"ts\":" << r.start << ",\"dur\":" << r.wallTime << ",\"pid\":1,\"tid\":" << r.thread
+         << ",\"args\":{\"cpu_us\":" << r.cpuTime << ",\"bytes\":" << r.bytes << ",\"frames\":" << r.frames 
+         << ",\"channels\":" << r.channels << ",\"peak_memory\":" << r.peakMemory;
+      if (!r.detail.empty())
+      {
+        os << ",\"detail\":";
+        _btk_profiler_json_string(os, r.detail);
+      }
+      os << "}}";
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+  };
+};
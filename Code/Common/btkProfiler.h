@@ -0,0 +1,109 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __btkProfiler_h
+#define __btkProfiler_h
+
+#include "btkConfigure.h"
+
+#include <typeinfo>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+namespace btk
+{
+  class DataObject;
+  
+  class Profiler
+  {
+  public:
+    struct Record
+    {
+      std::string category;
+      std::string name;
+      std::string detail;
+      int thread;
+      double start;
+      double wallTime;
+      double cpuTime;
+      size_t bytes;
+      int frames;
+      int channels;
+      size_t peakMemory;
+    };
+    
+    class Scope
+    {
+    public:
+      BTK_COMMON_EXPORT Scope(const char* category, const std::type_info& type, const char* detail = 0);
+      ~Scope() {if (this->m_Active) this->Stop();};
+      bool IsActive() const {return this->m_Active;};
+      void SetBytes(size_t bytes) {this->m_Bytes = bytes;};
+      void AddData(const DataObject* data) {if (this->m_Active) this->Count(data);};
+    private:
+      Scope(const Scope& ); // Not implemented.
+      Scope& operator=(const Scope& ); // Not implemented.
+      
+      BTK_COMMON_EXPORT void Stop();
+      BTK_COMMON_EXPORT void Count(const DataObject* data);
+      
+      bool m_Active;
+      const char* mp_Category;
+      const std::type_info* mp_Type;
+      const char* mp_Detail;
+      double m_Start;
+      double m_CpuStart;
+      size_t m_PeakMemoryStart;
+      size_t m_Bytes;
+      int m_Frames;
+      int m_Channels;
+    };
+    
+    BTK_COMMON_EXPORT static bool IsEnabled();
+    BTK_COMMON_EXPORT static void SetEnabled(bool enabled);
+    BTK_COMMON_EXPORT static void Clear();
+    BTK_COMMON_EXPORT static std::vector<Record> GetRecords();
+    BTK_COMMON_EXPORT static void PrintSummary(std::ostream& os);
+    BTK_COMMON_EXPORT static void WriteChromeTrace(std::ostream& os);
+    
+  private:
+    Profiler(); // Not implemented.
+  };
+};
+
+#endif // __btkProfiler_h
@@ -0,0 +1,330 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkThreadPool_p.h"
+
+#if defined(BTK_THREAD_POOL_PTHREADS)
+  #include <unistd.h> // sysconf
+#endif
+
+namespace btk
+{
+  // Pool and queue of the worker running in the current thread (if any).
+  static btkThreadLocal const thread_pool_p* _btk_current_pool = 0;
+  static btkThreadLocal int _btk_current_queue = -1;
+  
+  /**
+   * @class thread_pool_p btkThreadPool_p.h
+   * @brief Pool of threads executing tasks with a work stealing strategy.
+   *
+   * Each worker owns a queue of tasks. The tasks submitted by a worker are pushed in its own queue 
+   * and are executed in a last in, first out order. When its queue is empty, a worker steals the 
+   * oldest task of the other queues. The tasks submitted by another thread are distributed in the queues.
+   *
+   * The tasks are associated with a group. The method Wait() returns when all the tasks of a group 
+   * (including the ones submitted by these tasks) are finished. The waiting thread executes pending 
+   * tasks meanwhile. Thus, a task can wait for other tasks without blocking a worker and, if the 
+   * threads are not supported, all the tasks are executed by the waiting thread.
+   *
+   * @warning A task must not throw an exception.
+   * @note With the Win32 threads, the pool requires Windows Vista or later (condition variables).
+   */
+  
+  /**
+   * Constructor. If @a threadNumber is null or negative, the number of threads corresponds to the number of processors.
+   */
+  thread_pool_p::thread_pool_p(int threadNumber)
+  : m_Queues(), m_Workers(), m_Threads(), m_Pending(0), m_Next(0), m_Stopped(false)
+  {
+    if (threadNumber <= 0)
+      threadNumber = thread_pool_p::GetHardwareConcurrency();
+#if defined(BTK_THREAD_POOL_PTHREADS)
+    pthread_mutex_init(&(this->m_Mutex), NULL);
+    pthread_cond_init(&(this->m_Condition), NULL);
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    InitializeCriticalSection(&(this->m_Mutex));
+    InitializeConditionVariable(&(this->m_Condition));
+#else
+    threadNumber = 0;
+#endif
+    this->m_Queues.resize(threadNumber > 0 ? threadNumber : 1);
+    for (size_t i = 0 ; i < this->m_Queues.size() ; ++i)
+      this->m_Queues[i] = new queue_t;
+    this->m_Workers.resize(threadNumber); // The address of the workers must not change.
+    this->m_Threads.reserve(threadNumber);
+    for (int i = 0 ; i < threadNumber ; ++i)
+    {
+      this->m_Workers[i].pool = this;
+      this->m_Workers[i].index = i;
+      btk_thread_t thread;
+#if defined(BTK_THREAD_POOL_PTHREADS)
+      if (pthread_create(&thread, NULL, &thread_pool_p::Start, &(this->m_Workers[i])) != 0)
+        break;
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+      thread = CreateThread(NULL, 0, &thread_pool_p::Start, &(this->m_Workers[i]), 0, NULL);
+      if (thread == NULL)
+        break;
+#endif
+      this->m_Threads.push_back(thread);
+    }
+  };
+  
+  /**
+   * Destructor. The remaining tasks are executed before the end of the threads.
+   */
+  thread_pool_p::~thread_pool_p()
+  {
+    this->Lock();
+    this->m_Stopped = true;
+    this->WakeUp(true);
+    this->Unlock();
+    for (size_t i = 0 ; i < this->m_Threads.size() ; ++i)
+    {
+#if defined(BTK_THREAD_POOL_PTHREADS)
+      pthread_join(this->m_Threads[i], NULL);
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+      WaitForSingleObject(this->m_Threads[i], INFINITE);
+      CloseHandle(this->m_Threads[i]);
+#endif
+    }
+    // Tasks submitted without worker to execute them.
+    task_t task;
+    while (this->Take(-1, &task))
+      this->Run(task);
+#if defined(BTK_THREAD_POOL_PTHREADS)
+    pthread_cond_destroy(&(this->m_Condition));
+    pthread_mutex_destroy(&(this->m_Mutex));
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    DeleteCriticalSection(&(this->m_Mutex));
+#endif
+    for (size_t i = 0 ; i < this->m_Queues.size() ; ++i)
+      delete this->m_Queues[i];
+  };
+  
+  /**
+   * @fn int thread_pool_p::GetThreadNumber() const
+   * Returns the number of threads in the pool.
+   */
+  
+  /**
+   * Submits the task @a function which will be executed with the argument @a data in the group @a g.
+   */
+  void thread_pool_p::Submit(group* g, task_function function, void* data)
+  {
+    task_t task;
+    task.function = function;
+    task.data = data;
+    task.owner = g;
+    int index = _btk_current_queue;
+    // The task is counted in its group before being pushed: once in a queue, it can be taken by any thread 
+    // (for example a worker having reserved another task) and the count of the group is decremented at its end.
+    this->Lock();
+    if (_btk_current_pool != this)
+      index = static_cast<int>(this->m_Next++ % this->m_Queues.size());
+    ++(g->m_Count);
+    this->Unlock();
+    queue_t* queue = this->m_Queues[index];
+    queue->lock.Lock();
+    queue->tasks.push_back(task);
+    queue->lock.Unlock();
+    // The task is reserved only after being pushed: a reserved task is always found in a queue.
+    this->Lock();
+    ++(this->m_Pending);
+    this->WakeUp(false);
+    this->Unlock();
+  };
+  
+  /**
+   * Waits for the end of the tasks of the group @a g. Meanwhile, the current thread executes pending tasks.
+   */
+  void thread_pool_p::Wait(group* g)
+  {
+    const int index = (_btk_current_pool == this) ? _btk_current_queue : -1;
+    this->Lock();
+    while (g->m_Count != 0)
+    {
+      if (this->m_Pending != 0)
+      {
+        --(this->m_Pending);
+        this->Unlock();
+        task_t task;
+        while (!this->Take(index, &task)); // A task was reserved. It will be found.
+        this->Run(task);
+        this->Lock();
+      }
+      else
+        this->Sleep();
+    }
+    this->Unlock();
+  };
+  
+  /**
+   * Returns the number of processors available or 1 if it cannot be determined.
+   */
+  int thread_pool_p::GetHardwareConcurrency()
+  {
+    int num = 1;
+#if defined(BTK_THREAD_POOL_PTHREADS) && defined(_SC_NPROCESSORS_ONLN)
+    num = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    num = static_cast<int>(info.dwNumberOfProcessors);
+#endif
+    return (num > 0) ? num : 1;
+  };
+  
+  void thread_pool_p::Execute(int index)
+  {
+    _btk_current_pool = this;
+    _btk_current_queue = index;
+    this->Lock();
+    for (;;)
+    {
+      while ((this->m_Pending == 0) && !this->m_Stopped)
+        this->Sleep();
+      if (this->m_Pending == 0)
+        break; // Stopped
+      --(this->m_Pending);
+      this->Unlock();
+      task_t task;
+      while (!this->Take(index, &task)); // A task was reserved. It will be found.
+      this->Run(task);
+      this->Lock();
+    }
+    this->Unlock();
+  };
+  
+  void thread_pool_p::Run(const task_t& task)
+  {
+    task.function(task.data);
+    this->Lock();
+    if (--(task.owner->m_Count) == 0)
+      this->WakeUp(true);
+    this->Unlock();
+  };
+  
+  bool thread_pool_p::Take(int index, task_t* task)
+  {
+    // Most recent task of its own queue.
+    if (index >= 0)
+    {
+      queue_t* queue = this->m_Queues[index];
+      queue->lock.Lock();
+      bool found = !queue->tasks.empty();
+      if (found)
+      {
+        *task = queue->tasks.back();
+        queue->tasks.pop_back();
+      }
+      queue->lock.Unlock();
+      if (found)
+        return true;
+    }
+    // Oldest task of the other queues.
+    const size_t num = this->m_Queues.size();
+    const size_t start = static_cast<size_t>(index + 1);
+    for (size_t i = 0 ; i < num ; ++i)
+    {
+      queue_t* queue = this->m_Queues[(start + i) % num];
+      queue->lock.Lock();
+      bool found = !queue->tasks.empty();
+      if (found)
+      {
+        *task = queue->tasks.front();
+        queue->tasks.pop_front();
+      }
+      queue->lock.Unlock();
+      if (found)
+        return true;
+    }
+    return false;
+  };
+  
+  void thread_pool_p::Lock()
+  {
+#if defined(BTK_THREAD_POOL_PTHREADS)
+    pthread_mutex_lock(&(this->m_Mutex));
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    EnterCriticalSection(&(this->m_Mutex));
+#endif
+  };
+  
+  void thread_pool_p::Unlock()
+  {
+#if defined(BTK_THREAD_POOL_PTHREADS)
+    pthread_mutex_unlock(&(this->m_Mutex));
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    LeaveCriticalSection(&(this->m_Mutex));
+#endif
+  };
+  
+  void thread_pool_p::Sleep()
+  {
+#if defined(BTK_THREAD_POOL_PTHREADS)
+    pthread_cond_wait(&(this->m_Condition), &(this->m_Mutex));
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    SleepConditionVariableCS(&(this->m_Condition), &(this->m_Mutex), INFINITE);
+#endif
+  };
+  
+  void thread_pool_p::WakeUp(bool all)
+  {
+#if defined(BTK_THREAD_POOL_PTHREADS)
+    if (all)
+      pthread_cond_broadcast(&(this->m_Condition));
+    else
+      pthread_cond_signal(&(this->m_Condition));
+#elif defined(BTK_THREAD_POOL_WIN32_THREADS)
+    if (all)
+      WakeAllConditionVariable(&(this->m_Condition));
+    else
+      WakeConditionVariable(&(this->m_Condition));
+#else
+    (void)all;
+#endif
+  };
+  
+#if defined(BTK_THREAD_POOL_WIN32_THREADS)
+  DWORD WINAPI thread_pool_p::Start(LPVOID data)
+#else
+  void* thread_pool_p::Start(void* data)
+#endif
+  {
+    worker_t* worker = static_cast<worker_t*>(data);
+    worker->pool->Execute(worker->index);
+    return 0;
+  };
+};
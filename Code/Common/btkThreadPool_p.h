@@ -0,0 +1,132 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkThreadPool_p_h
+#define __btkThreadPool_p_h
+
+#include "btkCriticalSection_p.h"
+
+#include <vector>
+#include <deque>
+
+#if defined(HAVE_PTHREADS) || defined(HAVE_HP_PTHREADS)
+  #define BTK_THREAD_POOL_PTHREADS
+  typedef pthread_t btk_thread_t;
+  typedef pthread_mutex_t btk_thread_mutex_t;
+  typedef pthread_cond_t btk_thread_condition_t;
+#elif defined(HAVE_WIN32_THREADS)
+  #define BTK_THREAD_POOL_WIN32_THREADS
+  typedef HANDLE btk_thread_t;
+  typedef CRITICAL_SECTION btk_thread_mutex_t;
+  typedef CONDITION_VARIABLE btk_thread_condition_t;
+#else
+  // No thread: the tasks are executed by the thread waiting for them.
+  typedef int btk_thread_t;
+  typedef int btk_thread_mutex_t;
+  typedef int btk_thread_condition_t;
+#endif
+
+namespace btk
+{
+  class thread_pool_p
+  {
+  public:
+    typedef void (*task_function)(void* data);
+    
+    class group
+    {
+    public:
+      group() : m_Count(0) {};
+    private:
+      int m_Count;
+      friend class thread_pool_p;
+    };
+    
+    BTK_COMMON_EXPORT thread_pool_p(int threadNumber = 0);
+    BTK_COMMON_EXPORT ~thread_pool_p();
+    int GetThreadNumber() const {return static_cast<int>(this->m_Threads.size());};
+    BTK_COMMON_EXPORT void Submit(group* g, task_function function, void* data);
+    BTK_COMMON_EXPORT void Wait(group* g);
+    BTK_COMMON_EXPORT static int GetHardwareConcurrency();
+    
+  private:
+    thread_pool_p(const thread_pool_p& ); // Not implemented.
+    thread_pool_p& operator=(const thread_pool_p& ); // Not implemented.
+    
+    struct task_t
+    {
+      task_function function;
+      void* data;
+      group* owner;
+    };
+    
+    struct queue_t
+    {
+      std::deque<task_t> tasks;
+      critical_section_p lock;
+    };
+    
+    struct worker_t
+    {
+      thread_pool_p* pool;
+      int index;
+    };
+    
+    void Execute(int index);
+    void Run(const task_t& task);
+    bool Take(int index, task_t* task);
+    void Lock();
+    void Unlock();
+    void Sleep();
+    void WakeUp(bool all);
+    
+    std::vector<queue_t*> m_Queues;
+    std::vector<worker_t> m_Workers;
+    std::vector<btk_thread_t> m_Threads;
+    btk_thread_mutex_t m_Mutex;
+    btk_thread_condition_t m_Condition;
+    int m_Pending;
+    unsigned m_Next;
+    bool m_Stopped;
+    
+#if defined(BTK_THREAD_POOL_WIN32_THREADS)
+    static DWORD WINAPI Start(LPVOID data);
+#else
+    static void* Start(void* data);
+#endif
+  };
+};
+
+#endif // __btkThreadPool_p_h
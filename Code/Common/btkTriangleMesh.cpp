@@ -198,6 +198,16 @@ namespace btk
     return maxId;
   };
   
+  /**
+   * Adds the memory used by this mesh, its vertices, its edges and its faces to @a usage.
+   * The connected points are not counted (they belong to the acquisition).
+   */
+  void TriangleMesh::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(TriangleMesh));
+    usage->Add(MemoryUsage::Meshes, this->m_Vertices.capacity() * sizeof(Vertex) + this->m_Edges.capacity() * sizeof(Edge) + this->m_Faces.capacity() * sizeof(Face));
+  };
+  
   /**
    * Connect the given @a points to the mesh by finding the corresponding IDs. Returns true if all the vertices are connected.
    * If one of the point are not found (vertex ID not recognised), then the connections are reseted and the method return false.
@@ -150,6 +150,8 @@ namespace btk
     
     BTK_COMMON_EXPORT int GetMaxVertexId() const;
     
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
     BTK_COMMON_EXPORT bool ConnectPoints(PointCollection::Pointer points);
     
     int GetCurrentFrameIndex() const {return this->m_CurrentFrame;};
@@ -190,6 +190,41 @@ namespace btk
     }
   };
   
+  /**
+   * Adds the position, the force and the moment of this wrench to the digest @a hash.
+   */
+  bool Wrench::HashContent(Hash* hash) const
+  {
+    return this->m_Position->HashContent(hash) && this->m_Force->HashContent(hash) && this->m_Moment->HashContent(hash);
+  };
+  
+  /**
+   * Sets in @a digest the combination of the digests of the position, the force and the moment (see DataObject::GetContentHash()).
+   */
+  bool Wrench::GetContentHash(Hash::Value* digest) const
+  {
+    Hash::Value position, force, moment;
+    if (!this->m_Position->GetContentHash(&position) || !this->m_Force->GetContentHash(&force) || !this->m_Moment->GetContentHash(&moment))
+      return false;
+    Hash hash;
+    hash.Add(position);
+    hash.Add(force);
+    hash.Add(moment);
+    *digest = hash.GetValue();
+    return true;
+  };
+  
+  /**
+   * Adds the memory used by this wrench, its position, its force and its moment to @a usage.
+   */
+  void Wrench::AddMemoryUsage(MemoryUsage* usage) const
+  {
+    usage->Add(MemoryUsage::Objects, sizeof(Wrench));
+    this->m_Position->AddMemoryUsage(usage);
+    this->m_Force->AddMemoryUsage(usage);
+    this->m_Moment->AddMemoryUsage(usage);
+  };
+  
   /**
    * @fn Pointer Wrench::Clone() const
    * Returns a deep copy of the object as a smart pointer.
@@ -66,6 +66,10 @@ namespace btk
     
     BTK_COMMON_EXPORT void SetFrameNumber(int frameNumber);
     
+    BTK_COMMON_EXPORT virtual bool HashContent(Hash* hash) const;
+    BTK_COMMON_EXPORT virtual bool GetContentHash(Hash::Value* digest) const;
+    BTK_COMMON_EXPORT virtual void AddMemoryUsage(MemoryUsage* usage) const;
+    
     Pointer Clone() const {return Pointer(new Wrench(*this));};
     
   protected:
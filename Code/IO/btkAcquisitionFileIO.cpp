@@ -302,6 +302,34 @@ namespace btk
   * Returns true if the given @a option is used or false if not.
   */
     
+ /**
+  * @fn bool AcquisitionFileIO::HasRequestedRegion() const
+  * Returns true if only a part of the frames has to be read.
+  */
+  
+ /**
+  * @fn int AcquisitionFileIO::GetRequestedFirstFrame() const
+  * Returns the first frame to read. The returned value is meaningful only if HasRequestedRegion() returns true.
+  */
+  
+ /**
+  * @fn int AcquisitionFileIO::GetRequestedLastFrame() const
+  * Returns the last frame to read. The returned value is meaningful only if HasRequestedRegion() returns true.
+  */
+  
+ /**
+  * @fn void AcquisitionFileIO::SetRequestedRegion(int firstFrame, int lastFrame)
+  * Sets the frames to read (using the numbering of the frames stored in the file). 
+  * A file format supporting a partial reading (e.g. C3D) reads only these frames. 
+  * Otherwise, all the frames are read and the acquisition is cropped by the btk::AcquisitionFileReader.
+  * If @a firstFrame is greater than @a lastFrame, all the frames are read.
+  */
+  
+ /**
+  * @fn void AcquisitionFileIO::ResetRequestedRegion()
+  * Sets to read all the frames.
+  */
+  
  /**
   * @fn virtual bool AcquisitionFileIO::CanReadFile(const std::string& filename) = 0
   * Checks if @a filename can be read by this AcquisitionFileIO. This methods 
@@ -324,7 +352,39 @@ namespace btk
    * @fn virtual void AcquisitionFileIO::Write(const std::string& filename, Acquisition::Pointer input) = 0
    * Write the file designated by @a filename with the content of @a input.
    */
+  
+  /**
+   * Adds to @a usage an estimation of the memory used by the acquisition read from the file @a filename, 
+   * with the values stored in the given @a precision (see Acquisition::SetStoragePrecision()) and only the 
+   * requested frames (see SetRequestedRegion()). Only the header of the file has to be read, so a batch can
+   * be scheduled within a memory budget before reading its files.
+   *
+   * Returns false if the file format doesn't support the estimation (default behaviour) or if the header cannot be read.
+   */
+  bool AcquisitionFileIO::EstimateMemoryUsage(const std::string& /* filename */, Acquisition::StoragePrecision /* precision */, MemoryUsage* /* usage */)
+  {
+    return false;
+  };
    
+  /**
+   * Adds to @a usage the memory used by the points (values and residuals) and the analog channels of an acquisition with the given dimensions.
+   * The analog samples are counted as 16-bit integers if @a rawSamples is true and the @a precision is Acquisition::RawPrecision.
+   * This method is a helper to implement EstimateMemoryUsage(): the memory used by the metadata and the events has to be added separately.
+   */
+  void AcquisitionFileIO::AddAcquisitionMemoryUsage(MemoryUsage* usage, int pointNumber, int frameNumber, int analogNumber, int analogSampleNumberPerFrame, Acquisition::StoragePrecision precision, bool rawSamples)
+  {
+    const size_t node = 2 * sizeof(void*) + sizeof(DataObject::Pointer); // Item of a collection
+    const size_t pointWord = (precision == Acquisition::DoublePrecision) ? sizeof(double) : sizeof(float);
+    const size_t analogWord = ((precision == Acquisition::RawPrecision) && rawSamples) ? sizeof(int16_t) : pointWord;
+    const size_t frames = static_cast<size_t>(frameNumber), samples = frames * static_cast<size_t>(analogSampleNumberPerFrame);
+    usage->Add(MemoryUsage::Objects, sizeof(Acquisition) + 3 * sizeof(PointCollection));
+    usage->Add(MemoryUsage::Objects, pointNumber * (sizeof(Point) + sizeof(Point::Data) + node));
+    usage->Add(MemoryUsage::Values, pointNumber * frames * 3 * pointWord);
+    usage->Add(MemoryUsage::Residuals, pointNumber * frames * pointWord);
+    usage->Add(MemoryUsage::Objects, analogNumber * (sizeof(Analog) + sizeof(Analog::Data) + node));
+    usage->Add(MemoryUsage::Values, analogNumber * samples * analogWord);
+  };
+  
   /**
    * Constructor.
    */
@@ -334,6 +394,7 @@ namespace btk
     this->m_ByteOrder = b;
     this->m_StorageFormat = s;
     this->m_InternalsUpdate = internalsUpdate;
+    this->ResetRequestedRegion();
   };
   
   /**
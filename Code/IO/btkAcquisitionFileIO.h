@@ -73,11 +73,18 @@ namespace btk
     int GetInternalsUpdateOptions() const {return this->m_InternalsUpdate;};
     void SetInternalsUpdateOptions(int options) {this->m_InternalsUpdate = options;};
     bool HasInternalsUpdateOption(int option) const {return ((this->m_InternalsUpdate & option) == option);};
+    
+    bool HasRequestedRegion() const {return this->mp_RequestedRegion[0] <= this->mp_RequestedRegion[1];};
+    int GetRequestedFirstFrame() const {return this->mp_RequestedRegion[0];};
+    int GetRequestedLastFrame() const {return this->mp_RequestedRegion[1];};
+    void SetRequestedRegion(int firstFrame, int lastFrame) {this->mp_RequestedRegion[0] = firstFrame; this->mp_RequestedRegion[1] = lastFrame;};
+    void ResetRequestedRegion() {this->mp_RequestedRegion[0] = 1; this->mp_RequestedRegion[1] = 0;};
 
     virtual bool CanReadFile(const std::string& filename) = 0;
     virtual bool CanWriteFile(const std::string& filename) = 0;
     virtual void Read(const std::string& filename, Acquisition::Pointer output) = 0;
     virtual void Write(const std::string& filename, Acquisition::Pointer input) = 0;
+    BTK_IO_EXPORT virtual bool EstimateMemoryUsage(const std::string& filename, Acquisition::StoragePrecision precision, MemoryUsage* usage);
     
     class Extension
     {
@@ -112,11 +119,13 @@ namespace btk
     virtual ~AcquisitionFileIO() {};
     
     void SetFileType(FileType f) {this->m_FileType = f;};
+    BTK_IO_EXPORT static void AddAcquisitionMemoryUsage(MemoryUsage* usage, int pointNumber, int frameNumber, int analogNumber, int analogSampleNumberPerFrame, Acquisition::StoragePrecision precision, bool rawSamples);
         
     FileType m_FileType;
     ByteOrder m_ByteOrder;
     StorageFormat m_StorageFormat;
     int m_InternalsUpdate;
+    int mp_RequestedRegion[2];
     
   private:
     enum {ReadOp = 1, WriteOp = 1};
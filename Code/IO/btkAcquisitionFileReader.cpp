@@ -35,8 +35,11 @@
 
 #include "btkAcquisitionFileReader.h"
 #include "btkAcquisitionFileIOFactory.h"
+#include "btkProfiler.h"
+#include "btkLogger.h"
 
 #include <fstream>
+#include <algorithm>
 
 namespace btk
 {
@@ -69,6 +72,10 @@ namespace btk
    *
    * Note: Internally, this class use the AcquisitionFileIOFactory class for the automatic mode.
    *
+   * If a region is requested to the output (see DataObject::SetRequestedRegion()), only these frames are read. 
+   * The file formats which do not support a partial reading are read entirely and then cropped.
+   * The events out of the region are kept.
+   *
    * @ingroup BTKIO 
    */
   /**
@@ -157,6 +164,28 @@ namespace btk
     }
   };
   
+  /**
+   * Adds to @a usage an estimation of the memory used by the output once the file will be read, without reading it.
+   * The storage precision and the requested region of the output are taken into account (see AcquisitionFileIO::EstimateMemoryUsage()).
+   * Returns false if the file cannot be opened or if its format doesn't support the estimation.
+   */
+  bool AcquisitionFileReader::EstimateMemoryUsage(MemoryUsage* usage)
+  {
+    if (this->m_Filename.empty())
+      return false;
+    AcquisitionFileIO::Pointer io = this->m_AcquisitionIO;
+    if (io.get() == 0)
+      io = AcquisitionFileIOFactory::CreateAcquisitionIO(this->m_Filename.c_str(), AcquisitionFileIOFactory::ReadMode);
+    if (io.get() == 0)
+      return false;
+    Acquisition::Pointer output = this->GetOutput();
+    if (output->HasRequestedRegion())
+      io->SetRequestedRegion(output->GetRequestedFirstFrame(), output->GetRequestedLastFrame());
+    else
+      io->ResetRequestedRegion();
+    return io->EstimateMemoryUsage(this->m_Filename, output->GetStoragePrecision(), usage);
+  };
+  
   /**
    * Constructor. Sets the number of outputs equal to one. No input.
    */
@@ -212,6 +241,42 @@ namespace btk
         throw AcquisitionFileReaderException("No IO found, the file is not supported or valid or the file suffix is misspelled (Some IO use it to verify they can read the file)\nFilename: " + this->m_Filename);
     }
     
-    this->m_AcquisitionIO->Read(this->m_Filename, this->GetOutput());
+    Acquisition::Pointer output = this->GetOutput();
+    if (output->HasRequestedRegion())
+      this->m_AcquisitionIO->SetRequestedRegion(output->GetRequestedFirstFrame(), output->GetRequestedLastFrame());
+    else
+      this->m_AcquisitionIO->ResetRequestedRegion();
+    // The objects created by the IO are stored in the memory arena of the output (if any).
+    MemoryArena::Scope scope(output->GetMemoryArena());
+    // The messages sent by the IO are associated with the file.
+    Logger::Context context(this->m_Filename);
+    {
+      Profiler::Scope profile("Read", typeid(*(this->m_AcquisitionIO)), this->m_Filename.c_str());
+      this->m_AcquisitionIO->Read(this->m_Filename, output);
+      if (profile.IsActive())
+      {
+        ifs.clear();
+        ifs.open(this->m_Filename.c_str(), std::ios_base::in | std::ios_base::binary);
+        ifs.seekg(0, std::ios_base::end);
+        profile.SetBytes(static_cast<size_t>(ifs.tellg()));
+        ifs.close();
+        profile.AddData(output.get());
+      }
+    }
+    // Frames read by an IO which does not support the partial reading.
+    if (output->HasRequestedRegion() && (output->GetPointFrameNumber() != 0))
+    {
+      const int lb = std::max(output->GetRequestedFirstFrame(), output->GetFirstFrame());
+      const int ub = std::min(output->GetRequestedLastFrame(), output->GetLastFrame());
+      if ((lb <= ub) && ((lb != output->GetFirstFrame()) || (ub != output->GetLastFrame())))
+      {
+        output->ResizeFrameNumber(ub - output->GetFirstFrame() + 1);
+        output->ResizeFrameNumberFromEnd(ub - lb + 1);
+        output->SetFirstFrame(lb);
+      }
+    }
+    // Values converted in double precision by the IO are stored again in a compact form (if requested)
+    if (this->GetOutput()->GetStoragePrecision() != Acquisition::DoublePrecision)
+      this->GetOutput()->SetStoragePrecision(this->GetOutput()->GetStoragePrecision());
   };
 };
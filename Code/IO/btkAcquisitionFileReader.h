@@ -72,6 +72,8 @@ namespace btk
     AcquisitionFileIO::Pointer GetAcquisitionIO() {return this->m_AcquisitionIO;};
     AcquisitionFileIO::ConstPointer GetAcquisitionIO() const {return this->m_AcquisitionIO;};
     BTK_IO_EXPORT void SetAcquisitionIO(AcquisitionFileIO::Pointer io = AcquisitionFileIO::Pointer());
+    
+    BTK_IO_EXPORT bool EstimateMemoryUsage(MemoryUsage* usage);
   
   protected:
     BTK_IO_EXPORT AcquisitionFileReader();
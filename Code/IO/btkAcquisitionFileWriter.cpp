@@ -35,6 +35,8 @@
 
 #include "btkAcquisitionFileWriter.h"
 #include "btkAcquisitionFileIOFactory.h"
+#include "btkProfiler.h"
+#include "btkLogger.h"
 
 #include <fstream>
 
@@ -210,6 +212,15 @@ namespace btk
         throw AcquisitionFileWriterException("No IO found, the file is not supported or the file suffix is misspelled (IOs use it to verify they can write the file)\nFilename: " + this->m_Filename);
     }
     
+    Logger::Context context(this->m_Filename);
+    Profiler::Scope profile("Write", typeid(*(this->m_AcquisitionIO)), this->m_Filename.c_str());
     this->m_AcquisitionIO->Write(this->m_Filename, this->GetInput());
+    if (profile.IsActive())
+    {
+      std::ifstream ifs(this->m_Filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      ifs.seekg(0, std::ios_base::end);
+      profile.SetBytes(static_cast<size_t>(ifs.tellg()));
+      profile.AddData(this->GetInput().get());
+    }
   };
 };
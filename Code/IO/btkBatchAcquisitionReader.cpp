@@ -0,0 +1,425 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "btkBatchAcquisitionReader.h"
+#include "btkAcquisitionFileReader.h"
+#include "btkThreadPool_p.h"
+#include "btkLogger.h"
+
+#include <algorithm>
+#include <cctype>
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <dirent.h>
+  #include <sys/stat.h>
+#endif
+
+namespace btk
+{
+  struct BatchAcquisitionReader::Slot
+  {
+    thread_pool_p::group group;
+    Acquisition::StoragePrecision precision;
+    Result result;
+  };
+  
+  /**
+   * @class BatchAcquisitionReader btkBatchAcquisitionReader.h
+   * @brief Reads a list of acquisition files in parallel.
+   *
+   * The files are read by a pool of threads and the acquisitions are delivered in the order of the list, 
+   * either one by one with the method Next() or by the way of a handler with the method Read().
+   * The number of acquisitions read in advance is bounded by the capacity of the reader (see SetCapacity()). 
+   * When this number is reached, the threads wait for the delivery of the oldest acquisition before reading 
+   * the next file. The memory used by the reader is then bounded whatever the number of files.
+   *
+   * @code
+   * btk::BatchAcquisitionReader::Pointer reader = btk::BatchAcquisitionReader::New();
+   * reader->AddDirectory("/data/session", "c3d");
+   * btk::BatchAcquisitionReader::Result result;
+   * while (reader->Next(&result))
+   * {
+   *   if (!result.IsValid())
+   *     std::cerr << result.filename << ": " << result.error << std::endl;
+   *   else
+   *     ... // Process result.acquisition
+   * }
+   * @endcode
+   *
+   * An error during the reading of a file does not stop the reading of the others. 
+   * The message of the exception is stored in the result associated with the file.
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @struct BatchAcquisitionReader::Result
+   * @brief Acquisition read from a file of the list.
+   */
+  /**
+   * @var BatchAcquisitionReader::Result::index
+   * Index of the file in the list.
+   */
+  /**
+   * @var BatchAcquisitionReader::Result::filename
+   * Name of the file.
+   */
+  /**
+   * @var BatchAcquisitionReader::Result::acquisition
+   * Acquisition read. Null pointer if an error occurred.
+   */
+  /**
+   * @var BatchAcquisitionReader::Result::error
+   * Message of the exception thrown during the reading (empty if the file was read).
+   */
+  /**
+   * @fn bool BatchAcquisitionReader::Result::IsValid() const
+   * Returns true if the file was read without error.
+   */
+  
+  /**
+   * @class BatchAcquisitionReader::Handler btkBatchAcquisitionReader.h
+   * @brief Interface to process the acquisitions delivered by the method BatchAcquisitionReader::Read().
+   */
+  /**
+   * @fn virtual BatchAcquisitionReader::Handler::~Handler()
+   * Empty destructor.
+   */
+  /**
+   * @fn virtual void BatchAcquisitionReader::Handler::Process(const Result& result) = 0
+   * Processes the result of the reading of a file. This method is called in the thread using the reader.
+   */
+  
+  /**
+   * @typedef BatchAcquisitionReader::Pointer
+   * Smart pointer associated with a BatchAcquisitionReader object.
+   */
+  
+  /**
+   * @typedef BatchAcquisitionReader::ConstPointer
+   * Smart pointer associated with a const BatchAcquisitionReader object.
+   */
+  
+  /**
+   * @typedef BatchAcquisitionReader::NullPointer
+   * Type used to return a null pointer.
+   */
+  
+  /**
+   * @fn static Pointer BatchAcquisitionReader::New(int threadNumber = 0)
+   * Creates a smart pointer associated with a BatchAcquisitionReader object using @a threadNumber threads.
+   * If @a threadNumber is null or negative, the number of threads corresponds to the number of processors.
+   */
+  
+  /**
+   * @fn static NullPointer BatchAcquisitionReader::Null()
+   * Static function to return a null pointer.
+   */
+  
+  /**
+   * Destructor. The files being read are waited before stopping the threads.
+   */
+  BatchAcquisitionReader::~BatchAcquisitionReader()
+  {
+    this->Rewind();
+    for (size_t i = 0 ; i < this->m_Slots.size() ; ++i)
+      delete this->m_Slots[i];
+    delete this->mp_Pool;
+  };
+  
+  /**
+   * Returns the number of threads used to read the files.
+   * If the threads are not supported, this number is 0 and the files are read in the calling thread.
+   */
+  int BatchAcquisitionReader::GetThreadNumber() const
+  {
+    return this->mp_Pool->GetThreadNumber();
+  };
+  
+  /**
+   * @fn int BatchAcquisitionReader::GetCapacity() const
+   * Returns the maximum number of acquisitions read in advance.
+   */
+  
+  /**
+   * Sets the maximum number of acquisitions read in advance (and then kept in memory). 
+   * If @a capacity is null or negative, the capacity is set to twice the number of threads.
+   * The reading is restarted from the first file.
+   */
+  void BatchAcquisitionReader::SetCapacity(int capacity)
+  {
+    if (capacity <= 0)
+      capacity = std::max(1, 2 * this->mp_Pool->GetThreadNumber());
+    this->Rewind();
+    for (size_t i = static_cast<size_t>(capacity) ; i < this->m_Slots.size() ; ++i)
+      delete this->m_Slots[i];
+    this->m_Slots.resize(capacity, 0);
+    for (size_t i = 0 ; i < this->m_Slots.size() ; ++i)
+    {
+      if (this->m_Slots[i] == 0)
+        this->m_Slots[i] = new Slot;
+    }
+    this->m_Capacity = capacity;
+  };
+  
+  /**
+   * @fn Acquisition::StoragePrecision BatchAcquisitionReader::GetStoragePrecision() const
+   * Returns the precision used to store the values of the acquisitions read.
+   */
+  
+  /**
+   * Sets the precision used to store the values of the acquisitions read (see Acquisition::SetStoragePrecision()).
+   * A compact form reduces the memory used by the acquisitions read in advance.
+   * The reading is restarted from the first file.
+   */
+  void BatchAcquisitionReader::SetStoragePrecision(Acquisition::StoragePrecision precision)
+  {
+    this->Rewind();
+    this->m_StoragePrecision = precision;
+  };
+  
+  /**
+   * @fn const std::vector<std::string>& BatchAcquisitionReader::GetFilenames() const
+   * Returns the list of the files to read.
+   */
+  
+  /**
+   * Sets the list of the files to read. The reading is restarted from the first file.
+   */
+  void BatchAcquisitionReader::SetFilenames(const std::vector<std::string>& filenames)
+  {
+    this->Rewind();
+    this->m_Filenames = filenames;
+  };
+  
+  /**
+   * Appends the file @a filename to the list of the files to read. The reading is restarted from the first file.
+   */
+  void BatchAcquisitionReader::AddFilename(const std::string& filename)
+  {
+    this->Rewind();
+    this->m_Filenames.push_back(filename);
+  };
+  
+  /**
+   * Appends the files of the directory @a path to the list of the files to read. 
+   * If @a extension is not empty, only the files with this extension (case insensitive, with or without the leading dot) 
+   * are added. The files are added in the lexicographic order of their name. The subdirectories are not explored.
+   * Returns the number of files added. The reading is restarted from the first file.
+   */
+  int BatchAcquisitionReader::AddDirectory(const std::string& path, const std::string& extension)
+  {
+    std::string suffix = extension;
+    if (!suffix.empty() && (suffix[0] != '.'))
+      suffix.insert(0, 1, '.');
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), tolower);
+    std::string prefix = path;
+    if (!prefix.empty() && (*(prefix.rbegin()) != '/') && (*(prefix.rbegin()) != '\\'))
+      prefix += "/";
+    std::vector<std::string> names;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA((prefix + "*").c_str(), &data);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+      btkErrorMacro("Impossible to open the directory: " + path);
+      return 0;
+    }
+    do
+    {
+      if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+        names.push_back(data.cFileName);
+    }
+    while (FindNextFileA(handle, &data) != 0);
+    FindClose(handle);
+#else
+    DIR* dir = opendir(path.c_str());
+    if (dir == 0)
+    {
+      btkErrorMacro("Impossible to open the directory: " + path);
+      return 0;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != 0)
+    {
+      struct stat info;
+      if ((stat((prefix + entry->d_name).c_str(), &info) == 0) && S_ISREG(info.st_mode))
+        names.push_back(entry->d_name);
+    }
+    closedir(dir);
+#endif
+    std::sort(names.begin(), names.end());
+    this->Rewind();
+    int num = 0;
+    for (size_t i = 0 ; i < names.size() ; ++i)
+    {
+      if (!suffix.empty())
+      {
+        if (names[i].length() <= suffix.length())
+          continue;
+        std::string end = names[i].substr(names[i].length() - suffix.length());
+        std::transform(end.begin(), end.end(), end.begin(), tolower);
+        if (end.compare(suffix) != 0)
+          continue;
+      }
+      this->m_Filenames.push_back(prefix + names[i]);
+      ++num;
+    }
+    return num;
+  };
+  
+  /**
+   * Clears the list of the files to read.
+   */
+  void BatchAcquisitionReader::ClearFilenames()
+  {
+    this->Rewind();
+    this->m_Filenames.clear();
+  };
+  
+  /**
+   * Sets in @a result the acquisition read from the next file of the list and returns true. 
+   * Returns false if all the files were delivered. The files following the delivered one are read in advance 
+   * by the threads, in the limit of the capacity of the reader.
+   *
+   * The previous results returned by this method are not referenced by the reader.
+   */
+  bool BatchAcquisitionReader::Next(Result* result)
+  {
+    if (this->m_Delivered >= this->m_Filenames.size())
+      return false;
+    while ((this->m_Submitted < this->m_Filenames.size()) && (this->m_Submitted - this->m_Delivered < this->m_Slots.size()))
+      this->Submit(this->m_Submitted++);
+    Slot* slot = this->m_Slots[this->m_Delivered % this->m_Slots.size()];
+    this->mp_Pool->Wait(&(slot->group));
+    *result = slot->result;
+    slot->result.acquisition.reset();
+    ++this->m_Delivered;
+    // The slot is reused immediately for the next file to keep the threads busy while the result is processed.
+    if (this->m_Submitted < this->m_Filenames.size())
+      this->Submit(this->m_Submitted++);
+    return true;
+  };
+  
+  /**
+   * Reads all the files of the list (from the first one) and gives the results to the handler @a handler, in the order of the list.
+   * The handler is called in the calling thread while the next files are read.
+   * Returns the number of files which cannot be read.
+   */
+  int BatchAcquisitionReader::Read(Handler* handler)
+  {
+    this->Rewind();
+    int errors = 0;
+    Result result;
+    while (this->Next(&result))
+    {
+      if (!result.IsValid())
+        ++errors;
+      if (handler != 0)
+        handler->Process(result);
+    }
+    return errors;
+  };
+  
+  /**
+   * Restarts the reading from the first file. The files being read are waited and their results are discarded.
+   */
+  void BatchAcquisitionReader::Rewind()
+  {
+    for (size_t i = this->m_Delivered ; i < this->m_Submitted ; ++i)
+    {
+      Slot* slot = this->m_Slots[i % this->m_Slots.size()];
+      this->mp_Pool->Wait(&(slot->group));
+      slot->result.acquisition.reset();
+    }
+    this->m_Submitted = 0;
+    this->m_Delivered = 0;
+  };
+  
+  /**
+   * Constructor.
+   */
+  BatchAcquisitionReader::BatchAcquisitionReader(int threadNumber)
+  : m_Slots(), m_Filenames()
+  {
+    this->mp_Pool = new thread_pool_p(threadNumber);
+    this->m_Capacity = 0;
+    this->m_StoragePrecision = Acquisition::DoublePrecision;
+    this->m_Submitted = 0;
+    this->m_Delivered = 0;
+    this->SetCapacity(0);
+  };
+  
+  /**
+   * Submits the reading of the file at the index @a index to the threads.
+   */
+  void BatchAcquisitionReader::Submit(size_t index)
+  {
+    Slot* slot = this->m_Slots[index % this->m_Slots.size()];
+    slot->precision = this->m_StoragePrecision;
+    slot->result.index = static_cast<int>(index);
+    slot->result.filename = this->m_Filenames[index];
+    slot->result.acquisition.reset();
+    slot->result.error.clear();
+    this->mp_Pool->Submit(&(slot->group), &BatchAcquisitionReader::Run, slot);
+  };
+  
+  /**
+   * Reads the file of the slot @a data. The exceptions are stored in the result of the slot.
+   */
+  void BatchAcquisitionReader::Run(void* data)
+  {
+    Slot* slot = static_cast<Slot*>(data);
+    try
+    {
+      AcquisitionFileReader::Pointer reader = AcquisitionFileReader::New();
+      reader->SetFilename(slot->result.filename);
+      reader->GetOutput()->SetStoragePrecision(slot->precision);
+      reader->Update();
+      slot->result.acquisition = reader->GetOutput();
+    }
+    catch (std::exception& e)
+    {
+      slot->result.error = e.what();
+    }
+    catch (...)
+    {
+      slot->result.error = "Unknown error";
+    }
+  };
+};
@@ -0,0 +1,116 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkBatchAcquisitionReader_h
+#define __btkBatchAcquisitionReader_h
+
+#include "btkAcquisition.h"
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <vector>
+#include <string>
+
+namespace btk
+{
+  class thread_pool_p;
+  
+  class BatchAcquisitionReader
+  {
+  public:
+    typedef btkSharedPtr<BatchAcquisitionReader> Pointer;
+    typedef btkSharedPtr<const BatchAcquisitionReader> ConstPointer;
+    typedef btkNullPtr<BatchAcquisitionReader> NullPointer;
+    
+    struct Result
+    {
+      int index;
+      std::string filename;
+      Acquisition::Pointer acquisition;
+      std::string error;
+      bool IsValid() const {return this->error.empty();};
+    };
+    
+    class Handler
+    {
+    public:
+      virtual ~Handler() {};
+      virtual void Process(const Result& result) = 0;
+    };
+    
+    static Pointer New(int threadNumber = 0) {return Pointer(new BatchAcquisitionReader(threadNumber));};
+    static NullPointer Null() {return NullPointer();};
+    
+    BTK_IO_EXPORT ~BatchAcquisitionReader();
+    
+    BTK_IO_EXPORT int GetThreadNumber() const;
+    int GetCapacity() const {return this->m_Capacity;};
+    BTK_IO_EXPORT void SetCapacity(int capacity);
+    Acquisition::StoragePrecision GetStoragePrecision() const {return this->m_StoragePrecision;};
+    BTK_IO_EXPORT void SetStoragePrecision(Acquisition::StoragePrecision precision);
+    
+    const std::vector<std::string>& GetFilenames() const {return this->m_Filenames;};
+    BTK_IO_EXPORT void SetFilenames(const std::vector<std::string>& filenames);
+    BTK_IO_EXPORT void AddFilename(const std::string& filename);
+    BTK_IO_EXPORT int AddDirectory(const std::string& path, const std::string& extension = "");
+    BTK_IO_EXPORT void ClearFilenames();
+    
+    BTK_IO_EXPORT bool Next(Result* result);
+    BTK_IO_EXPORT int Read(Handler* handler);
+    BTK_IO_EXPORT void Rewind();
+    
+  protected:
+    BTK_IO_EXPORT BatchAcquisitionReader(int threadNumber);
+    
+  private:
+    BatchAcquisitionReader(const BatchAcquisitionReader& ); // Not implemented.
+    BatchAcquisitionReader& operator=(const BatchAcquisitionReader& ); // Not implemented.
+    
+    struct Slot;
+    
+    void Submit(size_t index);
+    static void Run(void* slot);
+    
+    thread_pool_p* mp_Pool;
+    std::vector<Slot*> m_Slots;
+    std::vector<std::string> m_Filenames;
+    int m_Capacity;
+    Acquisition::StoragePrecision m_StoragePrecision;
+    size_t m_Submitted;
+    size_t m_Delivered;
+  };
+};
+
+#endif // __btkBatchAcquisitionReader_h
@@ -37,6 +37,7 @@
 #include "btkMetaDataUtils.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkAsyncUpdate.h"
 
 #include <algorithm>
 #include <cctype>
@@ -207,6 +208,84 @@ namespace btk
       return false;
   };
   
+  /**
+   * Estimates the memory used by the acquisition read from the file @a filename with its header (number of points, 
+   * analog channels and frames) and the size of its parameter section. The file's data are not read.
+   */
+  bool C3DFileIO::EstimateMemoryUsage(const std::string& filename, Acquisition::StoragePrecision precision, MemoryUsage* usage)
+  {
+    BinaryFileStream* ibfs = new NativeBinaryFileStream();
+    ibfs->SetExceptions(BinaryFileStream::EndFileBit | BinaryFileStream::FailBit | BinaryFileStream::BadBit);
+    bool estimated = false;
+    try
+    {
+      ibfs->Open(filename, BinaryFileStream::In);
+      const int8_t parameterFirstBlock = ibfs->ReadI8();
+      if ((parameterFirstBlock <= 1) || (ibfs->ReadI8() != 80)) // No header
+        throw(C3DFileIOException("Bad header"));
+      ibfs->SeekRead(512 * (parameterFirstBlock - 1) + 3, BinaryFileStream::Begin);
+      BinaryFileStream* oldBFS = ibfs;
+      switch (ibfs->ReadI8())
+      {
+        case IEEE_LittleEndian :
+        case IEEE_LittleEndian + 83 :
+          ibfs = new IEEELittleEndianBinaryFileStream();
+          break;
+        case VAX_LittleEndian :
+        case VAX_LittleEndian + 83 :
+          ibfs = new VAXLittleEndianBinaryFileStream();
+          break;
+        case IEEE_BigEndian :
+        case IEEE_BigEndian + 83 :
+          ibfs = new IEEEBigEndianBinaryFileStream();
+          break;
+        default :
+          throw(C3DFileIOException("Invalid processor type"));
+          break;
+      };
+      ibfs->SwapStream(oldBFS);
+      delete oldBFS;
+      ibfs->SeekRead(2, BinaryFileStream::Begin);
+      const int pointNumber = ibfs->ReadU16(); // (word 02)
+      const int totalAnalogSamplesPer3dFrame = ibfs->ReadU16(); // (word 03)
+      const int firstFrame = ibfs->ReadU16(); // (word 04)
+      const int lastFrame = ibfs->ReadU16(); // (word 05)
+      ibfs->SeekRead(2, BinaryFileStream::Current); // (word 06)
+      const float pointScaleFactor = ibfs->ReadFloat(); // (word 07-08)
+      const int dataFirstBlock = ibfs->ReadU16(); // (word 09)
+      const int numberSamplesPerAnalogChannel = ibfs->ReadU16(); // (word 10)
+      const int analogNumber = (numberSamplesPerAnalogChannel != 0) ? totalAnalogSamplesPer3dFrame / numberSamplesPerAnalogChannel : 0;
+      int frameNumber = lastFrame - firstFrame + 1;
+      // The last frame is stored in 16 bits: the number of frames of a long acquisition is given by the size of the data section.
+      ibfs->SeekRead(0, BinaryFileStream::End);
+      const std::streamoff dataSize = static_cast<std::streamoff>(ibfs->TellRead()) - 512 * static_cast<std::streamoff>(dataFirstBlock - 1);
+      const std::streamoff frameSize = (4 * static_cast<std::streamoff>(pointNumber) + totalAnalogSamplesPer3dFrame) * ((pointScaleFactor < 0.0f) ? 4 : 2);
+      if (((lastFrame == 65535) || (frameNumber <= 0)) && (frameSize != 0) && (dataSize > 0))
+        frameNumber = static_cast<int>(dataSize / frameSize);
+      if (this->HasRequestedRegion())
+      {
+        const int lb = std::max(this->GetRequestedFirstFrame(), firstFrame);
+        const int ub = std::min(this->GetRequestedLastFrame(), firstFrame + frameNumber - 1);
+        if (lb <= ub)
+          frameNumber = ub - lb + 1;
+      }
+      AcquisitionFileIO::AddAcquisitionMemoryUsage(usage, pointNumber, std::max(frameNumber, 0), analogNumber, numberSamplesPerAnalogChannel, precision, pointScaleFactor > 0.0f);
+      // Each parameter is stored in a few bytes but uses a MetaData object and a MetaDataInfo object (about 11 times the size of the parameter section).
+      usage->Add(MemoryUsage::MetaData, 11 * 512 * static_cast<size_t>(std::max(dataFirstBlock - parameterFirstBlock, 0)));
+      estimated = true;
+    }
+    catch (BinaryFileStreamFailure& )
+    {
+      btkWarningMacro(filename, "Impossible to read the header to estimate the memory used.");
+    }
+    catch (C3DFileIOException& e)
+    {
+      btkWarningMacro(filename, "Impossible to estimate the memory used: " + std::string(e.what()));
+    }
+    if (ibfs) delete ibfs;
+    return estimated;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -766,28 +845,84 @@ namespace btk
           fdf = new FloatFormat(ibfs);
         }
         int frameNumber = lastFrame - output->GetFirstFrame() + 1;
+        // Partial reading: the frames before the requested region are skipped and the reading stops after the region.
+        if (this->HasRequestedRegion())
+        {
+          const int lb = std::max(this->GetRequestedFirstFrame(), output->GetFirstFrame());
+          const int ub = std::min(this->GetRequestedLastFrame(), lastFrame);
+          if (lb <= ub)
+          {
+            const std::streamoff wordSize = (this->m_StorageFormat == Integer) ? 2 : 4;
+            const std::streamoff frameSize = (4 * static_cast<std::streamoff>(pointNumber) + static_cast<std::streamoff>(totalAnalogSamplesPer3dFrame)) * wordSize;
+            ibfs->SeekRead(static_cast<std::streamoff>(lb - output->GetFirstFrame()) * frameSize, BinaryFileStream::Current);
+            output->SetFirstFrame(lb);
+            frameNumber = ub - lb + 1;
+          }
+          else
+            btkWarningMacro(filename, "The requested frames are not in the file. All the frames are read.");
+        }
         output->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel);
         output->SetPointFrequency(pointFrameRate);
+        // The values are directly stored in single precision if requested.
+        const bool singlePrecision = (output->GetStoragePrecision() != Acquisition::DoublePrecision);
+        // The integer analog samples are kept as is if requested.
+        // The unsigned samples are shifted (as their offset) to fit in 16-bit signed integers.
+        // The channels with a null scale cannot be stored as raw samples and are stored as the other values.
+        const bool rawSamples = (output->GetStoragePrecision() == Acquisition::RawPrecision) && (this->m_StorageFormat == Integer);
+        const double rawShift = (this->m_AnalogIntegerFormat == Unsigned) ? 32768.0 : 0.0;
+        if (rawSamples)
+        {
+          int incChannel = 0;
+          for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it, ++incChannel)
+          {
+            const double scale = this->m_AnalogChannelScale[incChannel] * this->m_AnalogUniversalScale;
+            if (scale != 0.0)
+              (*it)->GetData()->SetRawStorage(this->m_AnalogZeroOffset[incChannel] - rawShift, scale);
+          }
+        }
         try
         {
           for (int frame = 0 ; frame < frameNumber ; ++frame)
           {
+            AsyncUpdate::ReportProgress(static_cast<double>(frame) / static_cast<double>(frameNumber));
             Acquisition::PointIterator itM = output->BeginPoint(); 
             while (itM != output->EndPoint())
             {
               Point* point = itM->get();
-              fdf->ReadPoint(&(point->GetValues().data()[frame]),
-                             &(point->GetValues().data()[frame + frameNumber]),
-                             &(point->GetValues().data()[frame + 2*frameNumber]),
-                             &(point->GetResiduals().data()[frame]),
-                             this->m_PointScale);
+              if (singlePrecision)
+              {
+                double x = 0.0, y = 0.0, z = 0.0, res = 0.0;
+                fdf->ReadPoint(&x, &y, &z, &res, this->m_PointScale);
+                Point::Data* data = point->GetData().get();
+                data->GetSingleValues().coeffRef(frame, 0) = static_cast<float>(x);
+                data->GetSingleValues().coeffRef(frame, 1) = static_cast<float>(y);
+                data->GetSingleValues().coeffRef(frame, 2) = static_cast<float>(z);
+                data->GetSingleResiduals().coeffRef(frame) = static_cast<float>(res);
+              }
+              else
+              {
+                fdf->ReadPoint(&(point->GetValues().data()[frame]),
+                               &(point->GetValues().data()[frame + frameNumber]),
+                               &(point->GetValues().data()[frame + 2*frameNumber]),
+                               &(point->GetResiduals().data()[frame]),
+                               this->m_PointScale);
+              }
               ++itM;
             }
             unsigned inc = 0, incChannel = 0, analogFrame = numberSamplesPerAnalogChannel * frame;
             Acquisition::AnalogIterator itA = output->BeginAnalog();
             while (itA != output->EndAnalog())
             {
-              (*itA)->GetValues().data()[analogFrame] = (fdf->ReadAnalog() - this->m_AnalogZeroOffset[incChannel]) * this->m_AnalogChannelScale[incChannel] * this->m_AnalogUniversalScale;
+              if (rawSamples && (*itA)->GetData()->IsRaw())
+                (*itA)->GetData()->GetRawValues().coeffRef(analogFrame) = static_cast<int16_t>(fdf->ReadAnalog() - rawShift);
+              else
+              {
+                const double val = (fdf->ReadAnalog() - this->m_AnalogZeroOffset[incChannel]) * this->m_AnalogChannelScale[incChannel] * this->m_AnalogUniversalScale;
+                if (singlePrecision)
+                  (*itA)->GetData()->GetSingleValues().coeffRef(analogFrame) = static_cast<float>(val);
+                else
+                  (*itA)->GetValues().coeffRef(analogFrame) = val;
+              }
               ++itA; ++incChannel;
               if ((itA == output->EndAnalog()) && (inc < static_cast<unsigned>(numberSamplesPerAnalogChannel - 1)))
               {
@@ -867,6 +1002,8 @@ namespace btk
                   res.coeffRef(k) = -1.0;
                 }
               }
+              if (output->GetStoragePrecision() != Acquisition::DoublePrecision)
+                (*it)->GetData()->SetSinglePrecision(true);
             }
           }
           // Point's type
@@ -1257,8 +1394,21 @@ namespace btk
         {
           fdf = new FloatFormat(obfs);
         }
+        // The raw analog samples are written without quantization error when their scale corresponds to the one used in the file.
+        std::vector<double> rawFactors(input->GetAnalogNumber(), 0.0);
+        size_t incRaw = 0;
+        for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it, ++incRaw)
+        {
+          Analog::Data::Pointer data = (*it)->GetData();
+          if (data && data->IsRaw())
+          {
+            const double factor = data->GetRawScale() / this->m_AnalogChannelScale[incRaw] / this->m_AnalogUniversalScale;
+            rawFactors[incRaw] = (fabs(factor - 1.0) <= 1.0e-10) ? 1.0 : factor;
+          }
+        }
         for (int frame = 0 ; frame < frameNumber ; ++frame)
         {
+          AsyncUpdate::ReportProgress(static_cast<double>(frame) / static_cast<double>(frameNumber));
           Acquisition::PointConstIterator itM = input->BeginPoint();
           while (itM != input->EndPoint())
           {
@@ -1275,11 +1425,22 @@ namespace btk
           Acquisition::AnalogConstIterator itA = input->BeginAnalog();
           while (itA != input->EndAnalog())
           {
-            fdf->WriteAnalog(
-                (*itA)->GetValues().data()[analogFrame]
-                / this->m_AnalogChannelScale[incChannel]
-                / this->m_AnalogUniversalScale
-                + this->m_AnalogZeroOffset[incChannel]);
+            if (rawFactors[incChannel] != 0.0)
+            {
+              const Analog::Data* data = (*itA)->GetData().get();
+              fdf->WriteAnalog(
+                  (data->GetRawValues().coeff(analogFrame) - data->GetRawOffset())
+                  * rawFactors[incChannel]
+                  + this->m_AnalogZeroOffset[incChannel]);
+            }
+            else
+            {
+              fdf->WriteAnalog(
+                  (*itA)->GetValues().coeff(analogFrame)
+                  / this->m_AnalogChannelScale[incChannel]
+                  / this->m_AnalogUniversalScale
+                  + this->m_AnalogZeroOffset[incChannel]);
+            }
             ++itA; ++incChannel;
             if ((itA == input->EndAnalog()) && (inc < static_cast<size_t>(numberSamplesPerAnalogChannel - 1)))
             {
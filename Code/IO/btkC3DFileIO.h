@@ -84,6 +84,7 @@ namespace btk
     BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
+    BTK_IO_EXPORT virtual bool EstimateMemoryUsage(const std::string& filename, Acquisition::StoragePrecision precision, MemoryUsage* usage);
     
   protected:
     BTK_IO_EXPORT C3DFileIO();
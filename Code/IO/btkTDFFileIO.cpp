@@ -745,7 +745,9 @@ namespace btk
             }
             const int32_t shift = (EMGFirstframe - firstframe) * analogSampleNumberPerPointFrame;
             const int32_t numEMGFramesFinal = numEMGFrames - shift;
-            memcpy((*it)->GetValues().data() + shift, val.data(), (numEMGFramesFinal >= numAnalogFrames) ? numAnalogFrames : numEMGFramesFinal);
+            const int32_t num = std::min((numEMGFramesFinal >= numAnalogFrames) ? numAnalogFrames : numEMGFramesFinal, static_cast<int32_t>((*it)->GetFrameNumber()) - shift);
+            if (num > 0) // The values can be stored in a block (i.e. with a stride).
+              (*it)->GetValues().segment(shift, num) = val.head(num);
             ++it;
           }
         }
@@ -0,0 +1,133 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <btkBatchAcquisitionReader.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkMacro.h> // btkStripPathMacro
+
+#include <iostream> // std::cout, std::cerr
+#include <sstream> // std::ostringstream
+#include <cstdlib> // std::atoi
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+#endif
+
+// Wall time in seconds
+static double WallTime()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+};
+
+static void PrintThroughput(const std::string& label, int files, int errors, double seconds)
+{
+  std::cout << label << ": " << files << " files (" << errors << " errors) in " << seconds << " s";
+  if (seconds > 0.0)
+    std::cout << " - " << static_cast<double>(files) / seconds << " files/s";
+  std::cout << std::endl;
+};
+
+int main(int argc, char *argv[])
+{
+  if ((argc < 2) || (argc > 5))
+  {
+    std::cerr << "Wrong number of input arguments.\n\n"
+              << "Usage: " << btkStripPathMacro(argv[0]) << " directory [extension] [threads] [capacity]\n\n"
+              << "Read the acquisition files of a directory one after the other and then with a batch reader.\n"
+              << "The time spent by each method is reported."
+              << std::endl;
+    return -1;
+  }
+  
+  // Files to read
+  btk::BatchAcquisitionReader::Pointer batch = btk::BatchAcquisitionReader::New(argc > 3 ? std::atoi(argv[3]) : 0);
+  if (argc > 4)
+    batch->SetCapacity(std::atoi(argv[4]));
+  const int num = batch->AddDirectory(argv[1], argc > 2 ? argv[2] : "");
+  if (num == 0)
+  {
+    std::cerr << "No file to read." << std::endl;
+    return -2;
+  }
+  const std::vector<std::string>& filenames = batch->GetFilenames();
+  
+  // Sequential reading
+  int errors = 0;
+  double start = WallTime();
+  for (size_t i = 0 ; i < filenames.size() ; ++i)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(filenames[i]);
+    try
+    {
+      reader->Update();
+    }
+    catch (std::exception& )
+    {
+      ++errors;
+    }
+  }
+  PrintThroughput("Sequential", num, errors, WallTime() - start);
+  
+  // Batch reading. The acquisitions are released as soon as they are delivered.
+  start = WallTime();
+  btk::BatchAcquisitionReader::Result result;
+  errors = 0;
+  while (batch->Next(&result))
+  {
+    if (!result.IsValid())
+    {
+      std::cerr << result.filename << ": " << result.error << std::endl;
+      ++errors;
+    }
+  }
+  std::ostringstream label;
+  label << "Batch (" << batch->GetThreadNumber() << " threads, capacity: " << batch->GetCapacity() << ")";
+  PrintThroughput(label.str(), num, errors, WallTime() - start);
+  
+  return 0;
+};
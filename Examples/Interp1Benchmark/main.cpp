@@ -0,0 +1,173 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <btkEigen/Interpolation/Interp1.h>
+#include <btkMacro.h> // btkStripPathMacro
+
+#include <iostream> // std::cout, std::cerr
+#include <cstdlib> // std::atoi
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+#endif
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Vector;
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+
+// Wall time in seconds
+static double WallTime()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+};
+
+static void PrintTiming(const std::string& label, double seconds, int repetitions, const Matrix& Yi, const Matrix& ref)
+{
+  std::cout << "  " << label << ": " << seconds * 1000.0 / static_cast<double>(repetitions) << " ms";
+  if (ref.size() != 0)
+    std::cout << " (max difference: " << (Yi - ref).cwiseAbs().maxCoeff() << ")";
+  std::cout << std::endl;
+};
+
+// Former path: each query point is located with the bisection or the hunting of Base_interp.
+template <typename InterpType>
+static void InterpolateByQuery(Matrix* Yi, const Vector& x, const Matrix& Y, const Vector& xi)
+{
+  Yi->resize(xi.rows(), Y.cols());
+  for (int c = 0 ; c < Y.cols() ; ++c)
+  {
+    Vector y = Y.col(c);
+    InterpType interp(&x, &y);
+    for (int i = 0 ; i < xi.rows() ; ++i)
+      Yi->coeffRef(i,c) = interp.interp(xi.coeff(i));
+  }
+};
+
+// Sorted path: each column is interpolated separately, the intervals are found by walking over the sorted vectors.
+static void InterpolateLinearByColumn(Matrix* Yi, const Vector& x, const Matrix& Y, const Vector& xi)
+{
+  Yi->resize(xi.rows(), Y.cols());
+  Vector y, yi;
+  for (int c = 0 ; c < Y.cols() ; ++c)
+  {
+    y = Y.col(c);
+    btkEigen::interp1().linear(&yi, x, y, xi);
+    Yi->col(c) = yi;
+  }
+};
+
+static void InterpolatePchipByColumn(Matrix* Yi, const Vector& x, const Matrix& Y, const Vector& xi)
+{
+  Yi->resize(xi.rows(), Y.cols());
+  Vector y, yi;
+  for (int c = 0 ; c < Y.cols() ; ++c)
+  {
+    y = Y.col(c);
+    btkEigen::interp1().pchip(&yi, x, y, xi);
+    Yi->col(c) = yi;
+  }
+};
+
+int main(int argc, char *argv[])
+{
+  if (argc > 5)
+  {
+    std::cerr << "Wrong number of input arguments.\n\n"
+              << "Usage: " << btkStripPathMacro(argv[0]) << " [frames] [columns] [queries] [repetitions]\n\n"
+              << "Interpolate the columns of a random trial (by default 10000 frames and 60 columns, i.e. 20 markers)\n"
+              << "at sorted query points (by default 20000, i.e. an upsampling by 2) with the linear and PCHIP methods.\n"
+              << "The time spent by locating each query point, by walking over the sorted vectors for each column\n"
+              << "and by interpolating all the columns at once is reported."
+              << std::endl;
+    return -1;
+  }
+  const int frames = (argc > 1) ? std::atoi(argv[1]) : 10000;
+  const int columns = (argc > 2) ? std::atoi(argv[2]) : 60;
+  const int queries = (argc > 3) ? std::atoi(argv[3]) : 2 * frames;
+  const int repetitions = (argc > 4) ? std::atoi(argv[4]) : 10;
+  if ((frames < 2) || (columns < 1) || (queries < 1) || (repetitions < 1))
+  {
+    std::cerr << "At least two frames, one column, one query point and one repetition are required." << std::endl;
+    return -2;
+  }
+  
+  const Vector x = Vector::LinSpaced(frames, 0.0, static_cast<double>(frames - 1));
+  const Vector xi = Vector::LinSpaced(queries, 0.0, static_cast<double>(frames - 1));
+  const Matrix Y = Matrix::Random(frames, columns);
+  Matrix ref, Yi;
+  double start = 0.0;
+  std::cout << frames << " frames, " << columns << " columns, " << queries << " query points" << std::endl;
+  
+  std::cout << "Linear" << std::endl;
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    InterpolateByQuery< btkEigen::Linear_interp<Vector> >(&ref, x, Y, xi);
+  PrintTiming("By query point", WallTime() - start, repetitions, ref, Matrix());
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    InterpolateLinearByColumn(&Yi, x, Y, xi);
+  PrintTiming("Sorted, by column", WallTime() - start, repetitions, Yi, ref);
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    btkEigen::interp1().linearColumns(&Yi, x, Y, xi);
+  PrintTiming("Sorted, all columns", WallTime() - start, repetitions, Yi, ref);
+  
+  std::cout << "PCHIP" << std::endl;
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    InterpolateByQuery< btkEigen::PCHIP_interp<Vector> >(&ref, x, Y, xi);
+  PrintTiming("By query point", WallTime() - start, repetitions, ref, Matrix());
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    InterpolatePchipByColumn(&Yi, x, Y, xi);
+  PrintTiming("Sorted, by column", WallTime() - start, repetitions, Yi, ref);
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    btkEigen::interp1().pchipColumns(&Yi, x, Y, xi);
+  PrintTiming("Sorted, all columns", WallTime() - start, repetitions, Yi, ref);
+  
+  return 0;
+};
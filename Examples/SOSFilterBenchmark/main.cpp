@@ -0,0 +1,145 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkEigen/SignalProcessing/Filter.h>
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/SOSFilter.h>
+#include <btkMacro.h> // btkStripPathMacro
+
+#include <iostream> // std::cout, std::cerr
+#include <cstdlib> // std::atoi, std::atof
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+#endif
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Vector;
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+typedef Eigen::Matrix<double, Eigen::Dynamic, 6> Sections;
+
+// Wall time in seconds
+static double WallTime()
+{
+#if defined(_WIN32)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+};
+
+static void PrintTiming(const std::string& label, double seconds, int repetitions, const Matrix& Y, const Matrix& ref)
+{
+  std::cout << "  " << label << ": " << seconds * 1000.0 / static_cast<double>(repetitions) << " ms";
+  if (ref.size() != 0)
+    std::cout << " (max difference: " << (Y - ref).cwiseAbs().maxCoeff() << ")";
+  std::cout << std::endl;
+};
+
+int main(int argc, char *argv[])
+{
+  if (argc > 6)
+  {
+    std::cerr << "Wrong number of input arguments.\n\n"
+              << "Usage: " << btkStripPathMacro(argv[0]) << " [order] [cutoff] [frames] [columns] [repetitions]\n\n"
+              << "Filter the columns of a random trial (by default 10000 frames and 60 columns, i.e. 20 markers) with a lowpass\n"
+              << "Butterworth filter (by default of order 4 with a cutoff frequency of 0.06, normalized by the Nyquist frequency).\n"
+              << "The time spent by the forward filter and by the forward-backward filter is reported for the coefficients\n"
+              << "of the transfer function (btkEigen::filter, btkEigen::filtfilt) and for the second-order sections\n"
+              << "(btkEigen::sosfilt, btkEigen::sosfiltfilt). The differences are computed relatively to the second-order sections."
+              << std::endl;
+    return -1;
+  }
+  const int order = (argc > 1) ? std::atoi(argv[1]) : 4;
+  const double cutoff = (argc > 2) ? std::atof(argv[2]) : 0.06;
+  const int frames = (argc > 3) ? std::atoi(argv[3]) : 10000;
+  const int columns = (argc > 4) ? std::atoi(argv[4]) : 60;
+  const int repetitions = (argc > 5) ? std::atoi(argv[5]) : 10;
+  if ((columns < 1) || (repetitions < 1) || (frames <= 6 * order))
+  {
+    std::cerr << "At least one column and one repetition are required. The number of frames must be greater than 6 times the order of the filter." << std::endl;
+    return -2;
+  }
+  Vector b, a;
+  Sections sos;
+  if (!btkEigen::butter(&b, &a, order, cutoff) || !btkEigen::butterSOS(&sos, order, cutoff))
+    return -3;
+  
+  const Matrix X = Matrix::Random(frames, columns);
+  Matrix ref, Y;
+  Vector y;
+  double start = 0.0;
+  std::cout << "Order " << order << ", cutoff " << cutoff << ", " << frames << " frames, " << columns << " columns" << std::endl;
+  
+  std::cout << "Forward filter" << std::endl;
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+  {
+    ref = X;
+    btkEigen::sosfilt(sos, ref);
+  }
+  PrintTiming("Second-order sections", WallTime() - start, repetitions, ref, Matrix());
+  start = WallTime();
+  Y.resize(frames, columns);
+  for (int r = 0 ; r < repetitions ; ++r)
+  {
+    for (int j = 0 ; j < columns ; ++j)
+    {
+      y = X.col(j);
+      Y.col(j) = btkEigen::filter(b, a, y);
+    }
+  }
+  PrintTiming("Transfer function", WallTime() - start, repetitions, Y, ref);
+  
+  std::cout << "Forward-backward filter" << std::endl;
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    ref = btkEigen::sosfiltfilt(sos, X);
+  PrintTiming("Second-order sections", WallTime() - start, repetitions, ref, Matrix());
+  start = WallTime();
+  for (int r = 0 ; r < repetitions ; ++r)
+    Y = btkEigen::filtfilt(b, a, X);
+  PrintTiming("Transfer function", WallTime() - start, repetitions, Y, ref);
+  
+  return 0;
+};
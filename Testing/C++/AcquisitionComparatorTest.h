@@ -0,0 +1,214 @@
+#ifndef AcquisitionComparatorTest_h
+#define AcquisitionComparatorTest_h
+
+#include <btkAcquisitionComparator.h>
+#include <btkMetaDataUtils.h>
+
+#include <sstream>
+
+static btk::Acquisition::Pointer ComparatorAcquisition(int frameNumber = 100)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(3, frameNumber, 2, 4);
+  acq->SetPointFrequency(100.0);
+  for (int i = 0 ; i < 3 ; ++i)
+    for (int j = 0 ; j < 3 ; ++j)
+      acq->GetPoint(i)->GetValues().col(j).setLinSpaced(0.0, 100.0 * (i + j + 1));
+  for (int i = 0 ; i < 2 ; ++i)
+    acq->GetAnalog(i)->GetValues().setLinSpaced(-5.0, 5.0 * (i + 1));
+  acq->AppendEvent(btk::Event::New("Foot Strike", 0.1, "Left", btk::Event::Manual, "Bob"));
+  acq->AppendEvent(btk::Event::New("Foot Strike", 0.6, "Left", btk::Event::Manual, "Bob"));
+  acq->AppendEvent(btk::Event::New("Foot Off", 0.4, "Right", btk::Event::Manual, "Bob"));
+  btk::MetaData::Pointer point = btk::MetaDataCreateChild(acq->GetMetaData(), "POINT");
+  btk::MetaDataCreateChild(point, "RATE", 100.0f);
+  btk::MetaDataCreateChild(point, "UNITS", std::string("mm"));
+  return acq;
+};
+
+CXXTEST_SUITE(AcquisitionComparatorTest)
+{
+  CXXTEST_TEST(Identical)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    TS_ASSERT_EQUALS(comparator->Compare(reference, reference->Clone()), true);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 0u);
+    // The channels are matched by label, not by index.
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::Point::Pointer first = tested->GetPoint(0);
+    tested->RemovePoint(0);
+    tested->AppendPoint(first);
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), true);
+  };
+  
+  CXXTEST_TEST(Points)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition(3000);
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    comparator->SetPointTolerance(btk::AcquisitionComparator::Tolerance(1e-3));
+    tested->GetPoint(1)->GetValues().coeffRef(2500,2) += 5e-4;
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), true);
+    tested->GetPoint(1)->GetValues().coeffRef(2600,0) += 0.5;
+    tested->GetPoint(1)->GetValues().coeffRef(2500,1) += 0.2;
+    tested->GetPoint(1)->GetValues().coeffRef(2500,2) += 0.1;
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 1u);
+    const btk::AcquisitionComparator::Difference& diff = comparator->GetDifferences()[0];
+    TS_ASSERT_EQUALS(diff.category, btk::AcquisitionComparator::Difference::Point);
+    TS_ASSERT_EQUALS(diff.type, btk::AcquisitionComparator::Difference::Values);
+    TS_ASSERT_EQUALS(diff.label, "uname*2");
+    TS_ASSERT_EQUALS(diff.frame, 2500);
+    TS_ASSERT_EQUALS(diff.component, 1);
+    TS_ASSERT_EQUALS(diff.frameNumber, 2);
+    TS_ASSERT_DELTA(diff.maxError, 0.5, 1e-9);
+  };
+  
+  CXXTEST_TEST(Occlusion)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    reference->GetPoint(0)->GetResiduals().coeffRef(10) = -1.0;
+    tested->GetPoint(0)->GetResiduals().coeffRef(10) = -1.0;
+    tested->GetPoint(0)->GetValues().row(10).setZero();
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), true);
+    tested->GetPoint(0)->GetResiduals().coeffRef(20) = -1.0;
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 1u);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].frame, 20);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].frameNumber, 1);
+  };
+  
+  CXXTEST_TEST(Analogs)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    comparator->SetAnalogTolerance(btk::AcquisitionComparator::Tolerance(0.0, 1e-3));
+    tested->GetAnalog(1)->GetValues() *= 1.0005;
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), true);
+    tested->GetAnalog(1)->GetValues().coeffRef(399) *= 1.01;
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 1u);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].category, btk::AcquisitionComparator::Difference::Analog);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].frame, 399);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].component, 0);
+    tested->GetAnalog(0)->SetUnit("mV");
+    comparator->Compare(reference, tested);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 2u);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].type, btk::AcquisitionComparator::Difference::Property);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].detail, "unit");
+  };
+  
+  CXXTEST_TEST(CompactStorage)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    tested->GetPoint(2)->GetData()->SetSinglePrecision(true);
+    tested->GetAnalog(0)->GetData()->SetRawStorage(0.0, 0.01);
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    comparator->SetPointTolerance(btk::AcquisitionComparator::Tolerance(0.0, 1e-6));
+    comparator->SetAnalogTolerance(btk::AcquisitionComparator::Tolerance(0.005));
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), true);
+    // The compact storages are not converted.
+    TS_ASSERT_EQUALS(tested->GetPoint(2)->GetData()->IsSinglePrecision(), true);
+    TS_ASSERT_EQUALS(tested->GetAnalog(0)->GetData()->IsRaw(), true);
+  };
+  
+  CXXTEST_TEST(Labels)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    tested->GetPoint(0)->SetLabel("LASI");
+    tested->RemoveAnalog(1);
+    tested->GetPoint(1)->SetType(btk::Point::Angle);
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    const std::vector<btk::AcquisitionComparator::Difference>& diffs = comparator->GetDifferences();
+    TS_ASSERT_EQUALS(diffs.size(), 4u);
+    TS_ASSERT_EQUALS(diffs[0].type, btk::AcquisitionComparator::Difference::Missing);
+    TS_ASSERT_EQUALS(diffs[0].label, "uname*1");
+    TS_ASSERT_EQUALS(diffs[1].type, btk::AcquisitionComparator::Difference::Property);
+    TS_ASSERT_EQUALS(diffs[1].detail, "type");
+    TS_ASSERT_EQUALS(diffs[2].type, btk::AcquisitionComparator::Difference::Unexpected);
+    TS_ASSERT_EQUALS(diffs[2].label, "LASI");
+    TS_ASSERT_EQUALS(diffs[3].category, btk::AcquisitionComparator::Difference::Analog);
+    TS_ASSERT_EQUALS(diffs[3].type, btk::AcquisitionComparator::Difference::Missing);
+    std::ostringstream oss;
+    comparator->PrintDifferences(oss);
+    TS_ASSERT_EQUALS(oss.str(), "Point 'uname*1': missing\nPoint 'uname*2': different type\nPoint 'LASI': unexpected\nAnalog 'uname*2': missing\n");
+  };
+  
+  CXXTEST_TEST(Frames)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    tested->ResizeFrameNumber(80);
+    tested->SetFirstFrame(5);
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 2u);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].category, btk::AcquisitionComparator::Difference::Frames);
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[0].detail, "first frame");
+    TS_ASSERT_EQUALS(comparator->GetDifferences()[1].detail, "number of frames");
+  };
+  
+  CXXTEST_TEST(Events)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    comparator->SetEventTolerance(btk::AcquisitionComparator::Tolerance(0.005));
+    tested->GetEvent(0)->SetTime(0.104);
+    tested->GetEvent(1)->SetTime(0.61);
+    tested->GetEvent(2)->SetSubject("Alice");
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    const std::vector<btk::AcquisitionComparator::Difference>& diffs = comparator->GetDifferences();
+    TS_ASSERT_EQUALS(diffs.size(), 3u);
+    TS_ASSERT_EQUALS(diffs[0].type, btk::AcquisitionComparator::Difference::Values);
+    TS_ASSERT_EQUALS(diffs[0].label, "Left:Foot Strike");
+    TS_ASSERT_DELTA(diffs[0].maxError, 0.01, 1e-9);
+    TS_ASSERT_EQUALS(diffs[1].type, btk::AcquisitionComparator::Difference::Unexpected);
+    TS_ASSERT_EQUALS(diffs[1].detail, "Alice");
+    TS_ASSERT_EQUALS(diffs[2].type, btk::AcquisitionComparator::Difference::Missing);
+    TS_ASSERT_EQUALS(diffs[2].detail, "Bob");
+  };
+  
+  CXXTEST_TEST(MetaData)
+  {
+    btk::Acquisition::Pointer reference = ComparatorAcquisition();
+    btk::Acquisition::Pointer tested = reference->Clone();
+    btk::AcquisitionComparator::Pointer comparator = btk::AcquisitionComparator::New();
+    tested->GetMetaData()->GetChild("POINT")->GetChild("RATE")->GetInfo()->SetValues(100.5f);
+    tested->GetMetaData()->GetChild("POINT")->GetChild("UNITS")->GetInfo()->SetValues(std::string("m"));
+    btk::MetaDataCreateChild(tested->GetMetaData()->GetChild("POINT"), "SCALE", -0.1f);
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), false);
+    const std::vector<btk::AcquisitionComparator::Difference>& diffs = comparator->GetDifferences();
+    TS_ASSERT_EQUALS(diffs.size(), 3u);
+    TS_ASSERT_EQUALS(diffs[0].label, "POINT:RATE");
+    TS_ASSERT_EQUALS(diffs[0].type, btk::AcquisitionComparator::Difference::Values);
+    TS_ASSERT_DELTA(diffs[0].maxError, 0.5, 1e-9);
+    TS_ASSERT_EQUALS(diffs[1].label, "POINT:UNITS");
+    TS_ASSERT_EQUALS(diffs[2].label, "POINT:SCALE");
+    TS_ASSERT_EQUALS(diffs[2].type, btk::AcquisitionComparator::Difference::Unexpected);
+    comparator->SetMetaDataTolerance(btk::AcquisitionComparator::Tolerance(1.0));
+    comparator->Compare(reference, tested);
+    TS_ASSERT_EQUALS(comparator->GetDifferences().size(), 2u);
+    comparator->SetMetaDataComparison(false);
+    TS_ASSERT_EQUALS(comparator->Compare(reference, tested), true);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionComparatorTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Identical)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Points)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Occlusion)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Analogs)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, CompactStorage)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Labels)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Frames)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, Events)
+CXXTEST_TEST_REGISTRATION(AcquisitionComparatorTest, MetaData)
+#endif
@@ -158,6 +158,49 @@ CXXTEST_SUITE(AcquisitionTest)
     TS_ASSERT_EQUALS(test->GetPoint(1)->GetParent(), test.get());
     TS_ASSERT_EQUALS(test->GetPoint(2)->GetParent(), test.get());
   }
+  
+  CXXTEST_TEST(StoragePrecision)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    TS_ASSERT_EQUALS(test->GetStoragePrecision(), btk::Acquisition::DoublePrecision);
+    test->SetStoragePrecision(btk::Acquisition::SinglePrecision);
+    test->Init(2, 10, 3, 2);
+    TS_ASSERT(test->GetPoint(1)->GetData()->IsSinglePrecision());
+    TS_ASSERT(test->GetAnalog(2)->GetData()->IsSinglePrecision());
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetFrameNumber(), 20);
+    test->GetAnalog(2)->GetValues().setConstant(0.25);
+    TS_ASSERT(!test->GetAnalog(2)->GetData()->IsSinglePrecision());
+    test->ResizeFrameNumber(12);
+    TS_ASSERT(test->GetAnalog(2)->GetData()->IsSinglePrecision());
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetData()->GetSingleValues().rows(), 24);
+    btk::Acquisition::Pointer cloned = test->Clone();
+    TS_ASSERT_EQUALS(cloned->GetStoragePrecision(), btk::Acquisition::SinglePrecision);
+    TS_ASSERT(cloned->GetPoint(0)->GetData()->IsSinglePrecision());
+    test->SetStoragePrecision(btk::Acquisition::DoublePrecision);
+    TS_ASSERT(!test->GetPoint(0)->GetData()->IsSinglePrecision());
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetValues().coeff(19), 0.25);
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetValues().coeff(20), 0.0);
+    TS_ASSERT_EQUALS(cloned->GetAnalog(2)->GetValues().coeff(19), 0.25);
+  }
+  
+  CXXTEST_TEST(StorageRawPrecision)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    test->SetStoragePrecision(btk::Acquisition::RawPrecision);
+    test->Init(1, 10, 2, 1);
+    TS_ASSERT(test->GetPoint(0)->GetData()->IsSinglePrecision());
+    TS_ASSERT(test->GetAnalog(1)->GetData()->IsSinglePrecision());
+    test->GetAnalog(1)->GetData()->SetRawStorage(0.0, 0.25);
+    test->ResizeFrameNumber(12);
+    TS_ASSERT(test->GetAnalog(1)->GetData()->IsRaw());
+    TS_ASSERT_EQUALS(test->GetAnalog(1)->GetFrameNumber(), 12);
+    test->SetStoragePrecision(btk::Acquisition::SinglePrecision);
+    TS_ASSERT(!test->GetAnalog(1)->GetData()->IsRaw());
+    TS_ASSERT(test->GetAnalog(1)->GetData()->IsSinglePrecision());
+    test->SetStoragePrecision(btk::Acquisition::DoublePrecision);
+    TS_ASSERT(!test->GetAnalog(1)->GetData()->IsSinglePrecision());
+    TS_ASSERT_EQUALS(test->GetAnalog(1)->GetValues().rows(), 12);
+  }
 };
 
 CXXTEST_SUITE_REGISTRATION(AcquisitionTest)
@@ -172,4 +215,6 @@ CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeFromEnd)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, RemoveLastPoint)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, SetFirstFrameAdaptEvent)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeParent)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, StoragePrecision)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, StorageRawPrecision)
 #endif
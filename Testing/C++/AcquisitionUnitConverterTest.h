@@ -267,6 +267,50 @@ CXXTEST_SUITE(AcquisitionUnitConverterTest)
     TS_ASSERT((grw2->GetMoment()->GetValues() - (grw1->GetMoment()->GetValues() * 0.001)).rowwise().norm().sum() < 1e-3);
     TS_ASSERT_EIGEN_DELTA(grw2->GetForce()->GetValues(), grw1->GetForce()->GetValues(), 1e-9);
   };
+  
+  CXXTEST_TEST(Threads)
+  {
+    btk::Acquisition::Pointer input = btk::Acquisition::New();
+    input->Init(200, 100, 30, 2);
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      input->GetPoint(i)->SetType(static_cast<btk::Point::Type>(i % 6));
+      input->GetPoint(i)->GetValues().setRandom();
+    }
+    const char* units[3] = {"Nmm", "mm", "V"};
+    for (int i = 0 ; i < 30 ; ++i)
+    {
+      input->GetAnalog(i)->SetUnit(units[i % 3]);
+      input->GetAnalog(i)->GetValues().setRandom();
+    }
+    btk::AcquisitionUnitConverter::Pointer uc = btk::AcquisitionUnitConverter::New();
+    uc->SetInput(input);
+    uc->SetUnit(btk::AcquisitionUnitConverter::Length, "m");
+    uc->SetUnit(btk::AcquisitionUnitConverter::Moment, "Nm");
+    uc->Update();
+    btk::Acquisition::Pointer reference = uc->GetOutput()->Clone();
+    uc->SetThreadNumber(4);
+    input->Modified();
+    uc->Update();
+    btk::Acquisition::Pointer output = uc->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 200);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 30);
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      TS_ASSERT_EQUALS(output->GetPoint(i)->GetLabel(), reference->GetPoint(i)->GetLabel());
+      TS_ASSERT(output->GetPoint(i)->GetValues() == reference->GetPoint(i)->GetValues());
+    }
+    for (int i = 0 ; i < 30 ; ++i)
+    {
+      TS_ASSERT_EQUALS(output->GetAnalog(i)->GetLabel(), reference->GetAnalog(i)->GetLabel());
+      TS_ASSERT_EQUALS(output->GetAnalog(i)->GetUnit(), reference->GetAnalog(i)->GetUnit());
+      TS_ASSERT_EQUALS(output->GetAnalog(i)->GetScale(), reference->GetAnalog(i)->GetScale());
+      TS_ASSERT(output->GetAnalog(i)->GetValues() == reference->GetAnalog(i)->GetValues());
+    }
+    TS_ASSERT_EQUALS(output->GetAnalog(0)->GetUnit(), "Nm");
+    TS_ASSERT_EQUALS(output->GetAnalog(1)->GetUnit(), "m");
+    TS_ASSERT_DELTA(output->GetAnalog(1)->GetValues()(10), input->GetAnalog(1)->GetValues()(10) / 1000.0, 1e-15);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(AcquisitionUnitConverterTest)
@@ -277,4 +321,5 @@ CXXTEST_TEST_REGISTRATION(AcquisitionUnitConverterTest, ConversionForAnalog)
 CXXTEST_TEST_REGISTRATION(AcquisitionUnitConverterTest, ConversionFromFile)
 CXXTEST_TEST_REGISTRATION(AcquisitionUnitConverterTest, ConversionFromFileCalMatrix_Type4)
 CXXTEST_TEST_REGISTRATION(AcquisitionUnitConverterTest, ConversionFromFileCalMatrix_Type4a)
+CXXTEST_TEST_REGISTRATION(AcquisitionUnitConverterTest, Threads)
 #endif
@@ -0,0 +1,132 @@
+#ifndef AnalogBlockTest_h
+#define AnalogBlockTest_h
+
+#include <btkAnalogBlock.h>
+#include <btkAcquisition.h>
+
+CXXTEST_SUITE(AnalogBlockTest)
+{
+  CXXTEST_TEST(PackColumnMajor)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      btk::Analog::Pointer analog = btk::Analog::New(10);
+      analog->SetValues(Eigen::Matrix<double,Eigen::Dynamic,1>::Random(10,1));
+      analogs->InsertItem(analog);
+    }
+    Eigen::Matrix<double,Eigen::Dynamic,1> ref = analogs->GetItem(1)->GetValues();
+    btk::AnalogBlock::Pointer block = btk::AnalogBlock::Pack(analogs);
+    TS_ASSERT(block != btk::AnalogBlock::Null);
+    TS_ASSERT_EQUALS(block->GetFrameNumber(), 10);
+    TS_ASSERT_EQUALS(block->GetChannelNumber(), 3);
+    TS_ASSERT_EQUALS(block->GetFrameStride(), 1);
+    TS_ASSERT_EQUALS(block->GetChannelStride(), 10);
+    TS_ASSERT(analogs->GetItem(1)->GetValues().IsShared());
+    TS_ASSERT_EQUALS(analogs->GetItem(1)->GetValues().data(), block->GetData() + 10);
+    TS_ASSERT_EIGEN_DELTA(analogs->GetItem(1)->GetValues(), ref, 1e-15);
+    TS_ASSERT_EIGEN_DELTA(block->GetMatrix().col(1), ref, 1e-15);
+    block->GetMatrix().coeffRef(5,2) = 1234.0;
+    TS_ASSERT_EQUALS(analogs->GetItem(2)->GetValues().coeff(5), 1234.0);
+    int first = -1;
+    TS_ASSERT(btk::AnalogBlock::Find(analogs, &first) == block);
+    TS_ASSERT_EQUALS(first, 0);
+  };
+  
+  CXXTEST_TEST(PackRowMajor)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      btk::Analog::Pointer analog = btk::Analog::New(7);
+      analog->SetValues(Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(7,1,static_cast<double>(i)));
+      analogs->InsertItem(analog);
+    }
+    btk::AnalogBlock::Pointer block = btk::AnalogBlock::Pack(analogs, btk::AnalogBlock::RowMajor);
+    TS_ASSERT_EQUALS(block->GetFrameStride(), 4);
+    TS_ASSERT_EQUALS(block->GetChannelStride(), 1);
+    for (int i = 0 ; i < 4 ; ++i)
+      TS_ASSERT_EQUALS(block->GetData()[2 * 4 + i], static_cast<double>(i));
+    analogs->GetItem(3)->GetValues().coeffRef(6) = 42.0;
+    TS_ASSERT_EQUALS(block->GetData()[6 * 4 + 3], 42.0);
+    // Sub-collection
+    btk::AnalogCollection::Pointer sub = btk::AnalogCollection::New();
+    sub->InsertItem(analogs->GetItem(1));
+    sub->InsertItem(analogs->GetItem(2));
+    int first = -1;
+    TS_ASSERT(btk::AnalogBlock::Find(sub, &first) == block);
+    TS_ASSERT_EQUALS(first, 1);
+    TS_ASSERT_EIGEN_DELTA(block->GetChannels(first, 2).col(1), analogs->GetItem(2)->GetValues(), 1e-15);
+    // Not consecutive
+    sub->InsertItem(analogs->GetItem(0));
+    TS_ASSERT(btk::AnalogBlock::Find(sub) == btk::AnalogBlock::Null);
+  };
+  
+  CXXTEST_TEST(DetachAndClone)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 2 ; ++i)
+      analogs->InsertItem(btk::Analog::New(5));
+    analogs->GetItem(0)->GetValues().setConstant(3.0);
+    btk::AnalogBlock::Pointer block = btk::AnalogBlock::Pack(analogs);
+    btk::Analog::Pointer cloned = analogs->GetItem(0)->Clone();
+    TS_ASSERT(!cloned->GetValues().IsShared());
+    TS_ASSERT_EIGEN_DELTA(cloned->GetValues(), analogs->GetItem(0)->GetValues(), 1e-15);
+    // Same size: written in the block
+    analogs->GetItem(1)->SetValues(Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(5,1,2.0));
+    TS_ASSERT(analogs->GetItem(1)->GetValues().IsShared());
+    TS_ASSERT_EQUALS(block->GetMatrix().coeff(4,1), 2.0);
+    // Resize: detached from the block.
+    analogs->GetItem(0)->SetFrameNumber(8);
+    TS_ASSERT(!analogs->GetItem(0)->GetValues().IsShared());
+    TS_ASSERT(analogs->GetItem(0)->GetData()->GetBlock() == btk::AnalogBlock::Null);
+    TS_ASSERT_EQUALS(analogs->GetItem(0)->GetValues().coeff(4), 3.0);
+    TS_ASSERT_EQUALS(analogs->GetItem(0)->GetValues().coeff(7), 0.0);
+    TS_ASSERT(btk::AnalogBlock::Find(analogs) == btk::AnalogBlock::Null);
+    btk::AnalogBlock::Unpack(analogs);
+    TS_ASSERT(!analogs->GetItem(1)->GetValues().IsShared());
+    TS_ASSERT_EQUALS(analogs->GetItem(1)->GetValues().coeff(4), 2.0);
+  };
+  
+  CXXTEST_TEST(AcquisitionStorage)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    TS_ASSERT_EQUALS(acq->GetAnalogStorage(), btk::Acquisition::Separated);
+    acq->SetAnalogStorage(btk::Acquisition::RowMajor);
+    acq->Init(2, 10, 6, 2);
+    btk::AnalogBlock::Pointer block = btk::AnalogBlock::Find(acq->GetAnalogs());
+    TS_ASSERT(block != btk::AnalogBlock::Null);
+    TS_ASSERT_EQUALS(block->GetLayout(), btk::AnalogBlock::RowMajor);
+    TS_ASSERT_EQUALS(block->GetFrameNumber(), 20);
+    TS_ASSERT_EQUALS(block->GetChannelNumber(), 6);
+    acq->GetAnalog(4)->GetValues().setConstant(1.5);
+    acq->ResizeFrameNumber(15);
+    block = btk::AnalogBlock::Find(acq->GetAnalogs());
+    TS_ASSERT(block != btk::AnalogBlock::Null);
+    TS_ASSERT_EQUALS(block->GetFrameNumber(), 30);
+    TS_ASSERT_EQUALS(acq->GetAnalog(4)->GetValues().coeff(19), 1.5);
+    TS_ASSERT_EQUALS(acq->GetAnalog(4)->GetValues().coeff(20), 0.0);
+    acq->ResizeAnalogNumber(8);
+    block = btk::AnalogBlock::Find(acq->GetAnalogs());
+    TS_ASSERT(block != btk::AnalogBlock::Null);
+    TS_ASSERT_EQUALS(block->GetChannelNumber(), 8);
+    btk::Acquisition::Pointer cloned = acq->Clone();
+    TS_ASSERT_EQUALS(cloned->GetAnalogStorage(), btk::Acquisition::RowMajor);
+    TS_ASSERT(btk::AnalogBlock::Find(cloned->GetAnalogs()) != btk::AnalogBlock::Null);
+    TS_ASSERT(btk::AnalogBlock::Find(cloned->GetAnalogs()) != block);
+    TS_ASSERT_EQUALS(cloned->GetAnalog(4)->GetValues().coeff(19), 1.5);
+    acq->Reset();
+    TS_ASSERT_EQUALS(acq->GetAnalogStorage(), btk::Acquisition::RowMajor);
+    acq->SetAnalogStorage(btk::Acquisition::Separated);
+    cloned->SetAnalogStorage(btk::Acquisition::Separated);
+    TS_ASSERT(btk::AnalogBlock::Find(cloned->GetAnalogs()) == btk::AnalogBlock::Null);
+    TS_ASSERT_EQUALS(cloned->GetAnalog(4)->GetValues().coeff(19), 1.5);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AnalogBlockTest)
+CXXTEST_TEST_REGISTRATION(AnalogBlockTest, PackColumnMajor)
+CXXTEST_TEST_REGISTRATION(AnalogBlockTest, PackRowMajor)
+CXXTEST_TEST_REGISTRATION(AnalogBlockTest, DetachAndClone)
+CXXTEST_TEST_REGISTRATION(AnalogBlockTest, AcquisitionStorage)
+#endif // AnalogBlockTest_h
@@ -13,9 +13,42 @@ CXXTEST_SUITE(AnalogTest)
     for (int i = 0 ; i < 5 ; ++i)
       TS_ASSERT_DELTA(cloned->GetValues().coeff(i),analog->GetValues().coeff(i),1e-15);
   };
+  
+  CXXTEST_TEST(DataRawStorage)
+  {
+    btk::Analog::Pointer analog = btk::Analog::New("FZ1", 4);
+    analog->SetValues(Eigen::Matrix<double,4,1>(-1.0, 0.0, 0.5, 2.0));
+    btk::Analog::Data::Pointer data = analog->GetData();
+    data->SetRawStorage(2048.0, 0.5);
+    TS_ASSERT(data->IsRaw());
+    TS_ASSERT_EQUALS(analog->GetFrameNumber(), 4);
+    TS_ASSERT_EQUALS(data->GetRawValues().coeff(0), 2046);
+    TS_ASSERT_EQUALS(data->GetRawValues().coeff(3), 2052);
+    data->Resize(5);
+    TS_ASSERT_EQUALS(data->GetRawValues().coeff(4), 2048);
+    btk::Analog::Pointer cloned = analog->Clone();
+    TS_ASSERT(cloned->GetData()->IsRaw());
+    // Const access: the raw samples are kept.
+    btk::Analog::ConstPointer constAnalog = analog;
+    unsigned long int timestamp = data->GetTimestamp();
+    TS_ASSERT(constAnalog->GetData()->IsCompacted());
+    TS_ASSERT(data->IsRaw());
+    TS_ASSERT_EQUALS(data->GetRawValues().rows(), 5);
+    TS_ASSERT_EQUALS(data->GetTimestamp(), timestamp);
+    // Access: converted in double precision.
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(2), 0.5);
+    TS_ASSERT(!data->IsRaw());
+    TS_ASSERT(!data->IsCompacted());
+    TS_ASSERT(data->GetTimestamp() > timestamp);
+    TS_ASSERT_EQUALS(data->GetRawValues().rows(), 0);
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(3), 2.0);
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(4), 0.0);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(0), -1.0);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(AnalogTest)
-CXXTEST_TEST_REGISTRATION(AnalogTest, DataClone)  
+CXXTEST_TEST_REGISTRATION(AnalogTest, DataClone)
+CXXTEST_TEST_REGISTRATION(AnalogTest, DataRawStorage)  
 
 #endif // Analog
\ No newline at end of file
@@ -0,0 +1,148 @@
+#ifndef AsyncUpdateTest_h
+#define AsyncUpdateTest_h
+
+#include <btkAsyncUpdate.h>
+#include <btkDataObject.h>
+#include <btkMemoryArena.h>
+#include <btkProcessObject.h>
+
+class AsyncValue : public btk::DataObject
+{
+public:
+  typedef btkSharedPtr<AsyncValue> Pointer;
+  static Pointer New() {return Pointer(new AsyncValue());}; 
+  int GetValue() const {return this->m_Val;};
+  void SetValue(int val) {this->m_Val = val;};
+private:
+  AsyncValue() {this->m_Val = 0;};
+  int m_Val;
+};
+
+// Counts until the given number and reports its progress at each iteration.
+class AsyncCounter : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<AsyncCounter> Pointer;
+  static Pointer New(int count) {return Pointer(new AsyncCounter(count));}; 
+  AsyncValue::Pointer GetOutput() {return static_pointer_cast<AsyncValue>(this->GetNthOutput(0));};
+  void SetFailure(bool failure) {this->m_Failure = failure; this->Modified();};
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */)
+  {
+    return AsyncValue::New();
+  };
+  virtual void GenerateData()
+  {
+    int i = 0;
+    for ( ; i < this->m_Count ; ++i)
+      btk::AsyncUpdate::ReportProgress(static_cast<double>(i) / static_cast<double>(this->m_Count));
+    if (this->m_Failure)
+      throw btk::RuntimeError("Counter failure");
+    this->GetOutput()->SetValue(i);
+  };
+  
+private:
+  AsyncCounter(int count)
+  : btk::ProcessObject()
+  {
+    this->SetInputNumber(0);
+    this->SetOutputNumber(1);
+    this->m_Count = count;
+    this->m_Failure = false;
+  };
+  
+  int m_Count;
+  bool m_Failure;
+};
+
+CXXTEST_SUITE(AsyncUpdateTest)
+{
+  CXXTEST_TEST(Finished)
+  {
+    AsyncCounter::Pointer counter = AsyncCounter::New(1000);
+    btk::AsyncUpdate::Pointer update = btk::AsyncUpdate::New(counter);
+    update->Wait();
+    TS_ASSERT_EQUALS(update->IsFinished(), true);
+    TS_ASSERT_EQUALS(update->GetState(), btk::AsyncUpdate::Finished);
+    TS_ASSERT_EQUALS(update->GetProgress(), 1.0);
+    TS_ASSERT_EQUALS(update->GetErrorMessage(), "");
+    TS_ASSERT_EQUALS(counter->GetOutput()->GetValue(), 1000);
+  };
+  
+  CXXTEST_TEST(Failed)
+  {
+    AsyncCounter::Pointer counter = AsyncCounter::New(10);
+    counter->SetFailure(true);
+    btk::AsyncUpdate::Pointer update = btk::AsyncUpdate::New(counter);
+    TS_ASSERT_THROWS_EQUALS(update->Wait(), const btk::RuntimeError &e, e.what(), std::string("Counter failure"));
+    TS_ASSERT_EQUALS(update->GetState(), btk::AsyncUpdate::Failed);
+    TS_ASSERT_EQUALS(update->GetErrorMessage(), "Counter failure");
+    TS_ASSERT_EQUALS(counter->GetOutput()->GetValue(), 0);
+    // Updated again
+    counter->SetFailure(false);
+    update = btk::AsyncUpdate::New(counter);
+    update->Wait();
+    TS_ASSERT_EQUALS(counter->GetOutput()->GetValue(), 10);
+  };
+  
+  CXXTEST_TEST(Cancelled)
+  {
+    AsyncCounter::Pointer counter = AsyncCounter::New(100000000);
+    btk::AsyncUpdate::Pointer update = btk::AsyncUpdate::New(counter);
+    update->Cancel();
+    update->Wait();
+    TS_ASSERT_EQUALS(update->GetState(), btk::AsyncUpdate::Cancelled);
+    TS_ASSERT_EQUALS(update->GetErrorMessage(), "");
+    TS_ASSERT(update->GetProgress() < 1.0);
+    TS_ASSERT_EQUALS(counter->GetOutput()->GetValue(), 0);
+  };
+  
+  CXXTEST_TEST(Concurrent)
+  {
+    std::vector<AsyncCounter::Pointer> counters;
+    std::vector<btk::AsyncUpdate::Pointer> updates;
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      counters.push_back(AsyncCounter::New(1000 * (i + 1)));
+      updates.push_back(btk::AsyncUpdate::New(counters.back()));
+    }
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      updates[i]->Wait();
+      TS_ASSERT_EQUALS(counters[i]->GetOutput()->GetValue(), 1000 * (i + 1));
+    }
+  };
+  
+  CXXTEST_TEST(MemoryArena)
+  {
+    AsyncCounter::Pointer counter = AsyncCounter::New(1000);
+    btk::AsyncUpdate::Pointer update;
+    btk::MemoryArena* arena = 0;
+    {
+      btk::MemoryArena::Pointer owner = btk::MemoryArena::New();
+      arena = owner.get();
+      btk::MemoryArena::Scope scope(owner);
+      update = btk::AsyncUpdate::New(counter);
+    }
+    // The arena is not referenced anymore by its owner, but still by the update.
+    TS_ASSERT_EQUALS(arena->GetObjectNumber(), 1);
+    update->Wait();
+    TS_ASSERT_EQUALS(counter->GetOutput()->GetValue(), 1000);
+    update.reset(); // Releases the arena
+  };
+  
+  CXXTEST_TEST(ProgressWithoutUpdate)
+  {
+    TS_ASSERT_THROWS_NOTHING(btk::AsyncUpdate::ReportProgress(0.5));
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AsyncUpdateTest)
+CXXTEST_TEST_REGISTRATION(AsyncUpdateTest, Finished)
+CXXTEST_TEST_REGISTRATION(AsyncUpdateTest, Failed)
+CXXTEST_TEST_REGISTRATION(AsyncUpdateTest, Cancelled)
+CXXTEST_TEST_REGISTRATION(AsyncUpdateTest, Concurrent)
+CXXTEST_TEST_REGISTRATION(AsyncUpdateTest, MemoryArena)
+CXXTEST_TEST_REGISTRATION(AsyncUpdateTest, ProgressWithoutUpdate)
+#endif
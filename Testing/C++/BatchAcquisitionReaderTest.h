@@ -0,0 +1,128 @@
+#ifndef BatchAcquisitionReaderTest_h
+#define BatchAcquisitionReaderTest_h
+
+#include <btkBatchAcquisitionReader.h>
+#include <btkAcquisitionFileWriter.h>
+
+#include <sstream>
+
+static std::string BatchFilename(int i)
+{
+  std::ostringstream oss;
+  oss << BatchFilePathOUT << "batch" << i << ".c3d";
+  return oss.str();
+};
+
+// Writes 6 files with 10, 20, ... 60 frames.
+static std::vector<std::string> WriteBatchFiles()
+{
+  std::vector<std::string> filenames;
+  for (int i = 0 ; i < 6 ; ++i)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 10 * (i + 1), 1, 2);
+    acq->SetPointFrequency(100.0);
+    acq->GetPoint(0)->GetValues().setConstant(static_cast<double>(i));
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(BatchFilename(i));
+    writer->Update();
+    filenames.push_back(BatchFilename(i));
+  }
+  return filenames;
+};
+
+class BatchHandler : public btk::BatchAcquisitionReader::Handler
+{
+public:
+  std::vector<int> indices;
+  std::vector<int> frames;
+  virtual void Process(const btk::BatchAcquisitionReader::Result& result)
+  {
+    this->indices.push_back(result.index);
+    this->frames.push_back(result.IsValid() ? result.acquisition->GetPointFrameNumber() : -1);
+  };
+};
+
+CXXTEST_SUITE(BatchAcquisitionReaderTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::BatchAcquisitionReader::Pointer reader = btk::BatchAcquisitionReader::New(2);
+    TS_ASSERT(reader->GetCapacity() >= 1);
+    TS_ASSERT_EQUALS(reader->GetFilenames().size(), 0u);
+    btk::BatchAcquisitionReader::Result result;
+    TS_ASSERT_EQUALS(reader->Next(&result), false);
+  };
+  
+  CXXTEST_TEST(Order)
+  {
+    std::vector<std::string> filenames = WriteBatchFiles();
+    btk::BatchAcquisitionReader::Pointer reader = btk::BatchAcquisitionReader::New(3);
+    reader->SetCapacity(2);
+    TS_ASSERT_EQUALS(reader->GetCapacity(), 2);
+    reader->SetFilenames(filenames);
+    btk::BatchAcquisitionReader::Result result;
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      TS_ASSERT_EQUALS(reader->Next(&result), true);
+      TS_ASSERT_EQUALS(result.index, i);
+      TS_ASSERT_EQUALS(result.filename, filenames[i]);
+      TS_ASSERT(result.IsValid());
+      TS_ASSERT_EQUALS(result.acquisition->GetPointFrameNumber(), 10 * (i + 1));
+      TS_ASSERT_DELTA(result.acquisition->GetPoint(0)->GetValues().coeff(0,0), static_cast<double>(i), 1e-4);
+    }
+    TS_ASSERT_EQUALS(reader->Next(&result), false);
+    // Restart
+    reader->Rewind();
+    TS_ASSERT_EQUALS(reader->Next(&result), true);
+    TS_ASSERT_EQUALS(result.index, 0);
+  };
+  
+  CXXTEST_TEST(Errors)
+  {
+    std::vector<std::string> filenames = WriteBatchFiles();
+    filenames.insert(filenames.begin() + 2, BatchFilePathOUT + "missing.c3d");
+    btk::BatchAcquisitionReader::Pointer reader = btk::BatchAcquisitionReader::New(2);
+    reader->SetFilenames(filenames);
+    BatchHandler handler;
+    TS_ASSERT_EQUALS(reader->Read(&handler), 1);
+    TS_ASSERT_EQUALS(handler.indices.size(), 7u);
+    for (int i = 0 ; i < 7 ; ++i)
+      TS_ASSERT_EQUALS(handler.indices[i], i);
+    TS_ASSERT_EQUALS(handler.frames[1], 20);
+    TS_ASSERT_EQUALS(handler.frames[2], -1);
+    TS_ASSERT_EQUALS(handler.frames[3], 30);
+    TS_ASSERT_EQUALS(handler.frames[6], 60);
+  };
+  
+  CXXTEST_TEST(Directory)
+  {
+    std::vector<std::string> filenames = WriteBatchFiles();
+    btk::BatchAcquisitionReader::Pointer reader = btk::BatchAcquisitionReader::New(2);
+    TS_ASSERT_EQUALS(reader->AddDirectory(BatchFilePathOUT, "C3D"), 6);
+    TS_ASSERT_EQUALS(reader->AddDirectory(BatchFilePathOUT, ".trc"), 0);
+    TS_ASSERT_EQUALS(reader->GetFilenames().size(), 6u);
+    for (size_t i = 0 ; i < reader->GetFilenames().size() ; ++i)
+      TS_ASSERT_EQUALS(reader->GetFilenames()[i], filenames[i]);
+    reader->SetStoragePrecision(btk::Acquisition::SinglePrecision);
+    btk::BatchAcquisitionReader::Result result;
+    int num = 0;
+    while (reader->Next(&result))
+    {
+      TS_ASSERT(result.IsValid());
+      TS_ASSERT_EQUALS(result.acquisition->GetStoragePrecision(), btk::Acquisition::SinglePrecision);
+      ++num;
+    }
+    TS_ASSERT_EQUALS(num, 6);
+    reader->ClearFilenames();
+    TS_ASSERT_EQUALS(reader->Next(&result), false);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(BatchAcquisitionReaderTest)
+CXXTEST_TEST_REGISTRATION(BatchAcquisitionReaderTest, Constructor)
+CXXTEST_TEST_REGISTRATION(BatchAcquisitionReaderTest, Order)
+CXXTEST_TEST_REGISTRATION(BatchAcquisitionReaderTest, Errors)
+CXXTEST_TEST_REGISTRATION(BatchAcquisitionReaderTest, Directory)
+#endif
@@ -0,0 +1,219 @@
+#ifndef ButterworthFilterTest_h
+#define ButterworthFilterTest_h
+
+#include <btkButterworthFilter.h>
+#include <btkAnalogBlock.h>
+#include <btkConvert.h>
+
+#include <btkEigen/SignalProcessing/SOSFilter.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+
+#include <cmath>
+
+CXXTEST_SUITE(ButterworthFilterTest)
+{
+  CXXTEST_TEST(AnalogCollection)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 7 ; ++i)
+    {
+      btk::Analog::Pointer analog = btk::Analog::New("A" + btk::ToString(i), 500);
+      for (int j = 0 ; j < 500 ; ++j)
+        analog->GetValues()(j) = std::sin(2.0 * M_PI * 3.0 * j / 1000.0) + static_cast<double>(i) * std::sin(2.0 * M_PI * 200.0 * j / 1000.0);
+      analogs->InsertItem(analog);
+    }
+    analogs->GetItem(6)->SetFrameNumber(5); // Too short to be filtered
+    analogs->GetItem(2)->SetUnit("Nm");
+    
+    btk::ButterworthFilter<btk::AnalogCollection>::Pointer bf = btk::ButterworthFilter<btk::AnalogCollection>::New();
+    bf->SetInput(analogs);
+    bf->SetSamplingFrequency(1000.0);
+    bf->SetCutoffFrequency(20.0);
+    bf->SetOrder(4);
+    bf->Update();
+    btk::AnalogCollection::Pointer output = bf->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 7);
+    TS_ASSERT_EQUALS(output->GetItem(2)->GetLabel(), "A2");
+    TS_ASSERT_EQUALS(output->GetItem(2)->GetUnit(), "Nm");
+    
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 4, 0.04);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,1> ref = btkEigen::sosfiltfilt(sos, analogs->GetItem(i)->GetValues());
+      for (int j = 0 ; j < 500 ; ++j)
+        TS_ASSERT_DELTA(output->GetItem(i)->GetValues()(j), ref(j), 1e-12);
+      // The high frequency component is removed
+      TS_ASSERT_DELTA(output->GetItem(i)->GetValues()(250), std::sin(2.0 * M_PI * 3.0 * 250 / 1000.0), 1e-2);
+    }
+    TS_ASSERT_EQUALS(output->GetItem(6)->GetFrameNumber(), 5);
+    for (int j = 0 ; j < 5 ; ++j)
+      TS_ASSERT_EQUALS(output->GetItem(6)->GetValues()(j), analogs->GetItem(6)->GetValues()(j));
+    // The input is not modified
+    TS_ASSERT_DELTA(analogs->GetItem(5)->GetValues()(1), std::sin(2.0 * M_PI * 3.0 / 1000.0) + 5.0 * std::sin(2.0 * M_PI * 200.0 / 1000.0), 1e-15);
+    
+    // Same results with several threads
+    btk::ButterworthFilter<btk::AnalogCollection>::Pointer bf2 = btk::ButterworthFilter<btk::AnalogCollection>::New();
+    bf2->SetInput(analogs);
+    bf2->SetSamplingFrequency(1000.0);
+    bf2->SetCutoffFrequency(20.0);
+    bf2->SetOrder(4);
+    bf2->SetThreadNumber(4);
+    bf2->Update();
+    for (int i = 0 ; i < 7 ; ++i)
+    {
+      for (int j = 0 ; j < output->GetItem(i)->GetFrameNumber() ; ++j)
+        TS_ASSERT_EQUALS(bf2->GetOutput()->GetItem(i)->GetValues()(j), output->GetItem(i)->GetValues()(j));
+    }
+    
+    bf->SetCutoffFrequency(500.0);
+    bf->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(PointCollectionWithGap)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk::Point::Pointer point = btk::Point::New("P1", 100);
+    for (int j = 0 ; j < 100 ; ++j)
+      point->GetValues().row(j) << 10.0, 20.0 + std::cos(2.0 * M_PI * 40.0 * j / 100.0), -5.0;
+    point->GetResiduals().setZero();
+    for (int j = 40 ; j < 50 ; ++j)
+    {
+      point->GetValues().row(j).setZero();
+      point->GetResiduals()(j) = -1.0;
+    }
+    points->InsertItem(point);
+    
+    btk::ButterworthFilter<btk::PointCollection>::Pointer bf = btk::ButterworthFilter<btk::PointCollection>::New();
+    bf->SetInput(points);
+    bf->SetSamplingFrequency(100.0);
+    bf->SetCutoffFrequency(6.0);
+    bf->Update();
+    btk::Point::Pointer output = bf->GetOutput()->GetItem(0);
+    TS_ASSERT_EQUALS(output->GetLabel(), "P1");
+    TS_ASSERT_EQUALS(output->GetFrameNumber(), 100);
+    for (int j = 0 ; j < 100 ; ++j)
+    {
+      if ((j >= 40) && (j < 50))
+      {
+        TS_ASSERT_EQUALS(output->GetResiduals()(j), -1.0);
+        TS_ASSERT_EQUALS(output->GetValues()(j,0), 0.0);
+      }
+      else
+      {
+        // The invalid frames are not used by the filter.
+        TS_ASSERT_EQUALS(output->GetResiduals()(j), 0.0);
+        TS_ASSERT_DELTA(output->GetValues()(j,0), 10.0, 1e-10);
+        if (((j >= 15) && (j <= 25)) || ((j >= 65) && (j <= 85))) // Transient response at the boundaries of each block
+          TS_ASSERT_DELTA(output->GetValues()(j,1), 20.0, 5e-2);
+        TS_ASSERT_DELTA(output->GetValues()(j,2), -5.0, 1e-10);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(AnalogCollection_RowMajorBlock)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      btk::Analog::Pointer analog = btk::Analog::New("A" + btk::ToString(i), 200);
+      for (int j = 0 ; j < 200 ; ++j)
+        analog->GetValues()(j) = std::sin(2.0 * M_PI * (i + 1.0) * j / 100.0) + std::cos(2.0 * M_PI * 40.0 * j / 100.0);
+      analogs->InsertItem(analog);
+    }
+    btk::ButterworthFilter<btk::AnalogCollection>::Pointer bf = btk::ButterworthFilter<btk::AnalogCollection>::New();
+    bf->SetInput(analogs);
+    bf->SetSamplingFrequency(100.0);
+    bf->SetCutoffFrequency(10.0);
+    bf->Update();
+    btk::AnalogCollection::Pointer ref = bf->GetOutput()->Clone();
+    // Same result when the input values are interleaved
+    btk::AnalogBlock::Pack(analogs, btk::AnalogBlock::RowMajor);
+    TS_ASSERT(analogs->GetItem(1)->GetValues().innerStride() == 3);
+    bf = btk::ButterworthFilter<btk::AnalogCollection>::New();
+    bf->SetInput(analogs);
+    bf->SetSamplingFrequency(100.0);
+    bf->SetCutoffFrequency(10.0);
+    bf->Update();
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 200 ; ++j)
+        TS_ASSERT_EQUALS(bf->GetOutput()->GetItem(i)->GetValues()(j), ref->GetItem(i)->GetValues()(j));
+    }
+  };
+  
+  CXXTEST_TEST(Acquisition)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 100, 3, 10);
+    acq->SetPointFrequency(100.0);
+    acq->SetFirstFrame(11);
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      acq->GetPoint(i)->GetValues().setConstant(static_cast<double>(i + 1));
+      acq->GetPoint(i)->GetResiduals().setZero();
+    }
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 1000 ; ++j)
+        acq->GetAnalog(i)->GetValues()(j) = static_cast<double>(i) + std::sin(2.0 * M_PI * 300.0 * j / 1000.0);
+    }
+    acq->AppendEvent(btk::Event::New("Foot Strike", 31, "Left"));
+    
+    btk::ButterworthFilter<btk::Acquisition>::Pointer bf = btk::ButterworthFilter<btk::Acquisition>::New();
+    bf->SetInput(acq);
+    bf->SetCutoffFrequency(10.0);
+    bf->Update();
+    btk::Acquisition::Pointer output = bf->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 100);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(output->GetNumberAnalogSamplePerFrame(), 10);
+    TS_ASSERT_EQUALS(output->GetFirstFrame(), 11);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(output->GetEventNumber(), 1);
+    TS_ASSERT_DELTA(output->GetPoint(1)->GetValues()(50,1), 2.0, 1e-10);
+    for (int j = 200 ; j < 800 ; ++j) // Transient response at the boundaries
+      TS_ASSERT_DELTA(output->GetAnalog(2)->GetValues()(j), 2.0, 1e-3);
+    // The input is not modified
+    TS_ASSERT_DELTA(acq->GetAnalog(0)->GetValues()(1), std::sin(2.0 * M_PI * 300.0 / 1000.0), 1e-15);
+    
+    // The cutoff frequency is too high for the points.
+    bf->SetCutoffFrequency(60.0);
+    bf->Update();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 0);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 0);
+  };
+  
+  CXXTEST_TEST(AnalogCollection_HighOrder)
+  {
+    // The coefficients of the transfer function are not accurate enough for such a filter.
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    btk::Analog::Pointer analog = btk::Analog::New("A", 1000);
+    for (int j = 0 ; j < 1000 ; ++j)
+      analog->GetValues()(j) = 1.0 + std::sin(2.0 * M_PI * 200.0 * j / 1000.0);
+    analogs->InsertItem(analog);
+    
+    btk::ButterworthFilter<btk::AnalogCollection>::Pointer bf = btk::ButterworthFilter<btk::AnalogCollection>::New();
+    bf->SetInput(analogs);
+    bf->SetSamplingFrequency(1000.0);
+    bf->SetCutoffFrequency(10.0);
+    bf->SetOrder(10);
+    bf->Update();
+    btk::AnalogCollection::Pointer output = bf->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+    TS_ASSERT(output->GetItem(0)->GetValues().cwiseAbs().maxCoeff() < 1.5);
+    for (int j = 200 ; j < 800 ; ++j) // Transient response at the boundaries
+      TS_ASSERT_DELTA(output->GetItem(0)->GetValues()(j), 1.0, 1e-3);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ButterworthFilterTest)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, AnalogCollection)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, PointCollectionWithGap)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, AnalogCollection_RowMajorBlock)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, Acquisition)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, AnalogCollection_HighOrder)
+#endif
@@ -2,8 +2,13 @@
 #define C3DFileReaderTest_h
 
 #include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
 #include <btkC3DFileIO.h>
 
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
 CXXTEST_SUITE(C3DFileReaderTest)
 {
   CXXTEST_TEST(NoFile)
@@ -653,6 +658,99 @@ CXXTEST_SUITE(C3DFileReaderTest)
     TS_ASSERT_EQUALS(acq->GetPoint(0)->GetLabel(), "AbcdeFghijk:RASI");
     TS_ASSERT_EQUALS(acq->GetPoint(26)->GetLabel(), "AbcdeFghijk:LFIN");
 #endif
+  };  
+  CXXTEST_TEST(RequestedRegion)
+  {
+    const char* files[] = {"sample01/Eb015pi.c3d", "sample01/Eb015pr.c3d"};
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::AcquisitionFileReader::Pointer reference = btk::AcquisitionFileReader::New();
+      reference->SetFilename(C3DFilePathIN + files[i]);
+      reference->Update();
+      btk::Acquisition::Pointer acq0 = reference->GetOutput();
+      
+      btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+      reader->SetFilename(C3DFilePathIN + files[i]);
+      reader->GetOutput()->SetRequestedRegion(acq0->GetFirstFrame() + 100, acq0->GetFirstFrame() + 149);
+      reader->Update();
+      btk::Acquisition::Pointer acq = reader->GetOutput();
+      
+      TS_ASSERT_EQUALS(acq->GetFirstFrame(), acq0->GetFirstFrame() + 100);
+      TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), 50);
+      TS_ASSERT_EQUALS(acq->GetAnalogFrameNumber(), 50 * acq0->GetNumberAnalogSamplePerFrame());
+      TS_ASSERT_EQUALS(acq->GetPointNumber(), acq0->GetPointNumber());
+      TS_ASSERT_EQUALS(acq->GetAnalogNumber(), acq0->GetAnalogNumber());
+      TS_ASSERT_EQUALS(acq->GetEventNumber(), acq0->GetEventNumber());
+      for (int j = 0 ; j < acq->GetPointNumber() ; ++j)
+      {
+        TS_ASSERT(acq->GetPoint(j)->GetValues().isApprox(acq0->GetPoint(j)->GetValues().block(100,0,50,3)));
+        TS_ASSERT(acq->GetPoint(j)->GetResiduals() == acq0->GetPoint(j)->GetResiduals().segment(100,50));
+      }
+      const int n = acq0->GetNumberAnalogSamplePerFrame();
+      for (int j = 0 ; j < acq->GetAnalogNumber() ; ++j)
+        TS_ASSERT(acq->GetAnalog(j)->GetValues().isApprox(acq0->GetAnalog(j)->GetValues().segment(100 * n, 50 * n)));
+      
+      // Region partially outside of the file
+      reader->GetOutput()->SetRequestedRegion(acq0->GetLastFrame() - 9, acq0->GetLastFrame() + 100);
+      reader->Update();
+      TS_ASSERT_EQUALS(acq->GetFirstFrame(), acq0->GetLastFrame() - 9);
+      TS_ASSERT_EQUALS(acq->GetLastFrame(), acq0->GetLastFrame());
+      TS_ASSERT(acq->GetPoint(0)->GetValues().isApprox(acq0->GetPoint(0)->GetValues().bottomRows(10)));
+    }
+  };
+  
+  CXXTEST_TEST(RawPrecisionNullScale)
+  {
+    btk::Acquisition::Pointer acq0 = btk::Acquisition::New();
+    acq0->Init(1, 20, 3, 2);
+    acq0->SetPointFrequency(100.0);
+    acq0->GetPoint(0)->GetValues().setConstant(100.0);
+    acq0->GetPoint(0)->GetResiduals().setZero();
+    const double scales[3] = {0.5, 0.3125, 0.25};
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      acq0->GetAnalog(i)->SetScale(scales[i]);
+      for (int j = 0 ; j < 40 ; ++j)
+        acq0->GetAnalog(i)->GetValues().coeffRef(j) = static_cast<double>(j - 20) * scales[i];
+    }
+    btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+    io->SetStorageFormat(btk::C3DFileIO::Integer);
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetAcquisitionIO(io);
+    writer->SetInput(acq0);
+    writer->SetFilename(C3DFilePathOUT + "RawPrecisionNullScale.c3d");
+    writer->Update();
+    // The scale of the second channel (ANALOG:SCALE stored in floats) is set to 0 in the file.
+    std::ifstream ifs((C3DFilePathOUT + "RawPrecisionNullScale.c3d").c_str(), std::ios_base::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    const float scale = 0.3125f, zero = 0.0f;
+    const char* pattern = reinterpret_cast<const char*>(&scale);
+    std::vector<char>::iterator it = std::search(content.begin() + 512, content.end(), pattern, pattern + 4);
+    TS_ASSERT(it != content.end());
+    std::copy(reinterpret_cast<const char*>(&zero), reinterpret_cast<const char*>(&zero) + 4, it);
+    std::ofstream ofs((C3DFilePathOUT + "RawPrecisionNullScale.c3d").c_str(), std::ios_base::binary);
+    ofs.write(&(content[0]), content.size());
+    ofs.close();
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathOUT + "RawPrecisionNullScale.c3d");
+    reader->GetOutput()->SetStoragePrecision(btk::Acquisition::RawPrecision);
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(acq->GetAnalogFrameNumber(), 40);
+    TS_ASSERT(acq->GetAnalog(0)->GetData()->IsRaw());
+    TS_ASSERT(!acq->GetAnalog(1)->GetData()->IsRaw());
+    TS_ASSERT(acq->GetAnalog(1)->GetData()->IsSinglePrecision());
+    TS_ASSERT(acq->GetAnalog(2)->GetData()->IsRaw());
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetValues().rows(), 40);
+    TS_ASSERT(acq->GetAnalog(1)->GetValues().isZero());
+    for (int j = 0 ; j < 40 ; ++j)
+    {
+      TS_ASSERT_DELTA(acq->GetAnalog(0)->GetValues().coeff(j), acq0->GetAnalog(0)->GetValues().coeff(j), 1e-10);
+      TS_ASSERT_DELTA(acq->GetAnalog(2)->GetValues().coeff(j), acq0->GetAnalog(2)->GetValues().coeff(j), 1e-10);
+    }
   };
 };
 
@@ -691,5 +789,7 @@ CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Sample28_type1)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, ParameterOverflow)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, Mocap36)
 CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, BadParameterOffset)
-CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, UTF8)  
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, UTF8)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, RequestedRegion)
+CXXTEST_TEST_REGISTRATION(C3DFileReaderTest, RawPrecisionNullScale)
 #endif
@@ -5,6 +5,7 @@
 #include <btkAcquisitionFileWriter.h>
 #include <btkC3DFileIO.h>
 #include <btkConvert.h>
+#include <btkAsyncUpdate.h>
 
 CXXTEST_SUITE(C3DFileWriterTest)
 {
@@ -1864,6 +1865,74 @@ CXXTEST_SUITE(C3DFileWriterTest)
     
     TS_ASSERT(acq->GetAnalog(0)->GetValues().cwiseAbs().maxCoeff() <= 1e-5);
   };
+  CXXTEST_TEST(AsyncUpdate)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(5, 2000, 4, 2);
+    for (btk::Acquisition::PointIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+      (*it)->GetValues().setConstant(10.0);
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(C3DFilePathOUT + "asyncUpdate.c3d");
+    btk::AsyncUpdate::Pointer update = btk::AsyncUpdate::New(writer);
+    update->Wait();
+    TS_ASSERT_EQUALS(update->GetState(), btk::AsyncUpdate::Finished);
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathOUT + "asyncUpdate.c3d");
+    update = btk::AsyncUpdate::New(reader);
+    update->Wait();
+    TS_ASSERT_EQUALS(update->GetState(), btk::AsyncUpdate::Finished);
+    TS_ASSERT_EQUALS(update->GetProgress(), 1.0);
+    TS_ASSERT_EQUALS(reader->GetOutput()->GetPointFrameNumber(), 2000);
+    TS_ASSERT_EQUALS(reader->GetOutput()->GetAnalogNumber(), 4);
+    TS_ASSERT_DELTA(reader->GetOutput()->GetPoint(4)->GetValues().coeff(1999,2), 10.0, 1e-4);
+    
+    // Cancelled before or during the reading: the reader is updated again the next time.
+    // The reading can also be finished before the cancellation (the thread of the pool can start it immediately).
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(C3DFilePathOUT + "asyncUpdate.c3d");
+    update = btk::AsyncUpdate::New(reader2);
+    update->Cancel();
+    update->Wait();
+    TS_ASSERT((update->GetState() == btk::AsyncUpdate::Cancelled) || (update->GetState() == btk::AsyncUpdate::Finished));
+    reader2->Update();
+    TS_ASSERT_EQUALS(reader2->GetOutput()->GetPointFrameNumber(), 2000);
+    
+    // Failure
+    reader->SetFilename(C3DFilePathOUT + "asyncUpdate_missing.c3d");
+    update = btk::AsyncUpdate::New(reader);
+    TS_ASSERT_THROWS(update->Wait(), const btk::RuntimeError &e);
+    TS_ASSERT_EQUALS(update->GetState(), btk::AsyncUpdate::Failed);
+  };
+  CXXTEST_TEST(MemoryUsageEstimate)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(5, 200, 4, 2);
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(C3DFilePathOUT + "memoryUsageEstimate.c3d");
+    writer->Update();
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathOUT + "memoryUsageEstimate.c3d");
+    btk::MemoryUsage estimate;
+    TS_ASSERT_EQUALS(reader->EstimateMemoryUsage(&estimate), true);
+    reader->Update();
+    btk::MemoryUsage actual = reader->GetOutput()->GetMemoryUsage();
+    TS_ASSERT_EQUALS(estimate.Get(btk::MemoryUsage::Values), actual.Get(btk::MemoryUsage::Values));
+    TS_ASSERT_EQUALS(estimate.Get(btk::MemoryUsage::Residuals), actual.Get(btk::MemoryUsage::Residuals));
+    TS_ASSERT(estimate.GetTotal() > actual.GetTotal() * 3 / 4);
+    TS_ASSERT(estimate.GetTotal() < actual.GetTotal() * 5 / 4);
+    
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(C3DFilePathOUT + "memoryUsageEstimate.c3d");
+    reader2->GetOutput()->SetStoragePrecision(btk::Acquisition::SinglePrecision);
+    reader2->GetOutput()->SetRequestedRegion(11, 60);
+    estimate.Clear();
+    TS_ASSERT_EQUALS(reader2->EstimateMemoryUsage(&estimate), true);
+    TS_ASSERT_EQUALS(estimate.Get(btk::MemoryUsage::Values), (5 * 50 * 3 + 4 * 100) * sizeof(float));
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(C3DFileWriterTest)
@@ -1909,4 +1978,6 @@ CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, InternalsUpdateUpdateMetaDataBased)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, InternalsUpdateUpdateMetaDataBased_EventsHeader)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AnalogOffsetStoredAsReal_12Bits)
 CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AnalogOffsetStoredAsReal_16Bits)
+CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, AsyncUpdate)
+CXXTEST_TEST_REGISTRATION(C3DFileWriterTest, MemoryUsageEstimate)
 #endif
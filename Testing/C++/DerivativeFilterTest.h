@@ -0,0 +1,205 @@
+#ifndef DerivativeFilterTest_h
+#define DerivativeFilterTest_h
+
+#include <btkDerivativeFilter.h>
+#include <btkButterworthFilter.h>
+#include <btkAnalogBlock.h>
+#include <btkConvert.h>
+
+#include <cmath>
+
+CXXTEST_SUITE(DerivativeFilterTest)
+{
+  CXXTEST_TEST(AnalogCollection_CentralDifference)
+  {
+    // The central differences are exact for a quadratic signal
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    btk::Analog::Pointer analog = btk::Analog::New("A1", 100);
+    analog->SetUnit("V");
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      const double t = static_cast<double>(i) / 100.0;
+      analog->GetValues()(i) = 3.0 * t * t + 2.0 * t + 1.0;
+    }
+    analogs->InsertItem(analog);
+    
+    btk::DerivativeFilter<btk::AnalogCollection>::Pointer df = btk::DerivativeFilter<btk::AnalogCollection>::New();
+    TS_ASSERT_EQUALS(df->GetMethod(), btk::DerivativeFilter<btk::AnalogCollection>::CentralDifference);
+    TS_ASSERT_EQUALS(df->GetDerivativeOrder(), 1);
+    df->SetInput(analogs);
+    df->SetSamplingFrequency(100.0);
+    df->Update();
+    btk::AnalogCollection::Pointer output = df->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "A1");
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetUnit(), "V/s");
+    for (int i = 0 ; i < 100 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), output->GetItem(0)->GetValues()(i), 6.0 * static_cast<double>(i) / 100.0 + 2.0, 1e-9);
+    
+    df->SetDerivativeOrder(2);
+    df->Update();
+    output = df->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetUnit(), "V/s^2");
+    for (int i = 0 ; i < 100 ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), output->GetItem(0)->GetValues()(i), 6.0, 1e-6);
+  };
+  
+  CXXTEST_TEST(AnalogCollection_SavitzkyGolay)
+  {
+    // A cubic polynomial is fitted exactly with a polynomial of order 3 (boundaries included)
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      btk::Analog::Pointer analog = btk::Analog::New("A" + btk::ToString(j), 50);
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        const double t = static_cast<double>(i) / 50.0;
+        analog->GetValues()(i) = (j + 1.0) * t * t * t - t * t + 0.5;
+      }
+      analogs->InsertItem(analog);
+    }
+    btk::AnalogBlock::Pack(analogs, btk::AnalogBlock::RowMajor);
+    
+    btk::DerivativeFilter<btk::AnalogCollection>::Pointer df = btk::DerivativeFilter<btk::AnalogCollection>::New();
+    df->SetInput(analogs);
+    df->SetMethod(btk::DerivativeFilter<btk::AnalogCollection>::SavitzkyGolay);
+    df->SetSamplingFrequency(50.0);
+    df->SetWindowSize(7);
+    df->SetPolynomialOrder(3);
+    df->Update();
+    btk::AnalogCollection::Pointer output = df->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 3);
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        const double t = static_cast<double>(i) / 50.0;
+        TSM_ASSERT_DELTA("Channel #" + btk::ToString(j) + ", sample #" + btk::ToString(i), output->GetItem(j)->GetValues()(i), 3.0 * (j + 1.0) * t * t - 2.0 * t, 1e-9);
+      }
+    }
+    df->SetDerivativeOrder(2);
+    df->Update();
+    output = df->GetOutput();
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      for (int i = 0 ; i < 50 ; ++i)
+      {
+        const double t = static_cast<double>(i) / 50.0;
+        TSM_ASSERT_DELTA("Channel #" + btk::ToString(j) + ", sample #" + btk::ToString(i), output->GetItem(j)->GetValues()(i), 6.0 * (j + 1.0) * t - 2.0, 1e-7);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(AnalogCollection_Butterworth)
+  {
+    // Same result than the central differences of the output of the Butterworth filter
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int j = 0 ; j < 6 ; ++j)
+    {
+      btk::Analog::Pointer analog = btk::Analog::New("A" + btk::ToString(j), 300);
+      for (int i = 0 ; i < 300 ; ++i)
+        analog->GetValues()(i) = std::sin(2.0 * M_PI * 2.0 * i / 100.0 + j) + 0.1 * std::sin(2.0 * M_PI * 35.0 * i / 100.0);
+      analogs->InsertItem(analog);
+    }
+    btk::ButterworthFilter<btk::AnalogCollection>::Pointer bf = btk::ButterworthFilter<btk::AnalogCollection>::New();
+    bf->SetInput(analogs);
+    bf->SetSamplingFrequency(100.0);
+    bf->SetCutoffFrequency(8.0);
+    bf->SetOrder(2);
+    bf->Update();
+    
+    btk::DerivativeFilter<btk::AnalogCollection>::Pointer df = btk::DerivativeFilter<btk::AnalogCollection>::New();
+    df->SetInput(analogs);
+    df->SetMethod(btk::DerivativeFilter<btk::AnalogCollection>::Butterworth);
+    df->SetSamplingFrequency(100.0);
+    df->SetCutoffFrequency(8.0);
+    df->SetThreadNumber(2);
+    df->Update();
+    btk::AnalogCollection::Pointer output = df->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 6);
+    for (int j = 0 ; j < 6 ; ++j)
+    {
+      const btk::Analog::Values& y = bf->GetOutput()->GetItem(j)->GetValues();
+      for (int i = 1 ; i < 299 ; ++i)
+        TS_ASSERT_DELTA(output->GetItem(j)->GetValues()(i), (y(i+1) - y(i-1)) * 50.0, 1e-10);
+      // The high frequency component is removed
+      TS_ASSERT_DELTA(output->GetItem(j)->GetValues()(150), 2.0 * M_PI * 2.0 * std::cos(2.0 * M_PI * 2.0 * 150 / 100.0 + j), 0.5);
+    }
+  };
+  
+  CXXTEST_TEST(PointCollectionWithGap)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk::Point::Pointer point = btk::Point::New("uname*1", 60);
+    for (int i = 0 ; i < 60 ; ++i)
+    {
+      point->GetValues().row(i) << 2.0 * i, -1.0 * i, 0.5 * i * i;
+      point->GetResiduals()(i) = 1.0;
+    }
+    for (int i = 20 ; i < 25 ; ++i)
+      point->GetResiduals()(i) = -1.0;
+    for (int i = 27 ; i < 30 ; ++i) // Block of 2 frames: too short
+      point->GetResiduals()(i) = -1.0;
+    points->InsertItem(point);
+    
+    btk::DerivativeFilter<btk::PointCollection>::Pointer df = btk::DerivativeFilter<btk::PointCollection>::New();
+    df->SetInput(points);
+    df->SetSamplingFrequency(10.0);
+    df->Update();
+    btk::PointCollection::Pointer output = df->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+    btk::Point::Pointer velocity = output->GetItem(0);
+    TS_ASSERT_EQUALS(velocity->GetLabel(), "uname*1");
+    TS_ASSERT_EQUALS(velocity->GetType(), btk::Point::Scalar);
+    TS_ASSERT_EQUALS(velocity->GetFrameNumber(), 60);
+    for (int i = 0 ; i < 60 ; ++i)
+    {
+      if (((i >= 20) && (i < 30)))
+      {
+        TS_ASSERT_EQUALS(velocity->GetResiduals()(i), -1.0);
+        TS_ASSERT_EQUALS(velocity->GetValues()(i,0), 0.0);
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(velocity->GetResiduals()(i), 0.0);
+        TS_ASSERT_DELTA(velocity->GetValues()(i,0), 20.0, 1e-10);
+        TS_ASSERT_DELTA(velocity->GetValues()(i,1), -10.0, 1e-10);
+        TS_ASSERT_DELTA(velocity->GetValues()(i,2), 10.0 * i, 1e-9);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(WrongParameters)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    analogs->InsertItem(btk::Analog::New("A1", 100));
+    btk::DerivativeFilter<btk::AnalogCollection>::Pointer df = btk::DerivativeFilter<btk::AnalogCollection>::New();
+    df->SetInput(analogs);
+    df->Update(); // No sampling frequency
+    TS_ASSERT_EQUALS(df->GetOutput()->GetItemNumber(), 0);
+    df->SetSamplingFrequency(100.0);
+    df->SetDerivativeOrder(3);
+    df->Update();
+    TS_ASSERT_EQUALS(df->GetOutput()->GetItemNumber(), 0);
+    df->SetDerivativeOrder(2);
+    df->SetMethod(btk::DerivativeFilter<btk::AnalogCollection>::SavitzkyGolay);
+    df->SetWindowSize(4);
+    df->Update();
+    TS_ASSERT_EQUALS(df->GetOutput()->GetItemNumber(), 0);
+    df->SetWindowSize(5);
+    df->SetPolynomialOrder(1);
+    df->Update();
+    TS_ASSERT_EQUALS(df->GetOutput()->GetItemNumber(), 0);
+    df->SetPolynomialOrder(2);
+    df->Update();
+    TS_ASSERT_EQUALS(df->GetOutput()->GetItemNumber(), 1);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(DerivativeFilterTest)
+CXXTEST_TEST_REGISTRATION(DerivativeFilterTest, AnalogCollection_CentralDifference)
+CXXTEST_TEST_REGISTRATION(DerivativeFilterTest, AnalogCollection_SavitzkyGolay)
+CXXTEST_TEST_REGISTRATION(DerivativeFilterTest, AnalogCollection_Butterworth)
+CXXTEST_TEST_REGISTRATION(DerivativeFilterTest, PointCollectionWithGap)
+CXXTEST_TEST_REGISTRATION(DerivativeFilterTest, WrongParameters)
+#endif
@@ -4,6 +4,8 @@
 #include <btkDownsampleFilter.h>
 #include <btkConvert.h>
 
+#include <cmath>
+
 CXXTEST_SUITE(DownsampleFilterTest)
 {
   CXXTEST_TEST(WrenchRatioOne)
@@ -121,6 +123,153 @@ CXXTEST_SUITE(DownsampleFilterTest)
       }
     }
   };
+  
+  CXXTEST_TEST(AnalogCollectionAntiAliasing)
+  {
+    // 5 Hz sine with a 430 Hz component sampled at 1000 Hz and downsampled at 100 Hz.
+    btk::AnalogCollection::Pointer ac = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::Analog::Pointer a = btk::Analog::New("Test" + btk::ToString(i), 1000);
+      a->SetUnit("N");
+      for (int j = 0 ; j < 1000 ; ++j)
+        a->GetValues()(j) = std::sin(2.0 * M_PI * 5.0 * j / 1000.0) + static_cast<double>(i) * 0.5 * std::sin(2.0 * M_PI * 430.0 * j / 1000.0);
+      ac->InsertItem(a);
+    }
+    btk::DownsampleFilter<btk::AnalogCollection>::Pointer ds = btk::DownsampleFilter<btk::AnalogCollection>::New();
+    ds->SetInput(ac);
+    ds->SetUpDownRatio(10);
+    ds->SetAntiAliasing(true);
+    ds->Update();
+    btk::AnalogCollection::Pointer output = ds->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetLabel(), "Test1");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetUnit(), "N");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrameNumber(), 100);
+    for (int j = 10 ; j < 90 ; ++j)
+      TS_ASSERT_DELTA(output->GetItem(1)->GetValues()(j), output->GetItem(0)->GetValues()(j), 1e-3);
+    // Without anti-aliasing, the 430 Hz component becomes a 30 Hz component.
+    ds->SetAntiAliasing(false);
+    ds->Update();
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetValues()(1), ac->GetItem(1)->GetValues()(10));
+    TS_ASSERT(std::fabs(output->GetItem(1)->GetValues()(1) - output->GetItem(0)->GetValues()(1)) > 0.1);
+  };
+  
+  CXXTEST_TEST(PointCollectionWithGap)
+  {
+    btk::PointCollection::Pointer pc = btk::PointCollection::New();
+    btk::Point::Pointer p = btk::Point::New("Marker", 200, btk::Point::Marker, "Desc");
+    for (int j = 0 ; j < 200 ; ++j)
+    {
+      p->GetValues().row(j) << 2.0 * j, -1.0 * j + 5.0, 100.0;
+      p->GetResiduals()(j) = 0.5;
+    }
+    // Gap (frames 100 to 119)
+    for (int j = 100 ; j < 120 ; ++j)
+    {
+      p->GetValues().row(j).setZero();
+      p->GetResiduals()(j) = -1.0;
+    }
+    pc->InsertItem(p);
+    btk::DownsampleFilter<btk::PointCollection>::Pointer ds = btk::DownsampleFilter<btk::PointCollection>::New();
+    ds->SetInput(pc);
+    ds->SetUpDownRatio(4);
+    ds->SetAntiAliasing(true);
+    ds->Update();
+    btk::Point::Pointer out = ds->GetOutput()->GetItem(0);
+    TS_ASSERT_EQUALS(out->GetLabel(), "Marker");
+    TS_ASSERT_EQUALS(out->GetDescription(), "Desc");
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 50);
+    for (int j = 0 ; j < 50 ; ++j)
+    {
+      if ((j >= 25) && (j < 30))
+      {
+        TS_ASSERT_EQUALS(out->GetResiduals()(j), -1.0);
+        TS_ASSERT_EQUALS(out->GetValues()(j,0), 0.0);
+        continue;
+      }
+      TS_ASSERT_EQUALS(out->GetResiduals()(j), 0.5);
+      // Far from the boundaries and the gap, a linear trajectory is not modified. Close to them, the invalid frames are not used.
+      const double tol = ((j >= 10) && (j < 15)) ? 1e-10 : 4.0;
+      TS_ASSERT_DELTA(out->GetValues()(j,0), 2.0 * 4 * j, tol);
+      TS_ASSERT_DELTA(out->GetValues()(j,1), -1.0 * 4 * j + 5.0, tol);
+      TS_ASSERT_DELTA(out->GetValues()(j,2), 100.0, 1e-10);
+    }
+  };
+  
+  CXXTEST_TEST(WrenchCollectionReferenceAcquisition)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 10, 1, 4);
+    btk::WrenchCollection::Pointer wc = btk::WrenchCollection::New();
+    btk::Wrench::Pointer w = btk::Wrench::New("Test", 40);
+    w->GetForce()->GetValues().setConstant(10.0);
+    wc->InsertItem(w);
+    btk::DownsampleFilter<btk::WrenchCollection>::Pointer ds = btk::DownsampleFilter<btk::WrenchCollection>::New();
+    ds->SetInput(wc);
+    ds->SetReferenceAcquisition(acq);
+    ds->SetUpDownRatio(0);
+    ds->Update();
+    TS_ASSERT_EQUALS(ds->GetOutput()->GetItem(0)->GetForce()->GetFrameNumber(), 10);
+    TS_ASSERT_DELTA(ds->GetOutput()->GetItem(0)->GetForce()->GetValues()(5,2), 10.0, 1e-12);
+    acq->Resize(0, 10, 1, 8);
+    ds->Update();
+    TS_ASSERT_EQUALS(ds->GetOutput()->GetItem(0)->GetForce()->GetFrameNumber(), 5);
+  };
+  
+  CXXTEST_TEST(Acquisition)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 50, 3, 10);
+    acq->SetPointFrequency(100.0);
+    acq->SetFirstFrame(11);
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      acq->GetPoint(i)->GetValues().setConstant(static_cast<double>(i + 1));
+      acq->GetPoint(i)->GetResiduals().setZero();
+    }
+    for (int i = 0 ; i < 3 ; ++i)
+      acq->GetAnalog(i)->GetValues().setConstant(static_cast<double>(-i));
+    acq->AppendEvent(btk::Event::New("Foot Strike", 31, "Left"));
+    
+    btk::DownsampleFilter<btk::Acquisition>::Pointer ds = btk::DownsampleFilter<btk::Acquisition>::New();
+    ds->SetInput(acq);
+    ds->SetUpDownRatio(0);
+    ds->Update();
+    btk::Acquisition::Pointer output = ds->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 50);
+    TS_ASSERT_EQUALS(output->GetNumberAnalogSamplePerFrame(), 1);
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(output->GetFirstFrame(), 11);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(output->GetAnalog(2)->GetFrameNumber(), 50);
+    TS_ASSERT_DELTA(output->GetAnalog(2)->GetValues()(20), -2.0, 1e-12);
+    TS_ASSERT_EQUALS(output->GetEvent(0)->GetFrame(), 31);
+    TS_ASSERT(output->GetMetaData() != acq->GetMetaData());
+    
+    ds->SetUpDownRatio(5);
+    ds->Update();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(output->GetNumberAnalogSamplePerFrame(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalog(0)->GetFrameNumber(), 100);
+    
+    ds->SetUpDownRatio(20);
+    ds->Update();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 25);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 25);
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 50.0);
+    TS_ASSERT_EQUALS(output->GetFirstFrame(), 6);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetPoint(1)->GetFrameNumber(), 25);
+    TS_ASSERT_DELTA(output->GetPoint(1)->GetValues()(12,1), 2.0, 1e-12);
+    TS_ASSERT_EQUALS(output->GetEvent(0)->GetFrame(), 16);
+    TS_ASSERT_EQUALS(acq->GetEvent(0)->GetFrame(), 31);
+    
+    ds->SetUpDownRatio(3);
+    ds->Update();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 0);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(DownsampleFilterTest)
@@ -128,4 +277,8 @@ CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, WrenchRatioOne)
 CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, WrenchRatioOneOverTwo)
 CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, WrenchCollectionRatioOne)
 CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, WrenchCollectionRatioOneOverTwo)
+CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, AnalogCollectionAntiAliasing)
+CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, PointCollectionWithGap)
+CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, WrenchCollectionReferenceAcquisition)
+CXXTEST_TEST_REGISTRATION(DownsampleFilterTest, Acquisition)
 #endif
@@ -0,0 +1,80 @@
+#ifndef EigenDecimateTest_h
+#define EigenDecimateTest_h
+
+#include <btkEigen/SignalProcessing/Decimate.h>
+
+CXXTEST_SUITE(EigenDecimateTest)
+{
+  CXXTEST_TEST(FirWin_3_0Dot1)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    TS_ASSERT_EQUALS(btkEigen::firwin(&h, 3, 0.1), true);
+    TS_ASSERT_EQUALS(h.rows(), 3);
+    TS_ASSERT_DELTA(h(0), 0.06799017, 1e-8);
+    TS_ASSERT_DELTA(h(1), 0.86401967, 1e-8);
+    TS_ASSERT_DELTA(h(2), 0.06799017, 1e-8);
+    TS_ASSERT_EQUALS(btkEigen::firwin(&h, 3, 1.0), false);
+  };
+  
+  CXXTEST_TEST(DecimationFilter)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    TS_ASSERT_EQUALS(btkEigen::decimationFilter(&h, 1), true);
+    TS_ASSERT_EQUALS(h.rows(), 1);
+    TS_ASSERT_EQUALS(h(0), 1.0);
+    TS_ASSERT_EQUALS(btkEigen::decimationFilter(&h, 4), true);
+    TS_ASSERT_EQUALS(h.rows(), 81);
+    TS_ASSERT_DELTA(h.sum(), 1.0, 1e-15);
+    for (int i = 0 ; i < 40 ; ++i)
+      TS_ASSERT_DELTA(h(i), h(80-i), 1e-15);
+    TS_ASSERT_EQUALS(btkEigen::decimationFilter(&h, 0), false);
+  };
+  
+  CXXTEST_TEST(DecimateWithoutFilter)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> h = Eigen::Matrix<double,Eigen::Dynamic,1>::Ones(1);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> X = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(11,3);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> Y = btkEigen::decimate(h, 3, X);
+    TS_ASSERT_EQUALS(Y.rows(), 3);
+    TS_ASSERT_EQUALS(Y.cols(), 3);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+        TS_ASSERT_EQUALS(Y(i,j), X(3*i,j));
+    }
+  };
+  
+  CXXTEST_TEST(DecimateSines)
+  {
+    // Column 0: constant, column 1: low frequency sine, column 2: low frequency sine with a component above the new Nyquist frequency.
+    const int len = 2000, q = 10;
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> X(len, 3);
+    for (int i = 0 ; i < len ; ++i)
+    {
+      X(i,0) = 3.5;
+      X(i,1) = std::sin(2.0 * M_PI * 5.0 * i / 1000.0);
+      X(i,2) = X(i,1) + 0.5 * std::sin(2.0 * M_PI * 430.0 * i / 1000.0);
+    }
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    btkEigen::decimationFilter(&h, q);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> Y = btkEigen::decimate(h, q, X);
+    TS_ASSERT_EQUALS(Y.rows(), len / q);
+    for (int i = 0 ; i < Y.rows() ; ++i)
+    {
+      TS_ASSERT_DELTA(Y(i,0), 3.5, 1e-12);
+      // Far from the boundaries, the low frequency is kept and the high frequency is removed.
+      if ((i > 10) && (i < Y.rows() - 10))
+      {
+        TS_ASSERT_DELTA(Y(i,1), X(i*q,1), 5e-3);
+        TS_ASSERT_DELTA(Y(i,2), Y(i,1), 1e-3);
+      }
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenDecimateTest)
+CXXTEST_TEST_REGISTRATION(EigenDecimateTest, FirWin_3_0Dot1)
+CXXTEST_TEST_REGISTRATION(EigenDecimateTest, DecimationFilter)
+CXXTEST_TEST_REGISTRATION(EigenDecimateTest, DecimateWithoutFilter)
+CXXTEST_TEST_REGISTRATION(EigenDecimateTest, DecimateSines)
+#endif // EigenDecimateTest_h
@@ -123,6 +123,47 @@ CXXTEST_SUITE(EigenFiltFiltTest)
       TSM_ASSERT_DELTA("Row #" + btk::ToString(i), signal(i), ref(i), 5e-15); // 5e-15: Due to the differences in the computation of the initial state of the filter?
     }
   }
+  
+  CXXTEST_TEST(Butterworth_LowPass_2_0Dot5_Columns)
+  {
+    // 6 columns: filtered by groups of 4 channels (the second group has 2 empty lanes).
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> X(x.rows(), 6);
+    for (int i = 0 ; i < 6 ; ++i)
+      X.col(i) = static_cast<double>(i - 2) * x;
+    Eigen::Matrix<double,Eigen::Dynamic,1> a,b;
+    btkEigen::butter(&b, &a, 2, 0.5);
+    Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::filtfilt(b, a, x);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> Y = btkEigen::filtfilt(b, a, X);
+    TS_ASSERT_EQUALS(Y.rows(), X.rows());
+    TS_ASSERT_EQUALS(Y.cols(), 6);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      for (int j = 0 ; j < x.rows() ; ++j)
+        TSM_ASSERT_DELTA("Sample #" + btk::ToString(j), Y.coeff(j,i), static_cast<double>(i - 2) * y.coeff(j), 1e-14);
+    }
+  };
+  
+  CXXTEST_TEST(FiltFiltLanes)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,1> a,b,zi;
+    btkEigen::butter(&b, &a, 4, 0.2);
+    btkEigen::filtfiltState(&zi, b, a);
+    const int elen = 12;
+    btkEigen::FiltFiltLanesBuffer<double,2>::Type W(x.rows() + 2 * elen, 2);
+    W.block(elen, 0, x.rows(), 1) = x;
+    W.block(elen, 1, x.rows(), 1) = -2.0 * x;
+    btkEigen::filtfiltLanes<double,2>(b, a, zi, elen, &W);
+    Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::filtfilt(b, a, x);
+    for (int j = 0 ; j < x.rows() ; ++j)
+    {
+      TS_ASSERT_DELTA(W.coeff(elen + j, 0), y.coeff(j), 1e-14);
+      TS_ASSERT_DELTA(W.coeff(elen + j, 1), -2.0 * y.coeff(j), 1e-14);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(EigenFiltFiltTest)
@@ -131,5 +172,7 @@ CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, Butterworth_LowPass_7_0Dot4)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltWindowAverage_FixedSize)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltOrder2_FixedSize)
 CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltECG_FixedSize)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, Butterworth_LowPass_2_0Dot5_Columns)
+CXXTEST_TEST_REGISTRATION(EigenFiltFiltTest, FiltFiltLanes)
 
 #endif // EigenFiltFiltTest_h
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef EigenResampleTest_h
+#define EigenResampleTest_h
+
+#include <btkEigen/SignalProcessing/Resample.h>
+
+CXXTEST_SUITE(EigenResampleTest)
+{
+  CXXTEST_TEST(Rationalize)
+  {
+    int p = 0, q = 0;
+    TS_ASSERT_EQUALS(btkEigen::rationalize(1000.0 / 1200.0, &p, &q), true);
+    TS_ASSERT_EQUALS(p, 5);
+    TS_ASSERT_EQUALS(q, 6);
+    TS_ASSERT_EQUALS(btkEigen::rationalize(3.0, &p, &q), true);
+    TS_ASSERT_EQUALS(p, 3);
+    TS_ASSERT_EQUALS(q, 1);
+    TS_ASSERT_EQUALS(btkEigen::rationalize(148.0 / 100.0, &p, &q), true);
+    TS_ASSERT_EQUALS(p, 37);
+    TS_ASSERT_EQUALS(q, 25);
+    TS_ASSERT_EQUALS(btkEigen::rationalize(M_PI, &p, &q), false);
+    TS_ASSERT_EQUALS(p, 355);
+    TS_ASSERT_EQUALS(q, 113);
+    TS_ASSERT_EQUALS(btkEigen::rationalize(0.0, &p, &q), false);
+  };
+  
+  CXXTEST_TEST(ResamplingFilter)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    TS_ASSERT_EQUALS(btkEigen::resamplingFilter(&h, 1, 1), true);
+    TS_ASSERT_EQUALS(h.rows(), 1);
+    TS_ASSERT_EQUALS(h(0), 1.0);
+    TS_ASSERT_EQUALS(btkEigen::resamplingFilter(&h, 2, 3), true);
+    TS_ASSERT_EQUALS(h.rows(), 61);
+    TS_ASSERT_DELTA(h.sum(), 2.0, 1e-14);
+    TS_ASSERT_EQUALS(btkEigen::resamplingFilter(&h, 0, 3), false);
+  };
+  
+  CXXTEST_TEST(ResampleWithoutFilter)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> h = Eigen::Matrix<double,Eigen::Dynamic,1>::Ones(1);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> X = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(10,2);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> Y = btkEigen::resample(h, 1, 3, X);
+    TS_ASSERT_EQUALS(Y.rows(), 4);
+    TS_ASSERT_EQUALS(Y.cols(), 2);
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      TS_ASSERT_EQUALS(Y(i,0), X(3*i,0));
+      TS_ASSERT_EQUALS(Y(i,1), X(3*i,1));
+    }
+  };
+  
+  CXXTEST_TEST(UpsampleKeepsSamples)
+  {
+    // With an upsampling by an integer factor, the original samples are kept (up to the gain of the normalized filter).
+    const int p = 4;
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> X = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(50,3);
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    btkEigen::resamplingFilter(&h, p, 1);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> Y = btkEigen::resample(h, p, 1, X);
+    TS_ASSERT_EQUALS(Y.rows(), 200);
+    for (int i = 0 ; i < 50 ; ++i)
+    {
+      for (int j = 0 ; j < 3 ; ++j)
+        TS_ASSERT_DELTA(Y(p*i,j), X(i,j), 5e-3);
+    }
+  };
+  
+  CXXTEST_TEST(ResampleSines)
+  {
+    // 1200 Hz to 1000 Hz. Column 0: constant, column 1: low frequency sine, column 2: low frequency sine with a component above the new Nyquist frequency.
+    const int len = 2400, p = 5, q = 6;
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> X(len, 3);
+    for (int i = 0 ; i < len ; ++i)
+    {
+      X(i,0) = -1.5;
+      X(i,1) = std::sin(2.0 * M_PI * 10.0 * i / 1200.0);
+      X(i,2) = X(i,1) + 0.5 * std::sin(2.0 * M_PI * 560.0 * i / 1200.0);
+    }
+    Eigen::Matrix<double,Eigen::Dynamic,1> h;
+    btkEigen::resamplingFilter(&h, p, q);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> Y = btkEigen::resample(h, p, q, X);
+    TS_ASSERT_EQUALS(Y.rows(), 2000);
+    for (int i = 0 ; i < Y.rows() ; ++i)
+      TS_ASSERT_DELTA(Y(i,0), -1.5, 5e-3);
+    // Interior samples only (reflection at the boundaries)
+    for (int i = 100 ; i < Y.rows() - 100 ; ++i)
+    {
+      TS_ASSERT_DELTA(Y(i,1), std::sin(2.0 * M_PI * 10.0 * i / 1000.0), 5e-3);
+      TS_ASSERT_DELTA(Y(i,2), Y(i,1), 5e-2);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenResampleTest)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, Rationalize)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, ResamplingFilter)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, ResampleWithoutFilter)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, UpsampleKeepsSamples)
+CXXTEST_TEST_REGISTRATION(EigenResampleTest, ResampleSines)
+#endif
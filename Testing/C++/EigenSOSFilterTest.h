@@ -0,0 +1,196 @@
+#ifndef EigenSOSFilterTest_h
+#define EigenSOSFilterTest_h
+
+#include <btkEigen/SignalProcessing/SOSFilter.h>
+#include <btkEigen/SignalProcessing/Filter.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkConvert.h>
+
+#include "EigenFilt_Util.h"
+
+static void _eigenSOSFilterTest_poly(const Eigen::Matrix<double,Eigen::Dynamic,6>& sos, Eigen::Matrix<double,Eigen::Dynamic,1>* b, Eigen::Matrix<double,Eigen::Dynamic,1>* a)
+{
+  *b = Eigen::Matrix<double,Eigen::Dynamic,1>::Ones(1);
+  *a = Eigen::Matrix<double,Eigen::Dynamic,1>::Ones(1);
+  for (int s = 0 ; s < sos.rows() ; ++s)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> nb = Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(b->rows()+2), na = Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(a->rows()+2);
+    for (int i = 0 ; i < b->rows() ; ++i)
+    {
+      for (int k = 0 ; k < 3 ; ++k)
+      {
+        nb.coeffRef(i+k) += b->coeff(i) * sos.coeff(s,k);
+        na.coeffRef(i+k) += a->coeff(i) * sos.coeff(s,3+k);
+      }
+    }
+    *b = nb; *a = na;
+  }
+};
+
+CXXTEST_SUITE(EigenSOSFilterTest)
+{
+  CXXTEST_TEST(Butterworth_LowPass_4_0Dot2_Design)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    TS_ASSERT_EQUALS(btkEigen::butterSOS(&sos, 4, 0.2), true);
+    TS_ASSERT_EQUALS(sos.rows(), 2);
+    Eigen::Matrix<double,Eigen::Dynamic,1> a, b, as, bs;
+    btkEigen::butter(&b, &a, 4, 0.2);
+    _eigenSOSFilterTest_poly(sos, &bs, &as);
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+      TSM_ASSERT_DELTA("Numerator #" + btk::ToString(i), bs.coeff(i), b.coeff(i), 1e-12);
+      TSM_ASSERT_DELTA("Denominator #" + btk::ToString(i), as.coeff(i), a.coeff(i), 1e-12);
+    }
+    TS_ASSERT_DELTA(bs.coeff(5), 0.0, 1e-15);
+    TS_ASSERT_DELTA(as.coeff(5), 0.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(Butterworth_HighPass_3_0Dot4_Design)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    TS_ASSERT_EQUALS(btkEigen::butterSOS(&sos, 3, 0.4, btkEigen::HighPass), true);
+    TS_ASSERT_EQUALS(sos.rows(), 2);
+    Eigen::Matrix<double,Eigen::Dynamic,1> a, b, as, bs;
+    btkEigen::butter(&b, &a, 3, 0.4, btkEigen::HighPass);
+    _eigenSOSFilterTest_poly(sos, &bs, &as);
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      TSM_ASSERT_DELTA("Numerator #" + btk::ToString(i), bs.coeff(i), b.coeff(i), 1e-12);
+      TSM_ASSERT_DELTA("Denominator #" + btk::ToString(i), as.coeff(i), a.coeff(i), 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(Butterworth_WrongParameters)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    TS_ASSERT_EQUALS(btkEigen::butterSOS(&sos, 0, 0.2), false);
+    TS_ASSERT_EQUALS(btkEigen::butterSOS(&sos, 2, 1.2), false);
+    TS_ASSERT_EQUALS(btkEigen::butterSOS(&sos, 2, 0.2, btkEigen::BandPass), false);
+  };
+  
+  CXXTEST_TEST(Butterworth_LowPass_2_0Dot5)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,1> a, b;
+    btkEigen::butter(&b, &a, 2, 0.5);
+    Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::filter(b, a, x);
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 2, 0.5);
+    btkEigen::sosfilt(sos, x);
+    for (int i = 0 ; i < x.rows() ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), x.coeff(i), y.coeff(i), 1e-14);
+  };
+  
+  CXXTEST_TEST(Butterworth_HighPass_5_0Dot3_Columns)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> X(x.rows(), 3);
+    X.col(0) = x; X.col(1) = -2.0 * x; X.col(2) = x.reverse();
+    Eigen::Matrix<double,Eigen::Dynamic,1> a, b;
+    btkEigen::butter(&b, &a, 5, 0.3, btkEigen::HighPass);
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 5, 0.3, btkEigen::HighPass);
+    btkEigen::sosfilt(sos, X);
+    for (int j = 0 ; j < X.cols() ; ++j)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::filter(b, a, Eigen::Matrix<double,Eigen::Dynamic,1>(j == 0 ? x : (j == 1 ? (-2.0 * x).eval() : x.reverse().eval())));
+      for (int i = 0 ; i < X.rows() ; ++i)
+        TSM_ASSERT_DELTA("Column #" + btk::ToString(j) + ", sample #" + btk::ToString(i), X.coeff(i,j), y.coeff(i), 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(FixedAndDynamicSections)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x, y;
+    generateRawData(x);
+    y = x;
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 8, 0.35);
+    TS_ASSERT_EQUALS(sos.rows(), 4);
+    btkEigen::sosfilt(sos, x);
+    // Add a passthrough section to use the dynamic implementation.
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos5(5,6);
+    sos5.topRows(4) = sos;
+    sos5.row(4) << 2.0, 0.0, 0.0, 2.0, 0.0, 0.0;
+    btkEigen::sosfilt(sos5, y);
+    for (int i = 0 ; i < x.rows() ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), x.coeff(i), y.coeff(i), 1e-15);
+  };
+  
+  CXXTEST_TEST(Butterworth_LowPass_12_0Dot05_Stable)
+  {
+    // The coefficients of the transfer function are not accurate enough for such a filter.
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 12, 0.05);
+    TS_ASSERT_EQUALS(sos.rows(), 6);
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = Eigen::Matrix<double,Eigen::Dynamic,1>::Ones(2000);
+    btkEigen::sosfilt(sos, x.segment(0,2000));
+    TS_ASSERT_DELTA(x.coeff(1999), 1.0, 1e-10);
+    TS_ASSERT(x.cwiseAbs().maxCoeff() < 1.5);
+  };
+  
+  CXXTEST_TEST(FiltFilt_Butterworth_LowPass_7_0Dot4)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> X(x.rows(), 5);
+    for (int j = 0 ; j < X.cols() ; ++j)
+      X.col(j) = static_cast<double>(j + 1) * x;
+    Eigen::Matrix<double,Eigen::Dynamic,1> a, b;
+    btkEigen::butter(&b, &a, 7, 0.4);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> Y = btkEigen::filtfilt(b, a, X);
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 7, 0.4);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> Ys = btkEigen::sosfiltfilt(sos, X);
+    TS_ASSERT_EQUALS(Ys.rows(), X.rows());
+    TS_ASSERT_EQUALS(Ys.cols(), X.cols());
+    for (int j = 0 ; j < X.cols() ; ++j)
+    {
+      for (int i = 0 ; i < X.rows() ; ++i)
+        TSM_ASSERT_DELTA("Column #" + btk::ToString(j) + ", sample #" + btk::ToString(i), Ys.coeff(i,j), Y.coeff(i,j), 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(FiltFilt_Butterworth_HighPass_2_0Dot3)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x;
+    generateRawData(x);
+    Eigen::Matrix<double,Eigen::Dynamic,1> a, b;
+    btkEigen::butter(&b, &a, 2, 0.3, btkEigen::HighPass);
+    Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::filtfilt(b, a, x);
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 2, 0.3, btkEigen::HighPass);
+    Eigen::Matrix<double,Eigen::Dynamic,1> ys = btkEigen::sosfiltfilt(sos, x);
+    for (int i = 0 ; i < x.rows() ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), ys.coeff(i), y.coeff(i), 1e-13);
+  };
+  
+  CXXTEST_TEST(FiltFilt_Butterworth_LowPass_12_0Dot05_Stable)
+  {
+    // The initial states remove the transient: a constant signal is not modified.
+    Eigen::Matrix<double,Eigen::Dynamic,6> sos;
+    btkEigen::butterSOS(&sos, 12, 0.05);
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(200, 2.5);
+    Eigen::Matrix<double,Eigen::Dynamic,1> y = btkEigen::sosfiltfilt(sos, x);
+    for (int i = 0 ; i < x.rows() ; ++i)
+      TSM_ASSERT_DELTA("Sample #" + btk::ToString(i), y.coeff(i), 2.5, 1e-10);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenSOSFilterTest)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, Butterworth_LowPass_4_0Dot2_Design)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, Butterworth_HighPass_3_0Dot4_Design)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, Butterworth_WrongParameters)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, Butterworth_LowPass_2_0Dot5)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, Butterworth_HighPass_5_0Dot3_Columns)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, FixedAndDynamicSections)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, Butterworth_LowPass_12_0Dot05_Stable)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, FiltFilt_Butterworth_LowPass_7_0Dot4)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, FiltFilt_Butterworth_HighPass_2_0Dot3)
+CXXTEST_TEST_REGISTRATION(EigenSOSFilterTest, FiltFilt_Butterworth_LowPass_12_0Dot05_Stable)
+
+#endif // EigenSOSFilterTest_h
@@ -56,6 +56,46 @@ CXXTEST_SUITE(ForcePlatformTypesTest)
     TS_ASSERT_EQUALS(pf->GetCalMatrix().rows(), 12);
     TS_ASSERT_EQUALS(pf->GetCalMatrix().cols(), 12);
   };
+
+  CXXTEST_TEST(ForcePlatformType7)
+  {
+    btk::ForcePlatform::Pointer pf = btk::ForcePlatformType7::New();
+    TS_ASSERT_EQUALS(pf->GetType(), 7);
+    TS_ASSERT_EQUALS(pf->GetChannelNumber(), 8);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().isIdentity(), true);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().rows(), 8);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().cols(), 8);
+  };
+
+  CXXTEST_TEST(ForcePlatformType11)
+  {
+    btk::ForcePlatform::Pointer pf = btk::ForcePlatformType11::New();
+    TS_ASSERT_EQUALS(pf->GetType(), 11);
+    TS_ASSERT_EQUALS(pf->GetChannelNumber(), 8);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().isIdentity(), true);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().rows(), 8);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().cols(), 8);
+  };
+
+  CXXTEST_TEST(ForcePlatformType12)
+  {
+    btk::ForcePlatform::Pointer pf = btk::ForcePlatformType12::New();
+    TS_ASSERT_EQUALS(pf->GetType(), 12);
+    TS_ASSERT_EQUALS(pf->GetChannelNumber(), 8);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().isIdentity(), true);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().rows(), 8);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().cols(), 8);
+  };
+
+  CXXTEST_TEST(ForcePlatformType21)
+  {
+    btk::ForcePlatform::Pointer pf = btk::ForcePlatformType21::New();
+    TS_ASSERT_EQUALS(pf->GetType(), 21);
+    TS_ASSERT_EQUALS(pf->GetChannelNumber(), 6);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().isIdentity(), true);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().rows(), 6);
+    TS_ASSERT_EQUALS(pf->GetCalMatrix().cols(), 6);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ForcePlatformTypesTest)
@@ -65,5 +105,9 @@ CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType3)
 CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType4)
 CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType5)
 CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType6)
+CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType7)
+CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType11)
+CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType12)
+CXXTEST_TEST_REGISTRATION(ForcePlatformTypesTest, ForcePlatformType21)
 
 #endif // ForcePlatformTypesTest_h
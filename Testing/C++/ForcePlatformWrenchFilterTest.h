@@ -3,7 +3,147 @@
 
 #include <btkAcquisitionFileReader.h>
 #include <btkForcePlatformWrenchFilter.h>
+#include <btkGroundReactionWrenchFilter.h>
 #include <btkForcePlatformsExtractor.h>
+#include <btkAnalogBlock.h>
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, 3> WrenchComponent;
+
+static btk::ForcePlatform::Pointer WrenchPlatform(int type, int frameNumber, bool block)
+{
+  btk::ForcePlatform::Pointer fp;
+  switch (type)
+  {
+    case 1: fp = btk::ForcePlatformType1::New(); break;
+    case 2: fp = btk::ForcePlatformType2::New(); break;
+    case 3: fp = btk::ForcePlatformType3::New(); break;
+    case 4: fp = btk::ForcePlatformType4::New(); break;
+    case 6: fp = btk::ForcePlatformType6::New(); break;
+    case 7: fp = btk::ForcePlatformType7::New(); break;
+    case 11: fp = btk::ForcePlatformType11::New(); break;
+    case 12: fp = btk::ForcePlatformType12::New(); break;
+    case 21: fp = btk::ForcePlatformType21::New(); break;
+    default: fp = btk::ForcePlatformType5::New(); break;
+  }
+  const bool kistler = (type == 3) || (type == 6) || (type == 7) || (type == 11) || (type == 12);
+  btk::AnalogCollection::Pointer channels = btk::AnalogCollection::New();
+  for (int i = 0 ; i < fp->GetChannelNumber() ; ++i)
+  {
+    btk::Analog::Pointer channel = btk::Analog::New(frameNumber);
+    channel->SetValues(Eigen::Matrix<double, Eigen::Dynamic, 1>::Random(frameNumber) * 100.0);
+    if ((!kistler && (i == 2)) || ((type == 6) && (i >= 8)) || (((type == 3) || (type == 7) || (type == 11)) && (i >= 4)) || (type == 12)) // Vertical forces
+      channel->GetValues().array() -= (type == 12) ? 150.0 : 300.0; // Type 12: two sensors for each vertical force
+    channels->InsertItem(channel);
+  }
+  if (block)
+    btk::AnalogBlock::Pack(channels);
+  for (int i = 0 ; i < fp->GetChannelNumber() ; ++i)
+    fp->SetChannel(i, channels->GetItem(i));
+  if (kistler)
+    fp->SetOrigin(120.0, 200.0, -45.0);
+  else
+    fp->SetOrigin(1.5, -2.0, -38.0);
+  btk::ForcePlatform::Corners c;
+  c << 600.0, 600.0,   0.0,   0.0,
+       400.0,   0.0,   0.0, 400.0,
+         0.5,   0.2,  -0.1,   0.3;
+  fp->SetCorners(c);
+  return fp;
+};
+
+// Wrench computed component by component as done before the fused kernel.
+static void WrenchReference(btk::ForcePlatform::Pointer fp, bool ground, int location, bool global, WrenchComponent& F, WrenchComponent& M, WrenchComponent& P)
+{
+  const int n = fp->GetChannel(0)->GetFrameNumber();
+  std::vector< Eigen::Array<double, Eigen::Dynamic, 1> > c(fp->GetChannelNumber());
+  for (int i = 0 ; i < fp->GetChannelNumber() ; ++i)
+    c[i] = fp->GetChannel(i)->GetValues();
+  F.setZero(n, 3); M.setZero(n, 3); P.setZero(n, 3);
+  btk::ForcePlatform::Origin o = fp->GetOrigin();
+  if (fp->GetType() == 1)
+  {
+    F.col(0) = c[0]; F.col(1) = c[1]; F.col(2) = c[2];
+    P.col(0) = c[3]; P.col(1) = c[4];
+    M.col(2) = c[5];
+    if (!ground)
+    {
+      M.col(0).array() -= - P.col(1).array() * F.col(2).array();
+      M.col(1).array() -= F.col(2).array() * P.col(0).array();
+      M.col(2).array() -= F.col(0).array() * P.col(1).array() - P.col(0).array() * F.col(1).array();
+    }
+    ground = false;
+  }
+  else if ((fp->GetType() == 3) || (fp->GetType() == 7) || (fp->GetType() == 11))
+  {
+    F.col(0) = c[0] + c[1];
+    F.col(1) = c[2] + c[3];
+    F.col(2) = c[4] + c[5] + c[6] + c[7];
+    M.col(0) = o.y() * (c[4] + c[5] - c[6] - c[7]);
+    M.col(1) = o.x() * (c[5] + c[6] - c[4] - c[7]);
+    M.col(2) = o.y() * (c[1] - c[0]) + o.x() * (c[2] - c[3]);
+    o.x() = 0.0; o.y() = 0.0;
+  }
+  else if (fp->GetType() == 6)
+  {
+    // Sum of the moments of each sensor
+    const double x[4] = {o.x(), -o.x(), -o.x(), o.x()};
+    const double y[4] = {o.y(), o.y(), -o.y(), -o.y()};
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      Eigen::Array<double, Eigen::Dynamic, 1> fx = c[i], fy = c[i+4], fz = c[i+8];
+      F.col(0).array() += fx; F.col(1).array() += fy; F.col(2).array() += fz;
+      M.col(0).array() += y[i] * fz;
+      M.col(1).array() -= x[i] * fz;
+      M.col(2).array() += x[i] * fy - y[i] * fx;
+    }
+    o.x() = 0.0; o.y() = 0.0;
+  }
+  else
+  {
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      F.col(i) = c[i];
+      M.col(i) = c[i+3];
+    }
+  }
+  if (ground)
+  {
+    Eigen::Array<double, Eigen::Dynamic, 1> Fx = F.col(0), Fy = F.col(1), Fz = F.col(2);
+    M.col(0).array() += Fy * o.z() - o.y() * Fz;
+    M.col(1).array() += Fz * o.x() - o.z() * Fx;
+    M.col(2).array() += Fx * o.y() - o.x() * Fy;
+    Eigen::Array<double, Eigen::Dynamic, 1> Mx = M.col(0), My = M.col(1), Mz = M.col(2);
+    if (location == btk::GroundReactionWrenchFilter::COP)
+    {
+      P.col(0) = -My / Fz;
+      P.col(1) = Mx / Fz;
+      M.col(0).setZero();
+      M.col(1).setZero();
+      M.col(2).array() += -P.col(0).array() * Fy + P.col(1).array() * Fx;
+    }
+    else if (location == btk::GroundReactionWrenchFilter::PWA)
+    {
+      Eigen::Array<double, Eigen::Dynamic, 1> sNF = F.rowwise().squaredNorm();
+      P.col(0) = (Fy * Mz - Fz * My) / sNF - (Fx.square() * My - Fx * (Fy * Mx)) / (sNF * Fz);
+      P.col(1) = (Fz * Mx - Fx * Mz) / sNF - (Fx * (Fy * My) - Fy.square() * Mx) / (sNF * Fz);
+      M.col(0).array() -= P.col(1).array() * Fz;
+      M.col(1).array() += Fz * P.col(0).array();
+      M.col(2).array() += Fx * P.col(1).array() - P.col(0).array() * Fy;
+    }
+  }
+  if (global)
+  {
+    const btk::ForcePlatform::Corners& k = fp->GetCorners();
+    Eigen::Matrix<double, 3, 3> R;
+    R.col(0) = (k.col(0) - k.col(1)).normalized();
+    R.col(2) = R.col(0).cross(k.col(0) - k.col(3)).normalized();
+    R.col(1) = R.col(2).cross(R.col(0));
+    F *= R.transpose();
+    M *= R.transpose();
+    P *= R.transpose();
+    P.rowwise() += ((k.col(0) + k.col(2)) / 2.0).transpose();
+  }
+};
 
 CXXTEST_SUITE(ForcePlatformWrenchFilterTest)
 { 
@@ -47,8 +187,108 @@ CXXTEST_SUITE(ForcePlatformWrenchFilterTest)
       }
     }
   };
+
+  CXXTEST_TEST(FusedKernel)
+  {
+    WrenchComponent F, M, P;
+    const int types[9] = {1, 2, 3, 4, 5, 6, 7, 11, 21};
+    for (int t = 0 ; t < 9 ; ++t)
+    {
+      const int type = types[t];
+      for (int block = 0 ; block < 2 ; ++block)
+      {
+        btk::ForcePlatform::Pointer fp = WrenchPlatform(type, 1000, block != 0);
+        btk::ForcePlatformWrenchFilter::Pointer fpwf = btk::ForcePlatformWrenchFilter::New();
+        fpwf->SetInput(fp);
+        for (int global = 0 ; global < 2 ; ++global)
+        {
+          fpwf->SetTransformToGlobalFrame(global != 0);
+          fpwf->Update();
+          WrenchReference(fp, false, -1, global != 0, F, M, P);
+          btk::Wrench::Pointer wrh = fpwf->GetOutput()->GetItem(0);
+          TS_ASSERT_EIGEN_DELTA(wrh->GetForce()->GetValues(), F, 1e-9);
+          TS_ASSERT_EIGEN_DELTA(wrh->GetMoment()->GetValues(), M, 1e-7);
+          TS_ASSERT_EIGEN_DELTA(wrh->GetPosition()->GetValues(), P, 1e-9);
+        }
+        btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+        grwf->SetInput(fp);
+        for (int location = btk::GroundReactionWrenchFilter::Origin ; location <= btk::GroundReactionWrenchFilter::PWA ; ++location)
+        {
+          grwf->setLocation(static_cast<btk::GroundReactionWrenchFilter::Location>(location));
+          grwf->Update();
+          WrenchReference(fp, true, location, true, F, M, P);
+          btk::Wrench::Pointer wrh = grwf->GetOutput()->GetItem(0);
+          TS_ASSERT_EIGEN_DELTA(wrh->GetForce()->GetValues(), F, 1e-9);
+          TS_ASSERT_EIGEN_DELTA(wrh->GetMoment()->GetValues(), M, 1e-7);
+          TS_ASSERT_EIGEN_DELTA(wrh->GetPosition()->GetValues(), P, 1e-9);
+          TS_ASSERT_EQUALS(wrh->GetPosition()->GetResiduals().maxCoeff(), 0.0);
+        }
+        // Suppressed PWA
+        grwf->SetThresholdValue(2000.0);
+        grwf->SetThresholdState(true);
+        grwf->Update();
+        btk::Wrench::Pointer wrh = grwf->GetOutput()->GetItem(0);
+        if (type == 1)
+        {
+          TS_ASSERT_EQUALS(wrh->GetPosition()->GetResiduals().minCoeff(), 0.0);
+        }
+        else
+        {
+          TS_ASSERT_EQUALS(wrh->GetPosition()->GetResiduals().maxCoeff(), -1.0);
+        }
+      }
+    }
+  };
+  
+  CXXTEST_TEST(Threads)
+  {
+    const int types[12] = {1, 2, 3, 4, 5, 6, 7, 11, 12, 21, 2, 3};
+    btk::ForcePlatformCollection::Pointer fpc = btk::ForcePlatformCollection::New();
+    for (int i = 0 ; i < 12 ; ++i)
+      fpc->InsertItem(WrenchPlatform(types[i], 1000 + i, (i % 2) == 0));
+    btk::GroundReactionWrenchFilter::Pointer grwf = btk::GroundReactionWrenchFilter::New();
+    grwf->SetInput(fpc);
+    grwf->Update();
+    btk::WrenchCollection::Pointer reference = grwf->GetOutput()->Clone();
+    grwf->SetThreadNumber(4);
+    fpc->Modified();
+    grwf->Update();
+    btk::WrenchCollection::Pointer output = grwf->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 12);
+    for (int i = 0 ; i < 12 ; ++i)
+    {
+      TS_ASSERT_EQUALS(output->GetItem(i)->GetPosition()->GetLabel(), reference->GetItem(i)->GetPosition()->GetLabel());
+      TS_ASSERT_EQUALS(output->GetItem(i)->GetForce()->GetFrameNumber(), 1000 + i);
+      TS_ASSERT(output->GetItem(i)->GetForce()->GetValues() == reference->GetItem(i)->GetForce()->GetValues());
+      TS_ASSERT(output->GetItem(i)->GetMoment()->GetValues() == reference->GetItem(i)->GetMoment()->GetValues());
+      TS_ASSERT(output->GetItem(i)->GetPosition()->GetValues() == reference->GetItem(i)->GetPosition()->GetValues());
+      TS_ASSERT(output->GetItem(i)->GetPosition()->GetResiduals() == reference->GetItem(i)->GetPosition()->GetResiduals());
+    }
+  };
+  
+  CXXTEST_TEST(Type12NotSupported)
+  {
+    btk::ForcePlatformCollection::Pointer fpc = btk::ForcePlatformCollection::New();
+    fpc->InsertItem(WrenchPlatform(12, 100, false));
+    fpc->InsertItem(WrenchPlatform(3, 100, false));
+    btk::ForcePlatformWrenchFilter::Pointer fpwf = btk::ForcePlatformWrenchFilter::New();
+    fpwf->SetInput(fpc);
+    fpwf->Update();
+    btk::WrenchCollection::Pointer output = fpwf->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    // The wrench of the Gaitway treadmill is not computed.
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetForce()->GetValues().cwiseAbs().maxCoeff(), 0.0);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetMoment()->GetValues().cwiseAbs().maxCoeff(), 0.0);
+    WrenchComponent F, M, P;
+    WrenchReference(fpc->GetItem(1), false, -1, true, F, M, P);
+    TS_ASSERT_EIGEN_DELTA(output->GetItem(1)->GetForce()->GetValues(), F, 1e-9);
+    TS_ASSERT_EIGEN_DELTA(output->GetItem(1)->GetMoment()->GetValues(), M, 1e-7);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ForcePlatformWrenchFilterTest)
 CXXTEST_TEST_REGISTRATION(ForcePlatformWrenchFilterTest, FileSample09PluginC3D)
+CXXTEST_TEST_REGISTRATION(ForcePlatformWrenchFilterTest, FusedKernel)
+CXXTEST_TEST_REGISTRATION(ForcePlatformWrenchFilterTest, Threads)
+CXXTEST_TEST_REGISTRATION(ForcePlatformWrenchFilterTest, Type12NotSupported)
 #endif
@@ -188,6 +188,55 @@ CXXTEST_SUITE(ForcePlatformsExtractorTest)
     TS_ASSERT_EQUALS(pfc->GetItemNumber(), 2);
     TS_ASSERT(ts == pfc->GetTimestamp());
   };
+  
+  CXXTEST_TEST(CalibrationMatrixTypes)
+  {
+    const int types[5] = {6, 7, 11, 12, 21};
+    const int channels[5] = {12, 8, 8, 8, 6};
+    for (int t = 0 ; t < 5 ; ++t)
+    {
+      const int num = channels[t];
+      const int frameNumber = 1000; // Not a multiple of the blocks used internally
+      btk::Acquisition::Pointer acq = btk::Acquisition::New();
+      acq->Init(0, frameNumber, num, 1);
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> raw = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Random(frameNumber, num);
+      for (int i = 0 ; i < num ; ++i)
+        acq->GetAnalog(i)->SetValues(raw.col(i));
+      std::vector<uint8_t> dims(2, 1); dims[0] = num;
+      std::vector<int16_t> index(num);
+      for (int i = 0 ; i < num ; ++i)
+        index[i] = i + 1;
+      std::vector<float> coefficients(num * num);
+      for (int i = 0 ; i < num * num ; ++i)
+        coefficients[i] = static_cast<float>((i % 7) - 3) + ((i % (num + 1)) == 0 ? 10.0f : 0.0f);
+      std::vector<uint8_t> calDims(3, 1); calDims[0] = num; calDims[1] = num;
+      btk::MetaData::Pointer fp = btk::MetaData::New("FORCE_PLATFORM");
+      fp->AppendChild(btk::MetaData::New("USED", static_cast<int16_t>(1)));
+      fp->AppendChild(btk::MetaData::New("TYPE", std::vector<int16_t>(1, types[t])));
+      fp->AppendChild(btk::MetaData::New("CHANNEL", dims, index));
+      fp->AppendChild(btk::MetaData::New("CAL_MATRIX", calDims, coefficients));
+      acq->GetMetaData()->AppendChild(fp);
+      btk::ForcePlatformsExtractor::Pointer pfe = btk::ForcePlatformsExtractor::New();
+      pfe->SetInput(acq);
+      pfe->Update();
+      btk::ForcePlatformCollection::Pointer pfc = pfe->GetOutput();
+      TS_ASSERT_EQUALS(pfc->GetItemNumber(), 1);
+      btk::ForcePlatform::Pointer pf = pfc->GetItem(0);
+      TS_ASSERT_EQUALS(pf->GetType(), types[t]);
+      TS_ASSERT_EQUALS(pf->GetChannelNumber(), num);
+      btk::ForcePlatform::CalMatrix cal = pf->GetCalMatrix();
+      TS_ASSERT_EQUALS(cal(0,0), coefficients[0]);
+      TS_ASSERT_EQUALS(cal(1,0), coefficients[1]);
+      TS_ASSERT_EQUALS(cal(0,1), coefficients[num]);
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> calibrated = raw * cal.transpose();
+      for (int i = 0 ; i < num ; ++i)
+      {
+        TS_ASSERT_EIGEN_DELTA(pf->GetChannel(i)->GetValues(), calibrated.col(i), 1e-10);
+      }
+      // The raw channels of the acquisition are not modified
+      TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(0)->GetValues(), raw.col(0), 1e-15);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ForcePlatformsExtractorTest)
@@ -197,5 +246,6 @@ CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FileSample10Type4)
 CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FileSample19Sample19)
 CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FPAnalogModified)
 CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, FPAnalogNotModified)
+CXXTEST_TEST_REGISTRATION(ForcePlatformsExtractorTest, CalibrationMatrixTypes)
 
 #endif
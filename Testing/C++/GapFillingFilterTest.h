@@ -0,0 +1,221 @@
+#ifndef GapFillingFilterTest_h
+#define GapFillingFilterTest_h
+
+#include <btkGapFillingFilter.h>
+#include <btkConvert.h>
+
+#include <btkEigen/Interpolation/Interp1.h>
+
+#include <cmath>
+
+static btk::Point::Pointer _gapFillingFilterTest_point(const std::string& label, int frameNumber)
+{
+  btk::Point::Pointer point = btk::Point::New(label, frameNumber);
+  for (int i = 0 ; i < frameNumber ; ++i)
+  {
+    point->GetValues().coeffRef(i,0) = 100.0 * std::sin(2.0 * M_PI * i / 50.0);
+    point->GetValues().coeffRef(i,1) = 50.0 * std::cos(2.0 * M_PI * i / 35.0) + static_cast<double>(i);
+    point->GetValues().coeffRef(i,2) = 2.0 * static_cast<double>(i) + 1.0;
+    point->GetResiduals().coeffRef(i) = 1.0;
+  }
+  return point;
+};
+
+static void _gapFillingFilterTest_gap(btk::Point::Pointer point, int begin, int end)
+{
+  for (int i = begin ; i < end ; ++i)
+  {
+    point->GetValues().row(i).setZero();
+    point->GetResiduals().coeffRef(i) = -1.0;
+  }
+};
+
+CXXTEST_SUITE(GapFillingFilterTest)
+{
+  CXXTEST_TEST(PointCollection_PCHIP)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk::Point::Pointer point = _gapFillingFilterTest_point("uname*1", 100);
+    _gapFillingFilterTest_gap(point, 0, 3);
+    _gapFillingFilterTest_gap(point, 20, 25);
+    _gapFillingFilterTest_gap(point, 27, 28);
+    _gapFillingFilterTest_gap(point, 50, 70);
+    _gapFillingFilterTest_gap(point, 97, 100);
+    points->InsertItem(point);
+    
+    btk::GapFillingFilter<btk::PointCollection>::Pointer gff = btk::GapFillingFilter<btk::PointCollection>::New();
+    TS_ASSERT_EQUALS(gff->GetMethod(), btk::GapFillingFilter<btk::PointCollection>::PCHIP);
+    TS_ASSERT_EQUALS(gff->GetMaxGap(), -1);
+    gff->SetInput(points);
+    gff->Update();
+    btk::PointCollection::Pointer output = gff->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+    btk::Point::Pointer filled = output->GetItem(0);
+    TS_ASSERT_EQUALS(filled->GetLabel(), "uname*1");
+    
+    // Same result than the PCHIP interpolation of all the valid frames
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(68), y(68), xi(100), yi;
+    int inc = 0;
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      xi.coeffRef(i) = static_cast<double>(i);
+      if (point->GetResiduals().coeff(i) >= 0.0)
+        x.coeffRef(inc++) = static_cast<double>(i);
+    }
+    TS_ASSERT_EQUALS(inc, 68);
+    for (int c = 0 ; c < 3 ; ++c)
+    {
+      for (int i = 0 ; i < 68 ; ++i)
+        y.coeffRef(i) = point->GetValues().coeff(static_cast<int>(x.coeff(i)), c);
+      btkEigen::interp1().pchip(&yi, x, y, xi);
+      for (int i = 3 ; i < 97 ; ++i)
+        TSM_ASSERT_DELTA("Component #" + btk::ToString(c) + ", frame #" + btk::ToString(i), filled->GetValues().coeff(i,c), yi.coeff(i), 1e-12);
+    }
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      if ((i < 3) || (i >= 97))
+      {
+        TS_ASSERT_EQUALS(filled->GetResiduals().coeff(i), -1.0);
+        TS_ASSERT_EQUALS(filled->GetValues().coeff(i,0), 0.0);
+      }
+      else if (point->GetResiduals().coeff(i) < 0.0)
+      {
+        TS_ASSERT_EQUALS(filled->GetResiduals().coeff(i), 0.0);
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(filled->GetResiduals().coeff(i), 1.0);
+      }
+    }
+    // The input is not modified
+    TS_ASSERT_EQUALS(point->GetResiduals().coeff(22), -1.0);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(22,0), 0.0);
+  };
+  
+  CXXTEST_TEST(PointCollection_MaxGap)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk::Point::Pointer point = _gapFillingFilterTest_point("uname*1", 100);
+    _gapFillingFilterTest_gap(point, 20, 30);
+    _gapFillingFilterTest_gap(point, 50, 61);
+    points->InsertItem(point);
+    
+    btk::GapFillingFilter<btk::PointCollection>::Pointer gff = btk::GapFillingFilter<btk::PointCollection>::New();
+    gff->SetInput(points);
+    gff->SetMaxGap(10);
+    gff->Update();
+    btk::Point::Pointer filled = gff->GetOutput()->GetItem(0);
+    for (int i = 20 ; i < 30 ; ++i)
+      TS_ASSERT_EQUALS(filled->GetResiduals().coeff(i), 0.0);
+    for (int i = 50 ; i < 61 ; ++i)
+    {
+      TS_ASSERT_EQUALS(filled->GetResiduals().coeff(i), -1.0);
+      TS_ASSERT_EQUALS(filled->GetValues().coeff(i,2), 0.0);
+    }
+  };
+  
+  CXXTEST_TEST(PointCollection_LinearData)
+  {
+    // The three methods reproduce the linear component exactly (Z axis).
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk::Point::Pointer point = _gapFillingFilterTest_point("uname*1", 60);
+    _gapFillingFilterTest_gap(point, 1, 4); // Only one valid frame before the gap
+    _gapFillingFilterTest_gap(point, 6, 7);
+    _gapFillingFilterTest_gap(point, 30, 45);
+    points->InsertItem(point);
+    
+    btk::GapFillingFilter<btk::PointCollection>::Pointer gff = btk::GapFillingFilter<btk::PointCollection>::New();
+    gff->SetInput(points);
+    btk::GapFillingFilter<btk::PointCollection>::Method methods[3] = {btk::GapFillingFilter<btk::PointCollection>::Linear, btk::GapFillingFilter<btk::PointCollection>::PCHIP, btk::GapFillingFilter<btk::PointCollection>::Spline};
+    for (int m = 0 ; m < 3 ; ++m)
+    {
+      gff->SetMethod(methods[m]);
+      gff->Update();
+      btk::Point::Pointer filled = gff->GetOutput()->GetItem(0);
+      for (int i = 0 ; i < 60 ; ++i)
+      {
+        TSM_ASSERT_DELTA("Method #" + btk::ToString(m) + ", frame #" + btk::ToString(i), filled->GetValues().coeff(i,2), 2.0 * static_cast<double>(i) + 1.0, 1e-10);
+        TS_ASSERT(filled->GetResiduals().coeff(i) >= 0.0);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(PointCollection_Spline)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk::Point::Pointer point = _gapFillingFilterTest_point("uname*1", 100);
+    _gapFillingFilterTest_gap(point, 40, 46);
+    _gapFillingFilterTest_gap(point, 48, 49);
+    points->InsertItem(point);
+    
+    btk::GapFillingFilter<btk::PointCollection>::Pointer gff = btk::GapFillingFilter<btk::PointCollection>::New();
+    gff->SetInput(points);
+    gff->SetMethod(btk::GapFillingFilter<btk::PointCollection>::Spline);
+    gff->Update();
+    btk::Point::Pointer filled = gff->GetOutput()->GetItem(0);
+    // Natural spline going through the frames 36 to 39, 46, 47, 49 and 50.
+    Eigen::Matrix<double,Eigen::Dynamic,1> x(8), y(8), xi(6), yi;
+    x << 36.0, 37.0, 38.0, 39.0, 46.0, 47.0, 49.0, 50.0;
+    xi << 40.0, 41.0, 42.0, 43.0, 44.0, 45.0;
+    for (int c = 0 ; c < 3 ; ++c)
+    {
+      for (int i = 0 ; i < 8 ; ++i)
+        y.coeffRef(i) = point->GetValues().coeff(static_cast<int>(x.coeff(i)), c);
+      btkEigen::interp1().spline(&yi, x, y, xi);
+      for (int i = 0 ; i < 6 ; ++i)
+        TS_ASSERT_DELTA(filled->GetValues().coeff(40+i,c), yi.coeff(i), 1e-12);
+    }
+    // Smooth signal: the error stays small compared to the amplitude of the signal.
+    for (int i = 40 ; i < 46 ; ++i)
+      TS_ASSERT_DELTA(filled->GetValues().coeff(i,0), 100.0 * std::sin(2.0 * M_PI * i / 50.0), 1.0);
+  };
+  
+  CXXTEST_TEST(Acquisition_MaxInterpolationGap)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 100, 2, 2);
+    acq->SetPointFrequency(100.0);
+    acq->SetMaxInterpolationGap(5);
+    for (int j = 0 ; j < 12 ; ++j)
+    {
+      btk::Point::Pointer point = _gapFillingFilterTest_point("uname*" + btk::ToString(j), 100);
+      _gapFillingFilterTest_gap(point, 10 + j, 15 + j); // 5 frames
+      _gapFillingFilterTest_gap(point, 60, 66); // 6 frames
+      acq->AppendPoint(point);
+    }
+    acq->GetAnalog(0)->GetValues().setConstant(2.5);
+    
+    btk::GapFillingFilter<btk::Acquisition>::Pointer gff = btk::GapFillingFilter<btk::Acquisition>::New();
+    gff->SetInput(acq);
+    gff->SetThreadNumber(4);
+    gff->Update();
+    btk::Acquisition::Pointer output = gff->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 12);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 100);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetNumberAnalogSamplePerFrame(), 2);
+    TS_ASSERT_EQUALS(output->GetMaxInterpolationGap(), 5);
+    TS_ASSERT_EQUALS(output->GetAnalog(0)->GetValues().coeff(150), 2.5);
+    
+    btk::GapFillingFilter<btk::PointCollection>::Pointer ref = btk::GapFillingFilter<btk::PointCollection>::New();
+    ref->SetInput(acq->GetPoints());
+    ref->SetMaxGap(5);
+    ref->Update();
+    for (int j = 0 ; j < 12 ; ++j)
+    {
+      btk::Point::Pointer filled = output->GetPoint(j);
+      TS_ASSERT_EQUALS(filled->GetLabel(), "uname*" + btk::ToString(j));
+      TS_ASSERT_EQUALS(filled->GetResiduals().coeff(12 + j), 0.0);
+      TS_ASSERT_EQUALS(filled->GetResiduals().coeff(62), -1.0);
+      TS_ASSERT_EQUALS((filled->GetValues() - ref->GetOutput()->GetItem(j)->GetValues()).cwiseAbs().maxCoeff(), 0.0);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(GapFillingFilterTest)
+CXXTEST_TEST_REGISTRATION(GapFillingFilterTest, PointCollection_PCHIP)
+CXXTEST_TEST_REGISTRATION(GapFillingFilterTest, PointCollection_MaxGap)
+CXXTEST_TEST_REGISTRATION(GapFillingFilterTest, PointCollection_LinearData)
+CXXTEST_TEST_REGISTRATION(GapFillingFilterTest, PointCollection_Spline)
+CXXTEST_TEST_REGISTRATION(GapFillingFilterTest, Acquisition_MaxInterpolationGap)
+#endif
@@ -0,0 +1,154 @@
+#ifndef HashTest_h
+#define HashTest_h
+
+#include <btkHash.h>
+#include <btkAcquisition.h>
+
+#include <cstdlib>
+#include <vector>
+
+static btk::Acquisition::Pointer HashAcquisition()
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(3, 100, 4, 2);
+  for (int i = 0 ; i < 3 ; ++i)
+    acq->GetPoint(i)->GetValues().setConstant(static_cast<double>(i));
+  for (int i = 0 ; i < 4 ; ++i)
+    acq->GetAnalog(i)->GetValues().setLinSpaced(-1.0, static_cast<double>(i));
+  acq->AppendEvent(btk::Event::New("FS", 1.2, "Left"));
+  return acq;
+};
+
+CXXTEST_SUITE(HashTest)
+{
+  CXXTEST_TEST(Reference)
+  {
+    btk::Hash hash;
+    TS_ASSERT_EQUALS(btk::Hash::ToString(hash.GetValue()), "00000000000000000000000000000000");
+    hash.Add("hello", 5);
+    TS_ASSERT_EQUALS(btk::Hash::ToString(hash.GetValue()), "5b1e906a48ae1d19cbd8a7b341bd9b02");
+    hash.Reset();
+    TS_ASSERT_EQUALS(hash.GetValue(), btk::Hash::Value());
+  };
+
+  CXXTEST_TEST(Incremental)
+  {
+    std::vector<unsigned char> data(1000);
+    for (size_t i = 0 ; i < data.size() ; ++i)
+      data[i] = static_cast<unsigned char>(rand());
+    btk::Hash h1, h2;
+    h1.Add(&(data[0]), data.size());
+    size_t pos = 0, step = 0;
+    while (pos < data.size())
+    {
+      size_t num = (std::min)(data.size() - pos, step++ % 37);
+      h2.Add(&(data[pos]), num);
+      pos += num;
+      if (pos == 500)
+        TS_ASSERT_DIFFERS(h1.GetValue(), h2.GetValue());
+    }
+    TS_ASSERT_EQUALS(h1.GetValue(), h2.GetValue());
+    h1.Reset(); h1.Add(std::string("ab")); h1.Add(std::string("c"));
+    h2.Reset(); h2.Add(std::string("a")); h2.Add(std::string("bc"));
+    TS_ASSERT_DIFFERS(h1.GetValue(), h2.GetValue());
+  };
+
+  CXXTEST_TEST(Matrix)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> m = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Random(600,4);
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> b = m.block(1,1,598,2);
+    btk::Hash h1, h2, h3;
+    h1.AddMatrix(b);
+    h2.AddMatrix(m.block(1,1,598,2));
+    TS_ASSERT_EQUALS(h1.GetValue(), h2.GetValue());
+    h3.AddMatrix(Eigen::Map<Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> >(b.data(), 2, 598)); // Same coefficients, other shape
+    TS_ASSERT_DIFFERS(h1.GetValue(), h3.GetValue());
+    Eigen::Matrix<double,Eigen::Dynamic,1> v = m.row(2).transpose();
+    h1.Reset(); h1.AddMatrix(v);
+    h2.Reset(); h2.AddMatrix(Eigen::Map<Eigen::Matrix<double,Eigen::Dynamic,1>, 0, Eigen::InnerStride<> >(m.data() + 2, 4, Eigen::InnerStride<>(600)));
+    TS_ASSERT_EQUALS(h1.GetValue(), h2.GetValue());
+  };
+
+  CXXTEST_TEST(ContentHash)
+  {
+    btk::Acquisition::Pointer acq = HashAcquisition();
+    btk::Hash::Value d1, d2, d3;
+    TS_ASSERT_EQUALS(acq->GetContentHash(&d1), true);
+    TS_ASSERT_EQUALS(HashAcquisition()->GetContentHash(&d2), true);
+    TS_ASSERT_EQUALS(d1, d2);
+    TS_ASSERT_EQUALS(acq->Clone()->GetContentHash(&d2), true);
+    TS_ASSERT_EQUALS(d1, d2);
+    // One channel modified
+    btk::Analog::Values values = acq->GetAnalog(2)->GetValues();
+    acq->GetAnalog(2)->SetValues(values * 2.0);
+    acq->GetContentHash(&d2);
+    TS_ASSERT_DIFFERS(d1, d2);
+    acq->GetAnalog(2)->SetValues(values);
+    acq->GetContentHash(&d2);
+    TS_ASSERT_EQUALS(d1, d2);
+    // The digest of a channel is cached with its timestamp
+    acq->GetPoint(1)->GetValues().coeffRef(10,1) = 5.0;
+    acq->GetContentHash(&d2);
+    TS_ASSERT_EQUALS(d1, d2);
+    acq->GetPoint(1)->Modified();
+    acq->GetContentHash(&d2);
+    TS_ASSERT_DIFFERS(d1, d2);
+    acq->GetEvent(0)->SetTime(1.3);
+    acq->GetContentHash(&d3);
+    TS_ASSERT_DIFFERS(d2, d3);
+    // Collection with null items
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    analogs->SetItemNumber(2);
+    TS_ASSERT_EQUALS(analogs->GetContentHash(&d1), true);
+    btk::Hash hash;
+    TS_ASSERT_EQUALS(analogs->HashContent(&hash), true);
+  };
+
+  CXXTEST_TEST(ContentHashStorageForm)
+  {
+    // Values exactly stored in single precision and with raw samples.
+    btk::Acquisition::Pointer acq = HashAcquisition();
+    for (int i = 0 ; i < 4 ; ++i)
+      acq->GetAnalog(i)->GetValues().setConstant(0.25 * i);
+    btk::Hash::Value d1, d2;
+    acq->GetContentHash(&d1);
+    acq->SetStoragePrecision(btk::Acquisition::SinglePrecision);
+    TS_ASSERT(acq->GetPoint(2)->GetData()->IsSinglePrecision());
+    acq->GetContentHash(&d2);
+    TS_ASSERT_EQUALS(d1, d2);
+    acq->GetAnalog(1)->GetData()->SetRawStorage(0.0, 0.25);
+    TS_ASSERT(acq->GetAnalog(1)->GetData()->IsRaw());
+    acq->GetContentHash(&d2);
+    TS_ASSERT_EQUALS(d1, d2);
+    TS_ASSERT_EQUALS(HashAcquisition()->GetContentHash(&d2), true);
+    TS_ASSERT_DIFFERS(d1, d2);
+  };
+  
+  CXXTEST_TEST(StructuralFingerprint)
+  {
+    btk::Acquisition::Pointer acq1 = HashAcquisition();
+    btk::Acquisition::Pointer acq2 = HashAcquisition();
+    acq2->GetPoint(0)->SetValues(acq2->GetPoint(0)->GetValues() * 3.0);
+    acq2->ClearEvents();
+    btk::Hash::Value d1, d2;
+    acq1->GetContentHash(&d1);
+    acq2->GetContentHash(&d2);
+    TS_ASSERT_DIFFERS(d1, d2);
+    TS_ASSERT_EQUALS(acq1->GetStructuralFingerprint(), acq2->GetStructuralFingerprint());
+    acq2->GetAnalog(3)->SetUnit("N");
+    TS_ASSERT_DIFFERS(acq1->GetStructuralFingerprint(), acq2->GetStructuralFingerprint());
+    acq2->GetAnalog(3)->SetUnit("V");
+    TS_ASSERT_EQUALS(acq1->GetStructuralFingerprint(), acq2->GetStructuralFingerprint());
+    acq2->ResizeFrameNumber(101);
+    TS_ASSERT_DIFFERS(acq1->GetStructuralFingerprint(), acq2->GetStructuralFingerprint());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(HashTest)
+CXXTEST_TEST_REGISTRATION(HashTest, Reference)
+CXXTEST_TEST_REGISTRATION(HashTest, Incremental)
+CXXTEST_TEST_REGISTRATION(HashTest, Matrix)
+CXXTEST_TEST_REGISTRATION(HashTest, ContentHash)
+CXXTEST_TEST_REGISTRATION(HashTest, ContentHashStorageForm)
+CXXTEST_TEST_REGISTRATION(HashTest, StructuralFingerprint)
+#endif
@@ -265,6 +265,92 @@ CXXTEST_SUITE(IMUsExtractorTest)
     output->Update();
     TS_ASSERT_EQUALS(output->GetItemNumber(), 0);
   }
+  
+  CXXTEST_TEST(CalibrationMatrix_ThreeSensors)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,50,18);
+    for (int i = 0 ; i < 18 ; ++i)
+      acq->GetAnalog(i)->GetValues().setRandom();
+    btk::MetaData::Pointer imu = btk::MetaDataCreateChild(acq->GetMetaData(), "IMU");
+    btk::MetaDataCreateChild(imu, "USED", (int16_t)3);
+    btk::MetaDataCreateChild(imu, "TYPE", std::vector<int16_t>(3,2));
+    std::vector<int16_t> channels(18);
+    for (int i = 0 ; i < 18 ; ++i)
+      channels[i] = i + 1;
+    btk::MetaDataCreateChild(imu, "CHANNEL", channels, 6);
+    // Different full calibration matrix for each sensor (stored column by column, one after the other).
+    std::vector<float> calibration(3*36);
+    for (int i = 0 ; i < 3*36 ; ++i)
+      calibration[i] = static_cast<float>((i % 7) + 1) * 0.25f + static_cast<float>(i / 36);
+    btk::MetaDataCreateChild(imu, "CAL_MATRIX", calibration, 36);
+    
+    btk::IMUsExtractor::Pointer imuse = btk::IMUsExtractor::New();
+    imuse->SetInput(acq);
+    imuse->Update();
+    btk::IMUCollection::Pointer output = imuse->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 3);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      Eigen::Matrix<double,6,6> cal;
+      for (int j = 0 ; j < 36 ; ++j)
+        cal.data()[j] = calibration[i*36 + j];
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(i)->GetCalMatrix(), cal, 1e-15);
+      for (int j = 0 ; j < 6 ; ++j)
+      {
+        btk::Analog::Values ref = btk::Analog::Values::Zero(50);
+        for (int k = 0 ; k < 6 ; ++k)
+          ref += cal(j,k) * acq->GetAnalog(i*6+k)->GetValues();
+        TS_ASSERT_EIGEN_DELTA(output->GetItem(i)->GetChannel(j)->GetValues(), ref, 1e-10);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(CalibrationMatrix_Threads)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,200,48);
+    for (int i = 0 ; i < 48 ; ++i)
+      acq->GetAnalog(i)->GetValues().setRandom();
+    btk::MetaData::Pointer imu = btk::MetaDataCreateChild(acq->GetMetaData(), "IMU");
+    btk::MetaDataCreateChild(imu, "USED", (int16_t)8);
+    btk::MetaDataCreateChild(imu, "TYPE", std::vector<int16_t>(8,2));
+    std::vector<int16_t> channels(48);
+    for (int i = 0 ; i < 48 ; ++i)
+      channels[i] = i + 1;
+    btk::MetaDataCreateChild(imu, "CHANNEL", channels, 6);
+    std::vector<float> calibration(8*36, 0.0f);
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      for (int j = 0 ; j < 6 ; ++j)
+        calibration[i*36 + j*7] = static_cast<float>(i + 1);
+      calibration[i*36 + 1] = 0.5f;
+    }
+    btk::MetaDataCreateChild(imu, "CAL_MATRIX", calibration, 36);
+    
+    btk::IMUsExtractor::Pointer imuse = btk::IMUsExtractor::New();
+    imuse->SetInput(acq);
+    imuse->Update();
+    btk::IMUCollection::Pointer reference = imuse->GetOutput()->Clone();
+    imuse->SetThreadNumber(4);
+    acq->Modified();
+    imuse->Update();
+    btk::IMUCollection::Pointer output = imuse->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 8);
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      TS_ASSERT_EQUALS(output->GetItem(i)->GetType(), 2);
+      TS_ASSERT_EQUALS(output->GetItem(i)->GetChannelNumber(), 6);
+      for (int j = 0 ; j < 6 ; ++j)
+      {
+        TS_ASSERT(output->GetItem(i)->GetChannel(j)->GetValues() == reference->GetItem(i)->GetChannel(j)->GetValues());
+      }
+      // Diagonal calibration matrix, except the second row (accelerometer Y) using also the accelerometer X.
+      TS_ASSERT_DELTA(output->GetItem(i)->GetAccelerometerX()->GetValues()(10), (i + 1) * acq->GetAnalog(i*6)->GetValues()(10), 1e-10);
+      TS_ASSERT_DELTA(output->GetItem(i)->GetAccelerometerY()->GetValues()(10), (i + 1) * acq->GetAnalog(i*6+1)->GetValues()(10) + 0.5 * acq->GetAnalog(i*6)->GetValues()(10), 1e-10);
+      TS_ASSERT_DELTA(output->GetItem(i)->GetGyroscopeZ()->GetValues()(10), (i + 1) * acq->GetAnalog(i*6+5)->GetValues()(10), 1e-10);
+    }
+  };
 };
   
 CXXTEST_SUITE_REGISTRATION(IMUsExtractorTest)
@@ -277,5 +363,7 @@ CXXTEST_TEST_REGISTRATION(IMUsExtractorTest, OneAcquisition_MissingChannels)
 CXXTEST_TEST_REGISTRATION(IMUsExtractorTest, OneAcquisition_TwoSensors)
 CXXTEST_TEST_REGISTRATION(IMUsExtractorTest, TwoAcquisitions)
 CXXTEST_TEST_REGISTRATION(IMUsExtractorTest, TwoAcquisitions_NoIMU)
+CXXTEST_TEST_REGISTRATION(IMUsExtractorTest, CalibrationMatrix_ThreeSensors)
+CXXTEST_TEST_REGISTRATION(IMUsExtractorTest, CalibrationMatrix_Threads)
 
 #endif
\ No newline at end of file
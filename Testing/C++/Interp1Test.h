@@ -208,6 +208,146 @@ CXXTEST_SUITE(Interp1Test)
     for (int i = 0 ; i < yi_.rows() ; ++i)
       TS_ASSERT_DELTA(yi_.coeff(i), yi_.coeff(i), 1e-6);
   };
+  
+  CXXTEST_TEST(PchipXd_FixedMaxSize)
+  {
+    // Same slopes when the samples are stored on the stack
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(6), y(6);
+    Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 8, 1> x_(6), y_(6);
+    x << 1.0, 2.0, 4.0, 5.0, 6.0, 9.0;
+    y << -5.245373, -0.232714, -7.004030, 8.827446, 5.626890, -8.906643;
+    x_ = x; y_ = y;
+    btkEigen::PCHIP_interp< Eigen::Matrix<double, Eigen::Dynamic, 1> > pi(&x, &y);
+    btkEigen::PCHIP_interp< Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 8, 1> > pi_(&x_, &y_);
+    for (int i = 0 ; i < 6 ; ++i)
+      TS_ASSERT_EQUALS(pi.dk.coeff(i), pi_.dk.coeff(i));
+    TS_ASSERT_EQUALS(pi.interp(3.3), pi_.interp(3.3));
+  };
+  
+  CXXTEST_TEST(SplineXd)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(3), y(3), xi(5), yi;
+    x << 0.0, 1.0, 2.0;
+    y << 0.0, 1.0, 0.0;
+    xi << 0.0, 0.5, 1.0, 1.5, 2.0;
+    btkEigen::interp1().spline(&yi, x, y, xi);
+    
+    TS_ASSERT_EQUALS(yi.rows(), 5);
+    TS_ASSERT_DELTA(yi.coeff(0), 0.0, 1e-15);
+    TS_ASSERT_DELTA(yi.coeff(1), 0.6875, 1e-15);
+    TS_ASSERT_DELTA(yi.coeff(2), 1.0, 1e-15);
+    TS_ASSERT_DELTA(yi.coeff(3), 0.6875, 1e-15);
+    TS_ASSERT_DELTA(yi.coeff(4), 0.0, 1e-15);
+  };
+  
+  CXXTEST_TEST(SplineXd_Linear)
+  {
+    // Linear samples: null second derivatives
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(5), y(5), xi(4), yi;
+    x << 1.0, 2.0, 4.0, 5.0, 9.0;
+    y = 3.0 * x.array() - 2.0;
+    xi << 1.5, 3.0, 4.75, 8.0;
+    btkEigen::interp1().spline(&yi, x, y, xi);
+    
+    for (int i = 0 ; i < 4 ; ++i)
+      TS_ASSERT_DELTA(yi.coeff(i), 3.0 * xi.coeff(i) - 2.0, 1e-12);
+  };
+  
+  CXXTEST_TEST(LinearXd_UnsortedQueries)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(4), y(4), xi(6), xs(6), yi, ys;
+    x << 1.0, 2.0, 4.0, 8.0;
+    y << 3.0, -1.0, 5.0, 2.0;
+    xi << 7.0, 0.5, 2.0, 9.0, 3.25, 1.5;
+    xs << 0.5, 1.5, 2.0, 3.25, 7.0, 9.0;
+    btkEigen::interp1().linear(&yi, x, y, xi); // Bisection
+    btkEigen::interp1().linear(&ys, x, y, xs); // Sorted queries
+    
+    TS_ASSERT_DELTA(ys.coeff(0), 5.0, 1e-15); // Extrapolation
+    TS_ASSERT_DELTA(ys.coeff(1), 1.0, 1e-15);
+    TS_ASSERT_DELTA(ys.coeff(2), -1.0, 1e-15);
+    TS_ASSERT_DELTA(ys.coeff(3), 2.75, 1e-15);
+    TS_ASSERT_DELTA(ys.coeff(4), 2.75, 1e-15);
+    TS_ASSERT_DELTA(ys.coeff(5), 1.25, 1e-15); // Extrapolation
+    TS_ASSERT_EQUALS(yi.coeff(0), ys.coeff(4));
+    TS_ASSERT_EQUALS(yi.coeff(1), ys.coeff(0));
+    TS_ASSERT_EQUALS(yi.coeff(2), ys.coeff(2));
+    TS_ASSERT_EQUALS(yi.coeff(3), ys.coeff(5));
+    TS_ASSERT_EQUALS(yi.coeff(4), ys.coeff(3));
+    TS_ASSERT_EQUALS(yi.coeff(5), ys.coeff(1));
+  };
+  
+  CXXTEST_TEST(PchipXd_Columns)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(10), xi(27), yi;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Y(10,3), Yi;
+    x << 1.0, 2.0, 4.0, 5.0, 6.0, 7.0, 8.0, 10.0, 20.0, 25.0;
+    Y.col(0) << -5.245373, -0.232714, -7.004030, 8.827446, 5.626890, -8.906643, -4.271316, -2.599281, 1.940986, 1.202701;
+    Y.col(1) = Y.col(0).reverse();
+    Y.col(2) = x.cwiseProduct(x);
+    xi = Eigen::Matrix<double, Eigen::Dynamic, 1>::LinSpaced(27, 0.0, 26.0);
+    btkEigen::interp1().pchipColumns(&Yi, x, Y, xi);
+    
+    TS_ASSERT_EQUALS(Yi.rows(), 27);
+    TS_ASSERT_EQUALS(Yi.cols(), 3);
+    for (int c = 0 ; c < 3 ; ++c)
+    {
+      Eigen::Matrix<double, Eigen::Dynamic, 1> y = Y.col(c);
+      btkEigen::interp1().pchip(&yi, x, y, xi);
+      for (int i = 0 ; i < 27 ; ++i)
+        TS_ASSERT_EQUALS(Yi.coeff(i,c), yi.coeff(i));
+    }
+  };
+  
+  CXXTEST_TEST(LinearXd_Columns)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(5), xi(9), yi;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Y(5,2), Yi;
+    x << 0.0, 1.0, 1.0, 3.0, 4.0;
+    Y << 1.0, 2.0, 
+         3.0, -2.0, 
+         5.0, 0.5, 
+         -1.0, 7.0, 
+         2.0, 2.0;
+    xi << 4.5, 0.25, 1.0, 3.5, 2.0, 0.0, -1.0, 3.0, 0.75;
+    btkEigen::interp1().linearColumns(&Yi, x, Y, xi);
+    
+    TS_ASSERT_EQUALS(Yi.rows(), 9);
+    TS_ASSERT_EQUALS(Yi.cols(), 2);
+    for (int c = 0 ; c < 2 ; ++c)
+    {
+      Eigen::Matrix<double, Eigen::Dynamic, 1> y = Y.col(c);
+      btkEigen::interp1().linear(&yi, x, y, xi);
+      for (int i = 0 ; i < 9 ; ++i)
+        TS_ASSERT_EQUALS(Yi.coeff(i,c), yi.coeff(i));
+    }
+    TS_ASSERT_DELTA(Yi.coeff(1,0), 1.5, 1e-15);
+    TS_ASSERT_DELTA(Yi.coeff(4,1), 3.75, 1e-15);
+  };
+  
+  CXXTEST_TEST(LinearXd_TooShort)
+  {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> x(1), y(1), xi(3), yi;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Y(1,2), Yi;
+    x << 1.0;
+    y << 2.0;
+    Y << 2.0, 3.0;
+    xi << 0.0, 1.0, 2.0;
+    btkEigen::interp1().linear(&yi, x, y, xi);
+    TS_ASSERT_EQUALS(yi.rows(), 3);
+    TS_ASSERT((yi.array() != yi.array()).all()); // NaN
+    btkEigen::interp1().pchip(&yi, x, y, xi);
+    TS_ASSERT((yi.array() != yi.array()).all()); // NaN
+    btkEigen::interp1().spline(&yi, x, y, xi);
+    TS_ASSERT((yi.array() != yi.array()).all()); // NaN
+    btkEigen::interp1().linearColumns(&Yi, x, Y, xi);
+    TS_ASSERT_EQUALS(Yi.rows(), 3);
+    TS_ASSERT_EQUALS(Yi.cols(), 2);
+    TS_ASSERT((Yi.array() != Yi.array()).all()); // NaN
+    btkEigen::interp1().pchipColumns(&Yi, x, Y, xi);
+    TS_ASSERT_EQUALS(Yi.rows(), 3);
+    TS_ASSERT((Yi.array() != Yi.array()).all()); // NaN
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(Interp1Test)
@@ -218,5 +358,12 @@ CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_internals_condition)
 CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_internals)
 CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd)
 CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_bis)
+CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_FixedMaxSize)
+CXXTEST_TEST_REGISTRATION(Interp1Test, SplineXd)
+CXXTEST_TEST_REGISTRATION(Interp1Test, SplineXd_Linear)
+CXXTEST_TEST_REGISTRATION(Interp1Test, LinearXd_UnsortedQueries)
+CXXTEST_TEST_REGISTRATION(Interp1Test, PchipXd_Columns)
+CXXTEST_TEST_REGISTRATION(Interp1Test, LinearXd_Columns)
+CXXTEST_TEST_REGISTRATION(Interp1Test, LinearXd_TooShort)
 
 #endif // CumtrapzTest_h
\ No newline at end of file
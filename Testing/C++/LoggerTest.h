@@ -0,0 +1,117 @@
+#ifndef LoggerTest_h
+#define LoggerTest_h
+
+#include <btkLogger.h>
+#include <btkConvert.h>
+#include <btkThreadPool_p.h>
+
+#include <sstream>
+#include <vector>
+
+class LoggerRecords : public btk::Logger::Sink
+{
+public:
+  typedef btkSharedPtr<LoggerRecords> Pointer;
+  static Pointer New() {return Pointer(new LoggerRecords());};
+  virtual void Write(const btk::Logger::Record& record) {this->records.push_back(record);};
+  std::vector<btk::Logger::Record> records;
+private:
+  LoggerRecords() : btk::Logger::Sink(), records() {};
+};
+
+static void SendLoggerWarnings(void* data)
+{
+  const int id = *static_cast<int*>(data);
+  btk::Logger::Context context(btk::ToString(id));
+  for (int i = 0 ; i < 1000 ; ++i)
+    btk::Logger::Warning(btk::ToString(i));
+};
+
+CXXTEST_SUITE(LoggerTest)
+{
+  CXXTEST_TEST(Records)
+  {
+    LoggerRecords::Pointer sink = LoggerRecords::New();
+    btk::Logger::SetSink(sink);
+    btk::Logger::Warning("First");
+    {
+      btk::Logger::Context context("file.c3d");
+      btk::Logger::Error("Foo.cpp", 42, "Second");
+    }
+    btk::Logger::Warning("Third");
+    btk::Logger::SetSink(btk::Logger::Sink::Pointer());
+    btk::Logger::Warning("Not collected");
+    TS_ASSERT_EQUALS(sink->records.size(), 3u);
+    if (sink->records.size() == 3u)
+    {
+      TS_ASSERT_EQUALS(sink->records[0].level, btk::Logger::WarningLevel);
+      TS_ASSERT_EQUALS(sink->records[0].message, "First");
+      TS_ASSERT_EQUALS(sink->records[0].filename, "");
+      TS_ASSERT_EQUALS(sink->records[0].context, "");
+      TS_ASSERT_EQUALS(sink->records[1].level, btk::Logger::ErrorLevel);
+      TS_ASSERT_EQUALS(sink->records[1].filename, "Foo.cpp");
+      TS_ASSERT_EQUALS(sink->records[1].line, 42);
+      TS_ASSERT_EQUALS(sink->records[1].message, "Second");
+      TS_ASSERT_EQUALS(sink->records[1].context, "file.c3d");
+      TS_ASSERT_EQUALS(sink->records[1].repeated, 0);
+      TS_ASSERT_EQUALS(sink->records[2].context, "");
+    }
+  };
+  
+  CXXTEST_TEST(RepeatLimit)
+  {
+    std::ostringstream oss;
+    btk::Logger::VerboseMode mode = btk::Logger::GetVerboseMode();
+    btk::Logger::SetVerboseMode(btk::Logger::MessageOnly);
+    btk::Logger::SetWarningStream(&oss);
+    btk::Logger::SetRepeatLimit(2);
+    for (int i = 0 ; i < 10 ; ++i)
+      btk::Logger::Warning("Foo.cpp", 10, "Corrupted frame #" + btk::ToString(i));
+    btk::Logger::Warning("Foo.cpp", 20, "Other");
+    TS_ASSERT_EQUALS(oss.str(), "Corrupted frame #0\nCorrupted frame #1\nOther\n");
+    btk::Logger::Flush();
+    TS_ASSERT_EQUALS(oss.str(), "Corrupted frame #0\nCorrupted frame #1\nOther\nCorrupted frame #9 (repeated 8 times)\n");
+    // The counters are reset by the flush.
+    btk::Logger::Warning("Foo.cpp", 10, "Again");
+    btk::Logger::SetRepeatLimit(0);
+    btk::Logger::Flush();
+    btk::Logger::SetWarningStream(&std::cerr);
+    btk::Logger::SetVerboseMode(mode);
+    TS_ASSERT_EQUALS(oss.str(), "Corrupted frame #0\nCorrupted frame #1\nOther\nCorrupted frame #9 (repeated 8 times)\nAgain\n");
+  };
+  
+  CXXTEST_TEST(Asynchronous)
+  {
+    LoggerRecords::Pointer sink = LoggerRecords::New();
+    btk::Logger::SetSink(sink);
+    btk::Logger::SetAsynchronous(true);
+    {
+      btk::thread_pool_p pool(4);
+      btk::thread_pool_p::group g;
+      int ids[4] = {0, 1, 2, 3};
+      for (int i = 0 ; i < 4 ; ++i)
+        pool.Submit(&g, &SendLoggerWarnings, &(ids[i]));
+      pool.Wait(&g);
+    }
+    btk::Logger::Flush();
+    TS_ASSERT_EQUALS(sink->records.size(), 4000u);
+    // The messages of a thread are kept in order.
+    int next[4] = {0, 0, 0, 0};
+    bool ordered = true;
+    for (size_t i = 0 ; i < sink->records.size() ; ++i)
+    {
+      int id = btk::FromString<int>(sink->records[i].context);
+      ordered &= (btk::FromString<int>(sink->records[i].message) == next[id]++);
+    }
+    TS_ASSERT(ordered);
+    btk::Logger::SetAsynchronous(false);
+    TS_ASSERT_EQUALS(btk::Logger::IsAsynchronous(), false);
+    btk::Logger::SetSink(btk::Logger::Sink::Pointer());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(LoggerTest)
+CXXTEST_TEST_REGISTRATION(LoggerTest, Records)
+CXXTEST_TEST_REGISTRATION(LoggerTest, RepeatLimit)
+CXXTEST_TEST_REGISTRATION(LoggerTest, Asynchronous)
+#endif
@@ -0,0 +1,65 @@
+#ifndef MemoryArenaTest_h
+#define MemoryArenaTest_h
+
+#include <btkMemoryArena.h>
+#include <btkAcquisition.h>
+
+CXXTEST_SUITE(MemoryArenaTest)
+{
+  CXXTEST_TEST(Scope)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New(1024);
+    TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+    btk::Point::Pointer outside = btk::Point::New("OUT", 10);
+    {
+      btk::MemoryArena::Scope scope(arena);
+      TS_ASSERT_EQUALS(btk::MemoryArena::GetCurrent(), arena.get());
+      btk::Point::Pointer inside = btk::Point::New("IN", 10); // Point + Point::Data
+      btk::MetaDataInfo::Pointer info = btk::MetaDataInfo::New(std::string("C3D"));
+      TS_ASSERT_EQUALS(arena->GetObjectNumber(), 3);
+      {
+        btk::MemoryArena::Pointer none;
+        btk::MemoryArena::Scope heap(none);
+        TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+      }
+      TS_ASSERT_EQUALS(btk::MemoryArena::GetCurrent(), arena.get());
+    }
+    TS_ASSERT(btk::MemoryArena::GetCurrent() == 0);
+    TS_ASSERT_EQUALS(arena->GetObjectNumber(), 0);
+    TS_ASSERT_EQUALS(arena->GetChunkNumber(), 1u);
+    TS_ASSERT_EQUALS(outside->GetLabel(), "OUT");
+  };
+  
+  CXXTEST_TEST(LargeObject)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New(64);
+    btk::MemoryArena::Scope scope(arena);
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    TS_ASSERT(arena->GetObjectNumber() > 0);
+    TS_ASSERT(arena->GetAllocatedSize() > sizeof(btk::Acquisition));
+  };
+  
+  CXXTEST_TEST(AcquisitionClone)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(5, 20, 3, 2);
+    acq->SetMemoryArena(btk::MemoryArena::New());
+    btk::Acquisition::Pointer cloned = acq->Clone();
+    btk::MemoryArena::Pointer arena = acq->GetMemoryArena();
+    TS_ASSERT_EQUALS(cloned->GetMemoryArena(), arena);
+    TS_ASSERT(arena->GetObjectNumber() >= 5 * 2 + 3 * 2);
+    btk::Point::Pointer kept = cloned->GetPoint(2);
+    acq.reset();
+    cloned.reset();
+    arena.reset();
+    // The point keeps the memory of the arena.
+    TS_ASSERT_EQUALS(kept->GetFrameNumber(), 20);
+    kept.reset();
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MemoryArenaTest)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, Scope)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, LargeObject)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, AcquisitionClone)
+#endif // MemoryArenaTest_h
@@ -0,0 +1,112 @@
+#ifndef MemoryUsageTest_h
+#define MemoryUsageTest_h
+
+#include <btkMemoryUsage.h>
+#include <btkAcquisition.h>
+#include <btkAnalogBlock.h>
+#include <btkForcePlatformTypes.h>
+#include <btkTriangleMesh.h>
+
+#include <sstream>
+
+CXXTEST_SUITE(MemoryUsageTest)
+{
+  CXXTEST_TEST(Components)
+  {
+    btk::MemoryUsage usage;
+    TS_ASSERT_EQUALS(usage.GetTotal(), 0u);
+    usage.Add(btk::MemoryUsage::Values, 100);
+    usage.Add(btk::MemoryUsage::Strings, 20);
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), 100u);
+    TS_ASSERT_EQUALS(usage.GetTotal(), 120u);
+    int buffer = 0;
+    TS_ASSERT_EQUALS(usage.AddShared(btk::MemoryUsage::Values, &buffer, 50), true);
+    TS_ASSERT_EQUALS(usage.AddShared(btk::MemoryUsage::Values, &buffer, 50), false);
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), 150u);
+    std::ostringstream oss;
+    usage.Print(oss);
+    TS_ASSERT(oss.str().find("Values") != std::string::npos);
+    TS_ASSERT(oss.str().find("Total") != std::string::npos);
+    TS_ASSERT_EQUALS(std::string(btk::MemoryUsage::GetComponentName(btk::MemoryUsage::Calibrations)), "Calibrations");
+    usage.Clear();
+    TS_ASSERT_EQUALS(usage.GetTotal(), 0u);
+    TS_ASSERT_EQUALS(usage.AddShared(btk::MemoryUsage::Values, &buffer, 50), true);
+  };
+
+  CXXTEST_TEST(Acquisition)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(3, 100, 4, 2);
+    btk::MemoryUsage usage = acq->GetMemoryUsage();
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), (3 * 100 * 3 + 4 * 200) * sizeof(double));
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Residuals), 3 * 100 * sizeof(double));
+    TS_ASSERT(usage.Get(btk::MemoryUsage::Objects) > 7 * (sizeof(btk::Point) + sizeof(btk::Point::Data)) / 2);
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Calibrations), 0u);
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Meshes), 0u);
+    size_t metaData = usage.Get(btk::MemoryUsage::MetaData);
+    acq->GetMetaData()->AppendChild(btk::MetaData::New("POINT"));
+    acq->GetMetaData()->GetChild(0)->AppendChild(btk::MetaData::New("LABELS", std::vector<std::string>(3, "uname*")));
+    TS_ASSERT(acq->GetMetaData()->GetMemoryUsage().Get(btk::MemoryUsage::MetaData) > 3 * sizeof(btk::MetaData));
+    TS_ASSERT(acq->GetMemoryUsage().Get(btk::MemoryUsage::MetaData) > metaData);
+    // Same number of bytes for a clone
+    TS_ASSERT_EQUALS(acq->Clone()->GetMemoryUsage().GetTotal(), acq->GetMemoryUsage().GetTotal());
+  };
+
+  CXXTEST_TEST(StoragePrecision)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->SetStoragePrecision(btk::Acquisition::SinglePrecision);
+    acq->Init(3, 100, 4, 2);
+    btk::MemoryUsage usage = acq->GetMemoryUsage();
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), (3 * 100 * 3 + 4 * 200) * sizeof(float));
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Residuals), 3 * 100 * sizeof(float));
+    acq->SetStoragePrecision(btk::Acquisition::RawPrecision);
+    for (int i = 0 ; i < 4 ; ++i)
+      acq->GetAnalog(i)->GetData()->SetRawStorage(0.0, 0.25);
+    usage = acq->GetMemoryUsage();
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), 3 * 100 * 3 * sizeof(float) + 4 * 200 * sizeof(int16_t));
+    // Expanded when the values are accessed
+    acq->GetPoint(0)->GetValues();
+    TS_ASSERT(acq->GetMemoryUsage().Get(btk::MemoryUsage::Values) > usage.Get(btk::MemoryUsage::Values));
+  };
+
+  CXXTEST_TEST(SharedBuffers)
+  {
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 3 ; ++i)
+      analogs->InsertItem(btk::Analog::New(10));
+    btk::AnalogBlock::Pointer block = btk::AnalogBlock::Pack(analogs);
+    TS_ASSERT_EQUALS(analogs->GetMemoryUsage().Get(btk::MemoryUsage::Values), sizeof(btk::AnalogBlock) + 3 * 10 * sizeof(double));
+    // The same channel inserted twice is counted once
+    size_t objects = analogs->GetMemoryUsage().Get(btk::MemoryUsage::Objects);
+    analogs->InsertItem(analogs->GetItem(0));
+    btk::MemoryUsage usage = analogs->GetMemoryUsage();
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), sizeof(btk::AnalogBlock) + 3 * 10 * sizeof(double));
+    TS_ASSERT(usage.Get(btk::MemoryUsage::Objects) < objects + sizeof(btk::Analog));
+  };
+
+  CXXTEST_TEST(ForcePlatformAndMesh)
+  {
+    btk::ForcePlatformType2::Pointer pf = btk::ForcePlatformType2::New();
+    btk::MemoryUsage usage = pf->GetMemoryUsage();
+    TS_ASSERT(usage.Get(btk::MemoryUsage::Calibrations) >= (4 * 3 + 3 + 6 * 6) * sizeof(double));
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Values), 0u);
+
+    std::vector<int> m(5);
+    for (int i = 0 ; i < 5 ; ++i)
+      m[i] = i;
+    std::vector<btk::TriangleMesh::VertexLink> l;
+    btk::TriangleMesh::Pointer mesh = btk::TriangleMesh::New(m,l);
+    usage = mesh->GetMemoryUsage();
+    TS_ASSERT(usage.Get(btk::MemoryUsage::Meshes) > 0u);
+    TS_ASSERT_EQUALS(usage.Get(btk::MemoryUsage::Objects), sizeof(btk::TriangleMesh));
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MemoryUsageTest)
+CXXTEST_TEST_REGISTRATION(MemoryUsageTest, Components)
+CXXTEST_TEST_REGISTRATION(MemoryUsageTest, Acquisition)
+CXXTEST_TEST_REGISTRATION(MemoryUsageTest, StoragePrecision)
+CXXTEST_TEST_REGISTRATION(MemoryUsageTest, SharedBuffers)
+CXXTEST_TEST_REGISTRATION(MemoryUsageTest, ForcePlatformAndMesh)
+#endif
@@ -1868,6 +1868,43 @@ CXXTEST_SUITE(MergeAcquisitionFilterTest)
         TS_ASSERT_DELTA(output->GetAnalog(j)->GetValues().coeff(i), acq->GetAnalog(j)->GetValues().coeff(i), 1e-5);
       }   
     }
+  };  
+  CXXTEST_TEST(TwoInputsFromScratch_Resampling)
+  {
+    btk::Acquisition::Pointer i1 = btk::Acquisition::New();
+    i1->Init(2, 100, 1, 2);
+    i1->SetPointFrequency(100.0);
+    
+    btk::Acquisition::Pointer i2 = btk::Acquisition::New();
+    i2->Init(3, 50, 2, 4);
+    i2->SetPointFrequency(50.0);
+    i2->GetPoint(0)->SetLabel("Foo");
+    i2->GetPoint(0)->GetValues().setConstant(2.0);
+    i2->GetPoint(0)->GetResiduals().setZero();
+    i2->GetAnalog(1)->GetValues().setConstant(-3.0);
+    
+    btk::MergeAcquisitionFilter::Pointer merger = btk::MergeAcquisitionFilter::New();
+    merger->SetInput(0, i1);
+    merger->SetInput(1, i2);
+    merger->Update();
+    btk::Acquisition::Pointer output = merger->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 1);
+    
+    merger->SetResampling(true);
+    merger->Update();
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(output->GetNumberAnalogSamplePerFrame(), 2);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 5);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 3);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 100);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 200);
+    TS_ASSERT_EQUALS(output->GetPoint(2)->GetLabel(), "Foo");
+    TS_ASSERT_DELTA(output->GetPoint(2)->GetValues()(50,1), 2.0, 1e-10);
+    TS_ASSERT_DELTA(output->GetAnalog(2)->GetValues()(100), -3.0, 1e-2);
+    // The input is not modified
+    TS_ASSERT_EQUALS(i2->GetPointFrequency(), 50.0);
+    TS_ASSERT_EQUALS(i2->GetPointFrameNumber(), 50);
   };
 };
 
@@ -1904,4 +1941,5 @@ CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, C3D_Reconstructed_From_CAL
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, C3D_Reconstructed_From_ANC_CAL_TRC)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, SH01_C3D_ANC_FP)
 CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, Merge_Run4)
+CXXTEST_TEST_REGISTRATION(MergeAcquisitionFilterTest, TwoInputsFromScratch_Resampling)
 #endif
@@ -3,6 +3,11 @@
 
 #include <btkDataObject.h>
 #include <btkProcessObject.h>
+#include <btkPipelineExecutor.h>
+#include <btkException.h>
+#include <btkThreadPool_p.h>
+
+#include <algorithm>
 
 class Source : public btk::DataObject
 {
@@ -59,6 +64,112 @@ private:
   int m_Inc;
 };
 
+class Adder : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<Adder> Pointer;
+  static Pointer New(int inputNumber) {return Pointer(new Adder(inputNumber));}; 
+  void SetInput(int idx, Source::Pointer input) {this->SetNthInput(idx, input);};
+  Source::Pointer GetOutput() {return static_pointer_cast<Source>(this->GetNthOutput(0));};
+  int GetGenerationNumber() const {return this->m_Generation;};
+  void SetFailure(bool failure) {this->m_Failure = failure; this->Modified();};
+  void SetPadding(int padding) {this->m_Padding = padding; this->Modified();};
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */)
+  {
+    return Source::New();
+  };
+  virtual void GenerateData()
+  {
+    ++this->m_Generation;
+    if (this->m_Failure)
+      throw std::runtime_error("Adder failure");
+    int sum = 1;
+    for (int i = 0 ; i < this->GetInputNumber() ; ++i)
+      sum += static_pointer_cast<Source>(this->GetNthInput(i))->GetValue();
+    this->GetOutput()->SetValue(sum);
+  };
+  virtual int GetRequestedRegionPadding() const {return this->m_Padding;};
+  
+private:
+  Adder(int inputNumber)
+  : btk::ProcessObject()
+  {
+    this->SetInputNumber(inputNumber);
+    this->SetOutputNumber(1);
+    this->m_Generation = 0;
+    this->m_Failure = false;
+    this->m_Padding = 0;
+  };
+  
+  int m_Generation;
+  bool m_Failure;
+  int m_Padding;
+};
+
+struct LoopBody
+{
+  void operator()(int i)
+  {
+    if (i == this->failure)
+      throw std::runtime_error("Loop failure");
+    double sum = 0.0;
+    for (int j = 0 ; j <= i ; ++j)
+      sum += static_cast<double>(j);
+    (*this->values)[i] = sum;
+  };
+  std::vector<double>* values;
+  int failure;
+};
+
+class Looper : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<Looper> Pointer;
+  static Pointer New() {return Pointer(new Looper());};
+  std::vector<double> Run(int num, int failure = -1)
+  {
+    std::vector<double> values(num, -1.0);
+    LoopBody body = {&values, failure};
+    this->ParallelFor(num, body);
+    return values;
+  };
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */) {return Source::New();};
+  virtual void GenerateData() {};
+  
+private:
+  Looper() : btk::ProcessObject() {};
+};
+
+static void UpdateSource(void* data)
+{
+  static_cast<Source*>(data)->Update();
+};
+
+// Node of a binary tree of tasks: each task submits its children in the same group before finishing its work.
+struct NestedTask
+{
+  btk::thread_pool_p* pool;
+  btk::thread_pool_p::group* group;
+  std::vector<NestedTask>* nodes;
+  std::vector<int>* done;
+  int index;
+};
+
+static void RunNestedTask(void* data)
+{
+  NestedTask* task = static_cast<NestedTask*>(data);
+  for (int i = 2 * task->index + 1 ; (i <= 2 * task->index + 2) && (i < static_cast<int>(task->nodes->size())) ; ++i)
+    task->pool->Submit(task->group, &RunNestedTask, &((*task->nodes)[i]));
+  double sum = 0.0;
+  for (int j = 0 ; j < 1000 ; ++j)
+    sum += static_cast<double>(j);
+  (*task->done)[task->index] = (sum > 0.0) ? 1 : -1;
+};
+
 CXXTEST_SUITE(PipelineTest)
 {
   CXXTEST_TEST(PipelineOne)
@@ -164,6 +275,224 @@ CXXTEST_SUITE(PipelineTest)
     TS_ASSERT_EQUALS(res1->GetValue(), 11);
     TS_ASSERT_EQUALS(res2->GetValue(), 13);
   };
+  
+  CXXTEST_TEST(ParallelExecutor)
+  {
+    // Diamond: src -> a -> (b, c) -> d
+    Source::Pointer src = Source::New();
+    src->SetValue(5);
+    Adder::Pointer a = Adder::New(1), b = Adder::New(1), c = Adder::New(1), d = Adder::New(2);
+    a->SetInput(0, src);
+    b->SetInput(0, a->GetOutput());
+    c->SetInput(0, a->GetOutput());
+    d->SetInput(0, b->GetOutput());
+    d->SetInput(1, c->GetOutput());
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New(4);
+    executor->Update(d->GetOutput());
+    TS_ASSERT_EQUALS(a->GetOutput()->GetValue(), 6);
+    TS_ASSERT_EQUALS(b->GetOutput()->GetValue(), 7);
+    TS_ASSERT_EQUALS(d->GetOutput()->GetValue(), 15);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 1);
+    executor->Update(d);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 1);
+    src->SetValue(6);
+    executor->Update(d);
+    TS_ASSERT_EQUALS(d->GetOutput()->GetValue(), 17);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(c->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 2);
+    // Only the modified branch is updated.
+    b->SetFailure(false);
+    executor->Update(d);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 3);
+    TS_ASSERT_EQUALS(c->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 3);
+    // Same results than the sequential update
+    src->SetValue(10);
+    d->Update();
+    TS_ASSERT_EQUALS(d->GetOutput()->GetValue(), 25);
+  };
+  
+  CXXTEST_TEST(ParallelExecutorCycle)
+  {
+    Source::Pointer src = Source::New();
+    src->SetValue(5);
+    Filter::Pointer incFilt = Filter::New();
+    incFilt->SetInput(src);
+    Source::Pointer res = incFilt->GetOutput();
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New(2);
+    executor->Update(res);
+    TS_ASSERT_EQUALS(res->GetValue(), 6);
+    incFilt->SetInput(res);
+    executor->Update(res);
+    TS_ASSERT_EQUALS(res->GetValue(), 7);
+    executor->Update(incFilt);
+    TS_ASSERT_EQUALS(res->GetValue(), 8);
+  };
+  
+  CXXTEST_TEST(ParallelExecutorException)
+  {
+    Source::Pointer src = Source::New();
+    Adder::Pointer a = Adder::New(1), b = Adder::New(1);
+    a->SetInput(0, src);
+    b->SetInput(0, a->GetOutput());
+    a->SetFailure(true);
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New(2);
+    TS_ASSERT_THROWS(executor->Update(b), btk::RuntimeError);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 0);
+    a->SetFailure(false);
+    executor->Update(b);
+    TS_ASSERT_EQUALS(b->GetOutput()->GetValue(), 2);
+  };
+  
+  CXXTEST_TEST(ParallelFor)
+  {
+    Looper::Pointer looper = Looper::New();
+    TS_ASSERT_EQUALS(looper->GetThreadNumber(), 1);
+    std::vector<double> reference = looper->Run(1000);
+    for (int i = 0 ; i < 1000 ; ++i)
+      TS_ASSERT_EQUALS(reference[i], i * (i + 1) / 2.0);
+    looper->SetThreadNumber(4);
+    TS_ASSERT_EQUALS(looper->GetThreadNumber(), 4);
+    TS_ASSERT(looper->Run(1000) == reference);
+    TS_ASSERT(looper->Run(3) == std::vector<double>(reference.begin(), reference.begin() + 3));
+    TS_ASSERT(looper->Run(0).empty());
+    looper->SetThreadNumber(0);
+    TS_ASSERT_EQUALS(looper->GetThreadNumber(), btk::thread_pool_p::GetHardwareConcurrency());
+    TS_ASSERT(looper->Run(1000) == reference);
+    // The other iterations are finished before the exception is thrown.
+    looper->SetThreadNumber(4);
+    TS_ASSERT_THROWS(looper->Run(1000, 500), btk::RuntimeError);
+    try
+    {
+      looper->Run(1000, 10);
+    }
+    catch (btk::RuntimeError& e)
+    {
+      TS_ASSERT_EQUALS(std::string(e.what()), "Loop failure");
+    }
+  };
+  
+  CXXTEST_TEST(ConcurrentUpdate)
+  {
+    // Several threads update at the same time some pipelines sharing the same upstream processes.
+    Source::Pointer src = Source::New();
+    src->SetValue(1);
+    Adder::Pointer a = Adder::New(1), b = Adder::New(1);
+    a->SetInput(0, src);
+    b->SetInput(0, a->GetOutput());
+    std::vector<Adder::Pointer> branches(16);
+    for (size_t i = 0 ; i < branches.size() ; ++i)
+    {
+      branches[i] = Adder::New(1);
+      branches[i]->SetInput(0, b->GetOutput());
+    }
+    btk::thread_pool_p pool(4);
+    for (int j = 0 ; j < 3 ; ++j)
+    {
+      src->SetValue(j);
+      btk::thread_pool_p::group g;
+      for (size_t i = 0 ; i < branches.size() ; ++i)
+        pool.Submit(&g, &UpdateSource, branches[i]->GetOutput().get());
+      pool.Wait(&g);
+      TS_ASSERT_EQUALS(a->GetGenerationNumber(), j + 1);
+      TS_ASSERT_EQUALS(b->GetGenerationNumber(), j + 1);
+      for (size_t i = 0 ; i < branches.size() ; ++i)
+      {
+        TS_ASSERT_EQUALS(branches[i]->GetGenerationNumber(), j + 1);
+        TS_ASSERT_EQUALS(branches[i]->GetOutput()->GetValue(), j + 3);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(RequestedRegion)
+  {
+    Source::Pointer src = Source::New();
+    Adder::Pointer a = Adder::New(1), b = Adder::New(1);
+    a->SetInput(0, src);
+    a->SetPadding(2);
+    b->SetInput(0, a->GetOutput());
+    b->GetOutput()->SetRequestedRegion(10, 20);
+    b->Update();
+    TS_ASSERT_EQUALS(a->GetOutput()->GetRequestedFirstFrame(), 10);
+    TS_ASSERT_EQUALS(a->GetOutput()->GetRequestedLastFrame(), 20);
+    TS_ASSERT_EQUALS(src->GetRequestedFirstFrame(), 8);
+    TS_ASSERT_EQUALS(src->GetRequestedLastFrame(), 22);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 1);
+    // Region already generated
+    b->GetOutput()->SetRequestedRegion(12, 18);
+    b->Update();
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 1);
+    // Larger region
+    b->GetOutput()->SetRequestedRegion(5, 20);
+    b->Update();
+    TS_ASSERT_EQUALS(src->GetRequestedFirstFrame(), 3);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 2);
+    // All the frames
+    b->GetOutput()->ResetRequestedRegion();
+    b->Update();
+    TS_ASSERT_EQUALS(src->HasRequestedRegion(), false);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 3);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 3);
+    b->GetOutput()->SetRequestedRegion(10, 20);
+    b->Update();
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 3);
+    TS_ASSERT_EQUALS(b->GetGenerationNumber(), 3);
+  };
+  
+  CXXTEST_TEST(ParallelExecutorRequestedRegion)
+  {
+    // The output of 'a' is used by 'b' and 'c' which need a different number of surrounding frames.
+    Source::Pointer src = Source::New();
+    Adder::Pointer a = Adder::New(1), b = Adder::New(1), c = Adder::New(1), d = Adder::New(2);
+    a->SetInput(0, src);
+    b->SetInput(0, a->GetOutput());
+    b->SetPadding(1);
+    c->SetInput(0, a->GetOutput());
+    c->SetPadding(3);
+    d->SetInput(0, b->GetOutput());
+    d->SetInput(1, c->GetOutput());
+    d->GetOutput()->SetRequestedRegion(10, 20);
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New(4);
+    executor->Update(d);
+    TS_ASSERT_EQUALS(a->GetOutput()->GetRequestedFirstFrame(), 7);
+    TS_ASSERT_EQUALS(a->GetOutput()->GetRequestedLastFrame(), 23);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 1);
+    executor->Update(d);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 1);
+    d->GetOutput()->ResetRequestedRegion();
+    executor->Update(d);
+    TS_ASSERT_EQUALS(a->GetOutput()->HasRequestedRegion(), false);
+    TS_ASSERT_EQUALS(a->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(d->GetGenerationNumber(), 2);
+  };
+  
+  CXXTEST_TEST(ThreadPoolNestedSubmit)
+  {
+    // The tasks submitted by a running task are counted in the group before being available to the other threads.
+    btk::thread_pool_p pool(4);
+    for (int k = 0 ; k < 200 ; ++k)
+    {
+      btk::thread_pool_p::group group;
+      std::vector<NestedTask> nodes(255);
+      std::vector<int> done(nodes.size(), 0);
+      for (int i = 0 ; i < static_cast<int>(nodes.size()) ; ++i)
+      {
+        NestedTask node = {&pool, &group, &nodes, &done, i};
+        nodes[i] = node;
+      }
+      pool.Submit(&group, &RunNestedTask, &(nodes[0]));
+      pool.Wait(&group);
+      TS_ASSERT(std::count(done.begin(), done.end(), 1) == static_cast<int>(done.size()));
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(PipelineTest)
@@ -172,4 +501,12 @@ CXXTEST_TEST_REGISTRATION(PipelineTest, PipelineTwo)
 CXXTEST_TEST_REGISTRATION(PipelineTest, PipelineThree)
 CXXTEST_TEST_REGISTRATION(PipelineTest, DeleteParent)
 CXXTEST_TEST_REGISTRATION(PipelineTest, NewInput)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ParallelExecutor)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ParallelExecutorCycle)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ParallelExecutorException)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ParallelFor)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ConcurrentUpdate)
+CXXTEST_TEST_REGISTRATION(PipelineTest, RequestedRegion)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ParallelExecutorRequestedRegion)
+CXXTEST_TEST_REGISTRATION(PipelineTest, ThreadPoolNestedSubmit)
 #endif
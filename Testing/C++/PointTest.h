@@ -109,6 +109,93 @@ CXXTEST_SUITE(PointTest)
     TS_ASSERT_EQUALS(data[8], 0.0);
     TS_ASSERT_EQUALS(data[10], 0.0);
   };
+  
+  CXXTEST_TEST(DataSinglePrecision)
+  {
+    btk::Point::Pointer test = btk::Point::New(5);
+    test->SetValues(btk::Point::Values::Random(5,3));
+    test->SetResiduals(btk::Point::Residuals::Constant(5,1,0.5));
+    btk::Point::Values ref = test->GetValues();
+    test->GetData()->SetSinglePrecision(true);
+    TS_ASSERT(test->GetData()->IsSinglePrecision());
+    TS_ASSERT_EQUALS(test->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(test->GetData()->GetSingleValues().rows(), 5);
+    TS_ASSERT_EQUALS(test->GetData()->GetSingleResiduals().rows(), 5);
+    test->SetFrameNumber(7);
+    TS_ASSERT(test->GetData()->IsSinglePrecision());
+    btk::Point::Pointer cloned = test->Clone();
+    TS_ASSERT(cloned->GetData()->IsSinglePrecision());
+    // Const access: never converted.
+    btk::Point::ConstPointer constTest = test;
+    unsigned long int timestamp = test->GetData()->GetTimestamp();
+    TS_ASSERT(constTest->GetData()->IsCompacted());
+    TS_ASSERT_EQUALS(constTest->GetFrameNumber(), 7);
+    TS_ASSERT(test->GetData()->IsSinglePrecision());
+    TS_ASSERT_EQUALS(test->GetData()->GetTimestamp(), timestamp);
+    // Explicit expansion: converted back in double precision.
+    test->GetData()->Expand();
+    TS_ASSERT(!test->GetData()->IsCompacted());
+    TS_ASSERT(!test->GetData()->IsSinglePrecision());
+    TS_ASSERT(test->GetData()->GetTimestamp() > timestamp);
+    TS_ASSERT_EIGEN_DELTA(constTest->GetValues().topRows(5), ref, 1e-6);
+    TS_ASSERT_EQUALS(constTest->GetResiduals().rows(), 7);
+    timestamp = test->GetData()->GetTimestamp();
+    test->GetData()->Expand();
+    TS_ASSERT_EQUALS(test->GetData()->GetTimestamp(), timestamp);
+    TS_ASSERT_EQUALS(test->GetValues().coeff(6,2), 0.0);
+    TS_ASSERT_EQUALS(test->GetResiduals().coeff(4), 0.5);
+    TS_ASSERT_EQUALS(test->GetResiduals().coeff(6), 0.0);
+    TS_ASSERT_EQUALS(test->GetData()->GetSingleValues().rows(), 0);
+    TS_ASSERT_EIGEN_DELTA(cloned->GetValues(), test->GetValues(), 1e-15);
+  };
+  
+  CXXTEST_TEST(SwapAndAdoptValues)
+  {
+    btk::Point::Pointer test = btk::Point::New("HEEL_R", 5);
+    btk::Point::Values v(10,3);
+    v.setRandom();
+    const btk::Point::Values ref = v;
+    const double* buffer = v.data();
+    test->SwapValues(v);
+    TS_ASSERT_EQUALS(test->GetValues().data(), buffer);
+    TS_ASSERT_EQUALS(test->GetFrameNumber(), 10);
+    TS_ASSERT_EIGEN_DELTA(test->GetValues(), ref, 1e-15);
+    TS_ASSERT_EQUALS(v.rows(), 5);
+    test->SwapValues(v);
+    TS_ASSERT_EQUALS(v.data(), buffer);
+    
+    btk::Point::Residuals r(10);
+    r.setConstant(0.5);
+    test->SwapValues(v);
+    test->SwapResiduals(r);
+    TS_ASSERT_EQUALS(test->GetResiduals().rows(), 10);
+    TS_ASSERT_EQUALS(test->GetResiduals().coeff(9), 0.5);
+    
+    int released = 0;
+    double* external = new double[30];
+    for (int i = 0 ; i < 30 ; ++i)
+      external[i] = static_cast<double>(i);
+    test->AdoptValues(external, 10, btkSharedPtr<void>(external, ReleaseBuffer(&released)));
+    TS_ASSERT_EQUALS(test->GetValues().data(), external);
+    TS_ASSERT_EQUALS(test->GetValues().coeff(3,1), 13.0);
+    test->GetValues().coeffRef(3,1) = -1.0;
+    TS_ASSERT_EQUALS(external[13], -1.0);
+    btk::Point::Pointer cloned = test->Clone();
+    TS_ASSERT_DIFFERS(cloned->GetValues().data(), external);
+    TS_ASSERT_EQUALS(released, 0);
+    test->SetFrameNumber(12);
+    TS_ASSERT_EQUALS(released, 1);
+    TS_ASSERT_EQUALS(test->GetValues().coeff(3,1), -1.0);
+    TS_ASSERT_EQUALS(test->GetValues().coeff(11,2), 0.0);
+  };
+  
+private:
+  struct ReleaseBuffer
+  {
+    ReleaseBuffer(int* counter) : mp_Counter(counter) {};
+    void operator()(void* p) {++(*this->mp_Counter); delete[] static_cast<double*>(p);};
+    int* mp_Counter;
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(PointTest)
@@ -121,4 +208,6 @@ CXXTEST_TEST_REGISTRATION(PointTest, EigenDataFromMap)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataMapCopied)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataRowMajorFromMap)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataRowMajorFromMapSwap)
+CXXTEST_TEST_REGISTRATION(PointTest, DataSinglePrecision)
+CXXTEST_TEST_REGISTRATION(PointTest, SwapAndAdoptValues)
 #endif
@@ -0,0 +1,246 @@
+#ifndef ProcessCacheTest_h
+#define ProcessCacheTest_h
+
+#include <btkProcessCache.h>
+#include <btkProcessObject.h>
+#include <btkPointCollection.h>
+#include <btkEventCollection.h>
+
+#include <map>
+
+// Creates one event per point. Its time is the sum of the values multiplied by a factor.
+class CacheSum : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<CacheSum> Pointer;
+  static Pointer New() {return Pointer(new CacheSum());};
+  void SetInput(btk::PointCollection::Pointer input) {this->SetNthInput(0, input);};
+  btk::EventCollection::Pointer GetOutput() {return static_pointer_cast<btk::EventCollection>(this->GetNthOutput(0));};
+  void SetFactor(double factor) {this->m_Factor = factor; this->Modified();};
+  int GetGenerationNumber() const {return this->m_GenerationNumber;};
+
+protected:
+  CacheSum()
+  : btk::ProcessObject()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+    this->m_Factor = 1.0;
+    this->m_GenerationNumber = 0;
+  };
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */)
+  {
+    return btk::EventCollection::New();
+  };
+  virtual void GenerateData()
+  {
+    ++this->m_GenerationNumber;
+    btk::PointCollection::Pointer input = static_pointer_cast<btk::PointCollection>(this->GetNthInput(0));
+    btk::EventCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    for (btk::PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      output->InsertItem(btk::Event::New((*it)->GetLabel(), (*it)->GetValues().sum() * this->m_Factor));
+  };
+  virtual bool HashParameters(btk::Hash* hash) const
+  {
+    hash->Add(this->m_Factor);
+    return true;
+  };
+
+private:
+  double m_Factor;
+  int m_GenerationNumber;
+};
+
+// Same process without parameters' digest: the cache cannot be used.
+class CacheSumUnhashed : public CacheSum
+{
+public:
+  typedef btkSharedPtr<CacheSumUnhashed> Pointer;
+  static Pointer New() {return Pointer(new CacheSumUnhashed());};
+protected:
+  virtual bool HashParameters(btk::Hash* /* hash */) const {return false;};
+};
+
+// Keeps the time of the events in a map.
+class CacheMapStorage : public btk::ProcessCache::Storage
+{
+public:
+  typedef btkSharedPtr<CacheMapStorage> Pointer;
+  static Pointer New() {return Pointer(new CacheMapStorage());};
+  virtual bool Load(btk::ProcessCache::Key key, const std::vector<btk::DataObject::Pointer>& outputs)
+  {
+    std::map<btk::ProcessCache::Key, std::vector<double> >::const_iterator it = this->m_Times.find(key);
+    if (it == this->m_Times.end())
+      return false;
+    btk::EventCollection::Pointer events = static_pointer_cast<btk::EventCollection>(outputs[0]);
+    events->Clear();
+    for (size_t i = 0 ; i < it->second.size() ; ++i)
+      events->InsertItem(btk::Event::New("", it->second[i]));
+    return true;
+  };
+  virtual void Save(btk::ProcessCache::Key key, const std::vector<btk::DataObject::Pointer>& outputs)
+  {
+    btk::EventCollection::Pointer events = static_pointer_cast<btk::EventCollection>(outputs[0]);
+    std::vector<double> times;
+    for (btk::EventCollection::ConstIterator it = events->Begin() ; it != events->End() ; ++it)
+      times.push_back((*it)->GetTime());
+    this->m_Times[key] = times;
+  };
+  int GetEntryNumber() const {return static_cast<int>(this->m_Times.size());};
+private:
+  CacheMapStorage() : btk::ProcessCache::Storage(), m_Times() {};
+  std::map<btk::ProcessCache::Key, std::vector<double> > m_Times;
+};
+
+static btk::PointCollection::Pointer CachePoints(double value)
+{
+  btk::PointCollection::Pointer points = btk::PointCollection::New();
+  points->InsertItem(btk::Point::New("uname*1", 10));
+  points->InsertItem(btk::Point::New("uname*2", 10));
+  points->GetItem(0)->GetValues().setConstant(value);
+  points->GetItem(1)->GetValues().setConstant(2.0 * value);
+  return points;
+};
+
+CXXTEST_SUITE(ProcessCacheTest)
+{
+  CXXTEST_TEST(Content)
+  {
+    btk::PointCollection::Pointer points = CachePoints(1.0);
+    btk::Hash h1, h2;
+    TS_ASSERT_EQUALS(points->HashContent(&h1), true);
+    TS_ASSERT_EQUALS(CachePoints(1.0)->HashContent(&h2), true);
+    TS_ASSERT_EQUALS(h1.GetValue(), h2.GetValue());
+    points->GetItem(1)->GetResiduals().coeffRef(3) = -1.0;
+    h2.Reset();
+    points->HashContent(&h2);
+    TS_ASSERT_DIFFERS(h1.GetValue(), h2.GetValue());
+    points->GetItem(1)->GetResiduals().coeffRef(3) = 0.0;
+    points->GetItem(1)->SetType(btk::Point::Angle);
+    h2.Reset();
+    points->HashContent(&h2);
+    TS_ASSERT_DIFFERS(h1.GetValue(), h2.GetValue());
+  };
+
+  CXXTEST_TEST(Restore)
+  {
+    btk::ProcessCache::Pointer cache = btk::ProcessCache::New();
+    CacheSum::Pointer sum = CacheSum::New();
+    sum->SetCache(cache);
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0);
+    // Same content, new input
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1);
+    TS_ASSERT_EQUALS(sum->GetOutput()->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(sum->GetOutput()->GetItem(0)->GetLabel(), "uname*1");
+    TS_ASSERT_DELTA(sum->GetOutput()->GetItem(0)->GetTime(), 30.0, 1e-15);
+    TS_ASSERT_DELTA(sum->GetOutput()->GetItem(1)->GetTime(), 60.0, 1e-15);
+    // The restored output is a copy
+    sum->GetOutput()->GetItem(0)->SetTime(0.0);
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 1);
+    TS_ASSERT_DELTA(sum->GetOutput()->GetItem(0)->GetTime(), 30.0, 1e-15);
+    // Other parameter
+    sum->SetFactor(2.0);
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 2);
+    TS_ASSERT_DELTA(sum->GetOutput()->GetItem(0)->GetTime(), 60.0, 1e-15);
+    // Other content
+    sum->SetInput(CachePoints(3.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 3);
+    TS_ASSERT_DELTA(sum->GetOutput()->GetItem(0)->GetTime(), 180.0, 1e-15);
+    // Shared by another process
+    CacheSum::Pointer other = CacheSum::New();
+    other->SetCache(cache);
+    other->SetInput(CachePoints(1.0));
+    other->Update();
+    TS_ASSERT_EQUALS(other->GetGenerationNumber(), 0);
+    TS_ASSERT_DELTA(other->GetOutput()->GetItem(1)->GetTime(), 60.0, 1e-15);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 3);
+  };
+
+  CXXTEST_TEST(LeastRecentlyUsed)
+  {
+    btk::ProcessCache::Pointer cache = btk::ProcessCache::New(2);
+    CacheSum::Pointer sum = CacheSum::New();
+    sum->SetCache(cache);
+    for (int i = 1 ; i <= 3 ; ++i)
+    {
+      sum->SetInput(CachePoints(static_cast<double>(i)));
+      sum->Update();
+    }
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 2);
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 3);
+    sum->SetInput(CachePoints(2.0)); // Most recently used: 2, 3
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 3);
+    sum->SetInput(CachePoints(1.0)); // 3 removed
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 4);
+    sum->SetInput(CachePoints(3.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 5);
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 5);
+    cache->SetCapacity(1);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 1);
+    cache->Clear();
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 0);
+  };
+
+  CXXTEST_TEST(Storage)
+  {
+    CacheMapStorage::Pointer storage = CacheMapStorage::New();
+    btk::ProcessCache::Pointer cache = btk::ProcessCache::New(0);
+    cache->SetStorage(storage);
+    CacheSum::Pointer sum = CacheSum::New();
+    sum->SetCache(cache);
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(storage->GetEntryNumber(), 1);
+    CacheSum::Pointer other = CacheSum::New();
+    other->SetCache(cache);
+    other->SetInput(CachePoints(1.0));
+    other->Update();
+    TS_ASSERT_EQUALS(other->GetGenerationNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1);
+    TS_ASSERT_EQUALS(other->GetOutput()->GetItemNumber(), 2);
+    TS_ASSERT_DELTA(other->GetOutput()->GetItem(1)->GetTime(), 60.0, 1e-15);
+  };
+
+  CXXTEST_TEST(NotCacheable)
+  {
+    btk::ProcessCache::Pointer cache = btk::ProcessCache::New();
+    CacheSumUnhashed::Pointer sum = CacheSumUnhashed::New();
+    sum->SetCache(cache);
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    sum->SetInput(CachePoints(1.0));
+    sum->Update();
+    TS_ASSERT_EQUALS(sum->GetGenerationNumber(), 2);
+    TS_ASSERT_EQUALS(cache->GetEntryNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ProcessCacheTest)
+CXXTEST_TEST_REGISTRATION(ProcessCacheTest, Content)
+CXXTEST_TEST_REGISTRATION(ProcessCacheTest, Restore)
+CXXTEST_TEST_REGISTRATION(ProcessCacheTest, LeastRecentlyUsed)
+CXXTEST_TEST_REGISTRATION(ProcessCacheTest, Storage)
+CXXTEST_TEST_REGISTRATION(ProcessCacheTest, NotCacheable)
+#endif
@@ -0,0 +1,127 @@
+#ifndef ProfilerTest_h
+#define ProfilerTest_h
+
+#include <btkProfiler.h>
+#include <btkProcessObject.h>
+#include <btkAcquisition.h>
+#include <btkPipelineExecutor.h>
+
+#include <sstream>
+
+class ProfiledAcquisitionSource : public btk::ProcessObject
+{
+public:
+  typedef btkSharedPtr<ProfiledAcquisitionSource> Pointer;
+  static Pointer New() {return Pointer(new ProfiledAcquisitionSource());};
+  btk::Acquisition::Pointer GetOutput() {return static_pointer_cast<btk::Acquisition>(this->GetNthOutput(0));};
+  void Touch() {this->Modified();};
+  
+protected:
+  virtual btk::DataObject::Pointer MakeOutput(int /* idx */)
+  {
+    return btk::Acquisition::New();
+  };
+  virtual void GenerateData()
+  {
+    this->GetOutput()->Init(3, 100, 2, 2);
+  };
+  
+private:
+  ProfiledAcquisitionSource()
+  : btk::ProcessObject()
+  {
+    this->SetInputNumber(0);
+    this->SetOutputNumber(1);
+  };
+};
+
+CXXTEST_SUITE(ProfilerTest)
+{
+  CXXTEST_TEST(Disabled)
+  {
+    btk::Profiler::Clear();
+    TS_ASSERT_EQUALS(btk::Profiler::IsEnabled(), false);
+    ProfiledAcquisitionSource::Pointer source = ProfiledAcquisitionSource::New();
+    source->Update();
+    TS_ASSERT_EQUALS(btk::Profiler::GetRecords().size(), 0u);
+  };
+  
+  CXXTEST_TEST(Process)
+  {
+    btk::Profiler::Clear();
+    btk::Profiler::SetEnabled(true);
+    ProfiledAcquisitionSource::Pointer source = ProfiledAcquisitionSource::New();
+    source->Update();
+    source->Update(); // Not modified
+    btk::Profiler::SetEnabled(false);
+    source->Touch();
+    source->Update(); // Not recorded
+    std::vector<btk::Profiler::Record> records = btk::Profiler::GetRecords();
+    TS_ASSERT_EQUALS(records.size(), 1u);
+    if (records.size() == 1u)
+    {
+      TS_ASSERT_EQUALS(records[0].category, "Process");
+      TS_ASSERT_EQUALS(records[0].name, "ProfiledAcquisitionSource");
+      TS_ASSERT_EQUALS(records[0].frames, 100);
+      TS_ASSERT_EQUALS(records[0].channels, 5);
+      TS_ASSERT_EQUALS(records[0].bytes, 0u);
+      TS_ASSERT(records[0].start >= 0.0);
+      TS_ASSERT(records[0].wallTime >= 0.0);
+      TS_ASSERT(records[0].cpuTime >= 0.0);
+    }
+    btk::Profiler::Clear();
+    TS_ASSERT_EQUALS(btk::Profiler::GetRecords().size(), 0u);
+  };
+  
+  CXXTEST_TEST(Threads)
+  {
+    btk::Profiler::Clear();
+    btk::Profiler::SetEnabled(true);
+    std::vector<ProfiledAcquisitionSource::Pointer> sources(8);
+    btk::PipelineExecutor::Pointer executor = btk::PipelineExecutor::New(4);
+    for (size_t i = 0 ; i < sources.size() ; ++i)
+    {
+      sources[i] = ProfiledAcquisitionSource::New();
+      executor->Update(sources[i]);
+    }
+    btk::Profiler::SetEnabled(false);
+    std::vector<btk::Profiler::Record> records = btk::Profiler::GetRecords();
+    TS_ASSERT_EQUALS(records.size(), 8u);
+    btk::Profiler::Clear();
+  };
+  
+  CXXTEST_TEST(Export)
+  {
+    btk::Profiler::Clear();
+    btk::Profiler::SetEnabled(true);
+    ProfiledAcquisitionSource::Pointer source = ProfiledAcquisitionSource::New();
+    source->Update();
+    source->Touch();
+    source->Update();
+    btk::Profiler::SetEnabled(false);
+    std::ostringstream trace;
+    btk::Profiler::WriteChromeTrace(trace);
+    const std::string json = trace.str();
+    TS_ASSERT_EQUALS(json.compare(0, 15, "{\"traceEvents\":"), 0);
+    TS_ASSERT(json.find("\"name\":\"ProfiledAcquisitionSource\",\"cat\":\"Process\",\"ph\":\"X\"") != std::string::npos);
+    TS_ASSERT(json.find("\"frames\":100,\"channels\":5") != std::string::npos);
+    std::ostringstream summary;
+    btk::Profiler::PrintSummary(summary);
+    std::istringstream iss(summary.str());
+    std::string line, category, name;
+    int calls = 0;
+    std::getline(iss, line); // Header
+    iss >> category >> name >> calls;
+    TS_ASSERT_EQUALS(category, "Process");
+    TS_ASSERT_EQUALS(name, "ProfiledAcquisitionSource");
+    TS_ASSERT_EQUALS(calls, 2);
+    btk::Profiler::Clear();
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ProfilerTest)
+CXXTEST_TEST_REGISTRATION(ProfilerTest, Disabled)
+CXXTEST_TEST_REGISTRATION(ProfilerTest, Process)
+CXXTEST_TEST_REGISTRATION(ProfilerTest, Threads)
+CXXTEST_TEST_REGISTRATION(ProfilerTest, Export)
+#endif
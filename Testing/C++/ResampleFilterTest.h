@@ -0,0 +1,193 @@
+#ifndef ResampleFilterTest_h
+#define ResampleFilterTest_h
+
+#include <btkResampleFilter.h>
+#include <btkIMUTypes.h>
+
+#include <cmath>
+
+CXXTEST_SUITE(ResampleFilterTest)
+{
+  CXXTEST_TEST(AnalogCollection)
+  {
+    // From 1200 Hz to 1000 Hz
+    btk::AnalogCollection::Pointer analogs = btk::AnalogCollection::New();
+    analogs->InsertItem(btk::Analog::New("A", 1200));
+    analogs->InsertItem(btk::Analog::New("B", 1200));
+    for (int i = 0 ; i < 1200 ; ++i)
+    {
+      analogs->GetItem(0)->GetValues()(i) = std::sin(2.0 * M_PI * 5.0 * i / 1200.0);
+      analogs->GetItem(1)->GetValues()(i) = 2.5;
+    }
+    analogs->GetItem(1)->SetUnit("Nm");
+    
+    btk::ResampleFilter<btk::AnalogCollection>::Pointer rs = btk::ResampleFilter<btk::AnalogCollection>::New();
+    rs->SetInput(analogs);
+    rs->SetUpDownRatio(5, 6);
+    rs->Update();
+    btk::AnalogCollection::Pointer output = rs->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "A");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetUnit(), "Nm");
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrameNumber(), 1000);
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+      TS_ASSERT_DELTA(output->GetItem(1)->GetValues()(i), 2.5, 1e-2);
+      if ((i > 50) && (i < 950))
+        TS_ASSERT_DELTA(output->GetItem(0)->GetValues()(i), std::sin(2.0 * M_PI * 5.0 * i / 1000.0), 5e-3);
+    }
+    // The input is not modified
+    TS_ASSERT_EQUALS(analogs->GetItem(0)->GetFrameNumber(), 1200);
+    
+    rs->SetUpDownRatio(0, 6);
+    rs->Update();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(PointCollectionWithGap)
+  {
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    points->InsertItem(btk::Point::New("P1", 60));
+    points->GetItem(0)->GetValues().col(0).setConstant(1.0);
+    points->GetItem(0)->GetValues().col(1).setConstant(-2.0);
+    points->GetItem(0)->GetValues().col(2).setConstant(3.0);
+    points->GetItem(0)->GetResiduals().setConstant(0.5);
+    for (int i = 20 ; i < 25 ; ++i)
+    {
+      points->GetItem(0)->GetValues().row(i).setConstant(1000.0);
+      points->GetItem(0)->GetResiduals()(i) = -1.0;
+    }
+    
+    btk::ResampleFilter<btk::PointCollection>::Pointer rs = btk::ResampleFilter<btk::PointCollection>::New();
+    rs->SetInput(points);
+    rs->SetUpDownRatio(3, 2);
+    rs->Update();
+    btk::Point::Pointer p = rs->GetOutput()->GetItem(0);
+    TS_ASSERT_EQUALS(p->GetLabel(), "P1");
+    TS_ASSERT_EQUALS(p->GetFrameNumber(), 90);
+    for (int i = 0 ; i < 90 ; ++i)
+    {
+      // The frames between the input frames 19 and 25 (excluded) are invalid
+      if ((i >= 29) && (i <= 37))
+      {
+        TS_ASSERT_EQUALS(p->GetResiduals()(i), -1.0);
+        TS_ASSERT_EQUALS(p->GetValues()(i,0), 0.0);
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(p->GetResiduals()(i), 0.5);
+        TS_ASSERT_DELTA(p->GetValues()(i,0), 1.0, 1e-10);
+        TS_ASSERT_DELTA(p->GetValues()(i,1), -2.0, 1e-10);
+        TS_ASSERT_DELTA(p->GetValues()(i,2), 3.0, 1e-10);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(IMUCollectionFrequency)
+  {
+    btk::IMUCollection::Pointer imus = btk::IMUCollection::New();
+    imus->InsertItem(btk::IMUType1::New("IMU1"));
+    imus->InsertItem(btk::IMUType1::New("IMU2"));
+    imus->GetItem(0)->SetFrameNumber(300);
+    imus->GetItem(0)->SetFrequency(150.0);
+    imus->GetItem(1)->SetFrameNumber(200);
+    imus->GetItem(1)->SetFrequency(100.0);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      imus->GetItem(0)->GetChannel(i)->GetValues().setConstant(static_cast<double>(i));
+      imus->GetItem(1)->GetChannel(i)->GetValues().setConstant(static_cast<double>(-i));
+    }
+    
+    btk::ResampleFilter<btk::IMUCollection>::Pointer rs = btk::ResampleFilter<btk::IMUCollection>::New();
+    rs->SetInput(imus);
+    rs->SetFrequency(200.0);
+    rs->Update();
+    btk::IMUCollection::Pointer output = rs->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "IMU1");
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrequency(), 200.0);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetFrameNumber(), 400);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetChannelNumber(), 6);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetAccelerometerZ()->GetFrameNumber(), 400);
+    TS_ASSERT_DELTA(output->GetItem(0)->GetAccelerometerZ()->GetValues()(200), 2.0, 1e-2);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrequency(), 200.0);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetFrameNumber(), 400);
+    TS_ASSERT_DELTA(output->GetItem(1)->GetGyroscopeZ()->GetValues()(399), -5.0, 1e-2);
+    // The input is not modified
+    TS_ASSERT_EQUALS(imus->GetItem(0)->GetFrameNumber(), 300);
+    TS_ASSERT_EQUALS(imus->GetItem(0)->GetAccelerometerX()->GetFrameNumber(), 300);
+  };
+  
+  CXXTEST_TEST(Acquisition)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 100, 3, 2);
+    acq->SetPointFrequency(100.0);
+    acq->SetFirstFrame(11);
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      acq->GetPoint(i)->GetValues().setConstant(static_cast<double>(i + 1));
+      acq->GetPoint(i)->GetResiduals().setZero();
+    }
+    for (int i = 0 ; i < 3 ; ++i)
+      acq->GetAnalog(i)->GetValues().setConstant(static_cast<double>(-i));
+    acq->AppendEvent(btk::Event::New("Foot Strike", 31, "Left"));
+    
+    btk::ResampleFilter<btk::Acquisition>::Pointer rs = btk::ResampleFilter<btk::Acquisition>::New();
+    rs->SetInput(acq);
+    rs->SetFrequency(150.0);
+    rs->Update();
+    btk::Acquisition::Pointer output = rs->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 150.0);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 150);
+    TS_ASSERT_EQUALS(output->GetNumberAnalogSamplePerFrame(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 300);
+    TS_ASSERT_EQUALS(output->GetAnalog(2)->GetFrameNumber(), 300);
+    TS_ASSERT_DELTA(output->GetAnalog(2)->GetValues()(150), -2.0, 1e-2);
+    TS_ASSERT_DELTA(output->GetPoint(1)->GetValues()(75,2), 2.0, 1e-10);
+    TS_ASSERT_EQUALS(output->GetFirstFrame(), 16);
+    TS_ASSERT_EQUALS(output->GetEvent(0)->GetFrame(), 46);
+    // The input is not modified
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), 100);
+    TS_ASSERT_EQUALS(acq->GetEvent(0)->GetFrame(), 31);
+    TS_ASSERT(output->GetMetaData() != acq->GetMetaData());
+    
+    rs->SetFrequency(0.0);
+    rs->SetUpDownRatio(1, 2);
+    rs->Update();
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 50.0);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 100);
+    TS_ASSERT_EQUALS(output->GetEvent(0)->GetFrame(), 16);
+  };
+  
+  CXXTEST_TEST(AcquisitionAnalogSampleNumber)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(1, 100, 1, 10);
+    acq->SetPointFrequency(100.0);
+    acq->GetAnalog(0)->GetValues().setConstant(4.0);
+    
+    btk::Acquisition::Pointer output = btk::Acquisition::New();
+    TS_ASSERT_EQUALS(btk::ResampleAcquisition(acq, output, 100.0, 12), true);
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(output->GetAnalogFrequency(), 1200.0);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 100);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 1200);
+    TS_ASSERT_DELTA(output->GetAnalog(0)->GetValues()(600), 4.0, 1e-2);
+    // Point not modified but copied
+    TS_ASSERT(output->GetPoint(0) != acq->GetPoint(0));
+    
+    TS_ASSERT_EQUALS(btk::ResampleAcquisition(acq, output, 100.0, 0), false);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ResampleFilterTest)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AnalogCollection)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, PointCollectionWithGap)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, IMUCollectionFrequency)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, Acquisition)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AcquisitionAnalogSampleNumber)
+#endif
@@ -291,6 +291,24 @@ CXXTEST_SUITE(TRCFileReaderTest)
     TS_ASSERT_DELTA(acq->GetPoint(32)->GetValues()(1312,2), 951.17596, 1e-5);
     TS_ASSERT_DELTA(acq->GetPoint(32)->GetResiduals()(1312), 0.0, 1e-15);
   };
+  
+  CXXTEST_TEST(RequestedRegion)
+  {
+    btk::AcquisitionFileReader::Pointer reference = btk::AcquisitionFileReader::New();
+    reference->SetFilename(TRCFilePathIN + "MOTEK/T.trc");
+    reference->Update();
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TRCFilePathIN + "MOTEK/T.trc");
+    reader->GetOutput()->SetRequestedRegion(11, 30);
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), 11);
+    TS_ASSERT_EQUALS(acq->GetLastFrame(), 30);
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), 41);
+    TS_ASSERT_DELTA(acq->GetPoint(1)->GetValues()(3,0), reference->GetOutput()->GetPoint(1)->GetValues()(13,0), 1e-15);
+    TS_ASSERT(acq->GetPoint(40)->GetValues() == reference->GetOutput()->GetPoint(40)->GetValues().block(10,0,20,3));
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(TRCFileReaderTest)
@@ -302,4 +320,5 @@ CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, MOTEK_ballet)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, KneeWithOcclusion)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, Unamed1)
 CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, Unamed2)
+CXXTEST_TEST_REGISTRATION(TRCFileReaderTest, RequestedRegion)
 #endif
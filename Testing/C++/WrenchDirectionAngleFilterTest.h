@@ -2,6 +2,7 @@
 #define WrenchDirectionAngleFilterTest_h
 
 #include "btkWrenchDirectionAngleFilter.h"
+#include "btkConvert.h"
 
 CXXTEST_SUITE(WrenchDirectionAngleFilterTest)
 {
@@ -66,9 +67,37 @@ CXXTEST_SUITE(WrenchDirectionAngleFilterTest)
     TS_ASSERT_DELTA(output->GetItem(0)->GetValues()(5,1), 0.0, 1e-15);
     TS_ASSERT_DELTA(output->GetItem(0)->GetValues()(5,2), 0.0, 1e-15);
   };
+  
+  CXXTEST_TEST(Threads)
+  {
+    btk::WrenchCollection::Pointer input = btk::WrenchCollection::New();
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+      btk::Wrench::Pointer w = btk::Wrench::New("W" + btk::ToString(i), 100 + i);
+      w->GetForce()->GetValues().setRandom();
+      w->GetPosition()->GetResiduals()(i,0) = -1.0;
+      input->InsertItem(w);
+    }
+    btk::WrenchDirectionAngleFilter::Pointer wdaf = btk::WrenchDirectionAngleFilter::New();
+    wdaf->SetInput(input);
+    wdaf->Update();
+    btk::PointCollection::Pointer reference = wdaf->GetOutput()->Clone();
+    wdaf->SetThreadNumber(3);
+    input->Modified();
+    wdaf->Update();
+    btk::PointCollection::Pointer output = wdaf->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 10);
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+      TS_ASSERT_EQUALS(output->GetItem(i)->GetLabel(), "W" + btk::ToString(i) + ".DA");
+      TS_ASSERT(output->GetItem(i)->GetValues() == reference->GetItem(i)->GetValues());
+      TS_ASSERT_EQUALS(output->GetItem(i)->GetResiduals()(i), -1.0);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(WrenchDirectionAngleFilterTest)
 CXXTEST_TEST_REGISTRATION(WrenchDirectionAngleFilterTest, OneFrame)
+CXXTEST_TEST_REGISTRATION(WrenchDirectionAngleFilterTest, Threads)
 
 #endif // WrenchDirectionAngleFilterTest_h
\ No newline at end of file
@@ -2,13 +2,17 @@
 
 #include "AcquisitionUnitConverterTest.h"
 #include "AnalogOffsetRemoverTest.h"
+#include "ButterworthFilterTest.h"
+#include "DerivativeFilterTest.h"
 #include "DownSampleFilterTest.h"
 #include "ForcePlatformsExtractorTest.h"
 #include "ForcePlatformWrenchFilterTest.h"
+#include "GapFillingFilterTest.h"
 #include "GroundReactionWrenchFilterTest.h"
 #include "IMUsExtractorTest.h"
 #include "MeasureFrameExtractorTest.h"
 #include "MergeAcquisitionFilterTest.h"
+#include "ResampleFilterTest.h"
 #include "SeparateKnownVirtualMarkersFilterTest.h"
 #include "SpecializedPointsExtractorTest.h"
 #include "SubAcquisitionFilterTest.h"
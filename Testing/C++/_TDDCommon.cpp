@@ -1,13 +1,22 @@
 #include "_TDDConfigure.h"
 
 #include "AcquisitionTest.h"
+#include "AcquisitionComparatorTest.h"
 #include "AnalogTest.h"
+#include "AnalogBlockTest.h"
+#include "AsyncUpdateTest.h"
 #include "ForcePlatformTypesTest.h"
+#include "HashTest.h"
 #include "IMUTypesTest.h"
+#include "LoggerTest.h"
+#include "MemoryArenaTest.h"
+#include "MemoryUsageTest.h"
 #include "NullPtrTest.h"
 #include "PointTest.h"
 #include "PointCollectionTest.h"
 #include "MetaDataInfoTest.h"
 #include "MetaDataTest.h"
 #include "PipelineTest.h"
+#include "ProcessCacheTest.h"
+#include "ProfilerTest.h"
 #include "TriangleMeshTest.h"
\ No newline at end of file
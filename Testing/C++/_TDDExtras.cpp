@@ -1,8 +1,11 @@
 #include "_TDDConfigure.h"
 
 #include "EigenFilterTest.h"
+#include "EigenSOSFilterTest.h"
 #include "EigenFiltFiltTest.h"
 #include "EigenIIRFilterDesignTest.h"
+#include "EigenDecimateTest.h"
+#include "EigenResampleTest.h"
 #include "GammalnTest.h"
 #include "CombTest.h"
 #include "CumtrapzTest.h"
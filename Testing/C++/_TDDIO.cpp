@@ -11,6 +11,7 @@
 #include "ANCFileWriterTest.h"
 #include "ANGFileIOTest.h"
 #include "ANGFileReaderTest.h"
+#include "BatchAcquisitionReaderTest.h"
 #include "BSFFileIOTest.h"
 #include "BSFFileReaderTest.h"
 #include "CALForcePlateFileIOTest.h"
@@ -50,7 +50,7 @@
   template <typename T> int NumPyType() {return -1;};
   
   template <class Derived>
-  void ConvertFromNumpyToEigenMatrix(Eigen::MatrixBase<Derived>* out, PyObject* in)
+  void ConvertFromNumpyToEigenMatrix(Derived* out, PyObject* in)
   {
     int rows = 0;
     int cols = 0;
@@ -110,7 +110,7 @@
       PyErr_SetString(PyExc_ValueError, "Impossible to convert the input into a Python array object.");
       return;
     }
-    out->derived().setZero(rows, cols);
+    out->setZero(rows, cols); // Derived can be a plain Eigen matrix or a btk::MeasureValues object.
     typename Derived::Scalar* data = static_cast<typename Derived::Scalar*>(PyArray_DATA(temp));
     for (int i = 0; i != rows; ++i)
       for (int j = 0; j != cols; ++j)
@@ -119,7 +119,7 @@
 
   // Copies values from Eigen type into an existing NumPy type
   template <class Derived>
-  void CopyFromEigenToNumPyMatrix(PyObject* out, Eigen::MatrixBase<Derived>* in)
+  void CopyFromEigenToNumPyMatrix(PyObject* out, Derived* in)
   {
     int rows = 0;
     int cols = 0;
@@ -187,7 +187,7 @@
   };
   
   template <class Derived>
-  void ConvertFromEigenToNumPyMatrix(PyObject** out, Eigen::MatrixBase<Derived>* in)
+  void ConvertFromEigenToNumPyMatrix(PyObject** out, Derived* in)
   {
     npy_intp dims[2] = {in->rows(), in->cols()};
     *out = PyArray_SimpleNew(2, dims, NumPyType<typename Derived::Scalar>());
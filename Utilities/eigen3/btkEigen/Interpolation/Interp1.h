@@ -38,11 +38,108 @@
 
 #include "interp1_linear.h"
 #include "interp1_pchip.h"
+#include "interp1_spline.h"
+
+#include <limits>
 
 namespace btkEigen
 {
   using namespace Eigen;
   
+  /**
+   * Returns true if @a x and @a xi are monotonically increasing (time normalisation, resampling, etc.).
+   * In this case, the intervals used to interpolate the query points are found by walking once over both vectors.
+   */
+  template <typename VectorType, typename OtherVectorType>
+  bool interp1IsSorted(const VectorType& x, const OtherVectorType& xi)
+  {
+    typedef typename VectorType::Index Index;
+    for (Index i = 1 ; i < (x.rows() * x.cols()) ; ++i)
+    {
+      if (x.coeff(i-1) > x.coeff(i))
+        return false;
+    }
+    for (Index i = 1 ; i < (xi.rows() * xi.cols()) ; ++i)
+    {
+      if (xi.coeff(i-1) > xi.coeff(i))
+        return false;
+    }
+    return true;
+  };
+  
+  /**
+   * Returns true if @a x contains less than two samples. There is then no interval to interpolate the query points
+   * and the @a rows x @a cols values @a Yi are set to NaN. Used by the functions of the structure interp1 before to build their interpolant.
+   */
+  template <typename VectorType, typename OtherMatrixType>
+  bool interp1TooShort(OtherMatrixType* Yi, const VectorType& x, typename VectorType::Index rows, typename VectorType::Index cols)
+  {
+    if ((x.rows() * x.cols()) >= 2)
+      return false;
+    Yi->setConstant(rows, cols, std::numeric_limits<typename OtherMatrixType::Scalar>::quiet_NaN());
+    return true;
+  };
+  
+  /**
+   * Finds for each query point of @a xi the index @a j of the interval [x(j), x(j+1)] used to interpolate it.
+   * The indices are clamped to [0, n-2] (extrapolation with the first or the last interval). The vector @a x must contain at least two samples.
+   *
+   * When @a x and @a xi are sorted (see interp1IsSorted()), the intervals are found by walking once over both vectors. 
+   * Otherwise, the bisection and hunting of Base_interp are used for each query point.
+   */
+  template <typename VectorType, typename OtherVectorType>
+  void interp1Locate(Eigen::Matrix<typename VectorType::Index, Eigen::Dynamic, 1>* j, const VectorType& x, const OtherVectorType& xi)
+  {
+    typedef typename VectorType::Index Index;
+    const Index n = x.rows() * x.cols();
+    const Index m = xi.rows() * xi.cols();
+    eigen_assert((n >= 2) && "interp1 size error");
+    j->resize(m);
+    if (interp1IsSorted(x, xi))
+    {
+      Index k = 0;
+      for (Index i = 0 ; i < m ; ++i)
+      {
+        while ((k < n-2) && (xi.coeff(i) >= x.coeff(k+1)))
+          ++k;
+        j->coeffRef(i) = k;
+      }
+    }
+    else
+    {
+      Linear_interp<VectorType> li(&x, &x);
+      for (Index i = 0 ; i < m ; ++i)
+        j->coeffRef(i) = li.cor ? li.hunt(xi.coeff(i)) : li.locate(xi.coeff(i));
+    }
+  };
+  
+  /**
+   * Evaluates the interpolant @a interp at each query point of @a xi. Used by the functions of the structure interp1.
+   */
+  template <typename InterpType, typename VectorType, typename OtherVectorType>
+  void interp1Evaluate(OtherVectorType* yi, InterpType& interp, const VectorType& x, const OtherVectorType& xi)
+  {
+    typedef typename VectorType::Index Index;
+    const Index n = x.rows() * x.cols();
+    eigen_assert((n >= 2) && "interp1 size error");
+    yi->resize(xi.rows(), xi.cols());
+    if (interp1IsSorted(x, xi))
+    {
+      Index k = 0;
+      for (Index i = 0 ; i < (xi.rows() * xi.cols()) ; ++i)
+      {
+        while ((k < n-2) && (xi.coeff(i) >= x.coeff(k+1)))
+          ++k;
+        yi->coeffRef(i) = interp.rawinterp(k, xi.coeff(i));
+      }
+    }
+    else
+    {
+      for (Index i = 0 ; i < (xi.rows() * xi.cols()) ; ++i)
+        yi->coeffRef(i) = interp.interp(xi.coeff(i));
+    }
+  };
+  
   struct interp1
   {
     interp1()
@@ -53,26 +150,125 @@ namespace btkEigen
     
     template <typename VectorType, typename OtherVectorType>
     void pchip(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi);
+    
+    template <typename VectorType, typename OtherVectorType>
+    void spline(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi);
+    
+    template <typename VectorType, typename MatrixType, typename OtherVectorType, typename OtherMatrixType>
+    void linearColumns(OtherMatrixType* Yi, const VectorType& x, const MatrixType& Y, const OtherVectorType& xi);
+    
+    template <typename VectorType, typename MatrixType, typename OtherVectorType, typename OtherMatrixType>
+    void pchipColumns(OtherMatrixType* Yi, const VectorType& x, const MatrixType& Y, const OtherVectorType& xi);
   };
   
   template <typename VectorType, typename OtherVectorType>
   inline void interp1::linear(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi)
   {
-    typedef typename VectorType::Index Index;
+    if (interp1TooShort(yi, x, xi.rows(), xi.cols()))
+      return;
     Linear_interp<VectorType> li(&x, &y);
-    yi->resize(xi.rows(), xi.cols());
-    for (Index i = 0 ; i < (xi.rows() * xi.cols()) ; ++i)
-      yi->coeffRef(i) = li.interp(xi.coeff(i));
+    interp1Evaluate(yi, li, x, xi);
   };
   
   template <typename VectorType, typename OtherVectorType>
   inline void interp1::pchip(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi)
   {
+    if (interp1TooShort(yi, x, xi.rows(), xi.cols()))
+      return;
+    PCHIP_interp<VectorType> pi(&x, &y);
+    interp1Evaluate(yi, pi, x, xi);
+  };
+  
+  template <typename VectorType, typename OtherVectorType>
+  inline void interp1::spline(OtherVectorType* yi, const VectorType& x, const VectorType& y, const OtherVectorType& xi)
+  {
+    if (interp1TooShort(yi, x, xi.rows(), xi.cols()))
+      return;
+    Spline_interp<VectorType> si(&x, &y);
+    interp1Evaluate(yi, si, x, xi);
+  };
+  
+  /**
+   * Linear interpolation of each column of @a Y (sampled at @a x) at the query points @a xi. 
+   * The intervals and the weights are computed once and used for all the columns (e.g. all the coordinates of the markers of a trial).
+   * The result is the same than the function linear() applied on each column.
+   */
+  template <typename VectorType, typename MatrixType, typename OtherVectorType, typename OtherMatrixType>
+  inline void interp1::linearColumns(OtherMatrixType* Yi, const VectorType& x, const MatrixType& Y, const OtherVectorType& xi)
+  {
+    typedef typename VectorType::Scalar Scalar;
     typedef typename VectorType::Index Index;
+    const Index m = xi.rows() * xi.cols();
+    if (interp1TooShort(Yi, x, m, Y.cols()))
+      return;
+    Eigen::Matrix<Index, Eigen::Dynamic, 1> jj;
+    interp1Locate(&jj, x, xi);
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> t(m);
+    for (Index i = 0 ; i < m ; ++i)
+    {
+      const Index j = jj.coeff(i);
+      t.coeffRef(i) = (x.coeff(j) == x.coeff(j+1)) ? Scalar(0) : (xi.coeff(i) - x.coeff(j)) / (x.coeff(j+1) - x.coeff(j));
+    }
+    Yi->resize(m, Y.cols());
+    for (Index c = 0 ; c < Y.cols() ; ++c)
+    {
+      for (Index i = 0 ; i < m ; ++i)
+      {
+        const Index j = jj.coeff(i);
+        Yi->coeffRef(i,c) = Y.coeff(j,c) + t.coeff(i) * (Y.coeff(j+1,c) - Y.coeff(j,c));
+      }
+    }
+  };
+  
+  /**
+   * PCHIP interpolation of each column of @a Y (sampled at @a x) at the query points @a xi.
+   * The intervals and the Hermite basis functions are computed once (in vectorized expressions) and used for all the columns.
+   * Only the slopes are computed for each column (see PCHIP_interp).
+   * The result is the same than the function pchip() applied on each column.
+   */
+  template <typename VectorType, typename MatrixType, typename OtherVectorType, typename OtherMatrixType>
+  inline void interp1::pchipColumns(OtherMatrixType* Yi, const VectorType& x, const MatrixType& Y, const OtherVectorType& xi)
+  {
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename VectorType::Index Index;
+    const Index m = xi.rows() * xi.cols();
+    if (interp1TooShort(Yi, x, m, Y.cols()))
+      return;
+    Yi->resize(m, Y.cols());
+    if (Y.cols() == 0)
+      return;
+    Eigen::Matrix<Index, Eigen::Dynamic, 1> jj;
+    interp1Locate(&jj, x, xi);
+    Eigen::Array<Scalar, Eigen::Dynamic, 1> h(m), t(m);
+    for (Index i = 0 ; i < m ; ++i)
+    {
+      const Index j = jj.coeff(i);
+      h.coeffRef(i) = x.coeff(j+1) - x.coeff(j);
+      t.coeffRef(i) = (xi.coeff(i) - x.coeff(j)) / h.coeff(i);
+    }
+    const Scalar c1 = Scalar(1);
+    const Scalar c2 = Scalar(2);
+    const Scalar c3 = Scalar(3);
+    // Same expressions than PCHIP_interp::rawinterp
+    const Eigen::Array<Scalar, Eigen::Dynamic, 1> h00 = c2*t*t*t - c3*t*t + c1;
+    const Eigen::Array<Scalar, Eigen::Dynamic, 1> h10 = t*t*t - c2*t*t + t;
+    const Eigen::Array<Scalar, Eigen::Dynamic, 1> h01 = -c2*t*t*t + c3*t*t;
+    const Eigen::Array<Scalar, Eigen::Dynamic, 1> h11 = t*t*t - t*t;
+    VectorType y = Y.col(0);
     PCHIP_interp<VectorType> pi(&x, &y);
-    yi->resize(xi.rows(), xi.cols());
-    for (Index i = 0 ; i < (xi.rows() * xi.cols()) ; ++i)
-      yi->coeffRef(i) = pi.interp(xi.coeff(i));
+    for (Index c = 0 ; c < Y.cols() ; ++c)
+    {
+      if (c != 0)
+      {
+        y = Y.col(c);
+        pi.setinternals(&x, &y);
+      }
+      for (Index i = 0 ; i < m ; ++i)
+      {
+        const Index j = jj.coeff(i);
+        Yi->coeffRef(i,c) = y.coeff(j)*h00.coeff(i) + h.coeff(i)*pi.dk.coeff(j)*h10.coeff(i) + y.coeff(j+1)*h01.coeff(i) + h.coeff(i)*pi.dk.coeff(j+1)*h11.coeff(i);
+      }
+    }
   };
 };
 
@@ -94,40 +94,58 @@ namespace btkEigen
     void setinternals(const VectorType* x, const VectorType* y)
     {
       Index num = x->rows() * x->cols();
-      VectorType hk = x->segment(1,num-1) - x->segment(0,num-1);
-      VectorType mk = (y->segment(1,num-1) - y->segment(0,num-1)).cwiseQuotient(hk);
-      VectorType smk(num-1); smk.setZero(); smk = (mk.array() > 0.0).select(1.0, smk) - (mk.array() < 0.0).select(1.0, smk);
+      this->dk.resize(num);
 #if 1
       // Matlab method
-      VectorType condition(num-2); condition.setZero(); condition = ((smk.segment(0,num-2).cwiseProduct(smk.segment(1,num-2))).array() > 0).select(1.0,condition);
-      VectorType hs = hk.segment(1,num-2) + hk.segment(0,num-2);
-      VectorType w1 = (hk.segment(0,num-2) + hs).cwiseQuotient(3.0 * hs);
-      VectorType w2 = (hk.segment(1,num-2) + hs).cwiseQuotient(3.0 * hs);
-      VectorType mk1 = mk.segment(0,num-2).cwiseAbs();
-      VectorType mk2 = mk.segment(1,num-2).cwiseAbs();
-      VectorType dmax = (mk1.array() > mk2.array()).select(mk1,mk2);
-      VectorType dmin = (mk1.array() < mk2.array()).select(mk1,mk2);
-      this->dk.resize(num);
-      this->dk.segment(1,num-2) = (condition).select(dmin.cwiseQuotient((w1.cwiseProduct(mk.segment(0,num-2))+w2.cwiseProduct(mk.segment(1,num-2))).cwiseQuotient(dmax)),0.0);
+      // Computed in one pass over the samples: only the steps and the slopes of the current and the previous intervals are kept.
+      Scalar h0 = x->coeff(1) - x->coeff(0), m0 = (y->coeff(1) - y->coeff(0)) / h0;
+      const Scalar hf = h0, mf = m0; // First interval
+      Scalar hs1 = h0, ms1 = m0; // Second interval (replaced in the loop)
+      Scalar hp = h0, mp = m0; // Penultimate interval
+      for (Index i = 1 ; i < num-1 ; ++i)
+      {
+        const Scalar h1 = x->coeff(i+1) - x->coeff(i), m1 = (y->coeff(i+1) - y->coeff(i)) / h1;
+        if (((m0 > 0.0) && (m1 > 0.0)) || ((m0 < 0.0) && (m1 < 0.0)))
+        {
+          const Scalar hs = h1 + h0;
+          const Scalar w1 = (h0 + hs) / (3.0 * hs);
+          const Scalar w2 = (h1 + hs) / (3.0 * hs);
+          const Scalar mk1 = std::fabs(m0), mk2 = std::fabs(m1);
+          const Scalar dmax = (mk1 > mk2) ? mk1 : mk2;
+          const Scalar dmin = (mk1 < mk2) ? mk1 : mk2;
+          this->dk.coeffRef(i) = dmin / ((w1 * m0 + w2 * m1) / dmax);
+        }
+        else
+          this->dk.coeffRef(i) = 0.0;
+        if (i == 1)
+        {
+          hs1 = h1;
+          ms1 = m1;
+        }
+        hp = h0; mp = m0;
+        h0 = h1; m0 = m1;
+      }
       // dk(0)
-      this->dk.coeffRef(0) = ((2.0*hk.coeff(0)+hk.coeff(1))*mk.coeff(0) - hk.coeff(0)*mk.coeff(1)) / (hk.coeff(0)+hk.coeff(1));
-      if (sign(dk.coeff(0)) != sign(mk.coeff(0)))
+      this->dk.coeffRef(0) = ((2.0*hf+hs1)*mf - hf*ms1) / (hf+hs1);
+      if (sign(dk.coeff(0)) != sign(mf))
         this->dk.coeffRef(0) = 0.0;
-      else if ((sign(mk.coeff(0)) != sign(mk.coeff(1))) && (std::fabs(dk.coeff(0)) > std::fabs(3.0*mk.coeff(0))))
-        this->dk.coeffRef(0) = 3.0*mk.coeff(0);
+      else if ((sign(mf) != sign(ms1)) && (std::fabs(dk.coeff(0)) > std::fabs(3.0*mf)))
+        this->dk.coeffRef(0) = 3.0*mf;
       // dk(-1)
-      this->dk.coeffRef(num-1) = ((2.0*hk.coeff(num-2)+hk.coeff(num-3))*mk.coeff(num-2) - hk.coeff(num-2)*mk.coeff(num-3)) / (hk.coeff(num-2)+hk.coeff(num-3));
-      if (sign(dk.coeff(num-1)) != sign(mk.coeff(num-2)))
+      this->dk.coeffRef(num-1) = ((2.0*h0+hp)*m0 - h0*mp) / (h0+hp);
+      if (sign(dk.coeff(num-1)) != sign(m0))
         this->dk.coeffRef(num-1) = 0.0;
-      else if ((sign(mk.coeff(num-2)) != sign(mk.coeff(num-3))) && (std::fabs(dk.coeff(num-1)) > std::fabs(3.0*mk.coeff(num-2))))
-        this->dk.coeffRef(num-1) = 3.0*mk.coeff(num-2);
+      else if ((sign(m0) != sign(mp)) && (std::fabs(dk.coeff(num-1)) > std::fabs(3.0*m0)))
+        this->dk.coeffRef(num-1) = 3.0*m0;
 #else
       // ScyPy method
+      VectorType hk = x->segment(1,num-1) - x->segment(0,num-1);
+      VectorType mk = (y->segment(1,num-1) - y->segment(0,num-1)).cwiseQuotient(hk);
+      VectorType smk(num-1); smk.setZero(); smk = (mk.array() > 0.0).select(1.0, smk) - (mk.array() < 0.0).select(1.0, smk);
       VectorType w1 = 2.0 * hk.segment(1,num-2) + hk.segment(0,num-2);
       VectorType w2 = hk.segment(1,num-2) + 2.0 * hk.segment(0,num-2);
       VectorType whmean = (w1 + w2).cwiseInverse().cwiseProduct((w1.cwiseQuotient(mk.segment(1,num-2)) + w2.cwiseQuotient(mk.segment(0,num-2))));
       VectorType condition(num-2); condition.setZero(); condition = (smk.segment(0,num-2).array() != smk.segment(1,num-2).array()).select(1.0,condition) + (smk.segment(0,num-2).array() == 0).select(1.0,condition) + (smk.segment(1,num-2).array() == 0).select(1.0,condition);
-      this->dk.resize(num);
       this->dk.segment(1,num-2) = condition.select(0.0, whmean.cwiseInverse());
       dk.coeffRef(0) = ((mk.coeff(0) == 0) || (dk.coeff(1) == 0)) ? 0.0 : 1.0/(1.0/mk.coeff(0)+1.0/dk.coeff(1));
       dk.coeffRef(num-1) = ((mk.coeff(num-2) == 0) || (dk.coeff(num-2) == 0)) ? 0.0 : 1.0/(1.0/mk.coeff(num-2)+1.0/dk.coeff(num-2));
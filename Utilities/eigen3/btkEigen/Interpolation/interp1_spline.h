@@ -0,0 +1,100 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenInterp1Spline_h
+#define __btkEigenInterp1Spline_h
+
+#include "interp1_base.h"
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Natural cubic spline: the second derivative is null at both ends.
+   *
+   * The second derivatives at each sample are computed once with a tridiagonal system (Numeric Recipes in C, 3rd ed., section 3.3).
+   *
+   * WARNING: The value for the horizontal axis (variable x) MUST be monotone increasing
+   */
+  
+  template <typename VectorType>
+  struct Spline_interp : Base_interp<VectorType>
+  {
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename VectorType::Index Index;
+    
+    VectorType y2;
+    
+    Spline_interp(const VectorType* x, const VectorType* y)
+    : Base_interp<VectorType>(x,y,2), y2()
+    {
+      this->setinternals(x,y);
+    };
+    
+    Scalar rawinterp(Index j, Scalar x)
+    {
+      Index klo = j, khi = j+1;
+      Scalar h = this->xx->coeff(khi) - this->xx->coeff(klo);
+      eigen_assert(h > 0.0);
+      Scalar a = (this->xx->coeff(khi) - x) / h;
+      Scalar b = (x - this->xx->coeff(klo)) / h;
+      return a*this->yy->coeff(klo) + b*this->yy->coeff(khi) + ((a*a*a-a)*this->y2.coeff(klo) + (b*b*b-b)*this->y2.coeff(khi))*(h*h)/6.0;
+    };
+    
+    void setinternals(const VectorType* x, const VectorType* y)
+    {
+      Index num = x->rows() * x->cols();
+      this->y2.resize(num);
+      // Decomposition of the tridiagonal system (the factors are stored in y2) followed by the backsubstitution.
+      Eigen::Matrix<Scalar, Eigen::Dynamic, 1, 0, VectorType::MaxSizeAtCompileTime, 1> u(num);
+      this->y2.coeffRef(0) = 0.0;
+      u.coeffRef(0) = 0.0;
+      for (Index i = 1 ; i < num-1 ; ++i)
+      {
+        Scalar sig = (x->coeff(i) - x->coeff(i-1)) / (x->coeff(i+1) - x->coeff(i-1));
+        Scalar p = sig * this->y2.coeff(i-1) + 2.0;
+        this->y2.coeffRef(i) = (sig - 1.0) / p;
+        u.coeffRef(i) = (y->coeff(i+1) - y->coeff(i)) / (x->coeff(i+1) - x->coeff(i)) - (y->coeff(i) - y->coeff(i-1)) / (x->coeff(i) - x->coeff(i-1));
+        u.coeffRef(i) = (6.0 * u.coeff(i) / (x->coeff(i+1) - x->coeff(i-1)) - sig * u.coeff(i-1)) / p;
+      }
+      this->y2.coeffRef(num-1) = 0.0;
+      for (Index k = num-2 ; k >= 0 ; --k)
+        this->y2.coeffRef(k) = this->y2.coeff(k) * this->y2.coeff(k+1) + u.coeff(k);
+    };
+  };
+};
+
+#endif // __btkEigenInterp1Spline_h
@@ -0,0 +1,123 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenDecimate_h
+#define __btkEigenDecimate_h
+
+#include "FIRFilterDesign.h"
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Returns the index of the sample used for the index @a i of a signal with @a len samples 
+   * reflected (without repetition of the boundary samples) at its beginning and at its end.
+   */
+  template <typename Index>
+  inline Index reflectIndex(Index i, Index len)
+  {
+    if (len == 1)
+      return 0;
+    while ((i < 0) || (i >= len))
+      i = (i < 0) ? -i : 2 * (len - 1) - i;
+    return i;
+  };
+  
+  /**
+   * Design the anti-aliasing filter used to decimate a signal by the factor @a q (low-pass FIR filter with 20*q+1 coefficients and a cutoff frequency equal to the new Nyquist frequency).
+   * For a factor equal to 1, the filter has only one coefficient equal to 1.
+   *
+   * The same design than the one used by the function decimate provided in SciPy.
+   */
+  inline bool decimationFilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* h, int q)
+  {
+    if (q < 1)
+    {
+      btkErrorMacro("The decimation factor must be strictly positive.");
+      return false;
+    }
+    if (q == 1)
+    {
+      h->setOnes(1);
+      return true;
+    }
+    return firwin(h, 20 * q + 1, 1.0 / static_cast<double>(q));
+  };
+  
+  /**
+   * Filters each column of @a X by the FIR filter @a h and keeps one sample every @a q samples.
+   * The number of coefficients of @a h must be odd. The filter is centred on the kept samples so there is no delay 
+   * and the signal is reflected at its boundaries. The number of rows of the result is equal to the number of rows of @a X divided by @a q.
+   *
+   * Only the kept samples are computed (this is equivalent to the polyphase form of the decimator). 
+   * Each of them is computed for all the columns at once with the product between the coefficients and 
+   * a window of the input. To have contiguous windows, the matrix @a X should be stored in row major (channels interleaved).
+   */
+  template<typename FilterCoeff, typename MatrixType>
+  Eigen::Matrix<typename MatrixType::Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> decimate(const FilterCoeff& h, int q, const MatrixType& X)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> DMatrix;
+    
+    eigen_assert(h.cols() == 1);
+    eigen_assert((h.rows() % 2 == 1) && "The number of coefficients must be odd.");
+    eigen_assert((q > 0) && "The decimation factor must be strictly positive.");
+    
+    const Index len = h.rows();
+    const Index half = (len - 1) / 2;
+    const Index slen = X.rows();
+    const Index num = slen / q;
+    DMatrix Y(num, X.cols());
+    // The coefficients are reversed to use them with the windows in the natural order.
+    const Eigen::Matrix<Scalar, 1, Eigen::Dynamic> hr = h.reverse().transpose().template cast<Scalar>();
+    DMatrix W(len, X.cols()); // Window reflected at the boundaries
+    for (Index i = 0 ; i < num ; ++i)
+    {
+      const Index first = i * q - half;
+      if ((first >= 0) && (first + len <= slen))
+        Y.row(i).noalias() = hr * X.middleRows(first, len);
+      else
+      {
+        for (Index j = 0 ; j < len ; ++j)
+          W.row(j) = X.row(reflectIndex(first + j, slen));
+        Y.row(i).noalias() = hr * W;
+      }
+    }
+    return Y;
+  };
+};
+#endif // __btkEigenDecimate_h
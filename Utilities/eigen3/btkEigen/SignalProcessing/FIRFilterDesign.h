@@ -0,0 +1,80 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenFIRFilterDesign_h
+#define __btkEigenFIRFilterDesign_h
+
+#include "btkLogger.h"
+
+#include <Eigen/Core>
+#include <Eigen/Geometry> // M_PI
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Design a linear phase low-pass FIR filter with @a numtaps coefficients using the window method (Hamming window).
+   * The cutoff frequency @a Wn is normalized by the Nyquist frequency and must be in the range ]0,1[. 
+   * The coefficients are scaled to have an unity gain at the frequency 0.
+   *
+   * Inspired from the function firwin provided in SciPy.
+   */
+  inline bool firwin(Eigen::Matrix<double, Eigen::Dynamic, 1>* h, int numtaps, double Wn)
+  {
+    if (numtaps < 1)
+    {
+      btkErrorMacro("The number of coefficients must be strictly positive.");
+      return false;
+    }
+    if ((Wn <= 0.0) || (Wn >= 1.0))
+    {
+      btkErrorMacro("The cutoff frequency must be in the range ]0,1[.");
+      return false;
+    }
+    h->resize(numtaps);
+    const double alpha = 0.5 * static_cast<double>(numtaps - 1);
+    for (int i = 0 ; i < numtaps ; ++i)
+    {
+      const double m = static_cast<double>(i) - alpha;
+      const double s = (m == 0.0) ? Wn : std::sin(M_PI * Wn * m) / (M_PI * m);
+      const double w = (numtaps == 1) ? 1.0 : 0.54 - 0.46 * std::cos(2.0 * M_PI * static_cast<double>(i) / static_cast<double>(numtaps - 1));
+      h->coeffRef(i) = s * w;
+    }
+    *h /= h->sum();
+    return true;
+  };
+};
+#endif // __btkEigenFIRFilterDesign_h
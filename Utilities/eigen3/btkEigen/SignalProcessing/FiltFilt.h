@@ -40,26 +40,110 @@
 
 #include <Eigen/LU>
 
-#define BTKEIGEN_FILFILT_REVERSE_INPLACE(m) \
-  { \
-    Index dlen =  m.rows() * m.cols(); \
-    for (int k = 0 ; k < dlen / 2 ; ++k) \
-    { \
-      Scalar s = m.data()[k]; \
-      m.data()[k] = m.data()[dlen-k-1]; \
-      m.data()[dlen-k-1] = s; \
-    } \
-  }
-
 namespace btkEigen
 {
   using namespace Eigen;
   
+  /**
+   * Computes the initial state @a zi of the filter defined by the coefficients @a bb and @a aa (padded with zeros to have the same length and normalized by @a aa(0)) 
+   * to use in a forward-backward filter. This is the steady state of the filter for a step response (method proposed by Gustafsson (1996)). 
+   * The state must be multiplied by the first value filtered.
+   */
+  template<typename CoeffType, typename StateType>
+  void filtfiltState(StateType* zi, const CoeffType& bb, const CoeffType& aa)
+  {
+    typedef typename CoeffType::Index Index;
+    typedef Eigen::Matrix<typename CoeffType::Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
+    const Index order = bb.rows();
+    if (order == 2)
+    {
+      zi->resize(1,1);
+      zi->coeffRef(0) = (1.0 + aa.coeff(1)) / (bb.coeff(1) - bb.coeff(0)*aa.coeff(1));
+    }
+    else
+    {
+      FFMatrix temp(order-1,order-2);
+      temp.block(0,0,order-2,order-2) = -FFMatrix::Identity(order-2,order-2);
+      temp.block(order-2,0,1,order-2) = FFMatrix::Zero(1,order-2);
+      FFMatrix temp1(order-1,order-1);
+      temp1 << aa.block(1,0,order-1,1), temp;
+      temp1 += FFMatrix::Identity(order-1,order-1);
+      FFMatrix temp2 =  bb.block(1,0,order-1,1) - (bb.coeff(0) * aa.block(1,0,order-1,1));
+      *zi = temp1.lu().solve(temp2);
+    }
+  };
+  
+  /**
+   * Storage used by the function filtfiltLanes(): one row per sample and one column per channel (channels interleaved).
+   */
+  template<typename Scalar, int Lanes>
+  struct FiltFiltLanesBuffer
+  {
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Lanes, (Lanes == 1) ? Eigen::ColMajor : Eigen::RowMajor> Type;
+  };
+  
+  /**
+   * Extends the channels stored in the rows [@a elen, rows(W) - @a elen[ of @a W by an odd reflection of @a elen samples at each boundary.
+   * This function is used by filtfiltLanes() and sosfiltfiltLanes().
+   */
+  template<typename BufferType>
+  void filtfiltReflect(typename BufferType::Index elen, BufferType* W)
+  {
+    typedef typename BufferType::Index Index;
+    const Index last = W->rows() - elen - 1;
+    for (Index k = 0 ; k < elen ; ++k)
+    {
+      W->row(k) = 2.0 * W->row(elen) - W->row(2 * elen - k);
+      W->row(last + 1 + k) = 2.0 * W->row(last) - W->row(last - 1 - k);
+    }
+  };
+  
+  /**
+   * Forward-backward filter applied in place on the @a Lanes channels stored in @a W (see FiltFiltLanesBuffer). 
+   * The signals must be stored in the rows [@a elen, rows(W) - @a elen[. The other rows are used for the reflections at the boundaries.
+   * The coefficients @a bb and @a aa must have the same length and be normalized by @a aa(0). The initial state @a zi is computed by filtfiltState().
+   *
+   * The recursion of the filter (direct form II transposed) is computed for all the channels at once. With a fixed number of lanes (e.g. 4), 
+   * each operation is done on a small fixed size row which can be vectorized. The buffer @a W can be reused for several groups of channels with the same length.
+   */
+  template<typename Scalar, int Lanes, typename CoeffType, typename StateType>
+  void filtfiltLanes(const CoeffType& bb, const CoeffType& aa, const StateType& zi, typename CoeffType::Index elen, typename FiltFiltLanesBuffer<Scalar, Lanes>::Type* W)
+  {
+    typedef typename CoeffType::Index Index;
+    typedef Eigen::Array<Scalar, 1, Lanes> Lane;
+    typedef Eigen::Array<Scalar, Eigen::Dynamic, Lanes, (Lanes == 1) ? Eigen::ColMajor : Eigen::RowMajor> States;
+    
+    const Index rows = W->rows();
+    const Index n = bb.rows() - 1; // Number of states
+    // Reflections at the beginning and at the end
+    filtfiltReflect(elen, W);
+    States s(n, Lanes);
+    for (int pass = 0 ; pass < 2 ; ++pass)
+    {
+      // Forward filter, then backward filter
+      const Index first = (pass == 0) ? 0 : rows - 1;
+      const Index inc = (pass == 0) ? 1 : -1;
+      for (Index j = 0 ; j < n ; ++j)
+        s.row(j) = zi.coeff(j) * W->row(first).array();
+      for (Index i = first ; (i >= 0) && (i < rows) ; i += inc)
+      {
+        const Lane x = W->row(i).array();
+        const Lane y = s.row(0) + bb.coeff(0) * x;
+        for (Index j = 1 ; j < n ; ++j)
+          s.row(j-1) = s.row(j) - aa.coeff(j) * y + bb.coeff(j) * x;
+        s.row(n-1) = bb.coeff(n) * x - aa.coeff(n) * y;
+        W->row(i) = y.matrix();
+      }
+    }
+  };
+  
   /**
    * A forward-backward digital filter without phase delay (zero phase distorsion). 
    * Compared to a simple forward filter, the order of this filter is twice of the original order and the cutoff frequency is reduced. 
    * To have a more stable filter, the intial state of the filter is computed using the method proposed by Gustafsson (1996).
    *
+   * The columns of @a X are filtered by groups of 4 using the function filtfiltLanes(). The same buffer is used for all the groups.
+   *
    * Inspired from the filtfilt function provided in SciPy.
    *
    * @par References
@@ -72,8 +156,8 @@ namespace btkEigen
   {
     typedef typename MatrixType::Scalar Scalar;
     typedef typename MatrixType::Index Index;
-    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> FFMatrix;
     typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> FFVector;
+    typedef typename FiltFiltLanesBuffer<Scalar, 4>::Type FFBuffer;
   
     const Index slen = X.rows();
     const Index order = std::max(b.rows(), a.rows());
@@ -85,50 +169,23 @@ namespace btkEigen
     // Copy the coefficients and pad them with zeros 
     BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,bb,b,order)
     BTKEIGEN_FILTER_PAD_COEFFICIENTS(MatrixType,aa,a,order)
+    const Scalar norm = aa.coeff(0);
+    bb /= norm;
+    aa /= norm;
     
     // Compute the initial state of the filter
     FFVector zi;
-    if (order == 2)
-    {
-      zi.resize(1,1);
-      zi.coeffRef(0) = (1.0 + aa.coeff(1)) / (bb.coeff(1) - bb.coeff(0)*aa.coeff(1));
-    }
-    else
-    {
-      FFMatrix temp(order-1,order-2);
-      temp.block(0,0,order-2,order-2) = -FFMatrix::Identity(order-2,order-2);
-      temp.block(order-2,0,1,order-2) = FFMatrix::Zero(1,order-2);
-      FFMatrix temp1(order-1,order-1);
-      temp1 << aa.block(1,0,order-1,1), temp;
-      temp1 += FFMatrix::Identity(order-1,order-1);
-      FFMatrix temp2 =  bb.block(1,0,order-1,1) - (bb.coeff(0) * aa.block(1,0,order-1,1));
-      zi = temp1.lu().solve(temp2);
-    }
+    filtfiltState(&zi, bb, aa);
     
-    MatrixType Y = X;
-    for (int i = 0 ; i < Y.cols() ; ++i)
+    MatrixType Y(X.rows(), X.cols());
+    FFBuffer W(slen + 2 * elen, 4);
+    for (Index i = 0 ; i < X.cols() ; i += 4)
     {
-      // Reflection at the beginning
-      FFVector pre = -1.0 * Y.block(1,i,elen,1);
-      BTKEIGEN_FILFILT_REVERSE_INPLACE(pre)
-      pre.array() += 2.0 * Y.coeff(0,i);
-      // Reflection at the end
-      FFVector post = -1.0 * Y.block(Y.rows()-elen-1,i,elen,1);
-      BTKEIGEN_FILFILT_REVERSE_INPLACE(post)
-      post.array() += 2.0 * Y.coeff(Y.rows()-1,i);
-      // Signal to filter
-      FFVector y(Y.rows() + 2*elen,1);
-      y << pre, Y.col(i), post;
-      // Forward filter
-      FFVector zif = zi*y.coeff(0);
-      y = filter(bb,aa,y,zif);
-      // Backward filter
-      BTKEIGEN_FILFILT_REVERSE_INPLACE(y)
-      FFVector zib = zi*y.coeff(0);
-      y = filter(bb,aa,y,zib);
-      // Final filtered signal
-      BTKEIGEN_FILFILT_REVERSE_INPLACE(y)
-      Y.col(i) = y.block(elen,0,Y.rows(),1);
+      const Index num = std::min(static_cast<Index>(4), X.cols() - i);
+      W.block(elen, 0, slen, num) = X.middleCols(i, num);
+      W.block(elen, num, slen, 4 - num).setZero();
+      filtfiltLanes<Scalar, 4>(bb, aa, zi, elen, &W);
+      Y.middleCols(i, num) = W.block(elen, 0, slen, num);
     }
     
     return Y;
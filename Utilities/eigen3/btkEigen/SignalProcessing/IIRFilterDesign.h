@@ -51,23 +51,25 @@ namespace btkEigen
   typedef enum {Elliptic = 0, Butterworth, ChebyshevI, ChebyshevII, Bessel} FilterType;
   typedef enum {LowPass = 0, HighPass, BandPass, BandStop} BandType;
 
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp = NULL, double* rs = NULL, BandType btype = LowPass, FilterType ftype = Butterworth);
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* rp = NULL, double* rs = NULL, BandType btype = BandPass, FilterType ftype = Butterworth);
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp = NULL, double* rs = NULL, BandType btype = LowPass, FilterType ftype = Butterworth);
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* rp = NULL, double* rs = NULL, BandType btype = BandPass, FilterType ftype = Butterworth);
 
-  bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, BandType btype = LowPass)
+  inline bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, BandType btype = LowPass)
   {
     return iirfilter(b, a, order, Wn, NULL, NULL, btype, Butterworth);
   };
   
-  bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], BandType btype = BandPass)
+  inline bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], BandType btype = BandPass)
   {
     return iirfilter(b, a, order, Wn, NULL, NULL, btype, Butterworth);
   };
   
+  template <typename SOSType> bool butterSOS(SOSType* sos, int order, double Wn, BandType btype = LowPass);
+  
   // See the  paper "Design and responses of Butterworth and critically damped digital filters", Robertson & Dowling, Journal of Electromyography and Kinesiology, 2003.
   // or the paragraph 3.4.4.2 in the book "Biomechanics and Motor Control of Human Movement" (David A. Winter)
   // for more explanation on the need to adjust the order and the cutoff frequency.
-  void adjustZeroLagButterworth(int& n, double (*wn)[2])
+  inline void adjustZeroLagButterworth(int& n, double (*wn)[2])
   {
     const double c = 1.0 / std::pow(std::pow(2,1.0/static_cast<double>(n))-1.0, 0.25);
     (*wn)[0] *= c;
@@ -75,7 +77,7 @@ namespace btkEigen
     n /= 2;
   };
   
-  void adjustZeroLagButterworth(int& n, double& wn)
+  inline void adjustZeroLagButterworth(int& n, double& wn)
   {
     double wn_[2] = {wn, 0.0};
     adjustZeroLagButterworth(n, &wn_);
@@ -126,7 +128,7 @@ namespace btkEigen
 
   // ------------------------------------------------------------------------- //
 
-  void buttap(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* /* z */, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* p, double* k, int n)
+  inline void buttap(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* /* z */, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* p, double* k, int n)
   {
     // z is set to [], so no modification.
     std::complex<double> _1j(0.0, 1.0);
@@ -137,13 +139,13 @@ namespace btkEigen
     *k = 1.0;
   };
 
-  void zpk2tf(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& z, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& p, double k)
+  inline void zpk2tf(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& z, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& p, double k)
   {
     poly(b, z); *b *= k;
     poly(a, p);
   };
 
-  void lp2lp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
+  inline void lp2lp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a->rows();
@@ -161,7 +163,7 @@ namespace btkEigen
     normalize(b,a);
   };
   
-  void lp2hp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
+  inline void lp2hp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1> a_ = *a, b_ = *b;
@@ -192,7 +194,7 @@ namespace btkEigen
     normalize(b,a);
   };
   
-  void lp2bp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
+  inline void lp2bp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a->rows() - 1;
@@ -233,7 +235,7 @@ namespace btkEigen
     normalize(b,a);
   };
   
-  void lp2bs(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
+  inline void lp2bs(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a->rows() - 1;
@@ -274,7 +276,7 @@ namespace btkEigen
     normalize(b,a);
   };
 
-  void bilinear(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix< double, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& b_, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& a_, double fs = 1.0)
+  inline void bilinear(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix< double, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& b_, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& a_, double fs = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a_.rows() - 1;
@@ -337,7 +339,7 @@ namespace btkEigen
    *  - 3: Chebyshev II
    *  - 4: Bessel
    */
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp, double* rs, BandType btype, FilterType ftype)
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp, double* rs, BandType btype, FilterType ftype)
   {
     // This function is only for low pass or high pass filter
     if ((btype == 2) || (btype == 3))
@@ -349,7 +351,7 @@ namespace btkEigen
     return iirfilter(b, a, order, Wn_, rp, rs, btype, ftype);
   };
 
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* /*rp*/, double* /*rs*/, BandType btype, FilterType ftype)
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* /*rp*/, double* /*rs*/, BandType btype, FilterType ftype)
   {
     // This function is only for band pass or band stop filter
     if (((btype == 0) || (btype == 1)) && (Wn[1] != -1.0))
@@ -447,6 +449,65 @@ namespace btkEigen
   
     return true;
   };
+  
+  /**
+   * Design a lowpass or highpass Butterworth filter of order @a order directly as second-order sections (cascaded biquads). 
+   * Each row of @a sos contains the coefficients [b0, b1, b2, 1, a1, a2] of one section (see sosfilt()). The gain of the filter is set in the first section.
+   * The cutoff frequency @a Wn is normalized by the Nyquist frequency. 
+   *
+   * The poles are computed from the analog prototype (see buttap()) and transformed with the bilinear transform without computing the polynomials 
+   * of the transfer function. Thus, the coefficients stay accurate for the high orders. Each pair of conjugate poles gives one section. 
+   * For an odd order, the first section is a first order section (b2 and a2 equal to 0). The poles closest to the unit circle are set in the last section.
+   */
+  template <typename SOSType>
+  bool butterSOS(SOSType* sos, int order, double Wn, BandType btype)
+  {
+    if ((btype != LowPass) && (btype != HighPass))
+    {
+      btkErrorMacro("Only lowpass and highpass filters can be designed as second-order sections.");
+      return false;
+    }
+    if (order < 1)
+    {
+      btkErrorMacro("The order of the filter must be strictly positive.");
+      return false;
+    }
+    if ((Wn <= 0.0) || (Wn >= 1.0))
+    {
+      btkErrorMacro("The cutoff frequency must be in the range ]0,1[.");
+      return false;
+    }
+    // Pre-warp frequency for digital filter design
+    const double fs = 2.0;
+    const double wo = 2.0 * fs * tan(M_PI * Wn / fs);
+    // Analog lowpass prototype
+    Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1> z, p;
+    double k = 0.0;
+    buttap(&z, &p, &k, order);
+    // Lowpass to lowpass/highpass transformation and bilinear transformation of the poles.
+    // The zeros are at -1 (lowpass) or +1 (highpass) in the z-domain.
+    std::complex<double> gain(k, 0.0);
+    for (int i = 0 ; i < order ; ++i)
+    {
+      std::complex<double> pa = (btype == LowPass) ? p.coeff(i) * wo : wo / p.coeff(i);
+      gain *= (btype == LowPass) ? wo / (2.0 * fs - pa) : 2.0 * fs / ((2.0 * fs - pa) * -p.coeff(i));
+      p.coeffRef(i) = (2.0 * fs + pa) / (2.0 * fs - pa);
+    }
+    const double zero = (btype == LowPass) ? -1.0 : 1.0;
+    const int num = (order + 1) / 2;
+    sos->resize(num, 6);
+    int inc = 0;
+    // The real pole (odd order) is at the middle of the poles computed by buttap.
+    if (order % 2 == 1)
+    {
+      sos->row(inc++) << 1.0, -zero, 0.0, 1.0, -p.coeff(order / 2).real(), 0.0;
+    }
+    // Pairs of conjugate poles (i, order-1-i). The poles with the lowest indices are the closest to the unit circle.
+    for (int i = order / 2 - 1 ; i >= 0 ; --i)
+      sos->row(inc++) << 1.0, -2.0 * zero, 1.0, 1.0, -2.0 * p.coeff(i).real(), std::norm(p.coeff(i));
+    sos->row(0).head(3) *= gain.real();
+    return true;
+  };
 };
 
 #endif // __btkEigenIIRFilterDesign_h
\ No newline at end of file
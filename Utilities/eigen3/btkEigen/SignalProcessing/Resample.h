@@ -0,0 +1,156 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenResample_h
+#define __btkEigenResample_h
+
+#include "Decimate.h"
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Approximates the positive ratio @a r by the fraction @a p / @a q (irreducible) where @a q is lower or equal to @a maxDenominator.
+   * Returns false if the fraction is not equal to the ratio (relative difference greater than 1e-9) or if the ratio is not strictly positive.
+   *
+   * The fraction is computed with the continued fraction expansion of the ratio.
+   */
+  inline bool rationalize(double r, int* p, int* q, int maxDenominator = 1000)
+  {
+    *p = 0; *q = 1;
+    if (r <= 0.0)
+      return false;
+    // Convergents h(n)/k(n)
+    double h0 = 0.0, h1 = 1.0, k0 = 1.0, k1 = 0.0;
+    double x = r;
+    for (int i = 0 ; i < 64 ; ++i)
+    {
+      const double a = std::floor(x);
+      const double h2 = a * h1 + h0, k2 = a * k1 + k0;
+      if (k2 > static_cast<double>(maxDenominator))
+        break;
+      h0 = h1; h1 = h2; k0 = k1; k1 = k2;
+      if (std::fabs(h1 / k1 - r) <= 1e-9 * r)
+        break;
+      x = 1.0 / (x - a);
+    }
+    if ((k1 == 0.0) || (h1 == 0.0)) // Ratio too small or too large to be represented
+      return false;
+    *p = static_cast<int>(h1);
+    *q = static_cast<int>(k1);
+    return (std::fabs(h1 / k1 - r) <= 1e-9 * r);
+  };
+  
+  /**
+   * Design the filter used to resample a signal by the factor @a p / @a q (low-pass FIR filter with 20*max(p,q)+1 coefficients 
+   * and a cutoff frequency equal to the lowest Nyquist frequency, multiplied by @a p to compensate the inserted zeros).
+   * For @a p and @a q equal to 1, the filter has only one coefficient equal to 1.
+   *
+   * The same design than the one used by the function resample_poly provided in SciPy (except the window).
+   */
+  inline bool resamplingFilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* h, int p, int q)
+  {
+    if ((p < 1) || (q < 1))
+    {
+      btkErrorMacro("The resampling factors must be strictly positive.");
+      return false;
+    }
+    const int m = std::max(p, q);
+    if (m == 1)
+    {
+      h->setOnes(1);
+      return true;
+    }
+    if (!firwin(h, 20 * m + 1, 1.0 / static_cast<double>(m)))
+      return false;
+    *h *= static_cast<double>(p);
+    return true;
+  };
+  
+  /**
+   * Resamples each column of @a X by the factor @a p / @a q: the signal is upsampled by @a p (zeros inserted), filtered by the FIR filter @a h and downsampled by @a q.
+   * The number of coefficients of @a h must be odd. The filter is centred on the computed samples so there is no delay 
+   * and the signal is reflected at its boundaries. The number of rows of the result is equal to ceil(rows(X) * p / q) 
+   * (i.e. the samples computed are the ones in the time range of @a X).
+   *
+   * The polyphase form is used: only the computed samples are evaluated and the inserted zeros are skipped. 
+   * The coefficients are then split in @a p branches. Each sample is computed for all the columns at once with the product 
+   * between one branch and a window of the input. To have contiguous windows, the matrix @a X should be stored in row major (channels interleaved).
+   */
+  template<typename FilterCoeff, typename MatrixType>
+  Eigen::Matrix<typename MatrixType::Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> resample(const FilterCoeff& h, int p, int q, const MatrixType& X)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RMatrix;
+    
+    eigen_assert(h.cols() == 1);
+    eigen_assert((h.rows() % 2 == 1) && "The number of coefficients must be odd.");
+    eigen_assert((p > 0) && (q > 0) && "The resampling factors must be strictly positive.");
+    
+    const Index len = h.rows();
+    const Index half = (len - 1) / 2;
+    const Index slen = X.rows();
+    const Index num = (slen * p + q - 1) / q;
+    const Index taps = (len - 1) / p + 1; // Number of coefficients by branch
+    // Branches of the filter: the branch s contains the coefficients h(len-1-s), h(len-1-s-p), ...
+    RMatrix B = RMatrix::Zero(p, taps);
+    for (Index s = 0 ; s < p ; ++s)
+    {
+      for (Index t = 0 ; (t < taps) && (len - 1 - s - t * p >= 0) ; ++t)
+        B.coeffRef(s, t) = static_cast<Scalar>(h.coeff(len - 1 - s - t * p));
+    }
+    RMatrix Y(num, X.cols());
+    RMatrix W(taps, X.cols()); // Window reflected at the boundaries
+    for (Index i = 0 ; i < num ; ++i)
+    {
+      // First input sample used and the branch associated with it.
+      const Index a = i * q - half;
+      const Index first = (a >= 0) ? (a + p - 1) / p : -((-a) / p);
+      const Index s = len - 1 - (i * q + half - first * p);
+      if ((first >= 0) && (first + taps <= slen))
+        Y.row(i).noalias() = B.row(s) * X.middleRows(first, taps);
+      else
+      {
+        for (Index j = 0 ; j < taps ; ++j)
+          W.row(j) = X.row(reflectIndex(first + j, slen));
+        Y.row(i).noalias() = B.row(s) * W;
+      }
+    }
+    return Y;
+  };
+};
+#endif // __btkEigenResample_h
@@ -0,0 +1,305 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenSOSFilter_h
+#define __btkEigenSOSFilter_h
+
+#include "FiltFilt.h"
+#include "btkLogger.h"
+
+#include <Eigen/Core>
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  /**
+   * Filters in place the column @a col of @a X with the cascade of second-order sections @a sos.
+   * The number of sections is given at the compilation (@a Sections) or is dynamic (Eigen::Dynamic). 
+   * For a fixed number of sections, the coefficients and the states are stored in fixed size arrays and the loop over the sections can be unrolled.
+   * The states of the sections are reset to zero.
+   *
+   * Each section uses the direct form II transposed. This function is used by sosfilt().
+   */
+  template<int Sections, typename SOSType, typename MatrixType>
+  void sosfiltColumn(const SOSType& sos, MatrixType& X, typename MatrixType::Index col)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    
+    const Index num = (Sections == Eigen::Dynamic) ? sos.rows() : Sections;
+    Eigen::Matrix<Scalar, Sections, 5, Eigen::RowMajor> c(num, 5); // b0, b1, b2, a1, a2 (normalized by a0)
+    Eigen::Matrix<Scalar, Sections, 2, Eigen::RowMajor> z = Eigen::Matrix<Scalar, Sections, 2, Eigen::RowMajor>::Zero(num, 2);
+    for (Index s = 0 ; s < num ; ++s)
+    {
+      const Scalar a0 = static_cast<Scalar>(sos.coeff(s,3));
+      c.coeffRef(s,0) = static_cast<Scalar>(sos.coeff(s,0)) / a0;
+      c.coeffRef(s,1) = static_cast<Scalar>(sos.coeff(s,1)) / a0;
+      c.coeffRef(s,2) = static_cast<Scalar>(sos.coeff(s,2)) / a0;
+      c.coeffRef(s,3) = static_cast<Scalar>(sos.coeff(s,4)) / a0;
+      c.coeffRef(s,4) = static_cast<Scalar>(sos.coeff(s,5)) / a0;
+    }
+    for (Index i = 0 ; i < X.rows() ; ++i)
+    {
+      Scalar v = X.coeff(i, col);
+      for (Index s = 0 ; s < num ; ++s)
+      {
+        const Scalar y = c.coeff(s,0) * v + z.coeff(s,0);
+        z.coeffRef(s,0) = c.coeff(s,1) * v - c.coeff(s,3) * y + z.coeff(s,1);
+        z.coeffRef(s,1) = c.coeff(s,2) * v - c.coeff(s,4) * y;
+        v = y;
+      }
+      X.coeffRef(i, col) = v;
+    }
+  };
+  
+  /**
+   * Digital filter defined by a cascade of second-order sections (biquads) and applied in place on each column of @a X.
+   * Each row of @a sos contains the coefficients [b0, b1, b2, a0, a1, a2] of one section (see butterSOS() to design them).
+   * Compared to the function filter() with the coefficients of the transfer function, the cascade is numerically stable for the high orders.
+   * The initial states of the sections are set to zero.
+   *
+   * The filters with 1 to 4 sections (order 1 to 8) use the fixed size version of sosfiltColumn(). The other ones use the dynamic version.
+   * As the signal is modified in place, a block (e.g. a column of a matrix) can be given directly to this function.
+   *
+   * Inspired from the sosfilt function provided in SciPy.
+   */
+  template<typename SOSType, typename Derived>
+  void sosfilt(const SOSType& sos, const Eigen::MatrixBase<Derived>& X_)
+  {
+    typedef typename Derived::Index Index;
+    eigen_assert(sos.cols() == 6);
+    Eigen::MatrixBase<Derived>& X = const_cast< Eigen::MatrixBase<Derived>& >(X_); // See the Eigen documentation about the functions taking Eigen types as parameters.
+    for (Index s = 0 ; s < sos.rows() ; ++s)
+    {
+      if (sos.coeff(s,3) == 0.0)
+      {
+        btkErrorMacro("Impossible to filter the signal, the first element of the denominator of a section is equal to 0.");
+        return;
+      }
+    }
+    for (Index j = 0 ; j < X.cols() ; ++j)
+    {
+      switch (sos.rows())
+      {
+      case 0:
+        return;
+      case 1:
+        sosfiltColumn<1>(sos, X, j);
+        break;
+      case 2:
+        sosfiltColumn<2>(sos, X, j);
+        break;
+      case 3:
+        sosfiltColumn<3>(sos, X, j);
+        break;
+      case 4:
+        sosfiltColumn<4>(sos, X, j);
+        break;
+      default:
+        sosfiltColumn<Eigen::Dynamic>(sos, X, j);
+        break;
+      }
+    }
+  };
+  
+  /**
+   * Computes the initial states @ zi (one row per section, two states by row) of the cascade of second-order sections @a sos to use in a forward-backward filter.
+   * The coefficients of each section must be normalized by its first element of the denominator (e.g. designed by butterSOS()). 
+   * This is the steady state of each section for a step response, scaled by the static gain of the previous sections. 
+   * As for filtfiltState(), the states must be multiplied by the first value filtered.
+   *
+   * Inspired from the sosfilt_zi function provided in SciPy.
+   */
+  template<typename SOSType, typename StateType>
+  void sosfiltState(StateType* zi, const SOSType& sos)
+  {
+    typedef typename SOSType::Index Index;
+    typedef typename SOSType::Scalar Scalar;
+    zi->resize(sos.rows(), 2);
+    Scalar scale = 1.0;
+    for (Index s = 0 ; s < sos.rows() ; ++s)
+    {
+      // Steady state of the direct form II transposed for a constant input equal to 1.
+      const Scalar y = (sos.coeff(s,0) + sos.coeff(s,1) + sos.coeff(s,2)) / (1.0 + sos.coeff(s,4) + sos.coeff(s,5));
+      zi->coeffRef(s,0) = scale * (y - sos.coeff(s,0));
+      zi->coeffRef(s,1) = scale * (sos.coeff(s,2) - sos.coeff(s,5) * y);
+      scale *= y;
+    }
+  };
+  
+  /**
+   * Forward-backward filter defined by the cascade of second-order sections @a sos and applied in place on the @a Lanes channels stored in @a W.
+   * The number of sections is given at the compilation (@a Sections) or is dynamic (Eigen::Dynamic). As for sosfiltColumn(), the coefficients 
+   * and the states of a fixed number of sections are stored in fixed size arrays and the loop over the sections can be unrolled.
+   * This function is used by sosfiltfiltLanes().
+   */
+  template<int Sections, typename Scalar, int Lanes, typename SOSType, typename StateType>
+  void sosfiltfiltSections(const SOSType& sos, const StateType& zi, typename FiltFiltLanesBuffer<Scalar, Lanes>::Type* W)
+  {
+    typedef typename SOSType::Index Index;
+    typedef Eigen::Array<Scalar, 1, Lanes> Lane;
+    
+    const Index rows = W->rows();
+    const Index num = (Sections == Eigen::Dynamic) ? sos.rows() : Sections;
+    Eigen::Matrix<Scalar, Sections, 5, Eigen::RowMajor> c(num, 5); // b0, b1, b2, a1, a2
+    for (Index s = 0 ; s < num ; ++s)
+      c.row(s) << sos.coeff(s,0), sos.coeff(s,1), sos.coeff(s,2), sos.coeff(s,4), sos.coeff(s,5);
+    Eigen::Array<Scalar, Sections, Lanes, (Lanes == 1) ? Eigen::ColMajor : Eigen::RowMajor> z0(num, Lanes), z1(num, Lanes);
+    for (int pass = 0 ; pass < 2 ; ++pass)
+    {
+      // Forward filter, then backward filter
+      const Index first = (pass == 0) ? 0 : rows - 1;
+      const Index inc = (pass == 0) ? 1 : -1;
+      for (Index s = 0 ; s < num ; ++s)
+      {
+        z0.row(s) = zi.coeff(s,0) * W->row(first).array();
+        z1.row(s) = zi.coeff(s,1) * W->row(first).array();
+      }
+      for (Index i = first ; (i >= 0) && (i < rows) ; i += inc)
+      {
+        Lane v = W->row(i).array();
+        for (Index s = 0 ; s < num ; ++s)
+        {
+          const Lane y = z0.row(s) + c.coeff(s,0) * v;
+          z0.row(s) = z1.row(s) + c.coeff(s,1) * v - c.coeff(s,3) * y;
+          z1.row(s) = c.coeff(s,2) * v - c.coeff(s,4) * y;
+          v = y;
+        }
+        W->row(i) = v.matrix();
+      }
+    }
+  };
+  
+  /**
+   * Forward-backward filter defined by the cascade of second-order sections @a sos and applied in place on the @a Lanes channels stored in @a W (see FiltFiltLanesBuffer).
+   * The layout of @a W and the reflections at the boundaries are the same than for the function filtfiltLanes(). 
+   * The coefficients of each section must be normalized by its first element of the denominator and the initial states @a zi are computed by sosfiltState().
+   *
+   * As for filtfiltLanes(), the recursion of each section is computed for all the channels at once. 
+   * The filters with 1 to 4 sections (order 1 to 8) use the fixed size version of sosfiltfiltSections(). The other ones use the dynamic version.
+   */
+  template<typename Scalar, int Lanes, typename SOSType, typename StateType>
+  void sosfiltfiltLanes(const SOSType& sos, const StateType& zi, typename SOSType::Index elen, typename FiltFiltLanesBuffer<Scalar, Lanes>::Type* W)
+  {
+    // Reflections at the beginning and at the end
+    filtfiltReflect(elen, W);
+    switch (sos.rows())
+    {
+    case 0:
+      return;
+    case 1:
+      sosfiltfiltSections<1, Scalar, Lanes>(sos, zi, W);
+      break;
+    case 2:
+      sosfiltfiltSections<2, Scalar, Lanes>(sos, zi, W);
+      break;
+    case 3:
+      sosfiltfiltSections<3, Scalar, Lanes>(sos, zi, W);
+      break;
+    case 4:
+      sosfiltfiltSections<4, Scalar, Lanes>(sos, zi, W);
+      break;
+    default:
+      sosfiltfiltSections<Eigen::Dynamic, Scalar, Lanes>(sos, zi, W);
+      break;
+    }
+  };
+  
+  /**
+   * A forward-backward digital filter without phase delay defined by a cascade of second-order sections (see sosfilt()). 
+   * The signals are extended and the initial states are set as for the function filtfilt(). Compared to this function used with the coefficients 
+   * of the transfer function, the result is the same for the low orders and the filter stays numerically stable for the high orders.
+   *
+   * The columns of @a X are filtered by groups of 4 using the function sosfiltfiltLanes(). The same buffer is used for all the groups.
+   *
+   * Inspired from the sosfiltfilt function provided in SciPy.
+   */
+  template<typename SOSType, typename MatrixType>
+  MatrixType sosfiltfilt(const SOSType& sos, const MatrixType& X)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 6> FFSections;
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 2> FFStates;
+    typedef typename FiltFiltLanesBuffer<Scalar, 4>::Type FFBuffer;
+    
+    eigen_assert(sos.cols() == 6);
+    const Index slen = X.rows();
+    // Order of the filter: the first order sections (b2 and a2 equal to 0) have one state less.
+    Index order = 2 * sos.rows();
+    for (Index s = 0 ; s < sos.rows() ; ++s)
+    {
+      if ((sos.coeff(s,2) == 0.0) && (sos.coeff(s,5) == 0.0))
+        --order;
+    }
+    const Index elen = 3 * order; // Number of element used in the reflections
+    
+    eigen_assert((order > 0) && "The order of the filter must be greater than 0.");
+    eigen_assert((slen > elen) && "The signal to filter must have a length 3 times greater than the order of the filter.");
+    
+    MatrixType Y(X.rows(), X.cols());
+    
+    // Normalize the coefficients of each section
+    FFSections c = sos.template cast<Scalar>();
+    for (Index s = 0 ; s < c.rows() ; ++s)
+    {
+      if (c.coeff(s,3) == 0.0)
+      {
+        btkErrorMacro("Impossible to filter the signal, the first element of the denominator of a section is equal to 0.");
+        Y = X;
+        return Y;
+      }
+      c.row(s) /= c.coeff(s,3);
+    }
+    
+    // Compute the initial states of the sections
+    FFStates zi;
+    sosfiltState(&zi, c);
+    
+    FFBuffer W(slen + 2 * elen, 4);
+    for (Index i = 0 ; i < X.cols() ; i += 4)
+    {
+      const Index num = std::min(static_cast<Index>(4), X.cols() - i);
+      W.block(elen, 0, slen, num) = X.middleCols(i, num);
+      W.block(elen, num, slen, 4 - num).setZero();
+      sosfiltfiltLanes<Scalar, 4>(c, zi, elen, &W);
+      Y.middleCols(i, num) = W.block(elen, 0, slen, num);
+    }
+    
+    return Y;
+  };
+};
+#endif // __btkEigenSOSFilter_h
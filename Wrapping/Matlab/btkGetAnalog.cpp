@@ -48,7 +48,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   btk::Acquisition::Pointer acq = btk_MOH_get_object<btk::Acquisition>(prhs[0]);
   btk::Analog::Pointer analog = btkMXGetAnalog(acq, nrhs, prhs);
   plhs[0] = mxCreateDoubleMatrix(acq->GetAnalogFrameNumber(), 1, mxREAL);
-  memcpy(mxGetPr(plhs[0]), analog->GetValues().data(), mxGetNumberOfElements(plhs[0]) * sizeof(double));
+  Eigen::Map<Eigen::VectorXd>(mxGetPr(plhs[0]), mxGetNumberOfElements(plhs[0])) = analog->GetValues();
   if (nlhs > 1)
   {
     const char* info[] = {"label", "description", "gain", "offset", "scale", "frequency", "units"};
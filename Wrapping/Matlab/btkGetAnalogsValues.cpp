@@ -49,22 +49,11 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   int numberOfFrames = acq->GetAnalogFrameNumber();
   int numberOfChannels = acq->GetAnalogNumber();
   plhs[0] = mxCreateDoubleMatrix(numberOfFrames, numberOfChannels, mxREAL);
-  double* values = mxGetPr(plhs[0]);
+  Eigen::Map<Eigen::MatrixXd> values(mxGetPr(plhs[0]), numberOfFrames, numberOfChannels);
 
+  // The analog values can be stored in a block (i.e. with a stride).
   int i = 0;
-  int j = numberOfFrames;
-  double* v = 0;
-  btk::Acquisition::AnalogConstIterator it = acq->BeginAnalog();
-  while(i < (numberOfFrames * numberOfChannels))
-  {
-    if (j >= numberOfFrames)
-    {
-      v = (*it)->GetValues().data();
-      ++it;
-      j = 0;
-    }
-    values[i] = v[j];
-    ++i; ++j;
-  }
+  for (btk::Acquisition::AnalogConstIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+    values.col(i++) = (*it)->GetValues();
 };
 
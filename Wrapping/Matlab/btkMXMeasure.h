@@ -107,7 +107,7 @@ inline mxArray* btkMXCreateMeasuresStructure(typename btk::Collection<T>::Pointe
     for(typename itemCollection::ConstIterator it = m->Begin() ; it != m->End() ; ++it)
     {
       mxArray* measure = mxCreateDoubleMatrix(firstItem->GetFrameNumber(), firstItem->GetValues().cols(), mxREAL);
-      memcpy(mxGetPr(measure), (*it)->GetValues().data(), mxGetNumberOfElements(measure) * sizeof(double));
+      Eigen::Map<Eigen::MatrixXd>(mxGetPr(measure), mxGetM(measure), mxGetN(measure)) = (*it)->GetValues();
       mxSetFieldByNumber(out, 0, inc, measure);
       ++inc;
     }
@@ -56,23 +56,12 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   if (mxGetNumberOfElements(prhs[1]) != (numberOfFrames * numberOfChannels))
     mexErrMsgTxt("The second input doesn't have the same size than the number of analog channels values.");
     
-  double* values = mxGetPr(prhs[1]);
+  Eigen::Map<Eigen::MatrixXd> values(mxGetPr(prhs[1]), numberOfFrames, numberOfChannels);
 
+  // The analog values can be stored in a block (i.e. with a stride).
   int i = 0;
-  int j = numberOfFrames;
-  double* v = 0;
-  btk::Acquisition::AnalogIterator it = acq->BeginAnalog();
-  while (i < (numberOfFrames * numberOfChannels))
-  {
-    if (j >= numberOfFrames)
-    {
-      v = (*it)->GetValues().data();
-      ++it;
-      j = 0;
-    }
-    v[j] = values[i];
-    ++i; ++j;
-  }
+  for (btk::Acquisition::AnalogIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+    (*it)->GetValues() = values.col(i++);
 };
 
 